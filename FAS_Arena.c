@@ -0,0 +1,49 @@
+/**
+ * @file FAS_Arena.c
+ * @brief session 작업 메모리 구현
+ */
+
+#include <stdio.h>
+#include "FAS_Arena.h"
+
+ /**@brief arena 준비
+  * @param void *storage 쓸 메모리 (NULL이면 size만큼 한 번 malloc)
+  * @param size_t size 크기 (0이면 FAS_ARENA_DEFAULT_SIZE)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ArenaInit(FAS_ARENA *arena, void *storage, size_t size){
+    memset(arena, 0, sizeof(*arena));
+    if (size == 0)
+        size = FAS_ARENA_DEFAULT_SIZE;
+    if (storage == NULL) {
+        storage = malloc(size);
+        if (storage == NULL) {
+            perror("arena allocation failed");
+            return false;
+        }
+        arena->owned = true;
+    }
+    arena->base = storage;
+    arena->size = size;
+    return true;
+}
+
+ /**@brief FAS_ArenaInit이 잡은 메모리 반환*/
+void FAS_ArenaFree(FAS_ARENA *arena){
+    if (arena->owned)
+        free(arena->base);
+    memset(arena, 0, sizeof(*arena));
+}
+
+ /**@brief 메모리 떼어 주기 (FAS_ARENA_ALIGN 정렬)
+  * @return 공간이 모자라면 NULL (heap으로 넘어가지 않음)*/
+void *FAS_ArenaAlloc(FAS_ARENA *arena, size_t size){
+    size_t start = (arena->used + FAS_ARENA_ALIGN - 1) & ~(size_t)(FAS_ARENA_ALIGN - 1);
+    if (start > arena->size || size > arena->size - start) {
+        arena->overflow++;
+        return NULL;
+    }
+    arena->used = start + size;
+    if (arena->used > arena->high_water)
+        arena->high_water = arena->used;
+    return arena->base + start;
+}
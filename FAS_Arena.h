@@ -0,0 +1,63 @@
+
+#pragma once
+
+#ifndef FAS_ARENA_DEFINE
+#define FAS_ARENA_DEFINE
+
+/**
+ * @file FAS_Arena.h
+ * @brief session마다 하나씩 두는 고정 크기 작업 메모리 (bump allocator)
+ * @details 처음에 한 번만 크게 잡아 두고, 요청 처리 중 필요한 임시 배열은 여기서 떼어 쓴 뒤
+ * 처리가 끝나면 mark 위치로 되돌린다. 한 번 데워진 뒤에는 송수신 경로에서 heap을 건드리지 않는다.
+ * lock이 없으므로 arena 하나는 thread 하나(session 하나)에서만 쓴다.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FAS_ARENA_ALIGN 16
+#define FAS_ARENA_DEFAULT_SIZE (256 * 1024)
+
+typedef struct _FAS_ARENA
+{
+	uint8_t *base;
+	size_t size;
+	size_t used;
+	size_t high_water;			// 가장 많이 썼을 때 (크기 조정용)
+	uint64_t overflow;			// 공간이 모자라 실패한 횟수
+	bool owned;					// base를 FAS_ArenaInit이 잡았으면 TRUE
+} FAS_ARENA;
+
+bool FAS_ArenaInit(FAS_ARENA *arena, void *storage, size_t size);
+void FAS_ArenaFree(FAS_ARENA *arena);
+void *FAS_ArenaAlloc(FAS_ARENA *arena, size_t size);
+
+/**@brief 지금 위치 기억 (FAS_ArenaRelease로 되돌림)*/
+static inline size_t FAS_ArenaMark(const FAS_ARENA *arena) {
+    return arena->used;
+}
+
+/**@brief mark 이후에 뗀 메모리를 한꺼번에 반환*/
+static inline void FAS_ArenaRelease(FAS_ARENA *arena, size_t mark) {
+    if (mark <= arena->used)
+        arena->used = mark;
+}
+
+/**@brief 임시 메모리 (arena가 NULL이면 heap), zero면 0으로 채움*/
+static inline void *FAS_ScratchAlloc(FAS_ARENA *arena, size_t size, bool zero) {
+    void *p = arena != NULL ? FAS_ArenaAlloc(arena, size) : malloc(size ? size : 1);
+    if (p != NULL && zero)
+        memset(p, 0, size);
+    return p;
+}
+
+/**@brief FAS_ScratchAlloc 반환 (arena는 FAS_ArenaRelease로 한꺼번에 반환하므로 아무것도 안 함)*/
+static inline void FAS_ScratchFree(FAS_ARENA *arena, void *p) {
+    if (arena == NULL)
+        free(p);
+}
+
+#endif	//FAS_ARENA_DEFINE
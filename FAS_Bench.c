@@ -0,0 +1,2075 @@
+/**
+ * @file FAS_Bench.c
+ * @brief libfastech 동시 실행 benchmark
+ * @details 가짜 드라이브(FAS_StandIn) 8대를 127.0.0.11~18에 띄우고, context/thread 수를 1, 2, 4, 8로 늘리면서
+ * thread마다 자기 context로 명령을 보내고 응답을 받는다. context끼리 공유하는 lock이 없으므로
+ * 전체 처리량은 thread 수에 비례해야 한다.
+ * shard transport(FAS_Shard)는 가짜 드라이브 64대(127.0.1.1~64)를 shard 1, 2, 4, 8개에 나눠 맡기고,
+ * 보드마다 window만큼 요청을 계속 채워 넣는 closed loop로 초당 처리량과 shard별 통계를 본다.
+ * 가짜 드라이브는 응답 지연 동안 thread를 재우지 않으므로 처리량은 shard thread CPU에서 막히고,
+ * CPU가 shard 수의 2배 이상이면 shard 수에 거의 비례해야 한다 (CPU가 모자라면 speedup은 확인하지 않고 CPU 수만 찍음).
+ * 같은 측정을 epoll과 io_uring backend로 한 번씩 해서 요청당 syscall 수와 shard thread CPU 시간을 비교한다.
+ * 고장 주입 proxy(FAS_Fault)를 가짜 드라이브 앞에 두고 손실률 0, 1, 2, 5%에서 요청 엔진의 실제 처리량과
+ * 꼬리 지연(재전송 포함, 요청을 넣은 때부터 끝날 때까지)을 잰다.
+ * Frame 입력칸 편집 model(FAS_FrameEdit)에 253 byte 붙여넣기와 한 글자 편집이 걸리는 시간도 잰다.
+ * scope(FAS_Scope)는 보이는 구간 길이를 바꿔 가며 화면 폭 800열로 줄이는 시간을 잰다 (구간 길이와 무관해야 함).
+ * telemetry(FAS_Telemetry)는 8축 1kHz 1분 분량을 .fct로 쓰고 다시 읽어 확인하면서, 같은 응답을 hex 문자열로
+ * 남겼을 때와 크기를 비교한다.
+ * 명령 broker(FAS_Broker)는 같은 가짜 드라이브에 직접 명령과 broker 경유 명령의 RTT를 비교하고,
+ * 요청을 몰아 넣는 client 하나와 가볍게 보내는 client 둘이 같은 보드를 나눠 쓸 때 client별 처리량을 본다.
+ * position table(FAS_PosTable)은 가짜 드라이브 20대(127.0.0.100~119)에 256항목 recipe를 쓰고 확인 읽기까지 한 시간과,
+ * 항목 10%만 바꾼 recipe로 바꿀 때 바뀐 항목만 보내는 시간을 잰다.
+ * 송신 우선순위(FAS_PRIORITY)는 요청을 하나씩 처리하는 가짜 드라이브 8대(127.0.0.120~127, 한 대는 10배 느림)를
+ * polling으로 꽉 채운 채 MoveVelocity를 2 ms마다 넣어서, polling이 없을 때를 기준으로 우선순위를 끈 때, 켠 때,
+ * 보드당 조회를 한 칸만 보낼 때(poll_window 1)의 운전 명령 지연과 class별 대기 시간을 비교하고,
+ * shard 전체 제한(inflight_max)을 걸었을 때 보드별 polling 처리량을 본다.
+ * 운전 sequence(FAS_Script)는 가짜 드라이브 16대에 서보 ON → 원점 → 이동 → inposition 대기 → 엔코더 읽기를
+ * 2000개 동시에 돌려서 sequence당 메모리와 걸린 시간 분포를 본다.
+ * 적응형 polling(FAS_Poll)은 가짜 드라이브 16대 중 2대만 운전할 때 보드별 목표/실제 조회 rate와 전체 프레임 수를
+ * 고정 주기(모두 fast)와 비교하고, 멈춰 있던 축이 움직이거나 알람이 날 때 fast로 올라가기까지의 시간,
+ * 알람 종류 조회(0x2E)를 거절하는 드라이브에서도 상태 조회가 이어지는지와
+ * 전체 budget을 걸었을 때 운전 중인 축이 받는 rate를 본다.
+ * capture 분석(FAS_Pcap)은 드라이브 8대의 UDP 요청/응답 40만 쌍(알람 응답, 재전송, 응답 없는 요청 섞음)을
+ * pcap으로 쓰고 분석 속도(MB/s)와 센 값을 확인하고, segment를 일부러 잘게 나누고 한 번 다시 보낸 TCP 흐름을
+ * pcapng로 써서 재조립 결과를 확인한다.
+ * override 스트리밍(FAS_Stream)은 가짜 드라이브 한 대에 1kHz로 1초 동안 FAS_StreamPost 값을 보내서 주기 jitter,
+ * 건너뛴 주기, 덮인 setpoint, 응답 RTT를 보고, setpoint buffer를 다 보내고 스스로 끝난 스트림을 다시 시작해 본다.
+ * 프레임 codec(FAS_Codec)은 Header를 변수로 받는 예전 조립/분해와, 기본 codec의 inline 판, FAS_CodecEncode/Decode
+ * hot path, 함수 pointer 호출을 변형마다 비교한다 (inline 판이 예전 방식보다 빨라야 함).
+ * 파라미터 cache(FAS_Param)는 가짜 드라이브 2대에 전체 읽기 → 몇 개만 바꿔 쓰기 → ROM 저장 → 파일 저장/불러오기를
+ * 한 바퀴 돌려서, 바뀐 번호만 한 번씩 보내는지, ROM 저장은 보드마다 한 번인지, 파일이 값을 그대로 옮기는지,
+ * CRC가 틀린 파일은 거부하는지 확인한다.
+ * 마지막으로 데워진 뒤의 송수신 경로(명령, 파라미터 일괄 읽기, 프레임 문자열 변환)가 heap을 한 번도
+ * 쓰지 않는지 malloc을 가로채서 확인한다.
+ * 측정마다 통과 조건(실패한 요청 없음, 센 값이 맞음 등)을 확인해서 어긋난 줄 끝에 "<- FAIL"을 붙이고,
+ * 하나라도 실패하면 실패 개수를 찍고 종료 코드 1로 끝난다.
+ * 사용법: FAS_Bench [-n 요청 수/thread] [-d 가짜 드라이브 응답 지연 us] [-t 최대 thread 수]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "FAS_Library.h"
+#include "FAS_Metrics.h"
+#include "FAS_Param.h"
+#include "FAS_FrameEdit.h"
+#include "FAS_Scope.h"
+#include "FAS_Telemetry.h"
+#include "FAS_Shard.h"
+#include "FAS_Status.h"
+#include "FAS_Codec.h"
+#include "FAS_Fault.h"
+#include "FAS_EStop.h"
+#include "FAS_List.h"
+#include "FAS_StandIn.h"
+#include "FAS_Broker.h"
+#include "FAS_PosTable.h"
+#include "FAS_Script.h"
+#include "FAS_Poll.h"
+#include "FAS_Pcap.h"
+#include "FAS_Stream.h"
+
+#define BENCH_MAX_THREADS 8
+#define BENCH_WARMUP 50
+#define BENCH_SHARD_BOARDS 16
+#define BENCH_SWEEP_BOARDS 64			// shard sweep 보드 수 (127.0.1.1~64), shard thread가 CPU를 다 쓰도록 넉넉히
+#define BENCH_SWEEP_FIRST 257
+#define BENCH_SHARD_MS 500
+#define BENCH_FAULT_REQUESTS 2000
+#define BENCH_FAULT_TIMEOUT_MS 20
+#define BENCH_ESTOP_BOARD 200			// 비상정지 측정용 보드 번호 (다른 측정과 겹치지 않게)
+#define BENCH_ESTOP_TRIGGERS 20
+#define BENCH_COALESCE_UPDATES 1000
+#define BENCH_AXIS_BOARDS 4096
+#define BENCH_AXIS_CYCLES 1000
+#define BENCH_CODEC_FRAMES 2000000
+#define BENCH_LIST_BOARD 220			// 명령 목록 측정용 보드 번호
+#define BENCH_LIST_WINDOW 8
+#define BENCH_LIST_LATENCY_US 500		// 명령 목록 측정의 회선 지연 (한 방향)
+#define BENCH_TS_EXCHANGES 2000
+#define BENCH_BROKER_BOARD 222			// broker 측정용 보드 번호
+#define BENCH_BROKER_EXCHANGES 2000
+#define BENCH_BROKER_CLIENTS 3
+#define BENCH_BROKER_MS 300
+#define BENCH_PT_AXES 20
+#define BENCH_PT_BOARD 230				// position table 측정용 보드 번호 (230 ~ 249)
+#define BENCH_PT_WINDOW 8
+#define BENCH_BROKER_HEAVY_DEPTH 32		// 몰아 넣는 client가 보내 두는 요청 수 (나머지는 2)
+#define BENCH_COALESCE_PERIOD_US 20		// 드라이브 응답보다 훨씬 빠르게 속도를 바꾸는 producer
+#define BENCH_PRIO_BOARDS 8				// 우선순위 측정용 가짜 드라이브 (127.0.0.120~127, 마지막 한 대는 느림)
+#define BENCH_PRIO_MOTIONS 200
+#define BENCH_PRIO_PERIOD_US 2000
+#define BENCH_SCRIPT_BOARDS 16			// sequence 측정용 가짜 드라이브 (127.0.0.130~145)
+#define BENCH_SCRIPT_SEQUENCES 2000
+#define BENCH_POLL_BOARDS 16			// 적응형 polling 측정용 가짜 드라이브 (127.0.0.150~165)
+#define BENCH_POLL_BOARD 251			// 가짜 드라이브를 움직이는 context 보드 번호 (251 ~ 254)
+#define BENCH_POLL_MS 1000
+#define BENCH_PCAP_DRIVES 8				// capture 분석 측정용 드라이브 주소 (10.0.0.1~8, host 10.0.0.100)
+#define BENCH_PCAP_EXCHANGES 400000
+#define BENCH_PCAP_TCP_FRAMES 40
+#define BENCH_STREAM_BOARD 224			// override 스트리밍 측정용 보드 번호, 가짜 드라이브 127.0.0.172
+#define BENCH_STREAM_MS 1000
+#define BENCH_STREAM_POST_US 300		// producer가 FAS_StreamPost를 부르는 간격 (주기보다 짧아서 덮이는 값이 생김)
+#define BENCH_STREAM_SETPOINTS 500
+#define BENCH_PARAM_BOARD 226			// 파라미터 round trip 측정용 보드 번호 (226, 227), 가짜 드라이브 127.0.0.170~171
+
+/************************************************************************************************************************************
+ ************************************** 할당 횟수 hook (glibc malloc을 가로채서 thread별로 셈) **************************************
+ ************************************************************************************************************************************/
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *p, size_t size);
+
+static __thread uint64_t bench_allocs;
+
+void *malloc(size_t size){
+    bench_allocs++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size){
+    bench_allocs++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *p, size_t size){
+    bench_allocs++;
+    return __libc_realloc(p, size);
+}
+
+/************************************************************************************************************************************
+ ************************************************** 공통 (가짜 드라이브, shard, 결과 줄) ***********************************************
+ ************************************************************************************************************************************/
+
+ /**@brief 가짜 드라이브 count대를 127.0.0.first부터 띄움, 하나라도 실패하면 띄운 것을 모두 내림
+  * @param int first 주소 끝 두 자리 (256 이상이면 127.0.1.x, ...)
+  * @param char (*ip)[16] NULL이 아니면 드라이브마다 주소를 적음
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+static bool bench_standins_start(FAS_STANDIN *drives, int count, int first, uint32_t delay_us, char (*ip)[16]){
+    for (int i = 0; i < count; i++) {
+        char addr[16];
+        snprintf(addr, sizeof(addr), "127.0.%d.%d", (first + i) >> 8, (first + i) & 255);
+        if (ip != NULL)
+            memcpy(ip[i], addr, sizeof(addr));
+        if (!FAS_StandInStart(&drives[i], addr, delay_us)) {
+            while (i-- > 0)
+                FAS_StandInStop(&drives[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void bench_standins_stop(FAS_STANDIN *drives, int count){
+    for (int i = 0; i < count; i++)
+        FAS_StandInStop(&drives[i]);
+}
+
+ /**@brief shard 묶음을 만들어 보드 i = ip[i]를 붙이고 시작
+  * @return boolean 성공시 TRUE 실패시 FALSE (set은 쓰지 않은 상태)*/
+static bool bench_shards_open(FAS_SHARDS *set, int shards, const FAS_SHARD_OPTION *option, char (*ip)[16], int boards){
+    if (!FAS_ShardsInit(set, shards, option))
+        return false;
+    for (int b = 0; b < boards; b++) {
+        if (!FAS_ShardsAddBoard(set, b, ip[b])) {
+            FAS_ShardsFree(set);
+            return false;
+        }
+    }
+    if (!FAS_ShardsStart(set)) {
+        FAS_ShardsFree(set);
+        return false;
+    }
+    return true;
+}
+
+static void bench_shards_close(FAS_SHARDS *set){
+    FAS_ShardsStop(set);
+    FAS_ShardsFree(set);
+}
+
+ /**@brief 측정 결과 한 줄 출력, 확인이 틀렸으면 줄 끝에 FAIL (줄바꿈은 여기서)
+  * @return ok 그대로*/
+static bool bench_report(bool ok, const char *fmt, ...){
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf(ok ? "\n" : "  <- FAIL\n");
+    return ok;
+}
+
+typedef struct _BENCH_WORKER
+{
+	FAS_CONTEXT ctx;
+	int requests;
+	int failed;
+	uint64_t steady_allocs;		// 할당 확인 단계에서 데워진 뒤 생긴 heap 할당 수
+	pthread_barrier_t *start;
+	pthread_t thread;
+} BENCH_WORKER;
+
+static void *bench_worker_main(void *arg){
+    BENCH_WORKER *w = arg;
+    BYTE resp[DATA_SIZE];
+    int resp_len;
+
+    pthread_barrier_wait(w->start);
+    for (int i = 0; i < w->requests; i++) {
+        if (FAS_ContextCommand(&w->ctx, FRAME_GETALLSTATUS, NULL, 0, resp, sizeof(resp), &resp_len) != FMM_OK)
+            w->failed++;
+    }
+    return NULL;
+}
+
+// 한 번의 주고받기: 명령, 응답 문자열 변환, 문자열 -> byte, 파라미터 일괄 읽기
+static void bench_exchange(BENCH_WORKER *w, FAS_PARAM_CACHE *cache, const FAS_BATCH_OPTION *opt){
+    char text[BUFFER_SIZE * 3];
+    BYTE parsed[BUFFER_SIZE];
+    if (FAS_ContextCommand(&w->ctx, FRAME_GETALLSTATUS, NULL, 0, NULL, 0, NULL) != FMM_OK)
+        w->failed++;
+    FAS_FormatFrame(text, sizeof(text), w->ctx.rx, w->ctx.rx_len);
+    if (FAS_ParseBytes(text, 16, parsed, sizeof(parsed)) != w->ctx.rx_len)
+        w->failed++;
+    if (FAS_ParamReadAll(&w->ctx.link, cache, 1, opt) != 0)
+        w->failed++;
+}
+
+static void *bench_alloc_main(void *arg){
+    BENCH_WORKER *w = arg;
+    FAS_ARENA scratch;
+    FAS_PARAM_CACHE cache;
+    FAS_ArenaInit(&scratch, NULL, 0);
+    FAS_ParamCacheInit(&cache, w->ctx.link.iBdID, 0);
+    FAS_BATCH_OPTION opt = { .scratch = &scratch };
+
+    for (int i = 0; i < BENCH_WARMUP; i++)
+        bench_exchange(w, &cache, &opt);
+    uint64_t before = bench_allocs;
+    for (int i = 0; i < w->requests; i++)
+        bench_exchange(w, &cache, &opt);
+    w->steady_allocs = bench_allocs - before;
+
+    FAS_ArenaFree(&scratch);
+    return NULL;
+}
+
+// Frame 입력칸: 253 byte 16진수 붙여넣기 한 번, 가운데에서 한 글자 넣고 지우기 반복
+static bool bench_frame_edit(int edits){
+    static FAS_FRAME_EDIT edit;
+    char text[DATA_SIZE * 3 + 2];
+    int n = 0;
+    text[n++] = '[';
+    for (int i = 0; i < DATA_SIZE; i++)
+        n += snprintf(text + n, sizeof(text) - n, i + 1 < DATA_SIZE ? "%02X " : "%02X]", i);
+
+    FAS_FrameEditInit(&edit);
+    uint64_t t0 = FAS_MonotonicUs();
+    FAS_FrameEditReplace(&edit, 0, 0, text, n);
+    uint64_t paste_us = FAS_MonotonicUs() - t0;
+
+    int pos = n / 2;
+    t0 = FAS_MonotonicUs();
+    for (int i = 0; i < edits; i++) {
+        FAS_FrameEditReplace(&edit, pos, 0, "7", 1);
+        FAS_FrameEditReplace(&edit, pos, 1, "", 0);
+    }
+    uint64_t edit_us = FAS_MonotonicUs() - t0;
+    bool complete = FAS_FrameEditComplete(&edit);
+    return bench_report(complete && edit.tokens == DATA_SIZE, "frame edit: paste %d bytes %" PRIu64 " us, %.2f us/edit, complete %s",
+                        edit.tokens, paste_us, edits ? edit_us / (2.0 * edits) : 0.0, complete ? "yes" : "no");
+}
+
+// scope: 10분(100Hz) history를 채우고 800열로 줄이기, 구간을 1초 ~ 10분으로 바꿔 가며
+static bool bench_scope(void){
+    static FAS_SCOPE scope;
+    static int32_t col_min[800], col_max[800];
+    if (!FAS_ScopeInit(&scope, 0, 100 * 60 * 10))
+        return bench_report(false, "scope: init failed");
+    for (uint32_t i = 0; i < scope.history; i++) {
+        FAS_SCOPE_SAMPLE sample = { .t_us = i, .value = { (int32_t)i, (int32_t)(i % 1000), (int32_t)(i % 7) } };
+        FAS_ScopePush(&scope, &sample);
+        if ((i & (FAS_SCOPE_RING - 1)) == FAS_SCOPE_RING - 1)
+            FAS_ScopeDrain(&scope);
+    }
+    FAS_ScopeDrain(&scope);
+
+    // 마지막 열의 최대값은 위치(= 번호)의 마지막 값이어야 함
+    bool ok = true;
+    printf("scope query (800 columns):");
+    for (uint64_t span = 100; span <= scope.history; span *= 8) {
+        uint64_t t0 = FAS_MonotonicUs();
+        for (int i = 0; i < 100; i++)
+            FAS_ScopeQuery(&scope, FAS_SCOPE_POSITION, scope.count, span, 800, col_min, col_max);
+        printf("%s %" PRIu64 " samples %.1f us", span == 100 ? "" : ",", span, (FAS_MonotonicUs() - t0) / 100.0);
+        ok &= col_max[799] == (int32_t)(scope.history - 1);
+    }
+    FAS_ScopeFree(&scope);
+    return bench_report(ok, "");
+}
+
+// telemetry 한 행: 축마다 가속/등속/감속을 반복하는 위치, 가끔 바뀌는 상태 bit, 시각은 1ms +-20us
+static void bench_telemetry_row(int axis, uint64_t i, uint64_t *t_us, FAS_ALL_STATUS *st){
+    int64_t phase = (int64_t)(i % 4000);
+    int32_t vel = phase < 1000 ? (int32_t)phase * 20 : phase < 2000 ? 20000 : phase < 3000 ? (int32_t)(3000 - phase) * 20 : 0;
+    *t_us = 1000000 + i * 1000 + (uint64_t)((i * 7919 + axis * 31) % 41) - 20;
+    memset(st, 0, sizeof(*st));
+    st->actual_vel = vel;
+    st->command_pos = (int32_t)(i / 4000) * 40000000 + (int32_t)(phase < 1000 ? phase * phase * 10 : phase * 20000);
+    st->actual_pos = st->command_pos - vel / 100;
+    st->pos_error = st->command_pos - st->actual_pos;
+    st->axis_status = (1u << 20) | (vel ? 1u << 27 : 1u << 19);
+    st->input = (i / 10000) & 1;
+}
+
+static bool bench_telemetry(void){
+    static FAS_TELEMETRY tm;
+    static FAS_TELEMETRY_READER reader;
+    const char *path = "/tmp/fas_bench_telemetry.fct";
+    const int axes = 8, seconds = 60;
+    uint64_t rows = (uint64_t)axes * seconds * 1000, t_us;
+    FAS_ALL_STATUS st;
+
+    if (!FAS_TelemetryOpen(&tm, path))
+        return bench_report(false, "telemetry: %s open failed", path);
+    uint64_t t0 = FAS_MonotonicUs(), append_us = 0;
+    for (uint64_t i = 0; i < rows / axes; i++) {
+        uint64_t a0 = FAS_MonotonicUs();
+        for (int axis = 0; axis < axes; axis++) {
+            bench_telemetry_row(axis, i, &t_us, &st);
+            while (!FAS_TelemetryAppend(&tm, axis, t_us, &st))
+                atomic_fetch_sub(&tm.dropped, 1);	// 벤치에서는 버리지 않고 writer를 기다림
+        }
+        append_us += FAS_MonotonicUs() - a0;
+    }
+    FAS_TelemetryClose(&tm);
+    uint64_t total_us = FAS_MonotonicUs() - t0;
+
+    // 되읽어서 값 확인 (block은 보드별 시간 순)
+    uint64_t next[8] = { 0 }, bad = 0, read = 0;
+    FAS_TELEMETRY_SAMPLE s;
+    if (FAS_TelemetryReaderOpen(&reader, path)) {
+        while (FAS_TelemetryRead(&reader, &s)) {
+            bench_telemetry_row(s.iBdID, next[s.iBdID]++, &t_us, &st);
+            if (s.t_us != t_us || memcmp(&s.status, &st, sizeof(st)) != 0)
+                bad++;
+            read++;
+        }
+        FAS_TelemetryReaderClose(&reader);
+    }
+    unlink(path);
+
+    uint64_t hex_bytes = rows * ((FRAME_HEADER_SIZE + 1 + FAS_ALL_STATUS_SIZE) * 3);	// "AA 23 .. \n"
+    uint64_t bytes = atomic_load(&tm.bytes);
+
+    // header를 쓰지 못하는 파일(/dev/full)은 Open이 실패해야 함
+    static FAS_TELEMETRY full;
+    bool full_rejected = access("/dev/full", W_OK) != 0 || !FAS_TelemetryOpen(&full, "/dev/full");
+    return bench_report(read == rows && bad == 0 && full_rejected,
+                        "telemetry: %" PRIu64 " rows, %" PRIu64 " bytes (%.2f B/row), hex text %" PRIu64 " bytes, %.1fx smaller, "
+                        "append %.0f ns/row, total %.0f ns/row, read back %" PRIu64 " bad %" PRIu64 ", full disk %s",
+                        rows, bytes, (double)bytes / rows, hex_bytes, (double)hex_bytes / bytes,
+                        append_us * 1000.0 / rows, total_us * 1000.0 / rows, read, bad, full_rejected ? "rejected" : "accepted");
+}
+
+/************************************************************************************************************************************
+ ************************************************** capture 분석 ******************************************************************
+ ************************************************************************************************************************************/
+
+static void bench_be16(BYTE *p, uint16_t v){
+    p[0] = (BYTE)(v >> 8);
+    p[1] = (BYTE)v;
+}
+
+static void bench_be32(BYTE *p, uint32_t v){
+    bench_be16(p, (uint16_t)(v >> 16));
+    bench_be16(p + 2, (uint16_t)v);
+}
+
+// Ethernet + IPv4 + UDP/TCP 패킷 하나를 buf에 만듦, 길이를 돌려줌
+static int bench_pcap_packet(BYTE *buf, uint32_t src, uint32_t dst, uint16_t sport, uint16_t dport, bool tcp,
+                             uint32_t seq, BYTE flags, const BYTE *payload, int len){
+    int l4 = tcp ? 20 : 8, ip_len = 20 + l4 + len;
+    memset(buf, 0, 14 + 20 + l4);
+    buf[12] = 0x08;
+    BYTE *ip = buf + 14, *p = ip + 20;
+    ip[0] = 0x45;
+    bench_be16(ip + 2, (uint16_t)ip_len);
+    ip[8] = 64;
+    ip[9] = tcp ? 6 : 17;
+    bench_be32(ip + 12, src);
+    bench_be32(ip + 16, dst);
+    bench_be16(p, sport);
+    bench_be16(p + 2, dport);
+    if (tcp) {
+        bench_be32(p + 4, seq);
+        p[12] = 5 << 4;
+        p[13] = flags | 0x10;
+    }
+    else
+        bench_be16(p + 4, (uint16_t)(8 + len));
+    memcpy(p + l4, payload, len);
+    return 14 + ip_len;
+}
+
+static void bench_pcap_record(FILE *fp, uint64_t t_us, const BYTE *pkt, int len){
+    uint32_t hdr[4] = { (uint32_t)(t_us / 1000000u), (uint32_t)(t_us % 1000000u), (uint32_t)len, (uint32_t)len };
+    fwrite(hdr, sizeof(hdr), 1, fp);
+    fwrite(pkt, len, 1, fp);
+}
+
+// pcapng 블록 하나 (body는 4 byte 단위로 맞춤)
+static void bench_pcapng_block(FILE *fp, uint32_t type, const void *body, uint32_t len){
+    static const BYTE pad[4] = { 0 };
+    uint32_t padded = (len + 3u) & ~3u, total = 12 + padded;
+    fwrite(&type, 4, 1, fp);
+    fwrite(&total, 4, 1, fp);
+    fwrite(body, len, 1, fp);
+    fwrite(pad, padded - len, 1, fp);
+    fwrite(&total, 4, 1, fp);
+}
+
+static void bench_pcapng_packet(FILE *fp, uint64_t t_ns, const BYTE *pkt, int len){
+    BYTE body[20 + 64 + BUFFER_SIZE];
+    uint32_t v[5] = { 0, (uint32_t)(t_ns >> 32), (uint32_t)t_ns, (uint32_t)len, (uint32_t)len };
+    memcpy(body, v, sizeof(v));
+    memcpy(body + 20, pkt, len);
+    bench_pcapng_block(fp, 6, body, 20 + len);
+}
+
+static int bench_pcap_frame(BYTE *frame, BYTE sync, BYTE type, int status, uint32_t value){
+    int n = 0;
+    frame[n++] = FRAME_HEADER;
+    frame[n++] = 0;
+    frame[n++] = sync;
+    frame[n++] = 0;
+    frame[n++] = type;
+    if (status >= 0)
+        frame[n++] = (BYTE)status;
+    fas_put_le32(frame + n, value);
+    n += 4;
+    frame[1] = (BYTE)(n - 2);
+    return n;
+}
+
+static bool bench_pcap(void){
+    static FAS_PCAP_STATS stats;
+    const char *path = "/tmp/fas_bench_capture.pcap", *path_ng = "/tmp/fas_bench_capture.pcapng";
+    static char out_buffer[1 << 20];
+    const uint32_t host = 0x0A000064;
+    BYTE frame[BUFFER_SIZE], pkt[64 + BUFFER_SIZE];
+    BYTE sync[BENCH_PCAP_DRIVES] = { 0 };
+    uint64_t alarms = 0, retransmits = 0, unanswered = 0;
+
+    // UDP: 드라이브를 돌아가며 요청, 응답은 300~420 us 뒤
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+        return bench_report(false, "pcap: %s open failed", path);
+    setvbuf(fp, out_buffer, _IOFBF, sizeof(out_buffer));
+    uint32_t file_hdr[6] = { 0xA1B2C3D4u, 0x00040002u, 0, 0, 65535, 1 };
+    fwrite(file_hdr, sizeof(file_hdr), 1, fp);
+    uint64_t t_us = 1700000000ull * 1000000u;
+    for (int i = 0; i < BENCH_PCAP_EXCHANGES; i++) {
+        int d = i % BENCH_PCAP_DRIVES;
+        uint32_t drive = 0x0A000001 + d;
+        uint16_t port = (uint16_t)(50000 + d);
+        BYTE s = sync[d]++, type = i % 7000 == 6999 ? FRAME_GETACTUALPOS : FRAME_GETAXISSTATUS;
+        int n = bench_pcap_frame(frame, s, type, -1, 0);
+        n -= 4;
+        frame[1] = (BYTE)(n - 2);
+        int len = bench_pcap_packet(pkt, host, drive, port, PORT_UDP, false, 0, 0, frame, n);
+        bench_pcap_record(fp, t_us, pkt, len);
+        if (i % 5000 == 4999) {
+            // 응답이 없어 같은 Sync No.로 다시 보냄
+            bench_pcap_record(fp, t_us + 20000, pkt, len);
+            retransmits++;
+        }
+        else if (i % 7000 == 6999) {
+            unanswered++;
+            t_us += 50;
+            continue;
+        }
+        int status = i % 1000 == 999 ? FMP_RUNFAIL : FMM_OK;
+        alarms += status != FMM_OK;
+        n = bench_pcap_frame(frame, s, type, status, FAS_AXIS_SERVOON);
+        len = bench_pcap_packet(pkt, drive, host, PORT_UDP, port, false, 0, 0, frame, n);
+        bench_pcap_record(fp, t_us + 300 + (i % 7) * 20 + (i % 5000 == 4999 ? 20000 : 0), pkt, len);
+        t_us += 50;
+    }
+    fclose(fp);
+
+    FAS_PcapInit(&stats, 0, 0);
+    bool ok = FAS_PcapAnalyze(&stats, path);
+    unlink(path);
+    uint64_t requests = 0, matched = 0, got_alarms = 0, got_retransmits = 0, got_unanswered = 0, hist[FAS_RTT_BUCKETS] = { 0 };
+    for (int i = 0; i < stats.drive_count; i++) {
+        const FAS_PCAP_DRIVE *d = &stats.drive[i];
+        requests += d->requests;
+        matched += d->matched;
+        got_alarms += d->error_hist[FMP_RUNFAIL];
+        got_retransmits += d->retransmits;
+        got_unanswered += d->unanswered;
+        for (int b = 0; b < FAS_RTT_BUCKETS; b++)
+            hist[b] += d->rtt_hist[b];
+    }
+    bool udp_ok = bench_report(ok && requests == BENCH_PCAP_EXCHANGES + retransmits && matched == BENCH_PCAP_EXCHANGES - unanswered
+                               && got_alarms == alarms && got_retransmits == retransmits && got_unanswered == unanswered,
+                               "pcap: %d drives, %" PRIu64 " packets, %.1f MB in %.1f ms (%.0f MB/s, %.0f ns/packet), matched %" PRIu64
+                               " rtt p50 %" PRIu64 " us, alarms %" PRIu64 "/%" PRIu64 ", retransmits %" PRIu64 "/%" PRIu64
+                               ", unanswered %" PRIu64 "/%" PRIu64, stats.drive_count, stats.packets, stats.file_bytes / 1e6,
+                               stats.elapsed_us / 1000.0, stats.elapsed_us ? stats.file_bytes / (double)stats.elapsed_us : 0.0,
+                               stats.packets ? stats.elapsed_us * 1000.0 / stats.packets : 0.0, matched,
+                               FAS_MetricsHistPercentile(hist, 50), got_alarms, alarms, got_retransmits, retransmits,
+                               got_unanswered, unanswered);
+
+    // TCP: 요청을 이어 붙여 7 byte씩 잘라 보내고 한 segment는 다시 보냄, pcapng (ns 단위)
+    fp = fopen(path_ng, "wb");
+    if (fp == NULL)
+        return bench_report(false, "pcapng: %s open failed", path_ng);
+    uint32_t shb[4] = { 0x1A2B3C4Du, 0x00000001u, 0xFFFFFFFFu, 0xFFFFFFFFu };
+    bench_pcapng_block(fp, 0x0A0D0D0Au, shb, sizeof(shb));
+    BYTE idb[16] = { 1, 0, 0, 0, 0xFF, 0xFF, 0, 0, 9, 0, 1, 0, 9, 0, 0, 0 };	// Ethernet, if_tsresol 10^-9
+    bench_pcapng_block(fp, 1, idb, sizeof(idb));
+
+    const uint32_t drive = 0x0A000032;
+    BYTE stream[BENCH_PCAP_TCP_FRAMES * 8];
+    int stream_len = 0;
+    for (int i = 0; i < BENCH_PCAP_TCP_FRAMES; i++) {
+        int n = bench_pcap_frame(stream + stream_len, (BYTE)i, FRAME_GETAXISSTATUS, -1, 0) - 4;
+        stream[stream_len + 1] = (BYTE)(n - 2);
+        stream_len += n;
+    }
+    uint64_t t_ns = 1700000000ull * 1000000000u;
+    int len = bench_pcap_packet(pkt, host, drive, 40000, PORT_TCP, true, 1000, 0x02, NULL, 0);
+    bench_pcapng_packet(fp, t_ns, pkt, len);
+    len = bench_pcap_packet(pkt, drive, host, PORT_TCP, 40000, true, 9000, 0x02, NULL, 0);
+    bench_pcapng_packet(fp, t_ns += 1000, pkt, len);
+    uint32_t resp_seq = 9001;
+    int answered = 0;
+    for (int off = 0, seg = 0; off < stream_len; off += 7, seg++) {
+        int n = stream_len - off < 7 ? stream_len - off : 7;
+        len = bench_pcap_packet(pkt, host, drive, 40000, PORT_TCP, true, 1001 + off, 0, stream + off, n);
+        bench_pcapng_packet(fp, t_ns += 10000, pkt, len);
+        if (seg == 3)
+            bench_pcapng_packet(fp, t_ns += 10000, pkt, len);
+        // 끝까지 받은 요청에 응답 (두 응답을 한 segment에)
+        int complete = (off + n) / 5;
+        while (answered + 2 <= complete || (answered < complete && off + n == stream_len)) {
+            int count = complete - answered >= 2 ? 2 : 1, resp_len = 0;
+            for (int k = 0; k < count; k++)
+                resp_len += bench_pcap_frame(frame + resp_len, (BYTE)(answered + k), FRAME_GETAXISSTATUS, FMM_OK, 0);
+            len = bench_pcap_packet(pkt, drive, host, PORT_TCP, 40000, true, resp_seq, 0, frame, resp_len);
+            bench_pcapng_packet(fp, t_ns += 150000, pkt, len);
+            resp_seq += resp_len;
+            answered += count;
+        }
+    }
+    fclose(fp);
+
+    FAS_PcapInit(&stats, 0, 0);
+    ok = FAS_PcapAnalyze(&stats, path_ng);
+    unlink(path_ng);
+    const FAS_PCAP_DRIVE *d = &stats.drive[0];
+    ok = ok && stats.drive_count == 1 && d->tcp && d->requests == BENCH_PCAP_TCP_FRAMES && d->matched == BENCH_PCAP_TCP_FRAMES
+        && d->tcp_retransmits == 1 && d->bad_frames == 0 && d->unanswered == 0 && d->retransmits == 0;
+    ok = bench_report(ok, "pcapng tcp: %" PRIu64 " packets, requests %" PRIu64 " matched %" PRIu64 " tcp retransmits %" PRIu64
+                      " bad %" PRIu64 " rtt max %" PRIu64 " us", stats.packets, d->requests, d->matched, d->tcp_retransmits,
+                      d->bad_frames, d->rtt_max_us);
+
+    // TCP 연결 둘이 같은 드라이브에 같은 Sync No.로 요청, 요청은 프레임 중간에서 잘려 섞이고 응답은 거꾸로 옴
+    // 드라이브로만 묶으면 stream이 gap으로 끊기고 Sync No.가 덮여 짝이 틀림
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+        return bench_report(false, "pcap: %s open failed", path);
+    fwrite(file_hdr, sizeof(file_hdr), 1, fp);
+    uint32_t req_seq[2] = { 2001, 7001 }, rsp_seq[2] = { 5001, 8001 };
+    t_us = 1700000000ull * 1000000u;
+    for (int k = 0; k < 2; k++) {
+        len = bench_pcap_packet(pkt, host, drive, (uint16_t)(40001 + k), PORT_TCP, true, req_seq[k] - 1, 0x02, NULL, 0);
+        bench_pcap_record(fp, t_us += 10, pkt, len);
+        len = bench_pcap_packet(pkt, drive, host, PORT_TCP, (uint16_t)(40001 + k), true, rsp_seq[k] - 1, 0x02, NULL, 0);
+        bench_pcap_record(fp, t_us += 10, pkt, len);
+    }
+    for (int i = 0; i < BENCH_PCAP_TCP_FRAMES; i++) {
+        int n = bench_pcap_frame(frame, (BYTE)i, FRAME_GETAXISSTATUS, -1, 0) - 4;
+        frame[1] = (BYTE)(n - 2);
+        for (int half = 0; half < 2; half++) {
+            for (int k = 0; k < 2; k++) {
+                int from = half == 0 ? 0 : 3, part = half == 0 ? 3 : n - 3;
+                len = bench_pcap_packet(pkt, host, drive, (uint16_t)(40001 + k), PORT_TCP, true, req_seq[k], 0, frame + from, part);
+                bench_pcap_record(fp, t_us += 20, pkt, len);
+                req_seq[k] += part;
+            }
+        }
+        for (int k = 1; k >= 0; k--) {
+            BYTE resp[16];
+            int resp_len = bench_pcap_frame(resp, (BYTE)i, FRAME_GETAXISSTATUS, FMM_OK, (uint32_t)k);
+            len = bench_pcap_packet(pkt, drive, host, PORT_TCP, (uint16_t)(40001 + k), true, rsp_seq[k], 0, resp, resp_len);
+            bench_pcap_record(fp, t_us += 200, pkt, len);
+            rsp_seq[k] += resp_len;
+        }
+    }
+    fclose(fp);
+
+    FAS_PcapInit(&stats, 0, 0);
+    bool two = FAS_PcapAnalyze(&stats, path);
+    unlink(path);
+    d = &stats.drive[0];
+    two = two && stats.drive_count == 1 && stats.conn_count == 2 && d->connections == 2
+        && d->requests == 2 * BENCH_PCAP_TCP_FRAMES && d->matched == 2 * BENCH_PCAP_TCP_FRAMES && d->unmatched == 0
+        && d->unanswered == 0 && d->bad_frames == 0 && d->tcp_gaps == 0 && d->tcp_retransmits == 0;
+    two = bench_report(two, "pcap tcp 2 connections to 1 drive: requests %" PRIu64 " matched %" PRIu64 " unmatched %" PRIu64
+                       " unanswered %" PRIu64 " gaps %" PRIu64 " bad %" PRIu64, d->requests, d->matched, d->unmatched,
+                       d->unanswered, d->tcp_gaps, d->bad_frames);
+    return udp_ok && ok && two;
+}
+
+/**@brief shard closed loop 상태, 응답이 오면 같은 요청을 바로 다시 넣음*/
+typedef struct _BENCH_SHARD_LOOP
+{
+	FAS_SHARDS *set;
+	_Atomic bool running;
+	_Atomic uint64_t done;
+	_Atomic uint64_t failed;
+} BENCH_SHARD_LOOP;
+
+static void bench_shard_done(FAS_SHARD_REQUEST *r, void *user){
+    BENCH_SHARD_LOOP *loop = user;
+    if (!atomic_load_explicit(&loop->running, memory_order_relaxed))
+        return;
+    if (r->req.status == FMM_OK)
+        atomic_fetch_add_explicit(&loop->done, 1, memory_order_relaxed);
+    else
+        atomic_fetch_add_explicit(&loop->failed, 1, memory_order_relaxed);
+    FAS_RequestInit(&r->req, r->req.link, FRAME_GETALLSTATUS, NULL, 0);
+    FAS_ShardsSubmit(loop->set, r);
+}
+
+// 가짜 드라이브 16대, 보드마다 window만큼 요청을 항상 채워 둔 채로 shard 수를 늘림
+static bool bench_shards(int max_shards, uint32_t delay_us){
+    static FAS_STANDIN drives[BENCH_SWEEP_BOARDS];
+    static FAS_SHARD_REQUEST reqs[BENCH_SWEEP_BOARDS * FAS_DEFAULT_WINDOW * 2];
+    char ip[BENCH_SWEEP_BOARDS][16];
+    bool ok = true;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (!bench_standins_start(drives, BENCH_SWEEP_BOARDS, BENCH_SWEEP_FIRST, delay_us, ip))
+        return bench_report(false, "shards: stand-in start failed");
+
+    // 가짜 드라이브도 같은 CPU를 쓰므로 shard 수의 2배 이상 CPU가 있을 때만 speedup을 확인함
+    printf("%8s %8s %14s %10s %12s %12s %8s  (%d boards, window %d, %ld CPUs)\n", "backend", "shards", "requests/s",
+           "speedup", "syscall/req", "cpu us/req", "failed", BENCH_SWEEP_BOARDS, FAS_DEFAULT_WINDOW, cpus);
+    static const FAS_IO_BACKEND backends[] = { FAS_IO_EPOLL, FAS_IO_URING };
+    for (int k = 0; k < 2; k++) {
+        double base = 0;
+        for (int shards = 1; shards <= max_shards; shards *= 2) {
+            FAS_SHARDS set;
+            BENCH_SHARD_LOOP loop = { .set = &set };
+            FAS_SHARD_OPTION option = { .window = FAS_DEFAULT_WINDOW, .pin_cpu = true, .backend = backends[k] };
+            if (!bench_shards_open(&set, shards, &option, ip, BENCH_SWEEP_BOARDS)) {
+                ok = false;
+                break;
+            }
+            atomic_store(&loop.running, true);
+
+            // window를 넘는 요청은 보드 pending 목록에서 기다림 (queue가 늘 비지 않도록 window의 2배)
+            int count = BENCH_SWEEP_BOARDS * FAS_DEFAULT_WINDOW * 2;
+            for (int i = 0; i < count; i++) {
+                reqs[i].done = bench_shard_done;
+                reqs[i].user = &loop;
+                FAS_RequestInit(&reqs[i].req, i % BENCH_SWEEP_BOARDS, FRAME_GETALLSTATUS, NULL, 0);
+                FAS_ShardsSubmit(&set, &reqs[i]);
+            }
+            usleep(BENCH_SHARD_MS * 200);	// 데우기
+            FAS_SHARD_STATS st;
+            uint64_t syscalls0 = 0;
+            for (int i = 0; i < shards; i++) {
+                FAS_ShardsGetStats(&set, i, &st);
+                syscalls0 += st.syscalls;
+            }
+            uint64_t done0 = atomic_load(&loop.done), t0 = FAS_MonotonicUs();
+            usleep(BENCH_SHARD_MS * 1000);
+            uint64_t done = atomic_load(&loop.done) - done0, elapsed = FAS_MonotonicUs() - t0;
+            uint64_t syscalls = 0, cpu_us = 0, total = atomic_load(&loop.done);
+            int used = FAS_IO_EPOLL;
+            for (int i = 0; i < shards; i++) {
+                FAS_ShardsGetStats(&set, i, &st);
+                syscalls += st.syscalls;
+            }
+            atomic_store(&loop.running, false);
+            FAS_ShardsStop(&set);
+            for (int i = 0; i < shards; i++) {
+                FAS_ShardsGetStats(&set, i, &st);
+                cpu_us += st.cpu_us;
+                used = (int)st.backend;
+            }
+
+            double rate = done / (elapsed / 1e6);
+            if (shards == 1)
+                base = rate;
+            bool scaled = cpus < shards * 2 || rate / base >= shards * 0.5;
+            ok &= bench_report(done > 0 && atomic_load(&loop.failed) == 0 && scaled, "%8s %8d %14.0f %9.2fx %12.2f %12.2f %8" PRIu64,
+                               used == FAS_IO_URING ? "io_uring" : "epoll", shards, rate, rate / base,
+                               done ? (double)(syscalls - syscalls0) / done : 0.0, total ? (double)cpu_us / total : 0.0,
+                               atomic_load(&loop.failed));
+            if (k == 1 && shards * 2 > max_shards) {
+                for (int i = 0; i < shards; i++) {
+                    FAS_ShardsGetStats(&set, i, &st);
+                    printf("  shard %d: boards %" PRIu64 " sent %" PRIu64 " recv %" PRIu64 " done %" PRIu64
+                           " retries %" PRIu64 " stale %" PRIu64 " wakeups %" PRIu64 " loops %" PRIu64 "\n",
+                           i, st.boards, st.sent, st.received, st.completed, st.retries, st.stale, st.wakeups, st.loops);
+                }
+            }
+            FAS_ShardsFree(&set);
+        }
+    }
+    bench_standins_stop(drives, BENCH_SWEEP_BOARDS);
+    return ok;
+}
+
+/**@brief 고장 주입 측정 요청, 넣은 시각을 같이 들고 다님*/
+typedef struct _BENCH_FAULT_REQ
+{
+	FAS_SHARD_REQUEST r;
+	uint64_t t0_us;
+} BENCH_FAULT_REQ;
+
+typedef struct _BENCH_FAULT
+{
+	FAS_SHARDS *set;
+	int total;
+	_Atomic int issued;
+	_Atomic int finished;
+	_Atomic uint64_t retries;
+	_Atomic uint64_t failed;
+	uint32_t *latency_us;
+} BENCH_FAULT;
+
+static void bench_fault_done(FAS_SHARD_REQUEST *r, void *user){
+    BENCH_FAULT *b = user;
+    BENCH_FAULT_REQ *q = (BENCH_FAULT_REQ *)r;
+    uint64_t now = FAS_MonotonicUs();
+    int i = atomic_fetch_add(&b->finished, 1);
+    if (i < b->total)
+        b->latency_us[i] = (uint32_t)(now - q->t0_us);
+    atomic_fetch_add(&b->retries, r->req.retries);
+    if (r->req.status != FMM_OK)
+        atomic_fetch_add(&b->failed, 1);
+    if (atomic_fetch_add(&b->issued, 1) < b->total) {
+        q->t0_us = now;
+        FAS_RequestInit(&r->req, 0, FRAME_GETALLSTATUS, NULL, 0);
+        FAS_ShardsSubmit(b->set, r);
+    }
+}
+
+static int bench_u32_compare(const void *a, const void *b){
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// 가짜 드라이브 앞에 proxy, 양방향 손실률을 바꿔 가며 window 4 closed loop
+static bool bench_fault(uint32_t delay_us){
+    static FAS_STANDIN drive;
+    static FAS_FAULT_PROXY proxy;
+    static BENCH_FAULT_REQ reqs[FAS_DEFAULT_WINDOW];
+    static const double loss[] = { 0, 0.01, 0.02, 0.05 };
+    static uint32_t latency[BENCH_FAULT_REQUESTS];
+    bool ok = true;
+    if (!bench_standins_start(&drive, 1, 61, delay_us, NULL))
+        return bench_report(false, "fault proxy: stand-in start failed");
+
+    printf("fault proxy: %d requests, window %d, timeout %d ms, retries %d, latency 100+U(0,100) us each way\n",
+           BENCH_FAULT_REQUESTS, FAS_DEFAULT_WINDOW, BENCH_FAULT_TIMEOUT_MS, FAS_DEFAULT_RETRIES + 1);
+    printf("%6s %12s %10s %10s %10s %10s %8s %8s\n", "loss", "requests/s", "p50 us", "p99 us", "p99.9 us", "max us",
+           "retries", "failed");
+    for (int k = 0; k < (int)(sizeof(loss) / sizeof(loss[0])); k++) {
+        FAS_FAULT_PROFILE profile = { .dist = FAS_FAULT_UNIFORM, .latency_us = 100, .jitter_us = 100, .loss = loss[k] };
+        if (!FAS_FaultProxyStart(&proxy, "127.0.0.60", "127.0.0.61", &profile, &profile, 1 + k, NULL)) {
+            ok = false;
+            break;
+        }
+        FAS_SHARDS set;
+        FAS_SHARD_OPTION option = { .window = FAS_DEFAULT_WINDOW, .timeout_ms = BENCH_FAULT_TIMEOUT_MS,
+                                    .retries = FAS_DEFAULT_RETRIES + 1, .backend = FAS_IO_EPOLL };
+        BENCH_FAULT b = { .set = &set, .total = BENCH_FAULT_REQUESTS, .latency_us = latency };
+        char proxy_ip[1][16] = { "127.0.0.60" };
+        if (!bench_shards_open(&set, 1, &option, proxy_ip, 1)) {
+            FAS_FaultProxyStop(&proxy);
+            ok = false;
+            break;
+        }
+
+        uint64_t t0 = FAS_MonotonicUs();
+        atomic_store(&b.issued, FAS_DEFAULT_WINDOW);
+        for (int i = 0; i < FAS_DEFAULT_WINDOW; i++) {
+            reqs[i].r.done = bench_fault_done;
+            reqs[i].r.user = &b;
+            reqs[i].t0_us = FAS_MonotonicUs();
+            FAS_RequestInit(&reqs[i].r.req, 0, FRAME_GETALLSTATUS, NULL, 0);
+            FAS_ShardsSubmit(&set, &reqs[i].r);
+        }
+        while (atomic_load(&b.finished) < BENCH_FAULT_REQUESTS && FAS_MonotonicUs() - t0 < 30000000u)
+            usleep(1000);
+        uint64_t elapsed = FAS_MonotonicUs() - t0;
+        bench_shards_close(&set);
+        FAS_FaultProxyStop(&proxy);
+
+        // 모두 끝나야 하고, 손실이 없으면 실패도 없어야 함 (손실이 있으면 재전송을 다 잃는 경우만, 1% 미만)
+        int n = atomic_load(&b.finished) < BENCH_FAULT_REQUESTS ? atomic_load(&b.finished) : BENCH_FAULT_REQUESTS;
+        uint64_t failed = atomic_load(&b.failed);
+        if (n == 0) {
+            ok = bench_report(false, "%5.0f%% no request finished", loss[k] * 100);
+            continue;
+        }
+        qsort(latency, n, sizeof(*latency), bench_u32_compare);
+        ok &= bench_report(n == BENCH_FAULT_REQUESTS && (loss[k] == 0 ? failed == 0 : failed * 100 < (uint64_t)n),
+                           "%5.0f%% %12.0f %10u %10u %10u %10u %8" PRIu64 " %8" PRIu64, loss[k] * 100, n / (elapsed / 1e6),
+                           latency[n / 2], latency[(int)(n * 0.99)], latency[(int)(n * 0.999)], latency[n - 1],
+                           atomic_load(&b.retries), failed);
+    }
+    FAS_StandInStop(&drive);
+    return ok;
+}
+
+// 가짜 드라이브 16대를 shard로 계속 polling하는 중에 비상정지, 보드별로 FAS_EmergencyStop을 부르는 것과 비교
+static bool bench_estop(uint32_t delay_us){
+    static FAS_STANDIN drives[BENCH_SHARD_BOARDS];
+    static FAS_SHARD_REQUEST reqs[BENCH_SHARD_BOARDS * FAS_DEFAULT_WINDOW];
+    static FAS_ESTOP estop;
+    char ip[BENCH_SHARD_BOARDS][16];
+    bool ok = false;
+    if (!bench_standins_start(drives, BENCH_SHARD_BOARDS, 70, delay_us, ip))
+        return bench_report(false, "e-stop: stand-in start failed");
+    int opened = 0;
+    for (; opened < BENCH_SHARD_BOARDS; opened++) {
+        if (!FAS_ContextOpen(FAS_BoardContext(BENCH_ESTOP_BOARD + opened), ip[opened], false)) {
+            bench_report(false, "e-stop: board context open failed");
+            goto out;
+        }
+    }
+
+    // 지금까지의 방법: 보드마다 응답을 기다린 뒤 다음 보드
+    uint64_t t0 = FAS_MonotonicUs();
+    for (int b = 0; b < BENCH_SHARD_BOARDS; b++)
+        FAS_EmergencyStop(BENCH_ESTOP_BOARD + b);
+    uint64_t serial_us = FAS_MonotonicUs() - t0;
+
+    FAS_SHARDS set;
+    BENCH_SHARD_LOOP loop = { .set = &set };
+    FAS_SHARD_OPTION option = { .window = FAS_DEFAULT_WINDOW, .backend = FAS_IO_EPOLL };
+    if (!FAS_EStopInit(&estop)) {
+        bench_report(false, "e-stop: init failed");
+        goto out;
+    }
+    int boards = FAS_EStopArm(&estop);
+    if (!bench_shards_open(&set, 1, &option, ip, BENCH_SHARD_BOARDS)) {
+        bench_report(false, "e-stop: shard start failed");
+        FAS_EStopFree(&estop);
+        goto out;
+    }
+    atomic_store(&loop.running, true);
+    for (int i = 0; i < BENCH_SHARD_BOARDS * FAS_DEFAULT_WINDOW; i++) {
+        reqs[i].done = bench_shard_done;
+        reqs[i].user = &loop;
+        FAS_RequestInit(&reqs[i].req, i % BENCH_SHARD_BOARDS, FRAME_GETALLSTATUS, NULL, 0);
+        FAS_ShardsSubmit(&set, &reqs[i]);
+    }
+    usleep(50000);
+
+    uint32_t wire[BENCH_ESTOP_TRIGGERS], worst_ack = 0;
+    int acked = 0, n = 0;
+    for (; n < BENCH_ESTOP_TRIGGERS; n++) {
+        FAS_ESTOP_RESULT r;
+        if (FAS_EStopTrigger(&estop, 0, &r) < 0)
+            break;
+        wire[n] = r.wire_us;
+        acked += r.acked;
+        if (r.worst_ack_us > worst_ack)
+            worst_ack = r.worst_ack_us;
+        usleep(5000);
+    }
+    atomic_store(&loop.running, false);
+    bench_shards_close(&set);
+
+    qsort(wire, n, sizeof(wire[0]), bench_u32_compare);
+    printf("e-stop: %d boards, serial FAS_EmergencyStop %" PRIu64 " us to last ack\n", boards, serial_us);
+    ok = bench_report(n == BENCH_ESTOP_TRIGGERS && boards == BENCH_SHARD_BOARDS && acked == n * boards,
+                      "  burst under polling: wire p50 %u us, max %u us, worst ack %u us, acked %d/%d (%d triggers)",
+                      n ? wire[n / 2] : 0, estop.max_wire_us, worst_ack, acked, n * boards, n);
+    FAS_EStopFree(&estop);
+
+out:
+    for (int b = 0; b < opened; b++)
+        FAS_ContextClose(FAS_BoardContext(BENCH_ESTOP_BOARD + b));
+    bench_standins_stop(drives, BENCH_SHARD_BOARDS);
+    return ok;
+}
+
+/**@brief 속도 갱신 요청 하나, 넣은 시각과 끝난 시각*/
+typedef struct _BENCH_COALESCE_REQ
+{
+	FAS_SHARD_REQUEST r;
+	uint64_t t0_us;
+	_Atomic uint64_t done_us;
+} BENCH_COALESCE_REQ;
+
+static void bench_coalesce_done(FAS_SHARD_REQUEST *r, void *user){
+    BENCH_COALESCE_REQ *q = (BENCH_COALESCE_REQ *)r;
+    atomic_store(&q->done_us, FAS_MonotonicUs());
+}
+
+// 가짜 드라이브 하나에 MoveVelocity를 20 us마다 넣을 때, 합치기 전후의 송신 수와 마지막 값이 닿기까지의 시간
+static bool bench_coalesce(uint32_t delay_us){
+    static FAS_STANDIN drive;
+    static BENCH_COALESCE_REQ reqs[BENCH_COALESCE_UPDATES];
+    char ip[1][16];
+    bool ok = true;
+    if (!bench_standins_start(&drive, 1, 90, delay_us, ip))
+        return bench_report(false, "coalescing: stand-in start failed");
+
+    printf("coalescing: %d MoveVelocity updates every %d us, window 1\n", BENCH_COALESCE_UPDATES, BENCH_COALESCE_PERIOD_US);
+    printf("%10s %10s %10s %14s %14s\n", "coalesce", "sent", "coalesced", "last value us", "drain us");
+    for (int k = 0; k < 2; k++) {
+        FAS_SHARDS set;
+        FAS_SHARD_OPTION option = { .window = 1, .timeout_ms = 1000, .backend = FAS_IO_EPOLL, .no_coalesce = (k == 0) };
+        if (!bench_shards_open(&set, 1, &option, ip, 1)) {
+            ok = false;
+            break;
+        }
+
+        uint64_t t0 = FAS_MonotonicUs();
+        for (int i = 0; i < BENCH_COALESCE_UPDATES; i++) {
+            BYTE data[5] = { 0 };
+            int32_t velocity = 1000 + i;
+            memcpy(data, &velocity, sizeof(velocity));
+            reqs[i].r.done = bench_coalesce_done;
+            reqs[i].r.user = NULL;
+            atomic_store(&reqs[i].done_us, 0);
+            reqs[i].t0_us = FAS_MonotonicUs();
+            FAS_RequestInit(&reqs[i].r.req, 0, FRAME_MOVEVELOCITY, data, sizeof(data));
+            FAS_ShardsSubmit(&set, &reqs[i].r);
+            while (FAS_MonotonicUs() - reqs[i].t0_us < BENCH_COALESCE_PERIOD_US)
+                ;
+        }
+        BENCH_COALESCE_REQ *last = &reqs[BENCH_COALESCE_UPDATES - 1];
+        while (atomic_load(&last->done_us) == 0 && FAS_MonotonicUs() - t0 < 10000000u)
+            usleep(100);
+        FAS_SHARD_STATS st;
+        FAS_ShardsGetStats(&set, 0, &st);
+        bench_shards_close(&set);
+
+        // 마지막 값은 항상 닿아야 하고, 합치기를 켜면 넣은 것보다 덜 보내야 함
+        uint64_t end = atomic_load(&last->done_us);
+        ok &= bench_report(end != 0 && (k == 0 || st.sent < BENCH_COALESCE_UPDATES),
+                           "%10s %10" PRIu64 " %10" PRIu64 " %14" PRIu64 " %14" PRIu64, k ? "on" : "off", st.sent,
+                           st.coalesced, end ? end - last->t0_us : 0, end ? end - t0 : 0);
+    }
+    FAS_StandInStop(&drive);
+    return ok;
+}
+
+/**@brief 우선순위 측정 요청, 넣은 시각을 같이 들고 다님*/
+typedef struct _BENCH_PRIO_REQ
+{
+	FAS_SHARD_REQUEST r;
+	uint64_t t0_us;
+} BENCH_PRIO_REQ;
+
+typedef struct _BENCH_PRIO
+{
+	FAS_SHARDS *set;
+	_Atomic bool running;
+	_Atomic int motions;						// 끝난 운전 명령 수
+	_Atomic uint64_t polls[BENCH_PRIO_BOARDS];	// 보드별 끝난 polling 수
+	uint32_t latency_us[BENCH_PRIO_MOTIONS];
+} BENCH_PRIO;
+
+static void bench_prio_poll_done(FAS_SHARD_REQUEST *r, void *user){
+    BENCH_PRIO *b = user;
+    if (!atomic_load_explicit(&b->running, memory_order_relaxed))
+        return;
+    atomic_fetch_add_explicit(&b->polls[r->req.link], 1, memory_order_relaxed);
+    FAS_RequestInit(&r->req, r->req.link, FRAME_GETALLSTATUS, NULL, 0);
+    FAS_ShardsSubmit(b->set, r);
+}
+
+static void bench_prio_motion_done(FAS_SHARD_REQUEST *r, void *user){
+    BENCH_PRIO *b = user;
+    BENCH_PRIO_REQ *q = (BENCH_PRIO_REQ *)r;
+    int i = atomic_load_explicit(&b->motions, memory_order_relaxed);
+    if (i < BENCH_PRIO_MOTIONS)
+        b->latency_us[i] = (uint32_t)(FAS_MonotonicUs() - q->t0_us);
+    atomic_fetch_add(&b->motions, 1);
+}
+
+// polling이 꽉 찬 보드들에 운전 명령을 끼워 넣음: polling 없음(기준), 우선순위 끔, 켬, 켬+조회 한 칸, 켬+shard 전체 제한
+// 가짜 드라이브는 serial로 돌려서 실제 드라이브처럼 먼저 가 있는 조회가 끝나야 운전 명령을 처리함
+static bool bench_priority(uint32_t delay_us){
+    static FAS_STANDIN drives[BENCH_PRIO_BOARDS];
+    static FAS_SHARD_REQUEST polls[BENCH_PRIO_BOARDS * FAS_DEFAULT_WINDOW * 2];
+    static BENCH_PRIO_REQ motion;
+    static BENCH_PRIO b;
+    static const char *names[FAS_PRIO_CLASSES] = { "safety", "motion", "config", "poll" };
+    static const struct { const char *name; bool polling, no_priority; int poll_window, inflight_max; } runs[] = {
+        { "no polling", false, false, 0, 0 },
+        { "fifo", true, true, 0, 0 },
+        { "priority", true, false, 0, 0 },
+        { "prio+poll 1", true, false, 1, 0 },
+        { "prio+budget", true, false, 0, FAS_DEFAULT_WINDOW * 3 },
+    };
+    enum { RUNS = sizeof(runs) / sizeof(runs[0]) };
+    uint32_t p50[RUNS] = { 0 }, p99[RUNS] = { 0 };
+    char ip[BENCH_PRIO_BOARDS][16];
+    bool ok = true;
+    // 마지막 보드만 10배 느림
+    if (!bench_standins_start(drives, BENCH_PRIO_BOARDS - 1, 120, delay_us, ip))
+        return bench_report(false, "priority: stand-in start failed");
+    if (!bench_standins_start(&drives[BENCH_PRIO_BOARDS - 1], 1, 120 + BENCH_PRIO_BOARDS - 1, delay_us * 10,
+                              &ip[BENCH_PRIO_BOARDS - 1])) {
+        bench_standins_stop(drives, BENCH_PRIO_BOARDS - 1);
+        return bench_report(false, "priority: stand-in start failed");
+    }
+    for (int i = 0; i < BENCH_PRIO_BOARDS; i++)
+        atomic_store(&drives[i].serial, true);
+
+    printf("priority: %d serial boards (board %d %ux slower), polling 2 x window %d each, MoveVelocity every %d us\n",
+           BENCH_PRIO_BOARDS, BENCH_PRIO_BOARDS - 1, 10, FAS_DEFAULT_WINDOW, BENCH_PRIO_PERIOD_US);
+    printf("%14s %10s %10s %10s %8s %12s %12s %14s %14s\n", "scheduler", "motion p50", "p99", "max", "x idle",
+           "motion q us", "poll q us", "fast polls/s", "slow polls/s");
+    for (int k = 0; k < RUNS; k++) {
+        FAS_SHARDS set;
+        FAS_SHARD_OPTION option = { .window = FAS_DEFAULT_WINDOW, .timeout_ms = 1000, .backend = FAS_IO_EPOLL,
+                                    .no_priority = runs[k].no_priority, .poll_window = runs[k].poll_window,
+                                    .inflight_max = runs[k].inflight_max };
+        if (!bench_shards_open(&set, 1, &option, ip, BENCH_PRIO_BOARDS)) {
+            ok = false;
+            break;
+        }
+        memset(&b, 0, sizeof(b));
+        b.set = &set;
+        atomic_store(&b.running, true);
+        for (int i = 0; runs[k].polling && i < BENCH_PRIO_BOARDS * FAS_DEFAULT_WINDOW * 2; i++) {
+            polls[i].done = bench_prio_poll_done;
+            polls[i].user = &b;
+            polls[i].priority = FAS_PRIO_AUTO;
+            FAS_RequestInit(&polls[i].req, i % BENCH_PRIO_BOARDS, FRAME_GETALLSTATUS, NULL, 0);
+            FAS_ShardsSubmit(&set, &polls[i]);
+        }
+        usleep(20000);	// 데우기
+
+        uint64_t t0 = FAS_MonotonicUs();
+        for (int i = 0; i < BENCH_PRIO_MOTIONS; i++) {
+            BYTE data[5] = { 0 };
+            int32_t velocity = 1000 + i;
+            memcpy(data, &velocity, sizeof(velocity));
+            motion.r.done = bench_prio_motion_done;
+            motion.r.user = &b;
+            motion.r.priority = FAS_PRIO_AUTO;
+            FAS_RequestInit(&motion.r.req, i % (BENCH_PRIO_BOARDS - 1), FRAME_MOVEVELOCITY, data, sizeof(data));
+            motion.t0_us = FAS_MonotonicUs();
+            FAS_ShardsSubmit(&set, &motion.r);
+            while (atomic_load(&b.motions) <= i && FAS_MonotonicUs() - motion.t0_us < 1000000u)
+                usleep(50);
+            while (FAS_MonotonicUs() - motion.t0_us < BENCH_PRIO_PERIOD_US)
+                usleep(100);
+        }
+        uint64_t elapsed = FAS_MonotonicUs() - t0;
+        uint64_t fast = 0, slow = atomic_load(&b.polls[BENCH_PRIO_BOARDS - 1]);
+        for (int i = 0; i < BENCH_PRIO_BOARDS - 1; i++)
+            fast += atomic_load(&b.polls[i]);
+        FAS_SHARD_STATS st;
+        FAS_ShardsGetStats(&set, 0, &st);
+        atomic_store(&b.running, false);
+        bench_shards_close(&set);
+        // 다음 설정이 앞 설정의 남은 응답 뒤에 줄 서지 않게 드라이브가 비기를 기다림
+        usleep(delay_us * 10 * FAS_DEFAULT_WINDOW * 2 + 20000);
+
+        int n = atomic_load(&b.motions) < BENCH_PRIO_MOTIONS ? atomic_load(&b.motions) : BENCH_PRIO_MOTIONS;
+        if (n == 0) {
+            ok = bench_report(false, "%14s no motion finished", runs[k].name);
+            continue;
+        }
+        qsort(b.latency_us, n, sizeof(b.latency_us[0]), bench_u32_compare);
+        p50[k] = b.latency_us[n / 2];
+        p99[k] = b.latency_us[(int)(n * 0.99)];
+        const int m = FAS_PRIO_MOTION - 1, p = FAS_PRIO_POLL - 1, c = FAS_PRIO_CONFIG - 1;
+        // 우선순위를 끄면 모두 config class로 세므로 두 칸이 같음
+        int mk = runs[k].no_priority ? c : m, pk = runs[k].no_priority ? c : p;
+        // 우선순위는 fifo보다, 조회 한 칸은 기본 조회 칸 수보다 운전 명령이 빨라야 하고 조회 한 칸이면 polling 없을 때의 2배 안
+        bool faster = true;
+        if (runs[k].polling && !runs[k].no_priority && runs[k].inflight_max == 0)
+            faster = p50[k] < p50[k - 1] && (runs[k].poll_window != 1 || p50[k] <= p50[0] * 2);
+        ok &= bench_report(n == BENCH_PRIO_MOTIONS && faster, "%14s %10u %10u %10u %8.2f %12.1f %12.1f %14.0f %14.0f",
+               runs[k].name, p50[k], p99[k], b.latency_us[n - 1], p50[0] ? (double)p50[k] / p50[0] : 0.0,
+               st.class_sent[mk] ? (double)st.class_queue_us[mk] / st.class_sent[mk] : 0.0,
+               st.class_sent[pk] ? (double)st.class_queue_us[pk] / st.class_sent[pk] : 0.0,
+               fast / (BENCH_PRIO_BOARDS - 1) / (elapsed / 1e6), slow / (elapsed / 1e6));
+        if (runs[k].inflight_max > 0) {
+            printf("  per class (sent / avg / max queue us):");
+            for (int i = 0; i < FAS_PRIO_CLASSES; i++)
+                printf(" %s %" PRIu64 "/%.0f/%" PRIu64, names[i], st.class_sent[i],
+                       st.class_sent[i] ? (double)st.class_queue_us[i] / st.class_sent[i] : 0.0, st.class_queue_max_us[i]);
+            printf(", preempted %" PRIu64 "\n", st.preempted);
+        }
+    }
+    bench_standins_stop(drives, BENCH_PRIO_BOARDS);
+    return ok;
+}
+
+/**@brief sequence 하나의 user 상태 (AWAIT 사이에 남겨야 하는 값)*/
+typedef struct _BENCH_SCRIPT_AXIS
+{
+	int32_t target;
+	int32_t actual;
+} BENCH_SCRIPT_AXIS;
+
+static int bench_script_seq(FAS_SCRIPT *s){
+    static const BYTE on[1] = { 1 };
+    BENCH_SCRIPT_AXIS *axis = s->user;
+    BYTE move[8];
+
+    FAS_SCRIPT_BEGIN(s);
+    FAS_SCRIPT_AWAIT(s, FRAME_SERVOENABLE, on, sizeof(on));
+    FAS_SCRIPT_AWAIT_STATUS(s, FAS_SCRIPT_FLAG(s, FAS_AXIS_SERVOON), 1, 1000);
+    FAS_SCRIPT_AWAIT(s, FRAME_MOVEORIGINSINGLEAXIS, NULL, 0);
+    FAS_SCRIPT_AWAIT_STATUS(s, FAS_SCRIPT_FLAG(s, FAS_AXIS_ORIGINRETOK) && !FAS_SCRIPT_FLAG(s, FAS_AXIS_MOTIONING), 1, 5000);
+    fas_put_le32(move, (uint32_t)axis->target);
+    fas_put_le32(move + 4, 1000000);
+    FAS_SCRIPT_AWAIT(s, FRAME_MOVESINGLEAXISABSPOS, move, sizeof(move));
+    FAS_SCRIPT_SLEEP(s, 1);
+    FAS_SCRIPT_AWAIT_STATUS(s, FAS_SCRIPT_FLAG(s, FAS_AXIS_INPOSITION), 1, 5000);
+    FAS_SCRIPT_AWAIT(s, FRAME_GETACTUALPOS, NULL, 0);
+    axis->actual = (int32_t)fas_get_le32(s->r.req.resp);
+    FAS_SCRIPT_END(s);
+}
+
+// sequence 2000개를 가짜 드라이브 16대에 나눠 동시에 실행 (보드마다 125개가 같은 축을 번갈아 움직임)
+static bool bench_script(uint32_t delay_us){
+    static FAS_STANDIN drives[BENCH_SCRIPT_BOARDS];
+    static FAS_SCRIPT scripts[BENCH_SCRIPT_SEQUENCES];
+    static BENCH_SCRIPT_AXIS axes[BENCH_SCRIPT_SEQUENCES];
+    static uint32_t elapsed[BENCH_SCRIPT_SEQUENCES];
+    char ip[BENCH_SCRIPT_BOARDS][16];
+    FAS_SHARDS set;
+    FAS_SCRIPT_RUNNER runner;
+    FAS_SHARD_OPTION option = { .window = FAS_DEFAULT_WINDOW, .timeout_ms = 1000, .backend = FAS_IO_EPOLL };
+    if (!bench_standins_start(drives, BENCH_SCRIPT_BOARDS, 130, delay_us, ip))
+        return bench_report(false, "scripts: stand-in start failed");
+    if (!bench_shards_open(&set, 1, &option, ip, BENCH_SCRIPT_BOARDS)) {
+        bench_standins_stop(drives, BENCH_SCRIPT_BOARDS);
+        return bench_report(false, "scripts: shard start failed");
+    }
+    FAS_ScriptRunnerInit(&runner, &set);
+
+    uint64_t t0 = FAS_MonotonicUs();
+    int started = 0;
+    for (int i = 0; i < BENCH_SCRIPT_SEQUENCES; i++) {
+        axes[i].target = 1000 + i;
+        if (FAS_ScriptStart(&runner, &scripts[i], i % BENCH_SCRIPT_BOARDS, bench_script_seq, NULL, &axes[i]))
+            started++;
+    }
+    while (atomic_load(&runner.running) > 0 && FAS_MonotonicUs() - t0 < 30000000u)
+        usleep(1000);
+    uint64_t total_us = FAS_MonotonicUs() - t0;
+    FAS_SHARD_STATS st;
+    FAS_ShardsGetStats(&set, 0, &st);
+    bench_shards_close(&set);
+    bench_standins_stop(drives, BENCH_SCRIPT_BOARDS);
+
+    int n = 0;
+    uint64_t command_us = 0;
+    for (int i = 0; i < BENCH_SCRIPT_SEQUENCES; i++) {
+        if (scripts[i].end_us == 0 || scripts[i].result != FAS_SCRIPT_DONE)
+            continue;
+        elapsed[n++] = FAS_ScriptElapsedUs(&scripts[i]);
+        command_us += scripts[i].command_us;
+    }
+    if (n == 0)
+        return bench_report(false, "scripts: no sequence finished");
+    qsort(elapsed, n, sizeof(elapsed[0]), bench_u32_compare);
+    printf("scripts: %d sequences on %d boards, %zu bytes each (%zu KB total, no thread/stack), all done in %" PRIu64 " us\n",
+           started, BENCH_SCRIPT_BOARDS, sizeof(FAS_SCRIPT), sizeof(scripts) / 1024, total_us);
+    return bench_report(n == BENCH_SCRIPT_SEQUENCES && started == BENCH_SCRIPT_SEQUENCES && atomic_load(&runner.failed) == 0,
+                        "  done %d failed %" PRIu64 ", %.1f commands/sequence, sequence p50 %u us p99 %u us max %u us, "
+                        "avg command wait %.0f us, deferred polls %" PRIu64,
+                        n, atomic_load(&runner.failed), (double)atomic_load(&runner.commands) / started, elapsed[n / 2],
+           elapsed[(int)(n * 0.99)], elapsed[n - 1], (double)command_us / atomic_load(&runner.commands), st.deferred);
+}
+
+// 보드 하나가 원하는 상태가 될 때까지 기다림, 걸린 us (timeout이면 0)
+static uint64_t bench_poll_wait(FAS_POLLER *poller, int index, FAS_POLL_STATE state, int alarm){
+    uint64_t t0 = FAS_MonotonicUs();
+    FAS_POLL_INFO info;
+    while (FAS_MonotonicUs() - t0 < 2000000u) {
+        FAS_PollerGetInfo(poller, index, &info);
+        if (info.state == state && (alarm == 0 || info.alarm == alarm))
+            return FAS_MonotonicUs() - t0;
+        usleep(100);
+    }
+    return 0;
+}
+
+static void bench_poll_table(FAS_POLLER *poller, const char *name, uint64_t frames, uint64_t elapsed_us){
+    FAS_POLL_INFO info;
+    double fast_target = 0, fast_got = 0;
+    int fast = 0;
+    for (int i = 0; i < poller->count; i++) {
+        FAS_PollerGetInfo(poller, i, &info);
+        if (info.state == FAS_POLL_FAST) {
+            fast++;
+            fast_target += info.target_hz;
+            fast_got += info.achieved_hz;
+        }
+    }
+    printf("%12s %10.0f %12.0f %6d %14.0f %14.0f", name, frames / (elapsed_us / 1e6), FAS_PollerTotalHz(poller), fast,
+           fast ? fast_target / fast : 0.0, fast ? fast_got / fast : 0.0);
+    FAS_PollerGetInfo(poller, poller->count - 1, &info);
+    printf(" %10s %8.1f\n", FAS_PollStateName(info.state), info.achieved_hz);
+}
+
+// 가짜 드라이브 16대 중 2대만 운전, 고정 주기 / 적응형 / 적응형 + budget 비교
+static bool bench_poll(uint32_t delay_us){
+    static FAS_STANDIN drives[BENCH_POLL_BOARDS];
+    static FAS_POLLER poller;
+    char ip[BENCH_POLL_BOARDS][16];
+    bool ok = true;
+    if (!bench_standins_start(drives, BENCH_POLL_BOARDS, 150, delay_us, ip))
+        return bench_report(false, "adaptive polling: stand-in start failed");
+    // 0, 1번 축 운전 (context로 직접), 나머지는 서보 OFF / inposition
+    for (int b = 0; b < 4; b++)
+        FAS_ContextOpen(FAS_BoardContext(BENCH_POLL_BOARD + b), ip[b < 2 ? b : b == 2 ? 5 : 6], false);
+    for (int b = 0; b < 2; b++) {
+        FAS_ServoEnable(BENCH_POLL_BOARD + b, true);
+        FAS_MoveVelocity(BENCH_POLL_BOARD + b, 10000, 1);
+    }
+
+    printf("adaptive polling: %d boards (2 moving), %d ms, fast/normal/slow %d/%d/%d Hz\n", BENCH_POLL_BOARDS,
+           BENCH_POLL_MS, FAS_POLL_FAST_HZ, FAS_POLL_NORMAL_HZ, FAS_POLL_SLOW_HZ);
+    printf("%12s %10s %12s %6s %14s %14s %10s %8s\n", "poller", "frames/s", "achieved Hz", "fast", "fast target Hz",
+           "fast got Hz", "idle state", "idle Hz");
+    for (int k = 0; k < 3; k++) {
+        FAS_SHARDS set;
+        FAS_SHARD_OPTION option = { .window = FAS_DEFAULT_WINDOW, .timeout_ms = 1000, .backend = FAS_IO_EPOLL };
+        // 0: 모두 fast로 고정 (예전 고정 주기), 1: 적응형, 2: 적응형 + budget (fast 두 대 목표의 절반)
+        FAS_POLL_OPTION popt = { 0 };
+        if (k == 0)
+            popt.normal_hz = popt.slow_hz = FAS_POLL_FAST_HZ;
+        if (k == 2)
+            popt.budget_fps = FAS_POLL_FAST_HZ;
+        if (!bench_shards_open(&set, 1, &option, ip, BENCH_POLL_BOARDS)) {
+            ok = false;
+            break;
+        }
+        FAS_PollerInit(&poller, &set, &popt);
+        for (int b = 0; b < BENCH_POLL_BOARDS; b++)
+            FAS_PollerAdd(&poller, b);
+        FAS_PollerStart(&poller);
+        usleep((FAS_POLL_HOLD_MS + FAS_POLL_RATE_MS + 100) * 1000);	// 처음 fast hold가 풀리고 rate 구간 하나가 지날 때까지
+
+        FAS_SHARD_STATS st;
+        FAS_ShardsGetStats(&set, 0, &st);
+        uint64_t sent0 = st.sent, t0 = FAS_MonotonicUs();
+        usleep(BENCH_POLL_MS * 1000);
+        FAS_ShardsGetStats(&set, 0, &st);
+        bench_poll_table(&poller, k == 0 ? "fixed" : k == 1 ? "adaptive" : "budget", st.sent - sent0,
+                         FAS_MonotonicUs() - t0);
+
+        if (k == 1) {
+            // 멈춰 있던 5번 축을 움직이고, 6번 축에 알람
+            usleep(37000);	// 조회 주기와 어긋난 시점에 바꿈
+            FAS_ServoEnable(BENCH_POLL_BOARD + 2, true);
+            FAS_MoveVelocity(BENCH_POLL_BOARD + 2, 10000, 1);
+            uint64_t move_us = bench_poll_wait(&poller, 5, FAS_POLL_FAST, 0);
+            atomic_store(&drives[6].alarm, 0x0A);
+            uint64_t alarm_us = bench_poll_wait(&poller, 6, FAS_POLL_FAST, 0x0A);
+            FAS_MoveStop(BENCH_POLL_BOARD + 2);
+            FAS_ServoEnable(BENCH_POLL_BOARD + 2, false);
+            FAS_ServoAlarmReset(BENCH_POLL_BOARD + 3);
+            // 0이면 2초 안에 fast로 못 올라온 것
+            ok &= bench_report(move_us != 0 && alarm_us != 0, "  idle axis starts moving -> fast in %" PRIu64
+                               " us, alarm -> fast with type read in %" PRIu64 " us (slow period %d us)", move_us, alarm_us,
+                               1000000 / FAS_POLL_SLOW_HZ);
+
+            // 7번 축은 GetAlarmType(0x2E)을 거절하는 드라이브: 알람 뒤에도 상태 조회가 이어지고 0x2E를 되풀이하지 않아야 함
+            FAS_POLL_INFO before, after;
+            atomic_store(&drives[7].reject_type, FRAME_GETALARMTYPE);
+            atomic_store(&drives[7].alarm, 0x0B);
+            uint64_t reject_us = bench_poll_wait(&poller, 7, FAS_POLL_FAST, 0);
+            usleep(20000);
+            FAS_PollerGetInfo(&poller, 7, &before);
+            usleep(100000);
+            FAS_PollerGetInfo(&poller, 7, &after);
+            uint64_t rejected = atomic_load(&drives[7].rejected);
+            atomic_store(&drives[7].reject_type, 0);
+            FAS_ContextOpen(FAS_BoardContext(BENCH_POLL_BOARD + 3), ip[7], false);
+            FAS_ServoAlarmReset(BENCH_POLL_BOARD + 3);
+            ok &= bench_report(reject_us != 0 && rejected <= 2 && after.polls - before.polls >= 10,
+                               "  alarm on a drive that rejects 0x2E: fast in %" PRIu64 " us, 0x2E sent %" PRIu64
+                               " time(s), %" PRIu64 " status polls in the next 100 ms", reject_us, rejected,
+                               after.polls - before.polls);
+        }
+        FAS_PollerStop(&poller);
+        bench_shards_close(&set);
+    }
+    for (int b = 0; b < 4; b++)
+        FAS_ContextClose(FAS_BoardContext(BENCH_POLL_BOARD + b));
+    bench_standins_stop(drives, BENCH_POLL_BOARDS);
+    return ok;
+}
+
+// 보드 4096대 AxisStatus, 주기마다 0.5%의 보드에서 flag가 바뀔 때 변화만 고르기 vs 전부 글자로 만들기
+static bool bench_axis_status(void){
+    static uint32_t now[BENCH_AXIS_BOARDS], last[BENCH_AXIS_BOARDS];
+    static FAS_AXIS_CHANGE changes[BENCH_AXIS_BOARDS];
+    char text[512];
+    uint64_t rng = 88172645463325252ull, diff_ns, changed = 0, chars = 0;
+    for (int i = 0; i < BENCH_AXIS_BOARDS; i++)
+        now[i] = last[i] = FAS_AXIS_SERVOON | FAS_AXIS_INPOSITION;
+
+    uint64_t t0 = FAS_MonotonicUs();
+    for (int c = 0; c < BENCH_AXIS_CYCLES; c++) {
+        for (int k = 0; k < BENCH_AXIS_BOARDS / 200; k++) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            now[rng % BENCH_AXIS_BOARDS] ^= 1u << ((rng >> 32) & 31);
+        }
+        changed += FAS_AxisStatusChanges(last, now, BENCH_AXIS_BOARDS, changes, BENCH_AXIS_BOARDS);
+    }
+    diff_ns = (FAS_MonotonicUs() - t0) * 1000;
+
+    t0 = FAS_MonotonicUs();
+    for (int c = 0; c < BENCH_AXIS_CYCLES / 10; c++)
+        for (int i = 0; i < BENCH_AXIS_BOARDS; i++)
+            chars += FAS_AxisStatusFormat(text, sizeof(text), now[i]);
+    uint64_t format_ns = (FAS_MonotonicUs() - t0) * 1000 * 10;
+    return bench_report(changed > 0 && chars > 0,
+                        "axis status (%d boards): changes %.1f/cycle, diff %.2f ns/board, format every board %.1f ns/board (%" PRIu64 " chars)",
+                        BENCH_AXIS_BOARDS, (double)changed / BENCH_AXIS_CYCLES, (double)diff_ns / BENCH_AXIS_CYCLES / BENCH_AXIS_BOARDS,
+                        (double)format_ns / BENCH_AXIS_CYCLES / BENCH_AXIS_BOARDS, chars);
+}
+
+// codec 없이 Header를 변수로 받는 예전 방식 (라이브러리에 있던 FAS_BuildFrame처럼 따로 불리게 noinline)
+static __attribute__((noinline)) int bench_generic_build(BYTE *frame, BYTE header, BYTE sync_no, BYTE frame_type,
+                                                         const BYTE *data, int data_len){
+    frame[0] = header;
+    frame[1] = (BYTE)(data_len + 3);
+    frame[2] = sync_no;
+    frame[3] = 0x00;
+    frame[4] = frame_type;
+    if (data_len > 0)
+        memcpy(&frame[FRAME_HEADER_SIZE], data, data_len);
+    return data_len + FRAME_HEADER_SIZE;
+}
+
+// 예전 방식의 응답 확인 (Header 비교)
+static bool bench_generic_decode(BYTE header, BYTE *frame, int len, FAS_FRAME_VIEW *view){
+    if (len < FRAME_HEADER_SIZE + 1 || frame[0] != header || frame[1] + 2 != len)
+        return false;
+    view->sync = frame[2];
+    view->frame_type = frame[4];
+    view->status = frame[FRAME_HEADER_SIZE];
+    view->data = frame + FRAME_HEADER_SIZE + 1;
+    view->data_len = len - (FRAME_HEADER_SIZE + 1);
+    return true;
+}
+
+// 가짜 드라이브와 한 번에 하나씩 교환하며 RTT를 kernel timestamp로 드라이브 + 회선 / 우리 쪽 stack으로 나눔
+static bool bench_timestamps(uint32_t delay_us){
+    static FAS_STANDIN drive;
+    static FAS_CONTEXT ctx;
+    static uint32_t rtt[BENCH_TS_EXCHANGES], wire[BENCH_TS_EXCHANGES], stack[BENCH_TS_EXCHANGES];
+    static const char *source_name[] = { "none (CLOCK_MONOTONIC)", "software", "hardware" };
+    int n = 0, source = FAS_TS_NONE;
+    if (!bench_standins_start(&drive, 1, 97, delay_us, NULL))
+        return bench_report(false, "timestamps: stand-in start failed");
+    FAS_ContextInit(&ctx, BENCH_LIST_BOARD + 1);
+    if (!FAS_ContextOpen(&ctx, "127.0.0.97", false)) {
+        FAS_StandInStop(&drive);
+        return bench_report(false, "timestamps: open failed");
+    }
+    for (int i = 0; i < BENCH_TS_EXCHANGES; i++) {
+        if (FAS_ContextCommand(&ctx, FRAME_GETAXISSTATUS, NULL, 0, NULL, 0, NULL) != FMM_OK)
+            continue;
+        rtt[n] = ctx.rtt_us;
+        wire[n] = ctx.wire_us;
+        stack[n] = ctx.rtt_us - ctx.wire_us;
+        source = ctx.ts_source;
+        n++;
+    }
+    FAS_ContextClose(&ctx);
+    FAS_StandInStop(&drive);
+    if (n == 0)
+        return bench_report(false, "timestamps: no exchange finished");
+
+    qsort(rtt, n, sizeof(rtt[0]), bench_u32_compare);
+    qsort(wire, n, sizeof(wire[0]), bench_u32_compare);
+    qsort(stack, n, sizeof(stack[0]), bench_u32_compare);
+    return bench_report(n == BENCH_TS_EXCHANGES,
+                        "timestamps (%d exchanges, %s): rtt p50 %u p99 %u us, drive+wire p50 %u p99 %u us, stack p50 %u p99 %u us",
+                        n, source_name[source], rtt[n / 2], rtt[n * 99 / 100], wire[n / 2], wire[n * 99 / 100], stack[n / 2], stack[n * 99 / 100]);
+}
+
+// 50줄 설정 목록 (파라미터 36개, 서보 ON, 그 뒤에 매달린 위치 초기화와 상태 읽기)을 한 줄씩 응답 기다리기 vs 목록 실행
+// 가짜 드라이브 앞에 고정 지연 proxy를 둬서 회선 왕복 시간이 드라이브 처리 시간보다 큰 경우를 만듦
+static bool bench_list(uint32_t delay_us){
+    static FAS_LIST list;
+    static FAS_STANDIN drive;
+    static FAS_FAULT_PROXY proxy;
+    static char text[4096];
+    FAS_FAULT_PROFILE profile = { .dist = FAS_FAULT_FIXED, .latency_us = BENCH_LIST_LATENCY_US };
+    FAS_CONTEXT *ctx = FAS_BoardContext(BENCH_LIST_BOARD);
+    bool ok = false;
+    if (!bench_standins_start(&drive, 1, 95, delay_us, NULL))
+        return bench_report(false, "command list: stand-in start failed");
+    if (!FAS_FaultProxyStart(&proxy, "127.0.0.96", "127.0.0.95", &profile, &profile, 1, NULL)) {
+        FAS_StandInStop(&drive);
+        return bench_report(false, "command list: proxy start failed");
+    }
+
+    int len = 0, error_line = 0;
+    for (int p = 0; p < FAS_PARAM_COUNT; p++)
+        len += snprintf(text + len, sizeof(text) - len, "0 %02X %02X 00 00 00 00\n", FRAME_SETPARAMETER, p);
+    len += snprintf(text + len, sizeof(text) - len, "0 %02X 01    # servo on\n", FRAME_SERVOENABLE);
+    len += snprintf(text + len, sizeof(text) - len, "> 0 %02X\n", FRAME_CLEARPOSITION);
+    for (int i = 0; i < 12; i++)
+        len += snprintf(text + len, sizeof(text) - len, "0 %02X @38\n", i % 2 ? FRAME_GETACTUALPOS : FRAME_GETAXISSTATUS);
+    if (!FAS_ListParse(&list, text, &error_line)) {
+        bench_report(false, "command list: parse failed at line %d", error_line);
+        goto out;
+    }
+    if (!FAS_ContextOpen(ctx, "127.0.0.96", false)) {
+        bench_report(false, "command list: open failed");
+        goto out;
+    }
+
+    // 지금까지의 방법: send_packet처럼 한 줄마다 응답을 기다림
+    uint64_t t0 = FAS_MonotonicUs();
+    int serial_failed = 0;
+    for (int i = 0; i < list.count; i++) {
+        const FAS_REQUEST *r = &list.entry[i].req;
+        if (FAS_ContextCommand(ctx, r->frame_type, r->data, r->data_len, NULL, 0, NULL) != FMM_OK)
+            serial_failed++;
+    }
+    uint64_t serial_us = FAS_MonotonicUs() - t0;
+
+    FAS_BATCH_OPTION option = { .window = BENCH_LIST_WINDOW };
+    int failed = FAS_ListExecute(&ctx->link, 1, &list, &option);
+    ok = bench_report(serial_failed == 0 && failed == 0,
+                      "command list (%d steps, window %d, %d us each way): one by one %" PRIu64 " us (failed %d), list %u us in %d waves (failed %d)",
+                      list.count, BENCH_LIST_WINDOW, BENCH_LIST_LATENCY_US, serial_us, serial_failed, list.total_us, list.waves, failed);
+    FAS_ContextClose(ctx);
+
+out:
+    FAS_FaultProxyStop(&proxy);
+    FAS_StandInStop(&drive);
+    return ok;
+}
+
+/**@brief broker 측정 client thread 하나*/
+typedef struct _BENCH_BROKER_CLIENT
+{
+	const char *path;
+	int depth;					// 보내 둘 요청 수
+	uint64_t completed;
+	uint64_t queue_us_sum;
+	pthread_barrier_t *start;
+	pthread_t thread;
+} BENCH_BROKER_CLIENT;
+
+static void *bench_broker_client_main(void *arg){
+    BENCH_BROKER_CLIENT *bc = arg;
+    FAS_BROKER_CLIENT client;
+    bool connected = FAS_BrokerConnect(&client, bc->path);
+    pthread_barrier_wait(bc->start);
+    if (!connected)
+        return NULL;
+    int outstanding = 0;
+    uint64_t end = FAS_MonotonicUs() + BENCH_BROKER_MS * 1000ull;
+    while (FAS_MonotonicUs() < end || outstanding > 0) {
+        FAS_BROKER_SLOT *slot;
+        while (FAS_MonotonicUs() < end && outstanding < bc->depth && (slot = FAS_BrokerGetSlot(&client)) != NULL) {
+            slot->board = BENCH_BROKER_BOARD;
+            slot->frame_type = FRAME_GETAXISSTATUS;
+            slot->data_len = 0;
+            FAS_BrokerSubmit(&client, slot);
+            outstanding++;
+        }
+        if ((slot = FAS_BrokerWait(&client, 50)) == NULL)
+            break;
+        outstanding--;
+        if (slot->status == FMM_OK) {
+            bc->completed++;
+            bc->queue_us_sum += slot->queue_us;
+        }
+        FAS_BrokerRelease(&client, slot);
+    }
+    FAS_BrokerDisconnect(&client);
+    return NULL;
+}
+
+// 같은 가짜 드라이브에 직접(FAS_ContextCommand) vs broker 경유(FAS_BrokerCommand) 한 번에 하나씩, 그 다음 client 3개 공유
+static bool bench_broker(uint32_t delay_us){
+    static FAS_STANDIN drive;
+    static FAS_BROKER broker;
+    static FAS_CONTEXT ctx;
+    static uint32_t direct[BENCH_BROKER_EXCHANGES], brokered[BENCH_BROKER_EXCHANGES], queue[BENCH_BROKER_EXCHANGES];
+    static BENCH_BROKER_CLIENT clients[BENCH_BROKER_CLIENTS];
+    char path[64];
+    int nd = 0, nb = 0;
+    bool ok;
+    snprintf(path, sizeof(path), "/tmp/fas_bench_broker.%d.sock", (int)getpid());
+    if (!bench_standins_start(&drive, 1, 98, delay_us, NULL))
+        return bench_report(false, "broker: stand-in start failed");
+    FAS_BROKER_OPTION option = { .window = BENCH_LIST_WINDOW };
+    if (!FAS_BrokerInit(&broker, path, &option) || !FAS_BrokerAddBoard(&broker, BENCH_BROKER_BOARD, "127.0.0.98", false)
+        || !FAS_BrokerStart(&broker)) {
+        FAS_BrokerStop(&broker);
+        FAS_StandInStop(&drive);
+        return bench_report(false, "broker: start failed");
+    }
+
+    FAS_ContextInit(&ctx, BENCH_BROKER_BOARD + 1);
+    if (FAS_ContextOpen(&ctx, "127.0.0.98", false)) {
+        for (int i = 0; i < BENCH_BROKER_EXCHANGES; i++) {
+            uint64_t t0 = FAS_MonotonicUs();
+            if (FAS_ContextCommand(&ctx, FRAME_GETAXISSTATUS, NULL, 0, NULL, 0, NULL) == FMM_OK)
+                direct[nd++] = (uint32_t)(FAS_MonotonicUs() - t0);
+        }
+        FAS_ContextClose(&ctx);
+    }
+
+    FAS_BROKER_CLIENT client;
+    if (FAS_BrokerConnect(&client, path)) {
+        for (int i = 0; i < BENCH_BROKER_EXCHANGES; i++) {
+            FAS_BROKER_SLOT *slot = FAS_BrokerGetSlot(&client);
+            slot->board = BENCH_BROKER_BOARD;
+            slot->frame_type = FRAME_GETAXISSTATUS;
+            slot->data_len = 0;
+            uint64_t t0 = FAS_MonotonicUs();
+            FAS_BrokerSubmit(&client, slot);
+            FAS_BROKER_SLOT *done = FAS_BrokerWait(&client, -1);
+            if (done == NULL)
+                break;
+            if (done->status == FMM_OK) {
+                brokered[nb] = (uint32_t)(FAS_MonotonicUs() - t0);
+                queue[nb++] = done->queue_us;
+            }
+            FAS_BrokerRelease(&client, done);
+        }
+        FAS_BrokerDisconnect(&client);
+    }
+    ok = nd == BENCH_BROKER_EXCHANGES && nb == BENCH_BROKER_EXCHANGES;
+    if (nd > 0 && nb > 0) {
+        qsort(direct, nd, sizeof(direct[0]), bench_u32_compare);
+        qsort(brokered, nb, sizeof(brokered[0]), bench_u32_compare);
+        qsort(queue, nb, sizeof(queue[0]), bench_u32_compare);
+        bench_report(ok, "broker (%d exchanges): direct p50 %u p99 %u us, via broker p50 %u p99 %u us, submit->wire p50 %u p99 %u us",
+                     nb, direct[nd / 2], direct[nd * 99 / 100], brokered[nb / 2], brokered[nb * 99 / 100], queue[nb / 2], queue[nb * 99 / 100]);
+    }
+    else
+        bench_report(false, "broker: direct %d / via broker %d exchanges finished", nd, nb);
+
+    // 한 client가 window보다 많이 몰아 넣어도 나머지 client가 밀리지 않는지
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, BENCH_BROKER_CLIENTS);
+    for (int i = 0; i < BENCH_BROKER_CLIENTS; i++) {
+        clients[i] = (BENCH_BROKER_CLIENT){ .path = path, .depth = i == 0 ? BENCH_BROKER_HEAVY_DEPTH : 2, .start = &start };
+        pthread_create(&clients[i].thread, NULL, bench_broker_client_main, &clients[i]);
+    }
+    for (int i = 0; i < BENCH_BROKER_CLIENTS; i++)
+        pthread_join(clients[i].thread, NULL);
+    pthread_barrier_destroy(&start);
+    printf("broker sharing (%d clients, window %d, %d ms):", BENCH_BROKER_CLIENTS, BENCH_LIST_WINDOW, BENCH_BROKER_MS);
+    for (int i = 0; i < BENCH_BROKER_CLIENTS; i++)
+        printf(" [depth %d: %" PRIu64 " done, submit->wire %.1f us]", clients[i].depth, clients[i].completed,
+               clients[i].completed ? (double)clients[i].queue_us_sum / clients[i].completed : 0.0);
+    // 얕은 client도 몫을 받아야 함
+    bool shared = true;
+    for (int i = 0; i < BENCH_BROKER_CLIENTS; i++)
+        shared &= clients[i].completed > 0;
+    ok &= bench_report(shared, "");
+
+    FAS_BrokerStop(&broker);
+    FAS_StandInStop(&drive);
+    return ok;
+}
+
+// recipe 번호마다 조금씩 다른 position table 항목 (change_every 항목마다 위치가 recipe에 따라 달라짐)
+static void bench_pt_item(int item_no, int recipe, int change_every, FAS_PT_ITEM *item){
+    memset(item, 0, sizeof(*item));
+    item->position = item_no * 1000 + (item_no % change_every == 0 ? recipe * 7 : 0);
+    item->start_speed = 1;
+    item->move_speed = 10000 + item_no;
+    item->accel = item->decel = 100;
+    item->continuous = item_no + 1 < FAS_PT_ITEM_COUNT;
+    item->branch = (uint16_t)(item_no + 1);
+    item->check_inpos = 1;
+}
+
+// 축 20개에 256항목 table 전체 쓰기 + 확인, 그 다음 10%만 바뀐 recipe로 교체 (한 축을 한 항목씩 쓰고 읽는 방법과 비교)
+static bool bench_postable(uint32_t delay_us){
+    static FAS_STANDIN drives[BENCH_PT_AXES];
+    static FAS_LINK links[BENCH_PT_AXES];
+    static FAS_PT_CACHE caches[BENCH_PT_AXES];
+    static FAS_CONTEXT ctx;
+    FAS_BATCH_OPTION option = { .window = BENCH_PT_WINDOW };
+    FAS_PT_PROGRESS full, change;
+    FAS_PT_ITEM item;
+    char ip[BENCH_PT_AXES][16];
+    bool ok = false;
+    if (!bench_standins_start(drives, BENCH_PT_AXES, 100, delay_us, ip))
+        return bench_report(false, "position table: stand-in start failed");
+    int axes = 0;
+    for (; axes < BENCH_PT_AXES; axes++) {
+        if (!FAS_LinkOpen(&links[axes], BENCH_PT_BOARD + axes, ip[axes], false))
+            break;
+        FAS_PtCacheInit(&caches[axes], BENCH_PT_BOARD + axes, FAS_PT_ITEM_COUNT);
+    }
+    if (axes < BENCH_PT_AXES) {
+        bench_report(false, "position table: open failed");
+        goto out;
+    }
+
+    // 지금까지의 방법: 한 축, 항목마다 쓰기 응답과 읽기 응답을 기다림
+    uint64_t serial_us = 0;
+    FAS_ContextInit(&ctx, BENCH_PT_BOARD + BENCH_PT_AXES);
+    if (FAS_ContextOpen(&ctx, "127.0.0.100", false)) {
+        BYTE data[2 + FAS_PT_ITEM_SIZE], resp[DATA_SIZE];
+        uint64_t t0 = FAS_MonotonicUs();
+        for (int k = 0; k < FAS_PT_ITEM_COUNT; k++) {
+            bench_pt_item(k, 0, 10, &item);
+            data[0] = (BYTE)k;
+            data[1] = 0;
+            FAS_PtItemEncode(&item, &data[2]);
+            FAS_ContextCommand(&ctx, FRAME_POSTABLEWRITEITEM, data, sizeof(data), NULL, 0, NULL);
+            FAS_ContextCommand(&ctx, FRAME_POSTABLEREADITEM, data, 2, resp, sizeof(resp), NULL);
+        }
+        serial_us = FAS_MonotonicUs() - t0;
+        FAS_ContextClose(&ctx);
+    }
+
+    for (int a = 0; a < BENCH_PT_AXES; a++) {
+        for (int k = 0; k < FAS_PT_ITEM_COUNT; k++) {
+            bench_pt_item(k, 1, 10, &item);
+            FAS_PtSet(&caches[a], k, &item);
+        }
+    }
+    int full_left = FAS_PtUpload(links, caches, BENCH_PT_AXES, &option, NULL, NULL, &full);
+    for (int a = 0; a < BENCH_PT_AXES; a++) {
+        for (int k = 0; k < FAS_PT_ITEM_COUNT; k++) {
+            bench_pt_item(k, 2, 10, &item);
+            FAS_PtSet(&caches[a], k, &item);
+        }
+    }
+    int change_left = FAS_PtUpload(links, caches, BENCH_PT_AXES, &option, NULL, NULL, &change);
+
+    // 확인: 가짜 드라이브 table이 recipe 2와 같은지
+    int wrong = 0;
+    for (int a = 0; a < BENCH_PT_AXES; a++) {
+        for (int k = 0; k < FAS_PT_ITEM_COUNT; k++) {
+            BYTE node[FAS_PT_ITEM_SIZE];
+            bench_pt_item(k, 2, 10, &item);
+            FAS_PtItemEncode(&item, node);
+            wrong += memcmp(node, drives[a].pt[k], FAS_PT_ITEM_SIZE) != 0;
+        }
+    }
+    printf("position table (%d axes x %d items, window %d): one axis item by item %" PRIu64 " us (x%d axes %" PRIu64 " us)\n",
+           BENCH_PT_AXES, FAS_PT_ITEM_COUNT, BENCH_PT_WINDOW, serial_us, BENCH_PT_AXES, serial_us * BENCH_PT_AXES);
+    printf("  full upload  %5d items %8" PRIu64 " us %8.0f items/s %7.1f KB/s verified %d left %d\n", full.total, full.elapsed_us,
+           full.elapsed_us ? full.total * 1e6 / full.elapsed_us : 0.0, full.elapsed_us ? full.bytes * 1e6 / 1024.0 / full.elapsed_us : 0.0,
+           full.verified, full_left);
+    ok = bench_report(full_left == 0 && change_left == 0 && wrong == 0 && full.verified == full.total
+                      && change.verified == change.total,
+                      "  recipe swap  %5d items %8" PRIu64 " us %8.0f items/s %7.1f KB/s verified %d left %d, drive tables wrong %d",
+                      change.total, change.elapsed_us, change.elapsed_us ? change.total * 1e6 / change.elapsed_us : 0.0,
+           change.elapsed_us ? change.bytes * 1e6 / 1024.0 / change.elapsed_us : 0.0, change.verified, change_left, wrong);
+
+out:
+    for (int a = 0; a < axes; a++)
+        FAS_LinkClose(&links[a]);
+    bench_standins_stop(drives, BENCH_PT_AXES);
+    return ok;
+}
+
+/**@brief 스트리밍 측정의 setpoint producer thread*/
+typedef struct _BENCH_STREAM_POSTER
+{
+	FAS_STREAM *stream;
+	_Atomic bool running;
+	uint64_t posts;
+	pthread_t thread;
+} BENCH_STREAM_POSTER;
+
+static void *bench_stream_poster_main(void *arg){
+    BENCH_STREAM_POSTER *poster = arg;
+    while (atomic_load_explicit(&poster->running, memory_order_relaxed)) {
+        FAS_StreamPost(poster->stream, (int32_t)(10000 + poster->posts % 1000));
+        poster->posts++;
+        usleep(BENCH_STREAM_POST_US);
+    }
+    return NULL;
+}
+
+// 가짜 드라이브 한 대에 1kHz 속도 override, 주기보다 자주 FAS_StreamPost / setpoint buffer 두 번 (끝난 뒤 다시 시작)
+static bool bench_stream(uint32_t delay_us){
+    static FAS_STANDIN drive;
+    static FAS_LINK link;
+    static FAS_STREAM stream;
+    static int32_t setpoints[BENCH_STREAM_SETPOINTS];
+    static BENCH_STREAM_POSTER poster;
+    FAS_STREAM_STATS st, run[2];
+    char ip[1][16];
+    bool ok = false;
+    if (!bench_standins_start(&drive, 1, 172, delay_us, ip))
+        return bench_report(false, "stream: stand-in start failed");
+    if (!FAS_LinkOpen(&link, BENCH_STREAM_BOARD, ip[0], false)) {
+        FAS_StandInStop(&drive);
+        return bench_report(false, "stream: open failed");
+    }
+
+    FAS_StreamInit(&stream, &link, FAS_STREAM_VELOCITY, 1000);
+    poster = (BENCH_STREAM_POSTER){ .stream = &stream };
+    atomic_store(&poster.running, true);
+    if (!FAS_StreamStart(&stream) || pthread_create(&poster.thread, NULL, bench_stream_poster_main, &poster) != 0) {
+        bench_report(false, "stream: start failed");
+        FAS_StreamStop(&stream);
+        goto out;
+    }
+    usleep(BENCH_STREAM_MS * 1000);
+    // producer를 먼저 멈추고 마지막 값이 나갈 때까지 몇 주기 더 돌림 (보낸 것 + 덮인 것 = Post 수)
+    atomic_store(&poster.running, false);
+    pthread_join(poster.thread, NULL);
+    usleep(5000);
+    FAS_StreamStop(&stream);
+    FAS_StreamGetStats(&stream, &st);
+
+    // 주기마다 하나씩, 다 보내면 스스로 끝남 → 그대로 다시 시작
+    for (int i = 0; i < BENCH_STREAM_SETPOINTS; i++)
+        setpoints[i] = 20000 + i;
+    FAS_StreamSetBuffer(&stream, setpoints, BENCH_STREAM_SETPOINTS);
+    bool restarted = true;
+    for (int k = 0; k < 2; k++) {
+        memset(&run[k], 0, sizeof(run[k]));
+        if (!FAS_StreamStart(&stream)) {
+            restarted = false;
+            break;
+        }
+        uint64_t t0 = FAS_MonotonicUs();
+        while (FAS_StreamIsRunning(&stream) && FAS_MonotonicUs() - t0 < 5000000u)
+            usleep(1000);
+        FAS_StreamGetStats(&stream, &run[k]);
+    }
+    FAS_StreamStop(&stream);
+
+    // 손실 없는 loopback이라 nack/송신 오류는 없어야 하고, 응답은 늦게 온 마지막 한두 개만 빼고 모두 짝이 맞아야 함
+    // 건너뛴 주기는 5% 이하 (host가 thread를 수십 ms 멈추면 한 번에 그만큼 건너뜀)
+    bool post_ok = st.frames_sent + st.superseded == poster.posts && st.send_errors == 0 && st.nacks == 0
+                   && st.rtt_count == st.acks && st.acks + 2 >= st.frames_sent && st.missed_ticks * 20 <= st.ticks;
+    bool buffer_ok = restarted;
+    for (int k = 0; k < 2 && restarted; k++)
+        buffer_ok &= run[k].frames_sent + run[k].dropped == BENCH_STREAM_SETPOINTS;
+    printf("stream (1 kHz velocity override, %d ms, FAS_StreamPost every %d us): ticks %" PRIu64 " missed %" PRIu64
+           ", jitter mean %.1f max %.1f us\n", BENCH_STREAM_MS, BENCH_STREAM_POST_US, st.ticks, st.missed_ticks,
+           st.ticks ? st.jitter_sum_ns / 1000.0 / st.ticks : 0.0, st.jitter_max_ns / 1000.0);
+    bench_report(post_ok, "  posted %" PRIu64 ": sent %" PRIu64 " superseded %" PRIu64 ", ack %" PRIu64 " nack %" PRIu64
+                 ", rtt mean %.1f max %" PRIu64 " us", poster.posts, st.frames_sent, st.superseded, st.acks, st.nacks,
+                 st.rtt_count ? (double)st.rtt_sum_us / st.rtt_count : 0.0, st.rtt_max_us);
+    bench_report(buffer_ok, "  buffer %d setpoints, run twice (restart after it ends by itself): sent %" PRIu64 "/%" PRIu64
+                 ", dropped %" PRIu64 "/%" PRIu64 "%s", BENCH_STREAM_SETPOINTS, run[0].frames_sent, run[1].frames_sent,
+                 run[0].dropped, run[1].dropped, restarted ? "" : ", restart failed");
+    ok = post_ok && buffer_ok;
+
+out:
+    FAS_LinkClose(&link);
+    FAS_StandInStop(&drive);
+    return ok;
+}
+
+// 가짜 드라이브 2대: 전체 읽기, 보드 0은 3개 / 보드 1은 1개만 바꿔 쓰기 (하나는 같은 값), ROM 저장, 파일 왕복, CRC 깨진 파일
+static bool bench_param(uint32_t delay_us){
+    static FAS_STANDIN drives[2];
+    static FAS_LINK links[2];
+    static FAS_PARAM_CACHE caches[2], loaded[2];
+    static const int changes[2][3] = { { 3, 17, 35 }, { 8, -1, -1 } };
+    const char *path = "/tmp/fas_bench_param.fcp";
+    FAS_BATCH_OPTION option = { .window = BENCH_LIST_WINDOW };
+    char ip[2][16];
+    bool ok = false;
+    if (!bench_standins_start(drives, 2, 170, delay_us, ip))
+        return bench_report(false, "param round trip: stand-in start failed");
+    int opened = 0;
+    for (; opened < 2; opened++) {
+        if (!FAS_LinkOpen(&links[opened], BENCH_PARAM_BOARD + opened, ip[opened], false)) {
+            bench_report(false, "param round trip: open failed");
+            goto out;
+        }
+        FAS_ParamCacheInit(&caches[opened], BENCH_PARAM_BOARD + opened, 0);
+    }
+
+    int read_failed = FAS_ParamReadAll(links, caches, 2, &option);
+    bool read_ok = read_failed == 0;
+    for (int b = 0; b < 2; b++)
+        read_ok &= caches[b].valid == (1ull << FAS_PARAM_COUNT) - 1 && caches[b].value[7] == drives[b].param[7];
+
+    // 바꾼 번호만 한 번씩 가야 함, 드라이브에 있는 값과 같은 값을 넣은 번호는 보내지 않음
+    uint64_t expect[2] = { 0, 0 };
+    for (int b = 0; b < 2; b++) {
+        for (int k = 0; k < 3 && changes[b][k] >= 0; k++) {
+            FAS_ParamSet(&caches[b], changes[b][k], 100000 + b * 100 + k);
+            expect[b] |= 1ull << changes[b][k];
+        }
+    }
+    FAS_ParamSet(&caches[1], 20, drives[1].param[20]);
+    int write_failed = FAS_ParamWriteDirty(links, caches, 2, &option);
+    int again_failed = FAS_ParamWriteDirty(links, caches, 2, &option);
+    bool write_ok = write_failed == 0 && again_failed == 0;
+    for (int b = 0; b < 2; b++) {
+        write_ok &= drives[b].param_written == expect[b] && drives[b].param_writes == (uint64_t)__builtin_popcountll(expect[b])
+                    && caches[b].dirty == 0 && caches[b].rom_dirty;
+        for (int k = 0; k < 3 && changes[b][k] >= 0; k++)
+            write_ok &= drives[b].param[changes[b][k]] == 100000 + b * 100 + k;
+    }
+
+    // 보드마다 한 번, 다시 불러도 rom_dirty가 없으므로 보내지 않음
+    int save_failed = FAS_ParamSaveToROM(links, caches, 2, &option);
+    save_failed += FAS_ParamSaveToROM(links, caches, 2, &option);
+    bool save_ok = save_failed == 0 && drives[0].param_rom_saves == 1 && drives[1].param_rom_saves == 1
+                   && !caches[0].rom_dirty && !caches[1].rom_dirty;
+
+    // 파일 왕복: 빈 cache에 불러오면 값과 번호가 모두 같아야 함
+    bool file_ok = FAS_ParamExport(path, caches, 2);
+    for (int b = 0; b < 2; b++)
+        FAS_ParamCacheInit(&loaded[b], BENCH_PARAM_BOARD + b, 0);
+    file_ok &= FAS_ParamImport(path, loaded, 2) == 2;
+    for (int b = 0; b < 2; b++)
+        file_ok &= loaded[b].dirty == caches[b].valid
+                   && memcmp(loaded[b].value, caches[b].value, sizeof(caches[b].value[0]) * FAS_PARAM_COUNT) == 0;
+
+    // 값 한 byte를 바꾼 파일은 CRC에서 걸러지고 cache는 그대로여야 함
+    bool crc_ok = false;
+    FILE *fp = fopen(path, "r+b");
+    if (fp != NULL) {
+        int c;
+        fseek(fp, 8 + 12 + 4 * 7, SEEK_SET);
+        c = fgetc(fp);
+        fseek(fp, 8 + 12 + 4 * 7, SEEK_SET);
+        fputc(c ^ 0x01, fp);
+        fclose(fp);
+        FAS_ParamCacheInit(&loaded[0], BENCH_PARAM_BOARD, 0);
+        crc_ok = FAS_ParamImport(path, loaded, 1) == -1 && loaded[0].dirty == 0;
+    }
+    unlink(path);
+
+    ok = bench_report(read_ok && write_ok && save_ok && file_ok && crc_ok,
+                      "param round trip (2 boards x %d): read %s, wrote %" PRIu64 "+%" PRIu64 " (%s), "
+                      "ROM saves %" PRIu64 "/%" PRIu64 ", export/import %s, bad CRC %s",
+                      FAS_PARAM_COUNT, read_ok ? "ok" : "wrong", drives[0].param_writes, drives[1].param_writes,
+                      write_ok ? "changed only, dirty cleared" : "wrong", drives[0].param_rom_saves, drives[1].param_rom_saves,
+                      file_ok ? "lossless" : "differs", crc_ok ? "rejected" : "accepted");
+
+out:
+    for (int b = 0; b < opened; b++)
+        FAS_LinkClose(&links[b]);
+    bench_standins_stop(drives, 2);
+    return ok;
+}
+
+// 0x43 크기 프레임 조립 + 분해 BENCH_CODEC_FRAMES번 (ENCODE/DECODE는 frame, i, data, view를 쓰는 식)
+#define BENCH_CODEC_LOOP(ENCODE, DECODE)                                        \
+    for (int i = 0; i < BENCH_CODEC_FRAMES; i++) {                              \
+        data[0] = (BYTE)i;                                                      \
+        int len = (ENCODE);                                                     \
+        ok += (DECODE) && view.status == (BYTE)i;                               \
+    }
+
+/**@brief bench_codec 한 바퀴
+  * @param int variant 0 generic, 1 inline, 2 hot path, 3 함수 pointer
+  * @return 프레임당 ns, 분해 결과가 하나라도 틀리면 음수*/
+static double bench_codec_round(int variant, const FAS_CODEC *codec, BYTE *data, int data_len){
+    // Header와 codec은 volatile로 읽어서 compiler가 상수로 접지 못하게 함 (실제 연결처럼 실행 중에 정해짐)
+    volatile BYTE header_var = FRAME_HEADER;
+    const FAS_CODEC *volatile codec_var = codec;
+    BYTE header = header_var, frame[BUFFER_SIZE];
+    const FAS_CODEC *c = codec_var;
+    FAS_FRAME_VIEW view;
+    uint64_t ok = 0, t0 = FAS_MonotonicUs();
+    switch (variant) {
+        case 0:
+            BENCH_CODEC_LOOP(bench_generic_build(frame, header, (BYTE)i, FRAME_GETALLSTATUS, data, data_len),
+                             bench_generic_decode(header, frame, len, &view));
+            break;
+        case 1:
+            BENCH_CODEC_LOOP(FAS_FastechEncode(frame, (BYTE)i, FRAME_GETALLSTATUS, data, data_len),
+                             FAS_FastechDecode(frame, len, &view));
+            break;
+        case 2:
+            BENCH_CODEC_LOOP(FAS_CodecEncode(c, frame, (BYTE)i, FRAME_GETALLSTATUS, data, data_len),
+                             FAS_CodecDecode(c, frame, len, &view));
+            break;
+        default:
+            BENCH_CODEC_LOOP(c->encode(frame, (BYTE)i, FRAME_GETALLSTATUS, data, data_len),
+                             c->decode(frame, len, &view));
+            break;
+    }
+    double ns = (FAS_MonotonicUs() - t0) * 1000.0 / BENCH_CODEC_FRAMES;
+    return ok == BENCH_CODEC_FRAMES ? ns : -1;
+}
+
+// 0x43 크기 프레임을 조립하고 다시 나누기, 변형마다 ns/frame (다섯 바퀴 중 가장 빠른 값)
+// Header가 상수인 inline 판은 Header를 변수로 받는 예전 방식보다 빨라야 함
+// (hot path는 codec 비교 한 번만큼 inline 판보다 느리고 예전 방식과는 비슷함, 함수 pointer보다는 빠름)
+static bool bench_codec(void){
+    static const struct { const char *name; int variant; const FAS_CODEC *codec; } cases[] = {
+        { "generic", 0, &FAS_CodecFastech },
+        { "fastech inline", 1, &FAS_CodecFastech },
+        { "fastech hot path", 2, &FAS_CodecFastech },
+        { "fastech pointer", 3, &FAS_CodecFastech },
+        { "user pointer", 3, &FAS_CodecUser },
+        { "serial pointer", 3, &FAS_CodecSerial },
+    };
+    enum { CASES = sizeof(cases) / sizeof(cases[0]) };
+    BYTE data[FAS_ALL_STATUS_SIZE + 1];
+    double ns[CASES];
+    bool decoded = true;
+    for (int i = 0; i < (int)sizeof(data); i++)
+        data[i] = (BYTE)(i * 37);
+
+    for (int c = 0; c < CASES; c++) {
+        ns[c] = 0;
+        for (int round = 0; round < 5; round++) {
+            double t = bench_codec_round(cases[c].variant, cases[c].codec, data, sizeof(data));
+            decoded &= t >= 0;
+            if (round == 0 || t < ns[c])
+                ns[c] = t;
+        }
+    }
+
+    printf("codec (%d-byte data):", (int)sizeof(data));
+    for (int c = 0; c < CASES; c++)
+        printf(" %s %.1f ns%s", cases[c].name, ns[c], c == CASES - 1 ? "" : ",");
+    bool faster = ns[1] < ns[0];
+
+    // Length byte(data + 3)가 255를 넘는 data는 조립하지 않아야 함 (serial은 DATA_SIZE까지)
+    static BYTE big[DATA_SIZE], frame[BUFFER_SIZE];
+    bool bounded = FAS_CodecEncode(&FAS_CodecFastech, frame, 0, FRAME_GETALLSTATUS, big, DATA_SIZE - 1) == DATA_SIZE - 1 + FRAME_HEADER_SIZE
+                   && FAS_CodecEncode(&FAS_CodecFastech, frame, 0, FRAME_GETALLSTATUS, big, DATA_SIZE) < 0
+                   && FAS_CodecUser.encode(frame, 0, FRAME_GETALLSTATUS, big, DATA_SIZE) < 0;
+    return bench_report(decoded && faster && bounded, "; decode %s, inline %s than generic, %d-byte data %s",
+                        decoded ? "ok" : "mismatch", faster ? "faster" : "not faster",
+                        DATA_SIZE, bounded ? "rejected" : "encoded");
+}
+
+static double bench_run(BENCH_WORKER *workers, int threads, int requests, int *failed){
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, threads + 1);
+    for (int i = 0; i < threads; i++) {
+        workers[i].requests = requests;
+        workers[i].failed = 0;
+        workers[i].start = &start;
+        pthread_create(&workers[i].thread, NULL, bench_worker_main, &workers[i]);
+    }
+
+    pthread_barrier_wait(&start);
+    uint64_t t0 = FAS_MonotonicUs();
+    *failed = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        *failed += workers[i].failed;
+    }
+    uint64_t elapsed = FAS_MonotonicUs() - t0;
+    pthread_barrier_destroy(&start);
+    return (double)threads * requests / (elapsed / 1e6);
+}
+
+int main(int argc, char *argv[]){
+    int requests = 2000, max_threads = BENCH_MAX_THREADS;
+    uint32_t delay_us = 200;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:t:")) != -1) {
+        switch (opt) {
+            case 'n': requests = atoi(optarg); break;
+            case 'd': delay_us = (uint32_t)atoi(optarg); break;
+            case 't': max_threads = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-n requests] [-d delay_us] [-t threads]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (max_threads < 1 || max_threads > BENCH_MAX_THREADS)
+        max_threads = BENCH_MAX_THREADS;
+
+    FAS_MetricsInit(NULL);
+    static FAS_STANDIN drives[BENCH_MAX_THREADS];
+    static BENCH_WORKER workers[BENCH_MAX_THREADS];
+    char ip[BENCH_MAX_THREADS][16];
+    if (!bench_standins_start(drives, max_threads, 11, delay_us, ip))
+        return 1;
+    for (int i = 0; i < max_threads; i++) {
+        FAS_ContextInit(&workers[i].ctx, i);
+        if (!FAS_ContextOpen(&workers[i].ctx, ip[i], false))
+            return 1;
+    }
+
+    printf("requests/thread %d, stand-in delay %u us\n", requests, delay_us);
+    printf("%8s %14s %10s %8s\n", "threads", "requests/s", "speedup", "failed");
+    double base = 0;
+    int failures = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        int failed;
+        double rate = bench_run(workers, threads, requests, &failed);
+        if (threads == 1)
+            base = rate;
+        failures += !bench_report(failed == 0, "%8d %14.0f %9.2fx %8d", threads, rate, rate / base, failed);
+    }
+
+    // 측정마다 통과/실패, 하나라도 실패하면 종료 코드 1
+    failures += !bench_shards(max_threads, delay_us);
+    failures += !bench_fault(delay_us);
+    failures += !bench_estop(delay_us);
+    failures += !bench_coalesce(delay_us);
+    failures += !bench_priority(delay_us);
+    failures += !bench_list(delay_us);
+    failures += !bench_timestamps(delay_us);
+    failures += !bench_broker(delay_us);
+    failures += !bench_postable(delay_us);
+    failures += !bench_param(delay_us);
+    failures += !bench_stream(delay_us);
+    failures += !bench_script(delay_us);
+    failures += !bench_poll(delay_us);
+    failures += !bench_frame_edit(requests);
+    failures += !bench_scope();
+    failures += !bench_axis_status();
+    failures += !bench_codec();
+    failures += !bench_telemetry();
+    failures += !bench_pcap();
+
+    // 데워진 뒤 할당 없는지 확인
+    int failed = 0, alloc_requests = requests / 10 > 0 ? requests / 10 : 1;
+    uint64_t steady_allocs = 0;
+    for (int i = 0; i < max_threads; i++) {
+        workers[i].requests = alloc_requests;
+        workers[i].failed = 0;
+        pthread_create(&workers[i].thread, NULL, bench_alloc_main, &workers[i]);
+    }
+    for (int i = 0; i < max_threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        failed += workers[i].failed;
+        steady_allocs += workers[i].steady_allocs;
+    }
+    failures += !bench_report(steady_allocs == 0 && failed == 0,
+                              "steady-state heap allocations: %" PRIu64 " (%d exchanges x %d threads, failed %d)",
+                              steady_allocs, alloc_requests, max_threads, failed);
+
+    for (int i = 0; i < max_threads; i++)
+        FAS_ContextClose(&workers[i].ctx);
+    bench_standins_stop(drives, max_threads);
+    FAS_MetricsShutdown();
+    if (failures > 0)
+        printf("%d bench check(s) failed\n", failures);
+    return failures == 0 ? 0 : 1;
+}
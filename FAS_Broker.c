@@ -0,0 +1,783 @@
+/**
+ * @file FAS_Broker.c
+ * @brief 명령 broker (client마다 memfd 공유메모리 SQ/CQ, eventfd 깨우기, client 돌아가며 꺼내기, 보드별 Sync No. 매칭)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "FAS_Broker.h"
+#include "FAS_Trace.h"
+
+#define SLOT_MASK (FAS_BROKER_SLOTS - 1)
+#define BROKER_EVENTS 64
+
+// epoll data: 위 32bit는 종류, 아래 32bit는 client/보드 번호
+#define EV_LISTEN (1ull << 32)
+#define EV_STOP (2ull << 32)
+#define EV_SOCK (3ull << 32)
+#define EV_SUBMIT (4ull << 32)
+#define EV_BOARD (5ull << 32)
+
+/**@brief 연결할 때 broker가 fd 세 개(memfd, submit eventfd, complete eventfd)와 같이 보내는 내용*/
+typedef struct _BROKER_HELLO
+{
+	uint32_t magic;
+	uint32_t version;
+	int32_t index;				// client 번호, 자리가 없으면 -1 (fd 없음)
+	uint32_t size;				// sizeof(FAS_BROKER_REGION)
+} BROKER_HELLO;
+
+/**@brief broker가 연 보드 하나 (broker thread 전용)*/
+typedef struct _FAS_BROKER_BOARD
+{
+	FAS_LINK link;
+	int inflight;
+	int16_t slot_peer[256];		// Sync No. -> client 번호, 비어 있으면 -1
+	uint16_t slot_index[256];	// Sync No. -> client 영역의 slot 번호
+	uint64_t slot_sent[256];
+	uint32_t slot_key[256];		// Sync No. -> 송신 timestamp 번호
+	BYTE active[256];
+	int active_count;
+} FAS_BROKER_BOARD;
+
+/**@brief FAS_LinkReceive handler에 넘기는 상태*/
+typedef struct _BROKER_RX
+{
+	FAS_BROKER *broker;
+	FAS_BROKER_BOARD *bd;
+} BROKER_RX;
+
+static inline void stat_add(_Atomic uint64_t *v, uint64_t n){
+    atomic_fetch_add_explicit(v, n, memory_order_relaxed);
+}
+
+static void event_signal(int fd){
+    uint64_t one = 1;
+    if (write(fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        perror("broker eventfd write failed");
+}
+
+static void event_drain(int fd){
+    uint64_t v;
+    while (read(fd, &v, sizeof(v)) > 0)
+        ;
+}
+
+/************************************************************************************************************************************
+ ************************************************** client 관리 (broker thread 전용) ************************************************
+ ************************************************************************************************************************************/
+
+static void peer_free(FAS_BROKER *b, int index){
+    FAS_BROKER_PEER *p = &b->peer[index];
+    munmap(p->region, sizeof(FAS_BROKER_REGION));
+    close(p->complete_fd);
+    memset(p, 0, sizeof(*p));
+}
+
+/**@brief 연결이 끊긴 client 정리, 보드에 보내 둔 요청이 남아 있으면 그 응답이 끝난 뒤에 영역을 거둠*/
+static void peer_close(FAS_BROKER *b, int index){
+    FAS_BROKER_PEER *p = &b->peer[index];
+    if (!p->alive)
+        return;
+    epoll_ctl(b->epfd, EPOLL_CTL_DEL, p->sock, NULL);
+    epoll_ctl(b->epfd, EPOLL_CTL_DEL, p->submit_fd, NULL);
+    close(p->sock);
+    close(p->submit_fd);
+    p->alive = false;
+    atomic_fetch_sub_explicit(&b->clients, 1, memory_order_relaxed);
+    if (p->inflight == 0)
+        peer_free(b, index);
+}
+
+static void peer_accept(FAS_BROKER *b){
+    int sock = accept4(b->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (sock < 0)
+        return;
+
+    BROKER_HELLO hello = { FAS_BROKER_MAGIC, FAS_BROKER_VERSION, -1, sizeof(FAS_BROKER_REGION) };
+    int index = -1;
+    for (int i = 0; i < FAS_BROKER_CLIENTS; i++) {
+        if (!b->peer[i].used) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        send(sock, &hello, sizeof(hello), MSG_NOSIGNAL);
+        close(sock);
+        return;
+    }
+
+    int mfd = memfd_create("fastech_broker", MFD_CLOEXEC);
+    int submit_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int complete_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    FAS_BROKER_REGION *region = MAP_FAILED;
+    if (mfd >= 0 && ftruncate(mfd, sizeof(FAS_BROKER_REGION)) == 0)
+        region = mmap(NULL, sizeof(FAS_BROKER_REGION), PROT_READ | PROT_WRITE, MAP_SHARED, mfd, 0);
+    if (region == MAP_FAILED || submit_fd < 0 || complete_fd < 0) {
+        perror("broker client region failed");
+        goto fail;
+    }
+    region->magic = FAS_BROKER_MAGIC;
+    region->version = FAS_BROKER_VERSION;
+    region->slots = FAS_BROKER_SLOTS;
+    region->size = sizeof(FAS_BROKER_REGION);
+
+    // handshake: 영역과 eventfd를 SCM_RIGHTS로 넘김
+    int fds[3] = { mfd, submit_fd, complete_fd };
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct iovec iov = { &hello, sizeof(hello) };
+    struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1, .msg_control = control, .msg_controllen = sizeof(control) };
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    hello.index = index;
+    if (sendmsg(sock, &msg, MSG_NOSIGNAL) != sizeof(hello)) {
+        perror("broker handshake failed");
+        goto fail;
+    }
+    close(mfd);
+
+    FAS_BROKER_PEER *p = &b->peer[index];
+    memset(p, 0, sizeof(*p));
+    p->used = true;
+    p->alive = true;
+    p->sock = sock;
+    p->submit_fd = submit_fd;
+    p->complete_fd = complete_fd;
+    p->region = region;
+
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP, .data.u64 = EV_SOCK | (uint64_t)index };
+    epoll_ctl(b->epfd, EPOLL_CTL_ADD, sock, &ev);
+    ev.events = EPOLLIN;
+    ev.data.u64 = EV_SUBMIT | (uint64_t)index;
+    epoll_ctl(b->epfd, EPOLL_CTL_ADD, submit_fd, &ev);
+    atomic_fetch_add_explicit(&b->clients, 1, memory_order_relaxed);
+    return;
+
+fail:
+    if (region != MAP_FAILED)
+        munmap(region, sizeof(FAS_BROKER_REGION));
+    if (mfd >= 0)
+        close(mfd);
+    if (submit_fd >= 0)
+        close(submit_fd);
+    if (complete_fd >= 0)
+        close(complete_fd);
+    close(sock);
+}
+
+/************************************************************************************************************************************
+ ************************************************** 송수신 (broker thread 전용) *****************************************************
+ ************************************************************************************************************************************/
+
+/**@brief slot을 CQ에 넣어 client에 돌려줌 (깨우기는 바퀴 끝에 client마다 한 번)*/
+static void slot_complete(FAS_BROKER *b, int peer, int index, FMM_ERROR status){
+    FAS_BROKER_PEER *p = &b->peer[peer];
+    FAS_BROKER_REGION *r = p->region;
+    FAS_BROKER_SLOT *s = &r->slot[index];
+
+    s->status = status;
+    stat_add(&r->stats.completed, 1);
+    if (status != FMM_OK)
+        stat_add(&r->stats.failed, 1);
+    if (status == FMC_TIMEOUT_ERROR)
+        stat_add(&r->stats.timeouts, 1);
+    if (!p->alive) {
+        if (p->inflight == 0)
+            peer_free(b, peer);
+        return;
+    }
+    // SQ와 CQ 크기가 slot 수와 같으므로 CQ는 넘치지 않음
+    uint32_t tail = atomic_load_explicit(&r->cq.tail, memory_order_relaxed);
+    r->cq.index[tail & SLOT_MASK] = (uint16_t)index;
+    atomic_store_explicit(&r->cq.tail, tail + 1, memory_order_release);
+    p->need_wake = true;
+}
+
+static void board_remove(FAS_BROKER_BOARD *bd, BYTE sync){
+    for (int i = 0; i < bd->active_count; i++) {
+        if (bd->active[i] == sync) {
+            bd->active[i] = bd->active[--bd->active_count];
+            break;
+        }
+    }
+    bd->slot_peer[sync] = -1;
+    bd->inflight--;
+}
+
+static bool board_send(FAS_BROKER *b, FAS_BROKER_BOARD *bd, int peer, int index){
+    FAS_BROKER_SLOT *s = &b->peer[peer].region->slot[index];
+    FAS_LINK *link = &bd->link;
+    BYTE frame[BUFFER_SIZE];
+
+    // Sync No.가 없는 codec은 Slave ID로 짝을 맞춤 (peer_ready가 window를 1로 막아 겹치지 않음)
+    BYTE sync = (BYTE)link->iBdID;
+    if (link->codec->sync) {
+        while (bd->slot_peer[link->sync_no] >= 0)
+            link->sync_no++;
+        sync = link->sync_no++;
+    }
+
+    // slot은 client와 같이 보는 메모리이므로 길이는 여기서 한 번 더 막음
+    int data_len = s->data_len > DATA_SIZE ? DATA_SIZE : s->data_len;
+    int len = FAS_CodecEncode(link->codec, frame, sync, s->frame_type, s->data, data_len);
+    FAS_TRACE(FAS_TRACE_BUILD, link->iBdID, sync, s->frame_type);
+    if (len < 0 || FAS_LinkSendFrame(link, frame, len) < 0)
+        return false;
+    FAS_TRACE(FAS_TRACE_SEND, link->iBdID, sync, len);
+    FAS_MetricsSent(link->iBdID, len);
+    stat_add(&b->sent, 1);
+
+    bd->slot_peer[sync] = (int16_t)peer;
+    bd->slot_index[sync] = (uint16_t)index;
+    bd->slot_sent[sync] = FAS_MonotonicUs();
+    bd->slot_key[sync] = link->tx_last;
+    bd->active[bd->active_count++] = sync;
+    bd->inflight++;
+    return true;
+}
+
+static void frame_received(const BYTE *frame, int len, void *user){
+    BROKER_RX *rx = user;
+    FAS_BROKER *b = rx->broker;
+    FAS_BROKER_BOARD *bd = rx->bd;
+    FAS_FRAME_VIEW view;
+    if (!FAS_LinkDecode(&bd->link, frame, len, &view))
+        return;
+    BYTE sync = view.sync;
+    FAS_TRACE(FAS_TRACE_RECV, bd->link.iBdID, sync, len);
+
+    int peer = bd->slot_peer[sync];
+    if (peer < 0 || b->peer[peer].region->slot[bd->slot_index[sync]].frame_type != view.frame_type) {
+        stat_add(&b->stale, 1);
+        return;
+    }
+    int index = bd->slot_index[sync];
+    FAS_BROKER_PEER *p = &b->peer[peer];
+    FAS_BROKER_SLOT *s = &p->region->slot[index];
+    uint64_t rtt = FAS_MonotonicUs() - bd->slot_sent[sync];
+    board_remove(bd, sync);
+    p->inflight--;
+
+    s->wire_us = (uint32_t)rtt;
+    FAS_TS_SOURCE source = FAS_LinkWireUs(&bd->link, bd->slot_key[sync], &s->wire_us);
+    s->resp_len = (BYTE)(view.data_len > DATA_SIZE ? DATA_SIZE : view.data_len);
+    memcpy(s->resp, view.data, s->resp_len);
+    s->rtt_us = (uint32_t)rtt;
+    FAS_TRACE(FAS_TRACE_MATCH, bd->link.iBdID, sync, rtt);
+    FAS_MetricsReceived(bd->link.iBdID, len, (FMM_ERROR)view.status, rtt);
+    if (source != FAS_TS_NONE)
+        FAS_MetricsWire(bd->link.iBdID, s->wire_us, rtt);
+    stat_add(&p->region->stats.rtt_us_sum, rtt);
+    stat_add(&b->received, 1);
+    slot_complete(b, peer, index, (FMM_ERROR)view.status);
+}
+
+/**@brief SQ 맨 앞 요청을 지금 처리할 수 있는지 (보드 window에 자리가 있거나 모르는 보드)*/
+static bool peer_ready(FAS_BROKER *b, FAS_BROKER_PEER *p){
+    FAS_BROKER_REGION *r = p->region;
+    if (p->sq_head == atomic_load_explicit(&r->sq.tail, memory_order_acquire))
+        return false;
+    int board = r->slot[r->sq.index[p->sq_head & SLOT_MASK] & SLOT_MASK].board;
+    if (board < 0 || board >= FAS_MAX_BOARD || b->board[board] == NULL)
+        return true;
+    FAS_BROKER_BOARD *bd = b->board[board];
+    return bd->inflight < (bd->link.codec->sync ? b->option.window : 1);
+}
+
+/**@brief client를 돌아가며 한 바퀴에 quantum개씩 꺼내서 보드에 보냄, 더 꺼낼 것이 없을 때까지 반복*/
+static void broker_pump(FAS_BROKER *b){
+    bool progress = true;
+    int next = b->rr;
+    while (progress) {
+        progress = false;
+        for (int n = 0; n < FAS_BROKER_CLIENTS; n++) {
+            int i = (b->rr + n) % FAS_BROKER_CLIENTS;
+            FAS_BROKER_PEER *p = &b->peer[i];
+            if (!p->alive)
+                continue;
+            FAS_BROKER_REGION *r = p->region;
+            // 같은 client의 요청 순서를 지키기 위해 맨 앞 요청이 막히면 그 client는 이번 바퀴를 넘김
+            for (int q = 0; q < b->option.quantum && peer_ready(b, p); q++) {
+                int index = r->sq.index[p->sq_head & SLOT_MASK] & SLOT_MASK;
+                FAS_BROKER_SLOT *s = &r->slot[index];
+                p->sq_head++;
+                atomic_store_explicit(&r->sq.head, p->sq_head, memory_order_release);
+                progress = true;
+                next = (i + 1) % FAS_BROKER_CLIENTS;
+
+                uint64_t now = FAS_MonotonicUs();
+                s->queue_us = now > s->submit_us ? (uint32_t)(now - s->submit_us) : 0;
+                s->retries = 0;
+                s->resp_len = 0;
+                s->rtt_us = s->wire_us = 0;
+                stat_add(&r->stats.queue_us_sum, s->queue_us);
+                if (s->board < 0 || s->board >= FAS_MAX_BOARD || b->board[s->board] == NULL) {
+                    slot_complete(b, i, index, FMM_INVALID_SLAVE_NUM);
+                    continue;
+                }
+                p->inflight++;
+                if (!board_send(b, b->board[s->board], i, index)) {
+                    p->inflight--;
+                    slot_complete(b, i, index, FMC_DISCONNECTED);
+                }
+            }
+        }
+    }
+    // window가 한 칸씩 비는 동안에도 돌아가며 받도록 다음 pump는 마지막으로 꺼낸 client 다음부터
+    b->rr = next;
+}
+
+/**@brief 이번 바퀴에 완료가 생긴 client 중 기다리며 자는 client만 깨움*/
+static void broker_wake_clients(FAS_BROKER *b){
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = 0; i < FAS_BROKER_CLIENTS; i++) {
+        FAS_BROKER_PEER *p = &b->peer[i];
+        if (!p->need_wake)
+            continue;
+        p->need_wake = false;
+        if (p->alive && atomic_load_explicit(&p->region->client_waiting, memory_order_relaxed)) {
+            event_signal(p->complete_fd);
+            stat_add(&p->region->stats.wakeups, 1);
+        }
+    }
+}
+
+/**@brief 시간 초과된 요청 재전송/실패 처리
+  * @return 다음 시간 초과까지 ms (없으면 -1)*/
+static int broker_timeouts(FAS_BROKER *b){
+    uint64_t timeout_us = (uint64_t)b->option.timeout_ms * 1000;
+    uint64_t now = FAS_MonotonicUs(), deadline = UINT64_MAX;
+    for (int id = 0; id < FAS_MAX_BOARD; id++) {
+        FAS_BROKER_BOARD *bd = b->board[id];
+        if (bd == NULL)
+            continue;
+        for (int a = 0; a < bd->active_count; ) {
+            BYTE sync = bd->active[a];
+            if (now - bd->slot_sent[sync] < timeout_us) {
+                if (bd->slot_sent[sync] + timeout_us < deadline)
+                    deadline = bd->slot_sent[sync] + timeout_us;
+                a++;
+                continue;
+            }
+            int peer = bd->slot_peer[sync], index = bd->slot_index[sync];
+            FAS_BROKER_SLOT *s = &b->peer[peer].region->slot[index];
+            FAS_TRACE(FAS_TRACE_TIMEOUT, id, sync, s->retries);
+            FAS_MetricsTimeout(id);
+            board_remove(bd, sync);	// active[a] 자리에 마지막 항목이 옮겨 옴
+            if (s->retries < b->option.retries && b->peer[peer].alive) {
+                s->retries++;
+                if (board_send(b, bd, peer, index))
+                    continue;
+            }
+            b->peer[peer].inflight--;
+            slot_complete(b, peer, index, FMC_TIMEOUT_ERROR);
+        }
+    }
+    if (deadline == UINT64_MAX)
+        return -1;
+    return deadline <= now ? 0 : (int)((deadline - now + 999) / 1000);
+}
+
+/**@brief 잠들기 전에 client들에게 표시하고 SQ를 다시 봄 (표시와 client의 tail 저장 사이 경합은 seq_cst fence로 막음)
+  * @return 잠들어도 되면 TRUE*/
+static bool broker_prepare_sleep(FAS_BROKER *b, bool sleeping){
+    for (int i = 0; i < FAS_BROKER_CLIENTS; i++) {
+        if (b->peer[i].alive)
+            atomic_store_explicit(&b->peer[i].region->broker_sleeping, sleeping, memory_order_relaxed);
+    }
+    if (!sleeping)
+        return false;
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = 0; i < FAS_BROKER_CLIENTS; i++) {
+        if (b->peer[i].alive && peer_ready(b, &b->peer[i]))
+            return false;
+    }
+    return true;
+}
+
+static void *broker_thread_main(void *arg){
+    FAS_BROKER *b = arg;
+    struct epoll_event events[BROKER_EVENTS];
+
+    for (;;) {
+        broker_pump(b);
+        broker_wake_clients(b);
+        int wait_ms = broker_timeouts(b);
+        broker_wake_clients(b);
+        if (!broker_prepare_sleep(b, true))
+            wait_ms = 0;
+        int n = epoll_wait(b->epfd, events, BROKER_EVENTS, wait_ms);
+        broker_prepare_sleep(b, false);
+        if (n < 0 && errno != EINTR) {
+            perror("broker epoll_wait failed");
+            break;
+        }
+
+        for (int e = 0; e < n; e++) {
+            uint64_t kind = events[e].data.u64 & ~0xFFFFFFFFull;
+            int index = (int)(events[e].data.u64 & 0xFFFFFFFFu);
+            if (kind == EV_STOP)
+                return NULL;
+            if (kind == EV_LISTEN) {
+                peer_accept(b);
+            }
+            else if (kind == EV_SUBMIT) {
+                if (b->peer[index].alive)
+                    event_drain(b->peer[index].submit_fd);
+            }
+            else if (kind == EV_SOCK) {
+                // client는 socket에 아무것도 보내지 않으므로 읽을 것이 생기면 끊긴 것
+                char c;
+                if (b->peer[index].alive && recv(b->peer[index].sock, &c, 1, MSG_DONTWAIT) <= 0)
+                    peer_close(b, index);
+            }
+            else if (kind == EV_BOARD) {
+                FAS_BROKER_BOARD *bd = b->board[index];
+                BROKER_RX rx = { b, bd };
+                if (FAS_LinkReceive(&bd->link, frame_received, &rx) < 0) {
+                    fprintf(stderr, "broker: board %d disconnected\n", index);
+                    epoll_ctl(b->epfd, EPOLL_CTL_DEL, bd->link.fd, NULL);	// 남은 요청은 시간 초과로 정리
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+/************************************************************************************************************************************
+ ************************************************** broker API *********************************************************************
+ ************************************************************************************************************************************/
+
+ /**@brief broker 준비 (Unix socket 열기), 보드는 FAS_BrokerAddBoard로 넣고 FAS_BrokerStart로 시작
+  * @param const char *path Unix socket 경로 (NULL이면 FAS_BROKER_SOCK)
+  * @param const FAS_BROKER_OPTION *option NULL이면 기본값
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_BrokerInit(FAS_BROKER *broker, const char *path, const FAS_BROKER_OPTION *option){
+    memset(broker, 0, sizeof(*broker));
+    broker->listen_fd = broker->epfd = broker->stop_fd = -1;
+    if (option != NULL)
+        broker->option = *option;
+    if (broker->option.window <= 0)
+        broker->option.window = FAS_DEFAULT_WINDOW;
+    if (broker->option.window > FAS_WINDOW_MAX)
+        broker->option.window = FAS_WINDOW_MAX;
+    if (broker->option.timeout_ms <= 0)
+        broker->option.timeout_ms = FAS_DEFAULT_TIMEOUT_MS;
+    if (broker->option.retries <= 0)
+        broker->option.retries = FAS_DEFAULT_RETRIES;
+    if (broker->option.quantum <= 0)
+        broker->option.quantum = FAS_BROKER_QUANTUM;
+    if (path == NULL)
+        path = FAS_BROKER_SOCK;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path) || strlen(path) >= sizeof(broker->path))
+        return false;
+    strcpy(addr.sun_path, path);
+    strcpy(broker->path, path);
+
+    if ((broker->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
+        perror("Broker socket creation failed");
+        return false;
+    }
+    unlink(path);
+    if (bind(broker->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(broker->listen_fd, FAS_BROKER_CLIENTS) < 0) {
+        perror("Broker socket bind failed");
+        close(broker->listen_fd);
+        broker->listen_fd = -1;
+        return false;
+    }
+    broker->epfd = epoll_create1(EPOLL_CLOEXEC);
+    broker->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (broker->epfd < 0 || broker->stop_fd < 0) {
+        perror("Broker epoll creation failed");
+        FAS_BrokerStop(broker);
+        return false;
+    }
+    struct epoll_event ev = { .events = EPOLLIN, .data.u64 = EV_LISTEN };
+    epoll_ctl(broker->epfd, EPOLL_CTL_ADD, broker->listen_fd, &ev);
+    ev.data.u64 = EV_STOP;
+    epoll_ctl(broker->epfd, EPOLL_CTL_ADD, broker->stop_fd, &ev);
+    return true;
+}
+
+ /**@brief broker가 맡을 보드 연결 (FAS_BrokerStart 전에만)
+  * @param int iBdID 보드 번호 (client가 slot.board에 넣는 값)
+  * @param const char *ip 드라이브 주소
+  * @param bool tcp TRUE면 TCP, FALSE면 UDP
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_BrokerAddBoard(FAS_BROKER *broker, int iBdID, const char *ip, bool tcp){
+    if (broker->running || iBdID < 0 || iBdID >= FAS_MAX_BOARD || broker->board[iBdID] != NULL)
+        return false;
+    FAS_BROKER_BOARD *bd = calloc(1, sizeof(*bd));
+    if (bd == NULL)
+        return false;
+    if (!FAS_LinkOpen(&bd->link, iBdID, ip, tcp)) {
+        free(bd);
+        return false;
+    }
+    for (int s = 0; s < 256; s++)
+        bd->slot_peer[s] = -1;
+    struct epoll_event ev = { .events = EPOLLIN, .data.u64 = EV_BOARD | (uint64_t)iBdID };
+    epoll_ctl(broker->epfd, EPOLL_CTL_ADD, bd->link.fd, &ev);
+    broker->board[iBdID] = bd;
+    return true;
+}
+
+ /**@brief broker thread 시작
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_BrokerStart(FAS_BROKER *broker){
+    if (broker->running || broker->epfd < 0)
+        return false;
+    if (pthread_create(&broker->thread, NULL, broker_thread_main, broker) != 0)
+        return false;
+    broker->running = true;
+    return true;
+}
+
+ /**@brief broker thread를 멈추고 보드 연결, client 영역, socket을 모두 정리 (client에게는 연결 끊김으로 보임)*/
+void FAS_BrokerStop(FAS_BROKER *broker){
+    if (broker->running) {
+        event_signal(broker->stop_fd);
+        pthread_join(broker->thread, NULL);
+        broker->running = false;
+    }
+    for (int i = 0; i < FAS_BROKER_CLIENTS; i++) {
+        FAS_BROKER_PEER *p = &broker->peer[i];
+        if (!p->used)
+            continue;
+        if (p->alive) {
+            close(p->sock);
+            close(p->submit_fd);
+        }
+        peer_free(broker, i);
+    }
+    atomic_store(&broker->clients, 0);
+    for (int id = 0; id < FAS_MAX_BOARD; id++) {
+        if (broker->board[id] != NULL) {
+            FAS_LinkClose(&broker->board[id]->link);
+            free(broker->board[id]);
+            broker->board[id] = NULL;
+        }
+    }
+    if (broker->listen_fd >= 0) {
+        close(broker->listen_fd);
+        unlink(broker->path);
+    }
+    if (broker->epfd >= 0)
+        close(broker->epfd);
+    if (broker->stop_fd >= 0)
+        close(broker->stop_fd);
+    broker->listen_fd = broker->epfd = broker->stop_fd = -1;
+}
+
+ /**@brief 지금 붙어 있는 client 수 (아무 thread에서나)*/
+int FAS_BrokerClientCount(const FAS_BROKER *broker){
+    return atomic_load_explicit(&broker->clients, memory_order_relaxed);
+}
+
+/************************************************************************************************************************************
+ ************************************************** client API *********************************************************************
+ ************************************************************************************************************************************/
+
+ /**@brief broker에 붙어서 공유메모리 영역을 받음
+  * @param const char *path broker Unix socket 경로 (NULL이면 FAS_BROKER_SOCK)
+  * @return boolean 성공시 TRUE 실패시 FALSE (broker가 없거나 client 자리가 없음)*/
+bool FAS_BrokerConnect(FAS_BROKER_CLIENT *client, const char *path){
+    struct sockaddr_un addr;
+    memset(client, 0, sizeof(*client));
+    client->sock = client->submit_fd = client->complete_fd = -1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path == NULL)
+        path = FAS_BROKER_SOCK;
+    if (strlen(path) >= sizeof(addr.sun_path))
+        return false;
+    strcpy(addr.sun_path, path);
+
+    if ((client->sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+        return false;
+    if (connect(client->sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("Broker connect failed");
+        close(client->sock);
+        return false;
+    }
+
+    BROKER_HELLO hello;
+    int fds[3] = { -1, -1, -1 };
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct iovec iov = { &hello, sizeof(hello) };
+    struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1, .msg_control = control, .msg_controllen = sizeof(control) };
+    ssize_t n;
+    do {
+        n = recvmsg(client->sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    struct cmsghdr *cmsg = n == sizeof(hello) ? CMSG_FIRSTHDR(&msg) : NULL;
+    if (cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(fds)))
+        memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+
+    if (n != sizeof(hello) || hello.magic != FAS_BROKER_MAGIC || hello.version != FAS_BROKER_VERSION
+        || hello.size != sizeof(FAS_BROKER_REGION) || hello.index < 0 || fds[0] < 0) {
+        fprintf(stderr, "Broker handshake failed (%s)\n", n == sizeof(hello) && hello.index < 0 ? "no free client slot" : "version mismatch");
+        for (int i = 0; i < 3; i++)
+            if (fds[i] >= 0)
+                close(fds[i]);
+        close(client->sock);
+        client->sock = -1;
+        return false;
+    }
+
+    client->region = mmap(NULL, sizeof(FAS_BROKER_REGION), PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+    close(fds[0]);
+    client->submit_fd = fds[1];
+    client->complete_fd = fds[2];
+    client->index = hello.index;
+    if (client->region == MAP_FAILED) {
+        client->region = NULL;
+        FAS_BrokerDisconnect(client);
+        return false;
+    }
+    for (int i = 0; i < FAS_BROKER_SLOTS; i++)
+        client->free_slot[i] = (uint16_t)(FAS_BROKER_SLOTS - 1 - i);
+    client->free_count = FAS_BROKER_SLOTS;
+    return true;
+}
+
+ /**@brief broker 연결 끊기 (보내 둔 요청은 broker가 응답을 받은 뒤 버림)*/
+void FAS_BrokerDisconnect(FAS_BROKER_CLIENT *client){
+    if (client->region != NULL)
+        munmap(client->region, sizeof(FAS_BROKER_REGION));
+    if (client->sock >= 0)
+        close(client->sock);
+    if (client->submit_fd >= 0)
+        close(client->submit_fd);
+    if (client->complete_fd >= 0)
+        close(client->complete_fd);
+    client->region = NULL;
+    client->sock = client->submit_fd = client->complete_fd = -1;
+    client->free_count = 0;
+}
+
+ /**@brief 빈 요청 칸 하나 (공유메모리 안, 여기에 바로 요청을 씀)
+  * @return 빈 칸이 없으면 NULL (FAS_BrokerWait로 완료를 받아 FAS_BrokerRelease해야 생김)*/
+FAS_BROKER_SLOT *FAS_BrokerGetSlot(FAS_BROKER_CLIENT *client){
+    if (client->free_count == 0)
+        return NULL;
+    return &client->region->slot[client->free_slot[--client->free_count]];
+}
+
+ /**@brief 채운 칸을 broker에 넘김 (이후 FAS_BrokerWait로 돌아올 때까지 칸을 건드리지 않음)*/
+void FAS_BrokerSubmit(FAS_BROKER_CLIENT *client, FAS_BROKER_SLOT *slot){
+    FAS_BROKER_REGION *r = client->region;
+    slot->submit_us = FAS_MonotonicUs();
+    slot->status = FMM_UNKNOWN_ERROR;
+    uint32_t tail = atomic_load_explicit(&r->sq.tail, memory_order_relaxed);
+    r->sq.index[tail & SLOT_MASK] = (uint16_t)(slot - r->slot);
+    atomic_store_explicit(&r->sq.tail, tail + 1, memory_order_release);
+    atomic_fetch_add_explicit(&r->stats.submitted, 1, memory_order_relaxed);
+
+    // broker가 broker_sleeping을 올린 뒤 SQ를 다시 보므로, 둘 중 하나는 반드시 상대를 봄
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&r->broker_sleeping, memory_order_relaxed))
+        event_signal(client->submit_fd);
+}
+
+static FAS_BROKER_SLOT *cq_pop(FAS_BROKER_REGION *r){
+    uint32_t head = atomic_load_explicit(&r->cq.head, memory_order_relaxed);
+    if (head == atomic_load_explicit(&r->cq.tail, memory_order_acquire))
+        return NULL;
+    FAS_BROKER_SLOT *slot = &r->slot[r->cq.index[head & SLOT_MASK] & SLOT_MASK];
+    atomic_store_explicit(&r->cq.head, head + 1, memory_order_release);
+    return slot;
+}
+
+ /**@brief 완료된 요청 하나 받기 (완료 순서, 제출 순서와 다를 수 있음)
+  * @param int timeout_ms 0이면 기다리지 않음, 음수면 올 때까지
+  * @return 완료된 칸 (다 읽으면 FAS_BrokerRelease), 시간 초과나 broker 연결 끊김이면 NULL*/
+FAS_BROKER_SLOT *FAS_BrokerWait(FAS_BROKER_CLIENT *client, int timeout_ms){
+    FAS_BROKER_REGION *r = client->region;
+    FAS_BROKER_SLOT *slot = cq_pop(r);
+    if (slot != NULL || timeout_ms == 0)
+        return slot;
+
+    uint64_t deadline = timeout_ms > 0 ? FAS_MonotonicUs() + (uint64_t)timeout_ms * 1000 : UINT64_MAX;
+    for (;;) {
+        atomic_store_explicit(&r->client_waiting, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if ((slot = cq_pop(r)) != NULL)
+            break;
+
+        int wait_ms = -1;
+        if (deadline != UINT64_MAX) {
+            uint64_t now = FAS_MonotonicUs();
+            if (now >= deadline)
+                break;
+            wait_ms = (int)((deadline - now + 999) / 1000);
+        }
+        struct pollfd pfd[2] = { { client->complete_fd, POLLIN, 0 }, { client->sock, POLLIN | POLLRDHUP, 0 } };
+        int ready = poll(pfd, 2, wait_ms);
+        if (ready < 0 && errno != EINTR)
+            break;
+        if (pfd[0].revents & POLLIN)
+            event_drain(client->complete_fd);
+        if (pfd[1].revents & (POLLIN | POLLRDHUP | POLLHUP | POLLERR)) {
+            slot = cq_pop(r);	// broker가 끝나기 직전에 넣은 완료
+            break;
+        }
+    }
+    atomic_store_explicit(&r->client_waiting, 0, memory_order_relaxed);
+    return slot;
+}
+
+ /**@brief 다 읽은 칸을 빈 칸으로 돌려놓음*/
+void FAS_BrokerRelease(FAS_BROKER_CLIENT *client, FAS_BROKER_SLOT *slot){
+    client->free_slot[client->free_count++] = (uint16_t)(slot - client->region->slot);
+}
+
+ /**@brief 명령 하나를 보내고 응답까지 기다림 (이 client에 보내 둔 다른 요청이 없을 때만)
+  * @param BYTE *resp 응답 data (통신 상태 뒤), NULL 가능
+  * @param int *resp_len 응답 data 길이 (NULL 가능)
+  * @return 응답의 통신 상태, broker 연결이 끊기면 FMC_DISCONNECTED*/
+FMM_ERROR FAS_BrokerCommand(FAS_BROKER_CLIENT *client, int board, BYTE frame_type, const void *data, int data_len,
+                            BYTE *resp, int resp_size, int *resp_len){
+    if (data_len < 0 || data_len > DATA_SIZE)
+        return FMP_PACKETERROR;
+    FAS_BROKER_SLOT *slot = FAS_BrokerGetSlot(client);
+    if (slot == NULL)
+        return FMC_DISCONNECTED;
+    slot->board = board;
+    slot->frame_type = frame_type;
+    slot->data_len = (BYTE)data_len;
+    if (data_len > 0)
+        memcpy(slot->data, data, data_len);
+    FAS_BrokerSubmit(client, slot);
+
+    // broker가 시간 초과와 재전송을 맡으므로 완료는 반드시 옴 (끊기면 NULL)
+    FAS_BROKER_SLOT *done = FAS_BrokerWait(client, -1);
+    if (done == NULL)
+        return FMC_DISCONNECTED;
+    FMM_ERROR status = done->status;
+    int len = done->resp_len < resp_size ? done->resp_len : resp_size;
+    if (resp != NULL && len > 0)
+        memcpy(resp, done->resp, len);
+    if (resp_len != NULL)
+        *resp_len = done->resp_len;
+    FAS_BrokerRelease(client, done);
+    return status;
+}
@@ -0,0 +1,161 @@
+
+#pragma once
+
+#ifndef FAS_BROKER_DEFINE
+#define FAS_BROKER_DEFINE
+
+/**
+ * @file FAS_Broker.h
+ * @brief 드라이브 연결을 혼자 가지고 여러 local 프로세스(PLC 로직, HMI, data logger)의 요청을 대신 보내는 broker
+ * @details Plus-E의 TCP 연결은 한 프로세스만 가질 수 있으므로 broker(FAS_BrokerDaemon)가 모든 보드 연결을 열고,
+ * client는 Unix socket으로 한 번 붙어서 자기 전용 공유메모리 영역(memfd)과 eventfd 두 개를 받는다.
+ * 영역에는 요청/응답 칸(slot)과 SPSC ring 두 개(제출 SQ: client -> broker, 완료 CQ: broker -> client)가 있다.
+ * client는 빈 slot에 바로 요청을 쓰고 번호만 SQ에 넣으며, broker는 같은 slot에 응답을 써서 번호를 CQ에 넣는다 (복사 없음).
+ * 깨우기는 상대가 잠들었다고 표시했을 때만 eventfd에 쓰므로 바쁠 때는 syscall 없이 ring만으로 주고받는다.
+ * broker는 client를 돌아가며 한 번에 quantum개까지만 꺼내 보드 window에 넣어서, 한 client가 몰아 보내도
+ * 다른 client의 요청이 뒤로 밀리지 않는다. client마다 통계(제출, 완료, 실패, 대기/RTT 합)를 영역 안에 둔다.
+ * 한 client의 같은 보드 요청은 제출 순서대로 보낸다.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "Protocol_Define.h"
+#include "ReturnCodes_Define.h"
+#include "FAS_Pipeline.h"
+#include "FAS_Metrics.h"
+
+#define FAS_BROKER_SOCK "/tmp/fastech_broker.sock"	// 기본 Unix socket 경로
+#define FAS_BROKER_MAGIC 0x46415342			// "FASB"
+#define FAS_BROKER_VERSION 1
+#define FAS_BROKER_CLIENTS 16				// 동시에 붙는 client 수
+#define FAS_BROKER_SLOTS 64					// client마다 요청 칸 수 (2^n, 동시에 보내 둘 수 있는 요청 수)
+#define FAS_BROKER_QUANTUM 4				// 한 바퀴에 client 하나에서 꺼내는 요청 수
+
+/**@brief 요청 한 개와 그 응답 (client 영역 안, client가 쓰고 broker가 응답을 채움)*/
+typedef struct _FAS_BROKER_SLOT
+{
+	int board;					// 보드 번호 (broker에 등록한 iBdID)
+	BYTE frame_type;
+	BYTE data_len;
+	BYTE data[DATA_SIZE];
+	uint64_t submit_us;			// 제출 시각 (CLOCK_MONOTONIC, FAS_BrokerSubmit이 채움)
+	uint64_t user;				// client 임의 값 (그대로 돌아옴)
+
+	FMM_ERROR status;			// 응답의 통신 상태, 응답이 없으면 FMC_TIMEOUT_ERROR, 모르는 보드면 FMM_INVALID_SLAVE_NUM
+	BYTE resp_len;				// 통신 상태 뒤의 응답 data 길이
+	BYTE resp[DATA_SIZE];
+	BYTE retries;
+	uint32_t queue_us;			// 제출부터 broker가 소켓에 넘길 때까지
+	uint32_t rtt_us;			// 송신부터 응답까지
+	uint32_t wire_us;			// kernel timestamp 기준 드라이브 + 회선 (없으면 rtt_us)
+} FAS_BROKER_SLOT;
+
+/**@brief slot 번호를 넘기는 SPSC ring*/
+typedef struct _FAS_BROKER_RING
+{
+	_Alignas(FAS_CACHELINE) _Atomic uint32_t head;	// 소비자가 움직임
+	_Alignas(FAS_CACHELINE) _Atomic uint32_t tail;	// 생산자가 움직임
+	uint16_t index[FAS_BROKER_SLOTS];
+} FAS_BROKER_RING;
+
+/**@brief client 한 개의 통계 (broker가 relaxed로 더하고 누구나 읽음)*/
+typedef struct _FAS_BROKER_STATS
+{
+	_Atomic uint64_t submitted;
+	_Atomic uint64_t completed;
+	_Atomic uint64_t failed;		// FMM_OK가 아닌 응답, 시간 초과, 모르는 보드
+	_Atomic uint64_t timeouts;
+	_Atomic uint64_t queue_us_sum;	// 제출부터 송신까지 합 (client -> 소켓 overhead)
+	_Atomic uint64_t rtt_us_sum;
+	_Atomic uint64_t wakeups;		// broker가 이 client의 eventfd에 쓴 횟수
+} FAS_BROKER_STATS;
+
+/**@brief client 한 개의 공유메모리 영역 (memfd 하나, broker와 그 client만 map함)*/
+typedef struct _FAS_BROKER_REGION
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slots;
+	uint32_t size;					// sizeof(FAS_BROKER_REGION)
+	FAS_BROKER_RING sq;				// 제출 (client -> broker)
+	FAS_BROKER_RING cq;				// 완료 (broker -> client)
+	_Alignas(FAS_CACHELINE) _Atomic uint32_t broker_sleeping;	// broker가 epoll에서 자는 중 (client가 submit eventfd를 씀)
+	_Alignas(FAS_CACHELINE) _Atomic uint32_t client_waiting;	// client가 CQ를 기다리며 자는 중 (broker가 complete eventfd를 씀)
+	_Alignas(FAS_CACHELINE) FAS_BROKER_STATS stats;
+	FAS_BROKER_SLOT slot[FAS_BROKER_SLOTS];
+} FAS_BROKER_REGION;
+
+/**@brief client 쪽 연결 (프로세스 하나에 여러 개 가능, 하나는 thread 하나에서만 씀)*/
+typedef struct _FAS_BROKER_CLIENT
+{
+	int sock;						// broker와의 Unix socket (끊기면 broker가 영역을 거둠)
+	int submit_fd;					// eventfd: broker 깨우기
+	int complete_fd;				// eventfd: broker가 이 client 깨우기
+	int index;						// broker 안의 client 번호
+	FAS_BROKER_REGION *region;
+	int free_count;
+	uint16_t free_slot[FAS_BROKER_SLOTS];
+} FAS_BROKER_CLIENT;
+
+/**@brief FAS_BrokerInit 설정, 0인 항목은 기본값*/
+typedef struct _FAS_BROKER_OPTION
+{
+	int window;						// 보드당 동시에 보내 둘 요청 수 (기본 FAS_DEFAULT_WINDOW)
+	int timeout_ms;					// 기본 FAS_DEFAULT_TIMEOUT_MS
+	int retries;					// 기본 FAS_DEFAULT_RETRIES
+	int quantum;					// 기본 FAS_BROKER_QUANTUM
+} FAS_BROKER_OPTION;
+
+struct _FAS_BROKER_BOARD;
+
+/**@brief broker 쪽에서 본 client 하나 (broker thread 전용)*/
+typedef struct _FAS_BROKER_PEER
+{
+	bool used;
+	bool alive;						// FALSE면 연결은 끊겼고 보낸 요청의 응답만 기다림
+	int sock;
+	int submit_fd;
+	int complete_fd;
+	FAS_BROKER_REGION *region;
+	int inflight;					// 보드에 보내 둔 이 client 요청 수
+	uint32_t sq_head;				// 다음에 꺼낼 SQ 위치 (broker 사본)
+	bool need_wake;					// 이번 바퀴에 CQ에 넣음
+} FAS_BROKER_PEER;
+
+typedef struct _FAS_BROKER
+{
+	FAS_BROKER_OPTION option;
+	char path[108];
+	int listen_fd;
+	int epfd;
+	int stop_fd;					// eventfd: FAS_BrokerStop
+	pthread_t thread;
+	bool running;
+
+	struct _FAS_BROKER_BOARD *board[FAS_MAX_BOARD];	// 보드 번호 -> 연결 (없으면 NULL)
+	FAS_BROKER_PEER peer[FAS_BROKER_CLIENTS];
+	int rr;							// 다음 바퀴에 먼저 볼 client
+	_Atomic int clients;			// 붙어 있는 client 수
+	_Atomic uint64_t sent;			// 보낸 프레임 (재전송 포함)
+	_Atomic uint64_t received;		// 요청과 짝이 맞은 응답
+	_Atomic uint64_t stale;			// 재전송으로 버린 요청의 늦은 응답
+} FAS_BROKER;
+
+bool FAS_BrokerInit(FAS_BROKER *broker, const char *path, const FAS_BROKER_OPTION *option);
+bool FAS_BrokerAddBoard(FAS_BROKER *broker, int iBdID, const char *ip, bool tcp);
+bool FAS_BrokerStart(FAS_BROKER *broker);
+void FAS_BrokerStop(FAS_BROKER *broker);
+int FAS_BrokerClientCount(const FAS_BROKER *broker);
+
+bool FAS_BrokerConnect(FAS_BROKER_CLIENT *client, const char *path);
+void FAS_BrokerDisconnect(FAS_BROKER_CLIENT *client);
+FAS_BROKER_SLOT *FAS_BrokerGetSlot(FAS_BROKER_CLIENT *client);
+void FAS_BrokerSubmit(FAS_BROKER_CLIENT *client, FAS_BROKER_SLOT *slot);
+FAS_BROKER_SLOT *FAS_BrokerWait(FAS_BROKER_CLIENT *client, int timeout_ms);
+void FAS_BrokerRelease(FAS_BROKER_CLIENT *client, FAS_BROKER_SLOT *slot);
+FMM_ERROR FAS_BrokerCommand(FAS_BROKER_CLIENT *client, int board, BYTE frame_type, const void *data, int data_len,
+                            BYTE *resp, int resp_size, int *resp_len);
+
+#endif	//FAS_BROKER_DEFINE
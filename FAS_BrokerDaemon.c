@@ -0,0 +1,117 @@
+/**
+ * @file FAS_BrokerDaemon.c
+ * @brief 명령 broker 실행 파일 (FAS_Broker)
+ * @details 사용법: FAS_BrokerDaemon -b 1:192.168.0.2:tcp -b 2:192.168.0.3 [설정...]
+ * 드라이브 연결은 이 프로세스만 열고, PLC 로직/HMI/data logger는 FAS_BrokerConnect로 붙는다. Ctrl+C로 끝낸다.
+ *   -b id:ip[:tcp]  맡을 보드 (여러 번, tcp를 붙이면 TCP, 아니면 UDP)
+ *   -s path         Unix socket 경로 (기본 FAS_BROKER_SOCK)
+ *   -w n            보드당 window      -T ms       응답 시간 초과      -r n        재전송 횟수
+ *   -q n            한 바퀴에 client 하나에서 꺼내는 요청 수
+ *   -m              FAS_METRICS_SHM/FAS_METRICS_SOCK으로 metrics 공개
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include "FAS_Broker.h"
+
+static volatile sig_atomic_t broker_stop;
+
+static void on_signal(int sig){
+    broker_stop = 1;
+}
+
+static void usage(const char *name){
+    fprintf(stderr, "usage: %s -b id:ip[:tcp] [-b ...] [-s socket] [-w window] [-T timeout_ms] [-r retries] [-q quantum] [-m]\n", name);
+}
+
+/**@brief "id:ip[:tcp]" 해석 (arg는 고쳐 씀)*/
+static bool parse_board(char *arg, int *iBdID, char **ip, bool *tcp){
+    char *sep = strchr(arg, ':');
+    if (sep == NULL)
+        return false;
+    *sep = '\0';
+    *iBdID = atoi(arg);
+    *ip = sep + 1;
+    *tcp = false;
+    char *proto = strchr(*ip, ':');
+    if (proto != NULL) {
+        *proto = '\0';
+        *tcp = strcmp(proto + 1, "tcp") == 0;
+    }
+    return **ip != '\0';
+}
+
+int main(int argc, char *argv[]){
+    static FAS_BROKER broker;
+    static char *boards[FAS_MAX_BOARD];
+    FAS_BROKER_OPTION option = { 0 };
+    const char *path = FAS_BROKER_SOCK;
+    bool metrics = false;
+    int board_count = 0, opt;
+
+    while ((opt = getopt(argc, argv, "b:s:w:T:r:q:m")) != -1) {
+        switch (opt) {
+            case 'b':
+                if (board_count < FAS_MAX_BOARD)
+                    boards[board_count++] = optarg;
+                break;
+            case 's': path = optarg; break;
+            case 'w': option.window = atoi(optarg); break;
+            case 'T': option.timeout_ms = atoi(optarg); break;
+            case 'r': option.retries = atoi(optarg); break;
+            case 'q': option.quantum = atoi(optarg); break;
+            case 'm': metrics = true; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (board_count == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (metrics) {
+        if (!FAS_MetricsInit(FAS_METRICS_SHM))
+            FAS_MetricsInit(NULL);
+        FAS_MetricsServe(FAS_METRICS_SOCK);
+        printf("metrics shm %s, socket %s\n", FAS_MetricsShmName()[0] ? FAS_MetricsShmName() : "(none)",
+               FAS_MetricsSockPath()[0] ? FAS_MetricsSockPath() : "(none)");
+    }
+
+    if (!FAS_BrokerInit(&broker, path, &option))
+        return 1;
+    for (int i = 0; i < board_count; i++) {
+        int iBdID;
+        char *ip;
+        bool tcp;
+        if (!parse_board(boards[i], &iBdID, &ip, &tcp) || !FAS_BrokerAddBoard(&broker, iBdID, ip, tcp)) {
+            fprintf(stderr, "board %s: open failed\n", boards[i]);
+            FAS_BrokerStop(&broker);
+            return 1;
+        }
+        printf("board %d -> %s (%s)\n", iBdID, ip, tcp ? "TCP" : "UDP");
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    if (!FAS_BrokerStart(&broker)) {
+        FAS_BrokerStop(&broker);
+        return 1;
+    }
+    printf("broker on %s (window %d, timeout %d ms, retries %d, quantum %d), Ctrl+C to stop\n", path,
+           broker.option.window, broker.option.timeout_ms, broker.option.retries, broker.option.quantum);
+    while (!broker_stop)
+        pause();
+
+    printf("clients %d, sent %" PRIu64 ", received %" PRIu64 ", stale %" PRIu64 "\n", FAS_BrokerClientCount(&broker),
+           atomic_load(&broker.sent), atomic_load(&broker.received), atomic_load(&broker.stale));
+    FAS_BrokerStop(&broker);
+    if (metrics)
+        FAS_MetricsShutdown();
+    return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file FAS_Codec.c
+ * @brief 기본 codec (Fastech, 사용자 Header, serial CRC)과 codec 등록표
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include "FAS_Codec.h"
+
+#define SERIAL_START 0xCC			// 0xAA 다음 byte: 프레임 시작
+#define SERIAL_END 0xEE				// 0xAA 다음 byte: 프레임 끝
+
+static const FAS_CODEC *codec_table[FAS_CODEC_MAX] = { &FAS_CodecFastech, &FAS_CodecUser, &FAS_CodecSerial };
+static int codec_count = 3;
+
+ /**@brief Header 계열 프레임 길이 (Length byte + 2)
+  * @return 모자라면 0*/
+int FAS_LengthByteFrame(const BYTE *buf, int avail){
+    if (avail < 2 || avail < buf[1] + 2)
+        return 0;
+    return buf[1] + 2;
+}
+
+const FAS_CODEC FAS_CodecFastech = { "fastech", FRAME_HEADER, true, PORT_UDP, PORT_TCP, FAS_FastechEncode, FAS_LengthByteFrame, FAS_FastechDecode };
+const FAS_CODEC FAS_CodecUser = { "user", 0x00, true, PORT_UDP, PORT_TCP, FAS_UserHeaderEncode, FAS_LengthByteFrame, FAS_UserHeaderDecode };
+
+static uint16_t crc_table[256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_table_init(void){
+    for (int i = 0; i < 256; i++) {
+        uint16_t c = (uint16_t)i;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? (uint16_t)((c >> 1) ^ 0xA001) : (uint16_t)(c >> 1);
+        crc_table[i] = c;
+    }
+}
+
+ /**@brief CRC-16/MODBUS (다항식 0xA001 반사, 초기값 0xFFFF), byte마다 표 한 번*/
+uint16_t FAS_Crc16(const BYTE *data, int len){
+    pthread_once(&crc_once, crc_table_init);
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < len; i++)
+        crc = (uint16_t)((crc >> 8) ^ crc_table[(crc ^ data[i]) & 0xFF]);
+    return crc;
+}
+
+static int serial_put(BYTE *frame, int pos, BYTE b){
+    if (pos + 2 > BUFFER_SIZE - 2)
+        return -1;
+    frame[pos++] = b;
+    if (b == FRAME_HEADER)
+        frame[pos++] = FRAME_HEADER;
+    return pos;
+}
+
+static int serial_encode(BYTE *frame, BYTE sync_no, BYTE frame_type, const BYTE *data, int data_len){
+    BYTE body[DATA_SIZE + 2];
+    if (data_len > DATA_SIZE)
+        return -1;
+    body[0] = sync_no;
+    body[1] = frame_type;
+    memcpy(body + 2, data, data_len);
+    uint16_t crc = FAS_Crc16(body, data_len + 2);
+
+    int pos = 2;
+    frame[0] = FRAME_HEADER;
+    frame[1] = SERIAL_START;
+    for (int i = 0; i < data_len + 2 && pos >= 0; i++)
+        pos = serial_put(frame, pos, body[i]);
+    if (pos >= 0)
+        pos = serial_put(frame, pos, (BYTE)(crc & 0xFF));
+    if (pos >= 0)
+        pos = serial_put(frame, pos, (BYTE)(crc >> 8));
+    if (pos < 0)
+        return -1;
+    frame[pos++] = FRAME_HEADER;
+    frame[pos++] = SERIAL_END;
+    return pos;
+}
+
+static int serial_frame_length(const BYTE *buf, int avail){
+    if (avail >= 1 && buf[0] != FRAME_HEADER)
+        return -1;
+    if (avail >= 2 && buf[1] != SERIAL_START)
+        return -1;
+    for (int i = 2; i + 1 < avail; i++) {
+        if (buf[i] != FRAME_HEADER)
+            continue;
+        if (buf[i + 1] == SERIAL_END)
+            return i + 2;
+        if (buf[i + 1] != FRAME_HEADER)
+            return -1;
+        i++;
+    }
+    return 0;
+}
+
+static bool serial_decode(BYTE *frame, int len, FAS_FRAME_VIEW *view){
+    if (len < 8 || frame[0] != FRAME_HEADER || frame[1] != SERIAL_START
+        || frame[len - 2] != FRAME_HEADER || frame[len - 1] != SERIAL_END)
+        return false;
+
+    // 0xAA 0xAA -> 0xAA, 결과는 frame[2]부터 (ID, Type, Status, Data, CRC L H)
+    int n = 0;
+    for (int i = 2; i < len - 2; i++) {
+        frame[2 + n++] = frame[i];
+        if (frame[i] == FRAME_HEADER)
+            i++;
+    }
+    if (n < 5)
+        return false;
+    const BYTE *body = frame + 2;
+    if (FAS_Crc16(body, n - 2) != (uint16_t)(body[n - 2] | (body[n - 1] << 8)))
+        return false;
+    view->sync = body[0];
+    view->frame_type = body[1];
+    view->status = body[2];
+    view->data = body + 3;
+    view->data_len = n - 5;
+    return true;
+}
+
+const FAS_CODEC FAS_CodecSerial = { "serial", FRAME_HEADER, false, PORT_UDP, PORT_TCP, serial_encode, serial_frame_length, serial_decode };
+
+ /**@brief codec 등록 (프로그램 시작할 때, 통신 thread가 돌기 전에)
+  * @return 표가 찼거나 같은 이름이 있으면 FALSE*/
+bool FAS_CodecRegister(const FAS_CODEC *codec){
+    if (codec_count == FAS_CODEC_MAX || FAS_CodecFind(codec->name) != NULL)
+        return false;
+    codec_table[codec_count++] = codec;
+    return true;
+}
+
+ /**@brief 이름으로 codec 찾기
+  * @return 없으면 NULL*/
+const FAS_CODEC *FAS_CodecFind(const char *name){
+    for (int i = 0; i < codec_count; i++)
+        if (strcmp(codec_table[i]->name, name) == 0)
+            return codec_table[i];
+    return NULL;
+}
+
+ /**@brief base와 같은 프레임 함수에 port만 바꾼 codec (UDP/TCP 모두 port)*/
+void FAS_CodecWithPort(FAS_CODEC *out, const FAS_CODEC *base, uint16_t port){
+    *out = *base;
+    out->port_udp = port;
+    out->port_tcp = port;
+}
@@ -0,0 +1,120 @@
+
+#pragma once
+
+#ifndef FAS_CODEC_DEFINE
+#define FAS_CODEC_DEFINE
+
+/**
+ * @file FAS_Codec.h
+ * @brief 프로토콜 변형(Fastech Header, 사용자 Header, 사용자 port, serial CRC 프레임)마다 따로 만든 프레임 encoder/decoder
+ * @details 변형은 연결할 때 한 번 고르고 (FAS_ContextSetCodec), 그 뒤 프레임마다 부르는 encode/decode에는
+ * 변형을 가르는 분기가 없다. Header byte 변형은 FAS_CODEC_HEADER 매크로로 만들어서 Header가 상수로 박힌 함수가 따로 생긴다.
+ * 기본 codec은 inline 판(FAS_FastechEncode/Decode)도 header에 있어서, 송수신 hot path는 FAS_CodecEncode/FAS_CodecDecode로
+ * 기본 codec일 때 함수 pointer를 거치지 않는다.
+ * Header가 다른 장비는 .c 파일 하나에서 FAS_CODEC_HEADER(my_codec, "MyDevice", 0x55, 3001, 2001)로 정의하고,
+ * 길이 표시 방식까지 다르면 encode/frame_length/decode를 직접 채운 FAS_CODEC을 만들어 FAS_CodecRegister로 등록한다.
+ *
+ * 프레임 모양:
+ * - Header 계열 (Fastech, 사용자 Header): [Header][Length][Sync No.][0][Frame Type][Data], Length = Sync No.부터 끝까지
+ * - Serial CRC: [0xAA 0xCC][Slave ID][Frame Type][Data][CRC16 L H][0xAA 0xEE], 몸통의 0xAA는 0xAA 0xAA로 보냄
+ *   CRC는 Slave ID부터 Data까지의 CRC-16/MODBUS, Sync No. 자리에 Slave ID가 들어감 (응답 짝은 Slave ID로 맞춤)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "Protocol_Define.h"
+
+#define FAS_CODEC_MAX 16					// 등록할 수 있는 codec 수 (기본 codec 포함)
+
+/**@brief decode한 응답 프레임 (data는 원래 buffer를 가리킴)*/
+typedef struct _FAS_FRAME_VIEW
+{
+	BYTE sync;					// Sync No. (serial은 Slave ID)
+	BYTE frame_type;
+	BYTE status;				// 통신 상태 byte
+	const BYTE *data;			// 통신 상태 뒤의 응답 data
+	int data_len;
+} FAS_FRAME_VIEW;
+
+typedef struct _FAS_CODEC
+{
+	const char *name;
+	BYTE header;				// Header 계열의 Header byte (serial은 0xAA)
+	bool sync;					// Sync No.를 쓰면 TRUE, FALSE면 그 자리에 보드 번호(Slave ID)
+	uint16_t port_udp;
+	uint16_t port_tcp;
+
+	/**@brief 요청 프레임 조립, frame은 BUFFER_SIZE @return 프레임 길이, BUFFER_SIZE를 넘으면 -1*/
+	int (*encode)(BYTE *frame, BYTE sync_no, BYTE frame_type, const BYTE *data, int data_len);
+	/**@brief stream 앞의 프레임 하나 길이 @return 모자라면 0, 앞부분이 프레임이 아니면 -1 (1 byte 버리고 다시)*/
+	int (*frame_length)(const BYTE *buf, int avail);
+	/**@brief 응답 프레임 확인 및 분해 (serial은 frame 안에서 0xAA 0xAA를 풀어 씀) @return 형식/CRC가 맞으면 TRUE*/
+	bool (*decode)(BYTE *frame, int len, FAS_FRAME_VIEW *view);
+} FAS_CODEC;
+
+/**@brief Header가 상수로 들어간 Header 계열 encode/decode를 static inline으로 정의 (prefix##Encode, prefix##Decode)
+ * @details header에 두면 부르는 쪽에서 inline되어 Header 비교와 memcpy 길이까지 상수로 접힌다.
+ * encode는 Length byte(data + 3)가 한 byte이므로 data_len이 DATA_SIZE - 1보다 크면 -1.*/
+#define FAS_CODEC_HEADER_INLINE(prefix, HEADER)                                                                 \
+    static inline int prefix##Encode(BYTE *frame, BYTE sync_no, BYTE frame_type, const BYTE *data, int data_len) { \
+        if (data_len > DATA_SIZE - 1)                                                                           \
+            return -1;                                                                                          \
+        frame[0] = (HEADER);                                                                                    \
+        frame[1] = (BYTE)(data_len + 3);                                                                        \
+        frame[2] = sync_no;                                                                                     \
+        frame[3] = 0x00;                                                                                        \
+        frame[4] = frame_type;                                                                                  \
+        memcpy(frame + FRAME_HEADER_SIZE, data, data_len);                                                      \
+        return data_len + FRAME_HEADER_SIZE;                                                                    \
+    }                                                                                                           \
+    static inline bool prefix##Decode(BYTE *frame, int len, FAS_FRAME_VIEW *view) {                             \
+        if (len < FRAME_HEADER_SIZE + 1 || frame[0] != (HEADER) || frame[1] + 2 != len)                         \
+            return false;                                                                                       \
+        view->sync = frame[2];                                                                                  \
+        view->frame_type = frame[4];                                                                            \
+        view->status = frame[FRAME_HEADER_SIZE];                                                                \
+        view->data = frame + FRAME_HEADER_SIZE + 1;                                                             \
+        view->data_len = len - (FRAME_HEADER_SIZE + 1);                                                         \
+        return true;                                                                                            \
+    }
+
+/**@brief Header가 상수로 들어간 Header 계열 codec 정의 (.c 파일에서 한 번)
+ * @param sym 만들 const FAS_CODEC 변수 이름
+ * @param label FAS_CodecFind로 찾을 이름
+ * @param HEADER Header byte (상수)
+ * @param UDP/TCP 기본 port*/
+#define FAS_CODEC_HEADER(sym, label, HEADER, UDP, TCP)                                                          \
+    FAS_CODEC_HEADER_INLINE(sym##_, HEADER)                                                                     \
+    const FAS_CODEC sym = { label, (HEADER), true, (UDP), (TCP), sym##_Encode, FAS_LengthByteFrame, sym##_Decode }
+
+FAS_CODEC_HEADER_INLINE(FAS_Fastech, FRAME_HEADER)	// FAS_FastechEncode, FAS_FastechDecode (기본 codec의 inline 판)
+FAS_CODEC_HEADER_INLINE(FAS_UserHeader, 0x00)		// FAS_UserHeaderEncode, FAS_UserHeaderDecode
+
+extern const FAS_CODEC FAS_CodecFastech;	// Header 0xAA
+extern const FAS_CODEC FAS_CodecUser;		// Header 0x00 (ProtocolTest의 check_fastech 끔)
+extern const FAS_CODEC FAS_CodecSerial;		// serial CRC 프레임 (serial-Ethernet 변환기 뒤의 Plus-R 등)
+
+int FAS_LengthByteFrame(const BYTE *buf, int avail);
+uint16_t FAS_Crc16(const BYTE *data, int len);
+
+bool FAS_CodecRegister(const FAS_CODEC *codec);
+const FAS_CODEC *FAS_CodecFind(const char *name);
+void FAS_CodecWithPort(FAS_CODEC *out, const FAS_CODEC *base, uint16_t port);
+
+ /**@brief 요청 프레임 조립, 기본 codec(FAS_CodecFastech)이면 간접 호출 없이 inline 판으로
+  * @details 거의 모든 연결이 기본 codec이라 비교 한 번은 늘 같은 쪽으로 맞고, 나머지 codec만 함수 pointer로 간다.*/
+static inline int FAS_CodecEncode(const FAS_CODEC *codec, BYTE *frame, BYTE sync_no, BYTE frame_type, const BYTE *data, int data_len){
+    if (__builtin_expect(codec == &FAS_CodecFastech, 1))
+        return FAS_FastechEncode(frame, sync_no, frame_type, data, data_len);
+    return codec->encode(frame, sync_no, frame_type, data, data_len);
+}
+
+ /**@brief 응답 프레임 분해, FAS_CodecEncode와 같이 기본 codec은 inline 판으로*/
+static inline bool FAS_CodecDecode(const FAS_CODEC *codec, BYTE *frame, int len, FAS_FRAME_VIEW *view){
+    if (__builtin_expect(codec == &FAS_CodecFastech, 1))
+        return FAS_FastechDecode(frame, len, view);
+    return codec->decode(frame, len, view);
+}
+
+#endif	//FAS_CODEC_DEFINE
@@ -0,0 +1,254 @@
+/**
+ * @file FAS_EStop.c
+ * @brief 비상정지 전용 소켓, 미리 만든 0x32 프레임, sendmmsg 한 번으로 전체 송신, 보드별 deadline까지 응답 수거
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/ip.h>
+#include <sys/socket.h>
+#include "FAS_EStop.h"
+#include "FAS_Library.h"
+#include "FAS_Pipeline.h"
+#include "FAS_Trace.h"
+
+#define ESTOP_TOS 0xB8						// DSCP EF (스위치가 DSCP를 보면 다른 트래픽보다 먼저 보냄)
+#define ESTOP_PRIORITY 6					// SO_PRIORITY (CAP_NET_ADMIN 없이 줄 수 있는 최대값)
+
+static int estop_find(const FAS_ESTOP *estop, const struct sockaddr_in *from){
+    for (int i = 0; i < estop->count; i++)
+        if (estop->board[i].addr.sin_addr.s_addr == from->sin_addr.s_addr && estop->board[i].addr.sin_port == from->sin_port)
+            return i;
+    return -1;
+}
+
+ /**@brief 비상정지 전용 UDP 소켓 준비 (보드는 FAS_EStopAdd/FAS_EStopArm으로 넣음)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_EStopInit(FAS_ESTOP *estop){
+    memset(estop, 0, sizeof(*estop));
+    estop->sync_no = (BYTE)(rand() % 256);
+    estop->msg = calloc(FAS_MAX_BOARD, sizeof(struct mmsghdr));
+    estop->fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (estop->msg == NULL || estop->fd < 0) {
+        perror("E-stop socket creation failed");
+        FAS_EStopFree(estop);
+        return false;
+    }
+
+    // 실패해도 보내는 데는 지장이 없으므로 결과는 보지 않음
+    int prio = ESTOP_PRIORITY, tos = ESTOP_TOS;
+    setsockopt(estop->fd, SOL_SOCKET, SO_PRIORITY, &prio, sizeof(prio));
+    setsockopt(estop->fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+    return true;
+}
+
+ /**@brief 소켓과 보드 목록 해제*/
+void FAS_EStopFree(FAS_ESTOP *estop){
+    if (estop->fd >= 0)
+        close(estop->fd);
+    free(estop->msg);
+    estop->fd = -1;
+    estop->msg = NULL;
+    estop->count = 0;
+}
+
+ /**@brief 비상정지를 보낼 보드 추가 (이미 있는 보드 번호면 주소만 바꿈)
+  * @param int iBdID 드라이브 ID
+  * @param const char *ip 드라이브 IP
+  * @param const FAS_CODEC *codec 프레임 변형 (보통 FAS_CodecFastech)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_EStopAdd(FAS_ESTOP *estop, int iBdID, const char *ip, const FAS_CODEC *codec){
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(codec->port_udp);
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid address: %s\n", ip);
+        return false;
+    }
+
+    int i = 0;
+    while (i < estop->count && estop->board[i].iBdID != iBdID)
+        i++;
+    if (i == FAS_MAX_BOARD) {
+        fprintf(stderr, "Too many e-stop boards\n");
+        return false;
+    }
+
+    FAS_ESTOP_BOARD *b = &estop->board[i];
+    memset(b, 0, sizeof(*b));
+    b->iBdID = iBdID;
+    b->addr = addr;
+    b->codec = codec;
+    int len = codec->encode(b->frame, codec->sync ? 0 : (BYTE)iBdID, FRAME_EMERGENCYSTOP, NULL, 0);
+
+    struct mmsghdr *msg = &((struct mmsghdr *)estop->msg)[i];
+    b->iov.iov_base = b->frame;
+    b->iov.iov_len = len;
+    memset(msg, 0, sizeof(*msg));
+    msg->msg_hdr.msg_name = &b->addr;
+    msg->msg_hdr.msg_namelen = sizeof(b->addr);
+    msg->msg_hdr.msg_iov = &b->iov;
+    msg->msg_hdr.msg_iovlen = 1;
+    if (i == estop->count)
+        estop->count++;
+    return true;
+}
+
+ /**@brief 지금 열려 있는 보드 context 전부로 보드 목록을 다시 만듦 (연결/해제 뒤에 부름)
+  * @details context의 주소와 codec만 읽고 소켓은 쓰지 않는다.
+  * @return 비상정지를 보낼 보드 수*/
+int FAS_EStopArm(FAS_ESTOP *estop){
+    estop->count = 0;
+    for (int id = 0; id < FAS_MAX_BOARD; id++) {
+        FAS_CONTEXT *ctx = FAS_BoardContextFind(id);
+        if (ctx == NULL || !ctx->open)
+            continue;
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &ctx->link.addr.sin_addr, ip, sizeof(ip));
+        FAS_EStopAdd(estop, id, ip, ctx->codec);
+    }
+    return estop->count;
+}
+
+ /**@brief deadline까지 응답 수거, 맞는 응답마다 보드 결과를 채움
+  * @return 응답한 보드 수*/
+static int estop_collect(FAS_ESTOP *estop, BYTE sync_no, uint64_t t0, uint64_t deadline_us, int pending){
+    struct mmsghdr msg[FAS_ESTOP_BATCH];
+    struct iovec iov[FAS_ESTOP_BATCH];
+    struct sockaddr_in from[FAS_ESTOP_BATCH];
+    BYTE buf[FAS_ESTOP_BATCH][BUFFER_SIZE];
+    uint64_t end = 0;
+    int acked = 0;
+
+    for (int i = 0; i < estop->count; i++)
+        if (estop->board[i].sent_us != 0 && estop->board[i].sent_us + deadline_us > end)
+            end = estop->board[i].sent_us + deadline_us;
+
+    while (acked < pending) {
+        uint64_t now = FAS_MonotonicUs();
+        if (now >= end)
+            break;
+        struct pollfd pfd = { .fd = estop->fd, .events = POLLIN };
+        struct timespec wait = { .tv_sec = (end - now) / 1000000, .tv_nsec = ((end - now) % 1000000) * 1000 };
+        if (ppoll(&pfd, 1, &wait, NULL) <= 0)
+            continue;
+
+        for (int i = 0; i < FAS_ESTOP_BATCH; i++) {
+            iov[i].iov_base = buf[i];
+            iov[i].iov_len = BUFFER_SIZE;
+            memset(&msg[i], 0, sizeof(msg[i]));
+            msg[i].msg_hdr.msg_name = &from[i];
+            msg[i].msg_hdr.msg_namelen = sizeof(from[i]);
+            msg[i].msg_hdr.msg_iov = &iov[i];
+            msg[i].msg_hdr.msg_iovlen = 1;
+        }
+        int n = recvmmsg(estop->fd, msg, FAS_ESTOP_BATCH, MSG_DONTWAIT, NULL);
+        if (n <= 0)
+            continue;
+        now = FAS_MonotonicUs();
+
+        for (int i = 0; i < n; i++) {
+            int len = (int)msg[i].msg_len;
+            int index = estop_find(estop, &from[i]);
+            if (index < 0)
+                continue;
+            FAS_ESTOP_BOARD *b = &estop->board[index];
+            FAS_FRAME_VIEW view;
+            if (!b->codec->decode(buf[i], len, &view) || view.frame_type != FRAME_EMERGENCYSTOP
+                || view.sync != (b->codec->sync ? sync_no : (BYTE)b->iBdID))
+                continue;
+            // 이 보드의 deadline이 지난 뒤에 온 응답은 없는 것으로 봄
+            if (b->acked || b->sent_us == 0 || now > b->sent_us + deadline_us)
+                continue;
+            b->acked = true;
+            b->status = (FMM_ERROR)view.status;
+            b->ack_us = (uint32_t)(now - t0);
+            FAS_MetricsReceived(b->iBdID, len, b->status, now - b->sent_us);
+            FAS_TRACE(FAS_TRACE_RECV, b->iBdID, sync_no, len);
+            acked++;
+        }
+    }
+    return acked;
+}
+
+ /**@brief 모든 보드에 비상정지를 한 번에 보내고 보드마다 deadline까지 응답을 기다림
+  * @details 보내기 전에 하는 일은 Sync No.를 쓰는 보드 프레임을 새 Sync No.로 다시 만드는 것뿐이고 (data 없는 5 byte),
+  * sendmmsg 한 번에 전부 넘긴다.
+  * 다시 보내지 않는다 (응답 없는 보드는 FMC_TIMEOUT_ERROR, 보내지 못한 보드는 FMC_DISCONNECTED).
+  * @param int deadline_ms 보드마다 그 보드 프레임을 보낸 때부터 응답을 기다리는 시간 (0이하면 FAS_ESTOP_DEFAULT_DEADLINE_MS)
+  * @param FAS_ESTOP_RESULT *result 결과 (NULL 가능), 보드별 결과는 estop->board[]
+  * @return 응답한 보드 수, 다른 곳에서 이미 trigger 중이면 -1*/
+int FAS_EStopTrigger(FAS_ESTOP *estop, int deadline_ms, FAS_ESTOP_RESULT *result){
+    if (atomic_exchange_explicit(&estop->busy, true, memory_order_acquire))
+        return -1;
+    uint64_t t0 = FAS_MonotonicUs();
+    BYTE sync_no = estop->sync_no++;
+    struct mmsghdr *msg = estop->msg;
+    int count = estop->count, done = 0;
+
+    for (int i = 0; i < count; i++) {
+        FAS_ESTOP_BOARD *b = &estop->board[i];
+        if (b->codec->sync)
+            b->iov.iov_len = b->codec->encode(b->frame, sync_no, FRAME_EMERGENCYSTOP, NULL, 0);
+    }
+    while (done < count) {
+        int sent = sendmmsg(estop->fd, &msg[done], count - done, 0);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("E-stop sendmmsg failed");
+            break;
+        }
+        uint64_t now = FAS_MonotonicUs();
+        for (int i = done; i < done + sent; i++)
+            estop->board[i].sent_us = now;
+        done += sent;
+    }
+    uint32_t wire_us = (uint32_t)(FAS_MonotonicUs() - t0);
+
+    // 여기부터는 이미 다 보낸 뒤라 늦어도 됨
+    for (int i = 0; i < count; i++) {
+        FAS_ESTOP_BOARD *b = &estop->board[i];
+        b->acked = false;
+        b->ack_us = 0;
+        if (i < done) {
+            b->status = FMC_TIMEOUT_ERROR;
+            FAS_MetricsSent(b->iBdID, b->iov.iov_len);
+            FAS_TRACE(FAS_TRACE_SEND, b->iBdID, sync_no, b->iov.iov_len);
+        } else {
+            b->status = FMC_DISCONNECTED;
+            b->sent_us = 0;
+        }
+    }
+
+    uint64_t deadline_us = (uint64_t)(deadline_ms > 0 ? deadline_ms : FAS_ESTOP_DEFAULT_DEADLINE_MS) * 1000;
+    int acked = estop_collect(estop, sync_no, t0, deadline_us, done);
+
+    FAS_ESTOP_RESULT r = { .boards = count, .acked = acked, .wire_us = wire_us, .worst_board = -1 };
+    for (int i = 0; i < count; i++) {
+        FAS_ESTOP_BOARD *b = &estop->board[i];
+        uint32_t t = b->acked ? b->ack_us : (uint32_t)(b->sent_us != 0 ? b->sent_us + deadline_us - t0 : wire_us);
+        if (!b->acked && b->sent_us != 0)
+            FAS_MetricsTimeout(b->iBdID);
+        if (r.worst_board < 0 || t > r.worst_ack_us) {
+            r.worst_ack_us = t;
+            r.worst_board = b->iBdID;
+        }
+    }
+    estop->triggers++;
+    if (wire_us > estop->max_wire_us)
+        estop->max_wire_us = wire_us;
+    if (result != NULL)
+        *result = r;
+
+    atomic_store_explicit(&estop->busy, false, memory_order_release);
+    return acked;
+}
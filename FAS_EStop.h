@@ -0,0 +1,78 @@
+
+#pragma once
+
+#ifndef FAS_ESTOP_DEFINE
+#define FAS_ESTOP_DEFINE
+
+/**
+ * @file FAS_EStop.h
+ * @brief 모든 보드에 비상정지(0x32)를 한 번에 보내는 전용 경로
+ * @details FAS_EmergencyStop(iBdID)은 보드 context의 송수신 buffer와 소켓을 쓰므로 그 context에서 진행 중인
+ * 교환(상태 polling 등)이 끝나야 보낼 수 있고, 한 번에 한 대에만 간다.
+ * 여기서는 비상정지 전용 UDP 소켓을 따로 열고 (SO_PRIORITY/IP_TOS를 높여 둠), 보드마다 그 보드 codec으로 프레임을 미리 만들어 둔다.
+ * FAS_EStopTrigger는 Sync No.를 쓰는 codec의 프레임만 새 Sync No.로 다시 만든 뒤 sendmmsg 묶음으로 전부 보내고,
+ * 보드마다 deadline까지 응답을 모은다.
+ * 다시 보내지 않으며 context, shard queue, lock을 전혀 건드리지 않으므로 다른 통신을 기다리지 않는다.
+ * TCP로 연결한 보드도 같은 IP의 codec UDP port로 보낸다 (드라이브는 두 port를 모두 받음).
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include "Protocol_Define.h"
+#include "ReturnCodes_Define.h"
+#include "FAS_Metrics.h"
+#include "FAS_Codec.h"
+
+#define FAS_ESTOP_DEFAULT_DEADLINE_MS 20	// 응답 기다리는 시간 (보드마다 그 보드 프레임을 보낸 때부터)
+#define FAS_ESTOP_BATCH 64					// recvmmsg 한 번에 받는 응답 수
+
+/**@brief 미리 만든 비상정지 프레임과 마지막 결과 (보드 한 대)*/
+typedef struct _FAS_ESTOP_BOARD
+{
+	int iBdID;
+	struct sockaddr_in addr;		// 보드 IP, codec의 UDP port
+	const FAS_CODEC *codec;
+	BYTE frame[BUFFER_SIZE];		// codec으로 만든 0x32 프레임 (Sync No.를 쓰는 codec은 trigger마다 다시 만듦)
+	struct iovec iov;				// iov_len이 프레임 길이
+
+	bool acked;
+	FMM_ERROR status;				// 응답의 통신 상태, 응답이 없으면 FMC_TIMEOUT_ERROR
+	uint64_t sent_us;				// 이 보드 프레임이 든 sendmmsg가 끝난 시각
+	uint32_t ack_us;				// trigger부터 응답까지
+} FAS_ESTOP_BOARD;
+
+/**@brief trigger 한 번의 결과*/
+typedef struct _FAS_ESTOP_RESULT
+{
+	int boards;
+	int acked;
+	uint32_t wire_us;				// trigger부터 마지막 프레임을 소켓에 넘길 때까지
+	uint32_t worst_ack_us;			// 가장 늦은 응답 (응답 없는 보드가 있으면 그 보드의 deadline)
+	int worst_board;				// worst_ack_us의 보드 번호
+} FAS_ESTOP_RESULT;
+
+typedef struct _FAS_ESTOP
+{
+	int fd;
+	int count;
+	FAS_ESTOP_BOARD board[FAS_MAX_BOARD];
+	void *msg;						// struct mmsghdr[FAS_MAX_BOARD], board[]와 같은 순서로 미리 채워 둠
+	BYTE sync_no;					// 다음 trigger에 쓸 Sync No.
+
+	_Atomic bool busy;				// trigger 중 (두 곳에서 동시에 누르면 나중 것은 바로 돌아감)
+	uint64_t triggers;
+	uint32_t max_wire_us;			// 지금까지 가장 늦은 wire_us
+} FAS_ESTOP;
+
+bool FAS_EStopInit(FAS_ESTOP *estop);
+void FAS_EStopFree(FAS_ESTOP *estop);
+
+bool FAS_EStopAdd(FAS_ESTOP *estop, int iBdID, const char *ip, const FAS_CODEC *codec);
+int FAS_EStopArm(FAS_ESTOP *estop);
+int FAS_EStopTrigger(FAS_ESTOP *estop, int deadline_ms, FAS_ESTOP_RESULT *result);
+
+#endif	//FAS_ESTOP_DEFINE
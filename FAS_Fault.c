@@ -0,0 +1,496 @@
+/**
+ * @file FAS_Fault.c
+ * @brief 고장 주입 proxy 구현 (ppoll 한 thread, 지연 packet은 min heap)
+ */
+
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "FAS_Fault.h"
+#include "FAS_Metrics.h"
+
+#define STAT(field, dir) (offsetof(FAS_FAULT_STATS, field) / sizeof(uint64_t) + (dir))
+
+static const char *dir_name[2] = { "up", "down" };
+
+static void fault_stat(FAS_FAULT_PROXY *proxy, size_t index){
+    atomic_fetch_add_explicit(&proxy->stats[index], 1, memory_order_relaxed);
+}
+
+/************************************************************************************************************************************
+ ************************************************** 난수, 지연 분포 ****************************************************************
+ ************************************************************************************************************************************/
+
+// xorshift64*, seed가 같으면 같은 순서
+static double fault_random(FAS_FAULT_PROXY *proxy){
+    uint64_t x = proxy->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    proxy->rng = x;
+    return (double)((x * 2685821657736338717ull) >> 11) / (double)(1ull << 53);
+}
+
+static uint64_t fault_delay(FAS_FAULT_PROXY *proxy, const FAS_FAULT_PROFILE *p){
+    double extra = 0;
+    switch (p->dist) {
+        case FAS_FAULT_FIXED:
+            break;
+        case FAS_FAULT_UNIFORM:
+            extra = fault_random(proxy) * p->jitter_us;
+            break;
+        case FAS_FAULT_NORMAL: {
+            double u1 = fault_random(proxy), u2 = fault_random(proxy);
+            extra = sqrt(-2.0 * log(u1 > 0 ? u1 : 1e-300)) * cos(2.0 * M_PI * u2) * p->jitter_us;
+            break;
+        }
+        case FAS_FAULT_PARETO: {
+            double u = 1.0 - fault_random(proxy);
+            extra = p->jitter_us * (pow(u, -1.0 / 1.5) - 1.0);
+            if (extra > 100.0 * p->jitter_us)
+                extra = 100.0 * p->jitter_us;
+            break;
+        }
+    }
+    double delay = p->latency_us + extra;
+    return delay > 0 ? (uint64_t)delay : 0;
+}
+
+static void fault_log(FAS_FAULT_PROXY *proxy, const char *proto, int dir, const char *action,
+                      int len, int sync, uint64_t delay_us){
+    if (proxy->log != NULL)
+        fprintf(proxy->log, "%llu,%s,%s,%s,%d,%d,%llu\n", (unsigned long long)FAS_MonotonicUs(), proto,
+                dir_name[dir], action, len, sync, (unsigned long long)delay_us);
+}
+
+/************************************************************************************************************************************
+ ************************************************** 지연 queue (min heap) *********************************************************
+ ************************************************************************************************************************************/
+
+static bool packet_before(const FAS_FAULT_PACKET *a, const FAS_FAULT_PACKET *b){
+    return a->due_us < b->due_us || (a->due_us == b->due_us && a->seq < b->seq);
+}
+
+static void heap_swap(FAS_FAULT_PACKET *a, FAS_FAULT_PACKET *b){
+    FAS_FAULT_PACKET t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static bool fault_enqueue(FAS_FAULT_PROXY *proxy, int fd, const struct sockaddr_in *to,
+                          const BYTE *data, int len, uint64_t due_us){
+    if (proxy->queued == FAS_FAULT_QUEUE) {
+        atomic_fetch_add_explicit(&proxy->stats[STAT(overflow, 0)], 1, memory_order_relaxed);
+        return false;
+    }
+    int i = proxy->queued++;
+    FAS_FAULT_PACKET *p = &proxy->queue[i];
+    p->due_us = due_us;
+    p->seq = proxy->seq++;
+    p->fd = fd;
+    p->udp_reply = to != NULL;
+    if (to != NULL)
+        p->to = *to;
+    p->len = len;
+    memcpy(p->data, data, len);
+    while (i > 0 && packet_before(&proxy->queue[i], &proxy->queue[(i - 1) / 2])) {
+        heap_swap(&proxy->queue[i], &proxy->queue[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+    return true;
+}
+
+static void heap_pop(FAS_FAULT_PROXY *proxy){
+    FAS_FAULT_PACKET *q = proxy->queue;
+    q[0] = q[--proxy->queued];
+    for (int i = 0;;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < proxy->queued && packet_before(&q[l], &q[m]))
+            m = l;
+        if (r < proxy->queued && packet_before(&q[r], &q[m]))
+            m = r;
+        if (m == i)
+            break;
+        heap_swap(&q[i], &q[m]);
+        i = m;
+    }
+}
+
+static void fault_flush(FAS_FAULT_PROXY *proxy, uint64_t now){
+    while (proxy->queued > 0 && proxy->queue[0].due_us <= now) {
+        FAS_FAULT_PACKET *p = &proxy->queue[0];
+        if (p->fd >= 0) {
+            if (p->udp_reply)
+                sendto(p->fd, p->data, p->len, MSG_DONTWAIT, (struct sockaddr *)&p->to, sizeof(p->to));
+            else
+                send(p->fd, p->data, p->len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        }
+        heap_pop(proxy);
+    }
+}
+
+// 닫힌 소켓으로 갈 packet은 버림 (fd 번호가 재사용될 수 있으므로)
+static void fault_forget_fd(FAS_FAULT_PROXY *proxy, int fd){
+    for (int i = 0; i < proxy->queued; i++) {
+        if (proxy->queue[i].fd == fd)
+            proxy->queue[i].fd = -1;
+    }
+}
+
+/************************************************************************************************************************************
+ ************************************************** UDP ****************************************************************************
+ ************************************************************************************************************************************/
+
+static void udp_inject(FAS_FAULT_PROXY *proxy, int dir, int fd, const struct sockaddr_in *to, const BYTE *data, int len){
+    const FAS_FAULT_PROFILE *p = &proxy->profile[dir];
+    int sync = len > 2 ? data[2] : -1;
+    fault_stat(proxy, STAT(packets, dir));
+
+    if (p->loss > 0 && fault_random(proxy) < p->loss) {
+        fault_stat(proxy, STAT(dropped, dir));
+        fault_log(proxy, "udp", dir, "drop", len, sync, 0);
+        return;
+    }
+    uint64_t now = FAS_MonotonicUs();
+    uint64_t delay = fault_delay(proxy, p);
+    const char *action = "pass";
+    if (p->reorder > 0 && fault_random(proxy) < p->reorder) {
+        delay += p->reorder_us;
+        action = "reorder";
+        fault_stat(proxy, STAT(reordered, dir));
+    }
+    else {
+        fault_stat(proxy, STAT(passed, dir));
+    }
+    fault_enqueue(proxy, fd, to, data, len, now + delay);
+    fault_log(proxy, "udp", dir, action, len, sync, delay);
+
+    if (p->duplicate > 0 && fault_random(proxy) < p->duplicate) {
+        uint64_t dup_delay = fault_delay(proxy, p);
+        fault_stat(proxy, STAT(duplicated, dir));
+        fault_enqueue(proxy, fd, to, data, len, now + dup_delay);
+        fault_log(proxy, "udp", dir, "dup", len, sync, dup_delay);
+    }
+}
+
+static FAS_FAULT_UDP_CLIENT *udp_client(FAS_FAULT_PROXY *proxy, const struct sockaddr_in *from){
+    FAS_FAULT_UDP_CLIENT *free_slot = NULL;
+    for (int i = 0; i < FAS_FAULT_CLIENTS; i++) {
+        FAS_FAULT_UDP_CLIENT *c = &proxy->client[i];
+        if (c->upstream < 0) {
+            if (free_slot == NULL)
+                free_slot = c;
+        }
+        else if (c->addr.sin_addr.s_addr == from->sin_addr.s_addr && c->addr.sin_port == from->sin_port) {
+            return c;
+        }
+    }
+    if (free_slot == NULL)
+        return NULL;
+
+    // client마다 target 쪽 소켓을 따로 둬야 응답을 누구에게 돌려줄지 안다
+    struct sockaddr_in target = proxy->target;
+    target.sin_port = htons(PORT_UDP);
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&target, sizeof(target)) < 0) {
+        perror("proxy upstream socket failed");
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+    free_slot->addr = *from;
+    free_slot->upstream = fd;
+    return free_slot;
+}
+
+static void udp_from_client(FAS_FAULT_PROXY *proxy){
+    BYTE buf[BUFFER_SIZE];
+    struct sockaddr_in from;
+    socklen_t from_len = sizeof(from);
+    ssize_t n = recvfrom(proxy->udp_fd, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len);
+    if (n <= 0)
+        return;
+    FAS_FAULT_UDP_CLIENT *c = udp_client(proxy, &from);
+    if (c != NULL)
+        udp_inject(proxy, FAS_FAULT_UP, c->upstream, NULL, buf, (int)n);
+}
+
+static void udp_from_target(FAS_FAULT_PROXY *proxy, FAS_FAULT_UDP_CLIENT *c){
+    BYTE buf[BUFFER_SIZE];
+    ssize_t n = recv(c->upstream, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n > 0)
+        udp_inject(proxy, FAS_FAULT_DOWN, proxy->udp_fd, &c->addr, buf, (int)n);
+}
+
+/************************************************************************************************************************************
+ ************************************************** TCP ****************************************************************************
+ ************************************************************************************************************************************/
+
+static void tcp_close(FAS_FAULT_PROXY *proxy, FAS_FAULT_TCP_CONN *conn){
+    for (int d = 0; d < 2; d++) {
+        if (conn->fd[d] >= 0) {
+            fault_forget_fd(proxy, conn->fd[d]);
+            close(conn->fd[d]);
+            conn->fd[d] = -1;
+        }
+    }
+}
+
+static void tcp_accept(FAS_FAULT_PROXY *proxy){
+    int client = accept4(proxy->tcp_fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (client < 0)
+        return;
+    FAS_FAULT_TCP_CONN *conn = NULL;
+    for (int i = 0; i < FAS_FAULT_TCP && conn == NULL; i++) {
+        if (proxy->conn[i].fd[0] < 0)
+            conn = &proxy->conn[i];
+    }
+    struct sockaddr_in target = proxy->target;
+    target.sin_port = htons(PORT_TCP);
+    int upstream = conn != NULL ? socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0) : -1;
+    if (upstream < 0 || connect(upstream, (struct sockaddr *)&target, sizeof(target)) < 0) {
+        if (conn != NULL)
+            perror("proxy TCP connect to target failed");
+        if (upstream >= 0)
+            close(upstream);
+        close(client);
+        return;
+    }
+    fcntl(upstream, F_SETFL, fcntl(upstream, F_GETFL) | O_NONBLOCK);
+
+    // 조각마다 따로 나가도록 Nagle 끔
+    int one = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(upstream, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    conn->fd[FAS_FAULT_UP] = client;
+    conn->fd[FAS_FAULT_DOWN] = upstream;
+    conn->last_due[0] = conn->last_due[1] = 0;
+}
+
+static void tcp_relay(FAS_FAULT_PROXY *proxy, FAS_FAULT_TCP_CONN *conn, int dir){
+    const FAS_FAULT_PROFILE *p = &proxy->profile[dir];
+    BYTE buf[BUFFER_SIZE];
+    ssize_t n = recv(conn->fd[dir], buf, sizeof(buf), MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+        tcp_close(proxy, conn);
+        return;
+    }
+    if (n < 0)
+        return;
+    fault_stat(proxy, STAT(packets, dir));
+    fault_stat(proxy, STAT(passed, dir));
+
+    // 지연은 read 하나에 한 번, 앞 조각보다 먼저 나가지 않게 (TCP 순서 유지)
+    uint64_t delay = fault_delay(proxy, p);
+    uint64_t due = FAS_MonotonicUs() + delay;
+    if (due < conn->last_due[dir])
+        due = conn->last_due[dir];
+    conn->last_due[dir] = due;
+
+    int out = conn->fd[dir ^ 1];
+    if (p->tcp_segment <= 0) {
+        fault_enqueue(proxy, out, NULL, buf, (int)n, due);
+        fault_log(proxy, "tcp", dir, "pass", (int)n, -1, delay);
+        return;
+    }
+    for (int pos = 0; pos < n;) {
+        int len = 1 + (int)(fault_random(proxy) * p->tcp_segment);
+        if (len > n - pos)
+            len = (int)n - pos;
+        fault_enqueue(proxy, out, NULL, buf + pos, len, due);
+        fault_stat(proxy, STAT(segments, dir));
+        fault_log(proxy, "tcp", dir, "split", len, -1, delay);
+        pos += len;
+    }
+}
+
+/************************************************************************************************************************************
+ ************************************************** thread, 시작/정지 *************************************************************
+ ************************************************************************************************************************************/
+
+static void *fault_thread_main(void *arg){
+    FAS_FAULT_PROXY *proxy = arg;
+    struct pollfd pfd[2 + FAS_FAULT_CLIENTS + 2 * FAS_FAULT_TCP];
+    void *owner[2 + FAS_FAULT_CLIENTS + 2 * FAS_FAULT_TCP];
+
+    while (atomic_load_explicit(&proxy->running, memory_order_relaxed)) {
+        int n = 0;
+        pfd[n] = (struct pollfd){ .fd = proxy->udp_fd, .events = POLLIN };
+        owner[n++] = NULL;
+        if (proxy->tcp_fd >= 0) {
+            pfd[n] = (struct pollfd){ .fd = proxy->tcp_fd, .events = POLLIN };
+            owner[n++] = NULL;
+        }
+        for (int i = 0; i < FAS_FAULT_CLIENTS; i++) {
+            if (proxy->client[i].upstream >= 0) {
+                pfd[n] = (struct pollfd){ .fd = proxy->client[i].upstream, .events = POLLIN };
+                owner[n++] = &proxy->client[i];
+            }
+        }
+        for (int i = 0; i < FAS_FAULT_TCP; i++) {
+            for (int d = 0; d < 2; d++) {
+                if (proxy->conn[i].fd[d] >= 0) {
+                    pfd[n] = (struct pollfd){ .fd = proxy->conn[i].fd[d], .events = POLLIN };
+                    owner[n++] = &proxy->conn[i];
+                }
+            }
+        }
+
+        // 다음 송신 예정 시각까지 (us 단위로 맞추려고 ppoll), 없으면 정지 확인용 100ms
+        uint64_t now = FAS_MonotonicUs();
+        uint64_t wait_us = 100000;
+        if (proxy->queued > 0)
+            wait_us = proxy->queue[0].due_us > now ? proxy->queue[0].due_us - now : 0;
+        if (wait_us > 100000)
+            wait_us = 100000;
+        struct timespec ts = { .tv_sec = 0, .tv_nsec = (long)wait_us * 1000 };
+        int ready = ppoll(pfd, n, &ts, NULL);
+
+        fault_flush(proxy, FAS_MonotonicUs());
+        for (int i = 0; ready > 0 && i < n; i++) {
+            if (!(pfd[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            if (pfd[i].fd == proxy->udp_fd) {
+                udp_from_client(proxy);
+            }
+            else if (pfd[i].fd == proxy->tcp_fd) {
+                tcp_accept(proxy);
+            }
+            else if ((FAS_FAULT_UDP_CLIENT *)owner[i] >= proxy->client
+                     && (FAS_FAULT_UDP_CLIENT *)owner[i] < proxy->client + FAS_FAULT_CLIENTS) {
+                udp_from_target(proxy, owner[i]);
+            }
+            else {
+                FAS_FAULT_TCP_CONN *conn = owner[i];
+                for (int d = 0; d < 2; d++) {
+                    if (conn->fd[d] == pfd[i].fd) {
+                        tcp_relay(proxy, conn, d);
+                        break;
+                    }
+                }
+            }
+        }
+        fault_flush(proxy, FAS_MonotonicUs());
+    }
+    return NULL;
+}
+
+static int fault_listen(const struct sockaddr_in *addr, int type){
+    int fd = socket(AF_INET, type | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0)
+        return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (const struct sockaddr *)addr, sizeof(*addr)) < 0 || (type == SOCK_STREAM && listen(fd, 8) < 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+ /**@brief proxy 시작
+  * @param const char *listen_ip 도구가 드라이브 주소 대신 쓸 주소 ("127.0.0.60" 등)
+  * @param const char *target_ip 실제 드라이브 또는 가짜 드라이브 주소
+  * @param const FAS_FAULT_PROFILE *up 요청 방향 설정 (NULL이면 고장 없음)
+  * @param const FAS_FAULT_PROFILE *down 응답 방향 설정 (NULL이면 고장 없음)
+  * @param uint64_t seed 난수 seed (0이면 1)
+  * @param const char *log_path 주입 기록 CSV (NULL이면 기록 안 함)
+  * @return boolean 성공시 TRUE 실패시 FALSE (TCP port를 못 열면 경고만 하고 UDP만)*/
+bool FAS_FaultProxyStart(FAS_FAULT_PROXY *proxy, const char *listen_ip, const char *target_ip,
+                         const FAS_FAULT_PROFILE *up, const FAS_FAULT_PROFILE *down, uint64_t seed, const char *log_path){
+    memset(proxy, 0, sizeof(*proxy));
+    proxy->udp_fd = proxy->tcp_fd = -1;
+    for (int i = 0; i < FAS_FAULT_CLIENTS; i++)
+        proxy->client[i].upstream = -1;
+    for (int i = 0; i < FAS_FAULT_TCP; i++)
+        proxy->conn[i].fd[0] = proxy->conn[i].fd[1] = -1;
+    if (up != NULL)
+        proxy->profile[FAS_FAULT_UP] = *up;
+    if (down != NULL)
+        proxy->profile[FAS_FAULT_DOWN] = *down;
+    proxy->rng = seed ? seed : 1;
+
+    struct sockaddr_in listen_addr = { .sin_family = AF_INET };
+    proxy->target.sin_family = AF_INET;
+    if (inet_pton(AF_INET, listen_ip, &listen_addr.sin_addr) <= 0 || inet_pton(AF_INET, target_ip, &proxy->target.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid address: %s / %s\n", listen_ip, target_ip);
+        return false;
+    }
+    listen_addr.sin_port = htons(PORT_UDP);
+    proxy->udp_fd = fault_listen(&listen_addr, SOCK_DGRAM);
+    if (proxy->udp_fd < 0) {
+        perror("proxy UDP bind failed");
+        return false;
+    }
+    listen_addr.sin_port = htons(PORT_TCP);
+    proxy->tcp_fd = fault_listen(&listen_addr, SOCK_STREAM);
+    if (proxy->tcp_fd < 0)
+        fprintf(stderr, "proxy: TCP port %d not available, UDP only\n", PORT_TCP);
+
+    proxy->queue = malloc(FAS_FAULT_QUEUE * sizeof(*proxy->queue));
+    if (proxy->queue == NULL) {
+        perror("proxy queue allocation failed");
+        FAS_FaultProxyStop(proxy);
+        return false;
+    }
+    if (log_path != NULL) {
+        proxy->log = fopen(log_path, "w");
+        if (proxy->log == NULL) {
+            perror(log_path);
+            FAS_FaultProxyStop(proxy);
+            return false;
+        }
+        fprintf(proxy->log, "t_us,proto,dir,action,len,sync,delay_us\n");
+    }
+
+    atomic_store(&proxy->running, true);
+    if (pthread_create(&proxy->thread, NULL, fault_thread_main, proxy) != 0) {
+        perror("proxy thread create failed");
+        atomic_store(&proxy->running, false);
+        FAS_FaultProxyStop(proxy);
+        return false;
+    }
+    return true;
+}
+
+ /**@brief proxy 정지, 아직 지연 중인 packet은 버림*/
+void FAS_FaultProxyStop(FAS_FAULT_PROXY *proxy){
+    if (atomic_exchange(&proxy->running, false))
+        pthread_join(proxy->thread, NULL);
+    for (int i = 0; i < FAS_FAULT_TCP; i++)
+        tcp_close(proxy, &proxy->conn[i]);
+    for (int i = 0; i < FAS_FAULT_CLIENTS; i++) {
+        if (proxy->client[i].upstream >= 0)
+            close(proxy->client[i].upstream);
+        proxy->client[i].upstream = -1;
+    }
+    if (proxy->udp_fd >= 0)
+        close(proxy->udp_fd);
+    if (proxy->tcp_fd >= 0)
+        close(proxy->tcp_fd);
+    proxy->udp_fd = proxy->tcp_fd = -1;
+    if (proxy->log != NULL)
+        fclose(proxy->log);
+    proxy->log = NULL;
+    free(proxy->queue);
+    proxy->queue = NULL;
+    proxy->queued = 0;
+}
+
+ /**@brief 누적 통계 사본 (proxy thread는 멈추지 않음)*/
+void FAS_FaultProxyGetStats(FAS_FAULT_PROXY *proxy, FAS_FAULT_STATS *stats){
+    uint64_t *out = (uint64_t *)stats;
+    for (size_t i = 0; i < sizeof(*stats) / sizeof(uint64_t); i++)
+        out[i] = atomic_load_explicit(&proxy->stats[i], memory_order_relaxed);
+}
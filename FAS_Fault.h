@@ -0,0 +1,117 @@
+
+#pragma once
+
+#ifndef FAS_FAULT_DEFINE
+#define FAS_FAULT_DEFINE
+
+/**
+ * @file FAS_Fault.h
+ * @brief 도구와 드라이브(또는 가짜 드라이브) 사이에 끼워서 나쁜 네트워크를 흉내 내는 proxy
+ * @details listen_ip:PORT_UDP/PORT_TCP로 받은 것을 target_ip의 같은 port로 넘기고, 응답은 거꾸로 돌려준다.
+ * 방향(요청 = up, 응답 = down)마다 지연 분포, jitter, 손실, 중복, 순서 바꿈, TCP 분할을 따로 정한다.
+ * - UDP: datagram마다 손실/중복/순서 바꿈을 정하고, 지연 뒤에 보낸다.
+ * - TCP: 손실/중복/순서 바꿈은 TCP가 이미 숨기므로 하지 않고, 지연과 segment 분할만 한다 (순서는 유지).
+ * 난수는 seed로 정해지므로 같은 seed, 같은 트래픽이면 같은 결과가 나온다.
+ * log를 지정하면 지나간 packet마다 무엇을 했는지 CSV 한 줄로 남긴다:
+ * t_us,proto,dir,action,len,sync,delay_us (action: pass, drop, dup, reorder, split)
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include "Protocol_Define.h"
+
+#define FAS_FAULT_CLIENTS 16				// UDP client(보내는 쪽 주소) 수
+#define FAS_FAULT_TCP 8						// 동시 TCP 연결 수
+#define FAS_FAULT_QUEUE 4096				// 지연 중인 packet 수
+
+/**@brief 지연 분포, delay = latency_us + 분포에서 뽑은 값*/
+typedef enum _FAS_FAULT_DIST
+{
+	FAS_FAULT_FIXED = 0,			// jitter 없음
+	FAS_FAULT_UNIFORM,				// [0, jitter_us]
+	FAS_FAULT_NORMAL,				// 평균 0, 표준편차 jitter_us (0 아래는 0)
+	FAS_FAULT_PARETO,				// 긴 꼬리 (shape 1.5, scale jitter_us, 최대 100 x jitter_us)
+} FAS_FAULT_DIST;
+
+/**@brief 한 방향의 고장 설정*/
+typedef struct _FAS_FAULT_PROFILE
+{
+	FAS_FAULT_DIST dist;
+	uint32_t latency_us;			// 기본 지연
+	uint32_t jitter_us;				// 분포 크기
+	double loss;					// 버릴 확률 (0~1, UDP)
+	double duplicate;				// 두 번 보낼 확률 (UDP)
+	double reorder;					// reorder_us만큼 더 붙잡아서 뒤 packet에 추월당하게 할 확률 (UDP)
+	uint32_t reorder_us;
+	int tcp_segment;				// TCP를 1 ~ tcp_segment byte로 잘라 보냄 (0이면 자르지 않음)
+} FAS_FAULT_PROFILE;
+
+enum { FAS_FAULT_UP = 0, FAS_FAULT_DOWN = 1 };
+
+/**@brief 방향별 누적 통계*/
+typedef struct _FAS_FAULT_STATS
+{
+	uint64_t packets[2];			// 받은 packet (TCP는 read 한 번)
+	uint64_t passed[2];
+	uint64_t dropped[2];
+	uint64_t duplicated[2];
+	uint64_t reordered[2];
+	uint64_t segments[2];			// TCP로 나눠 보낸 조각 수
+	uint64_t overflow;				// 지연 queue가 차서 버린 packet
+} FAS_FAULT_STATS;
+
+/**@brief 지연 중인 packet 하나*/
+typedef struct _FAS_FAULT_PACKET
+{
+	uint64_t due_us;
+	uint64_t seq;					// 같은 시각이면 먼저 들어온 것부터
+	int fd;							// 보낼 소켓
+	bool udp_reply;					// UDP 응답이면 client 주소로 sendto
+	struct sockaddr_in to;
+	int len;
+	BYTE data[BUFFER_SIZE];
+} FAS_FAULT_PACKET;
+
+typedef struct _FAS_FAULT_UDP_CLIENT
+{
+	struct sockaddr_in addr;
+	int upstream;					// target에 connect한 소켓, -1이면 빈 칸
+} FAS_FAULT_UDP_CLIENT;
+
+typedef struct _FAS_FAULT_TCP_CONN
+{
+	int fd[2];						// [FAS_FAULT_UP] client 쪽, [FAS_FAULT_DOWN] target 쪽, -1이면 빈 칸
+	uint64_t last_due[2];			// 방향별 마지막 송신 예정 시각 (순서 유지)
+} FAS_FAULT_TCP_CONN;
+
+typedef struct _FAS_FAULT_PROXY
+{
+	int udp_fd;
+	int tcp_fd;						// listen 소켓, bind 못 하면 -1 (UDP만)
+	struct sockaddr_in target;
+	FAS_FAULT_PROFILE profile[2];
+	uint64_t rng;
+	uint64_t seq;
+	FILE *log;
+
+	pthread_t thread;
+	_Atomic bool running;
+
+	FAS_FAULT_UDP_CLIENT client[FAS_FAULT_CLIENTS];
+	FAS_FAULT_TCP_CONN conn[FAS_FAULT_TCP];
+	FAS_FAULT_PACKET *queue;		// due_us 기준 min heap
+	int queued;
+
+	_Atomic uint64_t stats[sizeof(FAS_FAULT_STATS) / sizeof(uint64_t)];
+} FAS_FAULT_PROXY;
+
+bool FAS_FaultProxyStart(FAS_FAULT_PROXY *proxy, const char *listen_ip, const char *target_ip,
+                         const FAS_FAULT_PROFILE *up, const FAS_FAULT_PROFILE *down, uint64_t seed, const char *log_path);
+void FAS_FaultProxyStop(FAS_FAULT_PROXY *proxy);
+void FAS_FaultProxyGetStats(FAS_FAULT_PROXY *proxy, FAS_FAULT_STATS *stats);
+
+#endif	//FAS_FAULT_DEFINE
@@ -0,0 +1,100 @@
+/**
+ * @file FAS_FaultProxy.c
+ * @brief 고장 주입 proxy 실행 파일 (FAS_Fault)
+ * @details 사용법: FAS_FaultProxy -l 127.0.0.60 -t 127.0.0.61 [설정...]
+ * 도구(ProtocolTest, FAS_Bench 등)에는 드라이브 주소 대신 -l 주소를 넣는다. Ctrl+C로 끝내면 방향별 통계를 출력한다.
+ *   -d us       기본 지연                 -j us       jitter (분포 크기)
+ *   -D 분포     fixed|uniform|normal|pareto
+ *   -L %        손실                      -u %        중복
+ *   -r %        순서 바꿈                 -R us       순서 바꿀 때 더 붙잡는 시간 (기본 2 x (지연 + jitter) + 1000)
+ *   -s bytes    TCP를 1~bytes로 잘라 보냄
+ *   -x 방향     up|down|both (기본 both, 요청/응답 중 어느 쪽에 고장을 넣을지)
+ *   -S seed     난수 seed (기본 1)        -o file     주입 기록 CSV
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include "FAS_Fault.h"
+
+static volatile sig_atomic_t proxy_stop;
+
+static void on_signal(int sig){
+    proxy_stop = 1;
+}
+
+static void usage(const char *name){
+    fprintf(stderr, "usage: %s -l listen_ip -t target_ip [-d us] [-j us] [-D fixed|uniform|normal|pareto]\n"
+                    "       [-L loss%%] [-u dup%%] [-r reorder%%] [-R us] [-s tcp_segment] [-x up|down|both] [-S seed] [-o log.csv]\n", name);
+}
+
+int main(int argc, char *argv[]){
+    static FAS_FAULT_PROXY proxy;
+    FAS_FAULT_PROFILE profile = { 0 };
+    const char *listen_ip = NULL, *target_ip = NULL, *log_path = NULL, *direction = "both";
+    uint64_t seed = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "l:t:d:j:D:L:u:r:R:s:x:S:o:")) != -1) {
+        switch (opt) {
+            case 'l': listen_ip = optarg; break;
+            case 't': target_ip = optarg; break;
+            case 'd': profile.latency_us = (uint32_t)atoi(optarg); break;
+            case 'j': profile.jitter_us = (uint32_t)atoi(optarg); break;
+            case 'D':
+                if (strcmp(optarg, "uniform") == 0)
+                    profile.dist = FAS_FAULT_UNIFORM;
+                else if (strcmp(optarg, "normal") == 0)
+                    profile.dist = FAS_FAULT_NORMAL;
+                else if (strcmp(optarg, "pareto") == 0)
+                    profile.dist = FAS_FAULT_PARETO;
+                else
+                    profile.dist = FAS_FAULT_FIXED;
+                break;
+            case 'L': profile.loss = atof(optarg) / 100.0; break;
+            case 'u': profile.duplicate = atof(optarg) / 100.0; break;
+            case 'r': profile.reorder = atof(optarg) / 100.0; break;
+            case 'R': profile.reorder_us = (uint32_t)atoi(optarg); break;
+            case 's': profile.tcp_segment = atoi(optarg); break;
+            case 'x': direction = optarg; break;
+            case 'S': seed = strtoull(optarg, NULL, 0); break;
+            case 'o': log_path = optarg; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (listen_ip == NULL || target_ip == NULL) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (profile.reorder > 0 && profile.reorder_us == 0)
+        profile.reorder_us = 2 * (profile.latency_us + profile.jitter_us) + 1000;
+
+    static const FAS_FAULT_PROFILE none = { 0 };
+    const FAS_FAULT_PROFILE *up = strcmp(direction, "down") == 0 ? &none : &profile;
+    const FAS_FAULT_PROFILE *down = strcmp(direction, "up") == 0 ? &none : &profile;
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    if (!FAS_FaultProxyStart(&proxy, listen_ip, target_ip, up, down, seed, log_path))
+        return 1;
+    printf("proxy %s -> %s (UDP %d, TCP %d), Ctrl+C to stop\n", listen_ip, target_ip, PORT_UDP, PORT_TCP);
+    while (!proxy_stop)
+        pause();
+
+    FAS_FAULT_STATS st;
+    FAS_FaultProxyGetStats(&proxy, &st);
+    FAS_FaultProxyStop(&proxy);
+    printf("%5s %10s %10s %10s %10s %10s %10s\n", "dir", "packets", "passed", "dropped", "dup", "reorder", "segments");
+    for (int d = 0; d < 2; d++)
+        printf("%5s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+               d == FAS_FAULT_UP ? "up" : "down", st.packets[d], st.passed[d], st.dropped[d],
+               st.duplicated[d], st.reordered[d], st.segments[d]);
+    if (st.overflow)
+        printf("queue overflow: %" PRIu64 "\n", st.overflow);
+    return 0;
+}
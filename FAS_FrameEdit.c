@@ -0,0 +1,168 @@
+/**
+ * @file FAS_FrameEdit.c
+ * @brief Frame 입력칸 편집 model 구현
+ */
+
+#include <string.h>
+#include "FAS_FrameEdit.h"
+
+static bool is_separator(char c){
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '[' || c == ']';
+}
+
+static int digit_value(char c, int base){
+    int v;
+    if (c >= '0' && c <= '9')
+        v = c - '0';
+    else if (c >= 'a' && c <= 'f')
+        v = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+        v = c - 'A' + 10;
+    else
+        return -1;
+    return v < base ? v : -1;
+}
+
+// text[start, end) 안의 token을 out에 채움, 돌려주는 값은 token 수
+static int tokenize(const FAS_FRAME_EDIT *edit, int start, int end, FAS_EDIT_TOKEN *out){
+    int n = 0;
+    int i = start;
+    while (i < end) {
+        if (is_separator(edit->text[i])) {
+            i++;
+            continue;
+        }
+        int s = i, value = 0;
+        while (i < end && !is_separator(edit->text[i])) {
+            int d = digit_value(edit->text[i], edit->base);
+            if (d < 0 || value < 0)
+                value = -1;
+            else if ((value = value * edit->base + d) > 0xFF)
+                value = -1;
+            i++;
+        }
+        out[n].start = (uint16_t)s;
+        out[n].len = (uint16_t)(i - s);
+        out[n].value = (int16_t)value;
+        n++;
+    }
+    return n;
+}
+
+static void reparse_all(FAS_FRAME_EDIT *edit){
+    edit->base = edit->text_len > 0 && edit->text[0] == '[' ? 16 : 10;
+    edit->tokens = tokenize(edit, 0, edit->text_len, edit->token);
+    edit->invalid = 0;
+    for (int i = 0; i < edit->tokens; i++) {
+        edit->bytes[i] = edit->token[i].value < 0 ? 0 : (BYTE)edit->token[i].value;
+        if (edit->token[i].value < 0)
+            edit->invalid++;
+    }
+    edit->changed_at = 0;
+    edit->removed = 0;
+    edit->inserted = edit->tokens;
+    edit->reparsed = true;
+}
+
+ /**@brief 빈 입력칸으로 초기화*/
+void FAS_FrameEditInit(FAS_FRAME_EDIT *edit){
+    memset(edit, 0, sizeof(*edit));
+    edit->base = 10;
+}
+
+ /**@brief 입력칸의 pos부터 del_len 글자를 ins로 바꿈 (삽입은 del_len 0, 삭제는 ins_len 0)
+  * @details 편집 범위에 닿는 token만 다시 읽어 끼워 넣는다. token 뒤쪽은 위치만 옮긴다(memmove).
+  * @return 입력칸이 FAS_EDIT_TEXT_MAX를 넘거나 위치가 잘못되면 FALSE (model은 그대로)*/
+bool FAS_FrameEditReplace(FAS_FRAME_EDIT *edit, int pos, int del_len, const char *ins, int ins_len){
+    if (pos < 0 || del_len < 0 || ins_len < 0 || pos + del_len > edit->text_len)
+        return false;
+    int delta = ins_len - del_len;
+    if (edit->text_len + delta > FAS_EDIT_TEXT_MAX)
+        return false;
+
+    memmove(&edit->text[pos + ins_len], &edit->text[pos + del_len], edit->text_len - pos - del_len);
+    memcpy(&edit->text[pos], ins, ins_len);
+    edit->text_len += delta;
+    edit->text[edit->text_len] = '\0';
+
+    // '['가 생기거나 없어져 진법이 바뀌면 전부 다시 읽음
+    int base = edit->text_len > 0 && edit->text[0] == '[' ? 16 : 10;
+    if (base != edit->base) {
+        reparse_all(edit);
+        return true;
+    }
+
+    // 옛 좌표에서 [pos, pos + del_len]에 닿는 token [a, b) (앞뒤로 붙어 있는 token도 포함)
+    int a = 0, b;
+    int lo = 0, hi = edit->tokens;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (edit->token[mid].start + edit->token[mid].len < pos)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    a = lo;
+    for (b = a; b < edit->tokens && edit->token[b].start <= pos + del_len; b++)
+        ;
+
+    int span_start = pos, span_end = pos + del_len;
+    if (a < b) {
+        if (edit->token[a].start < span_start)
+            span_start = edit->token[a].start;
+        if (edit->token[b - 1].start + edit->token[b - 1].len > span_end)
+            span_end = edit->token[b - 1].start + edit->token[b - 1].len;
+    }
+
+    FAS_EDIT_TOKEN fresh[FAS_EDIT_TOKEN_MAX];
+    int m = tokenize(edit, span_start, span_end + delta, fresh);
+    if (edit->tokens - (b - a) + m > FAS_EDIT_TOKEN_MAX)
+        return false;	// 구분자 하나당 글자 하나 이상이므로 실제로는 생기지 않음
+
+    for (int i = a; i < b; i++) {
+        if (edit->token[i].value < 0)
+            edit->invalid--;
+    }
+    int tail = edit->tokens - b;
+    memmove(&edit->token[a + m], &edit->token[b], tail * sizeof(FAS_EDIT_TOKEN));
+    memmove(&edit->bytes[a + m], &edit->bytes[b], tail);
+    for (int i = a + m; i < a + m + tail; i++)
+        edit->token[i].start = (uint16_t)(edit->token[i].start + delta);
+    for (int i = 0; i < m; i++) {
+        edit->token[a + i] = fresh[i];
+        edit->bytes[a + i] = fresh[i].value < 0 ? 0 : (BYTE)fresh[i].value;
+        if (fresh[i].value < 0)
+            edit->invalid++;
+    }
+    edit->tokens += m - (b - a);
+
+    edit->changed_at = a;
+    edit->removed = b - a;
+    edit->inserted = m;
+    edit->reparsed = false;
+    return true;
+}
+
+ /**@brief 보낼 수 있는 내용인지 (숫자 1개 이상 DATA_SIZE 이하, 잘못된 숫자 없음, 16진수면 ']'로 끝남)*/
+bool FAS_FrameEditComplete(const FAS_FRAME_EDIT *edit){
+    if (edit->tokens == 0 || edit->tokens > DATA_SIZE || edit->invalid > 0)
+        return false;
+    if (edit->base == 16) {
+        int i = edit->text_len - 1;
+        while (i > 0 && (edit->text[i] == ' ' || edit->text[i] == '\n' || edit->text[i] == '\r' || edit->text[i] == '\t'))
+            i--;
+        return edit->text[i] == ']';
+    }
+    return true;
+}
+
+ /**@brief 처음으로 잘못된 token 번호 (없으면 -1)*/
+int FAS_FrameEditFirstInvalid(const FAS_FRAME_EDIT *edit){
+    if (edit->invalid == 0)
+        return -1;
+    for (int i = 0; i < edit->tokens; i++) {
+        if (edit->token[i].value < 0)
+            return i;
+    }
+    return -1;
+}
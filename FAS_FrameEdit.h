@@ -0,0 +1,53 @@
+
+#pragma once
+
+#ifndef FAS_FRAME_EDIT_DEFINE
+#define FAS_FRAME_EDIT_DEFINE
+
+/**
+ * @file FAS_FrameEdit.h
+ * @brief Frame 입력칸의 글자를 따라가며 byte 배열을 유지하는 편집 model
+ * @details 입력칸에 글자가 들어가거나 지워질 때마다 전체를 다시 읽지 않고, 편집 위치에 닿는 token만 다시 읽어
+ * token 배열과 byte 배열에 끼워 넣는다. "[2A 01]"처럼 '['로 시작하면 16진수, 아니면 10진수이고
+ * 공백과 '[' ']'는 구분자이다. 첫 글자가 '['로 바뀌거나 '['가 지워질 때만 전체를 다시 읽는다.
+ * 마지막 편집이 바꾼 byte 범위(changed_at, removed, inserted)를 남기므로 미리보기도 그 부분만 고치면 된다.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Protocol_Define.h"
+
+#define FAS_EDIT_TEXT_MAX 2048						// 입력칸 최대 글자 수
+#define FAS_EDIT_TOKEN_MAX (FAS_EDIT_TEXT_MAX / 2 + 1)	// 글자 하나 + 구분자 하나
+
+/**@brief 입력칸의 숫자 하나*/
+typedef struct _FAS_EDIT_TOKEN
+{
+	uint16_t start;			// 입력칸 글자 위치
+	uint16_t len;
+	int16_t value;			// 0~255, 잘못된 숫자면 -1
+} FAS_EDIT_TOKEN;
+
+typedef struct _FAS_FRAME_EDIT
+{
+	char text[FAS_EDIT_TEXT_MAX + 1];	// 입력칸 내용 (ASCII가 아닌 글자는 '?')
+	int text_len;
+	int base;							// 16 또는 10
+
+	FAS_EDIT_TOKEN token[FAS_EDIT_TOKEN_MAX];
+	BYTE bytes[FAS_EDIT_TOKEN_MAX];		// token[i].value, 잘못된 token은 0
+	int tokens;
+	int invalid;						// 잘못된 token 수
+
+	int changed_at;						// 마지막 편집: 처음 바뀐 byte 번호
+	int removed;						// 마지막 편집: 없어진 byte 수
+	int inserted;						// 마지막 편집: 새로 들어간 byte 수
+	bool reparsed;						// 마지막 편집에서 전체를 다시 읽었음
+} FAS_FRAME_EDIT;
+
+void FAS_FrameEditInit(FAS_FRAME_EDIT *edit);
+bool FAS_FrameEditReplace(FAS_FRAME_EDIT *edit, int pos, int del_len, const char *ins, int ins_len);
+bool FAS_FrameEditComplete(const FAS_FRAME_EDIT *edit);
+int FAS_FrameEditFirstInvalid(const FAS_FRAME_EDIT *edit);
+
+#endif	//FAS_FRAME_EDIT_DEFINE
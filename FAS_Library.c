@@ -0,0 +1,536 @@
+/**
+ * @file FAS_Library.c
+ * @brief libfastech: context별 명령 송수신, 보드 번호 표, 기존 FAS_* 함수
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "FAS_Library.h"
+#include "FAS_Metrics.h"
+#include "FAS_Trace.h"
+
+/**@brief 명령 이름과 요청 data 길이*/
+typedef struct _FAS_FRAME_INFO
+{
+	const char *name;
+	int data_len;
+} FAS_FRAME_INFO;
+
+static const FAS_FRAME_INFO frame_info[256] = {
+    [FRAME_GETSLAVEINFO]            = { "FAS_GetboardInfo", 0 },
+    [FRAME_GETMOTORINFO]            = { "FAS_GetMotorInfo", 0 },
+    [FRAME_GETENCODER]              = { "FAS_GetEncoder", 0 },
+    [FRAME_GETFIRMWAREINFO]         = { "FAS_GetFirmwareInfo", 0 },
+    [FRAME_GETSLAVEINFOEX]          = { "FAS_GetSlaveInfoEx", 0 },
+    [FRAME_SAVEALLPARAMETERS]       = { "FAS_SaveAllParameters", 0 },
+    [FRAME_GETROMPARAMETER]         = { "FAS_GetROMParameter", 1 },
+    [FRAME_SETPARAMETER]            = { "FAS_SetParameter", 5 },
+    [FRAME_GETPARAMETER]            = { "FAS_GetParameter", 1 },
+    [FRAME_SERVOENABLE]             = { "FAS_ServoEnable", 1 },
+    [FRAME_SERVOALARMRESET]         = { "FAS_ServoAlarmReset", 0 },
+    [FRAME_GETALARMTYPE]            = { "FAS_GetAlarmType", 0 },
+    [FRAME_MOVESTOP]                = { "FAS_MoveStop", 0 },
+    [FRAME_EMERGENCYSTOP]           = { "FAS_EmergencyStop", 0 },
+    [FRAME_MOVEORIGINSINGLEAXIS]    = { "FAS_MoveOriginSingleAxis", 0 },
+    [FRAME_MOVESINGLEAXISABSPOS]    = { "FAS_MoveSingleAxisAbsPos", 8 },
+    [FRAME_MOVESINGLEAXISINCPOS]    = { "FAS_MoveSingleAxisIncPos", 8 },
+    [FRAME_MOVETOLIMIT]             = { "FAS_MoveToLimit", 5 },
+    [FRAME_MOVEVELOCITY]            = { "FAS_MoveVelocity", 5 },
+    [FRAME_POSITIONABSOVERRIDE]     = { "FAS_PositionAbsOverride", 4 },
+    [FRAME_POSITIONINCOVERRIDE]     = { "FAS_PositionIncOverride", 4 },
+    [FRAME_VELOCITYOVERRIDE]        = { "FAS_VelocityOverride", 4 },
+    [FRAME_GETAXISSTATUS]           = { "FAS_GetAxisStatus", 0 },
+    [FRAME_GETIOAXISSTATUS]         = { "FAS_GetIOAxisStatus", 0 },
+    [FRAME_GETMOTIONSTATUS]         = { "FAS_GetMotionStatus", 0 },
+    [FRAME_GETALLSTATUS]            = { "FAS_GetAllStatus", 0 },
+    [FRAME_SETCOMMANDPOS]           = { "FAS_SetCommandPos", 4 },
+    [FRAME_GETCOMMANDPOS]           = { "FAS_GetCommandPos", 0 },
+    [FRAME_SETACTUALPOS]            = { "FAS_SetActualPos", 4 },
+    [FRAME_GETACTUALPOS]            = { "FAS_GetActualPos", 0 },
+    [FRAME_GETPOSERROR]             = { "FAS_GetPosError", 0 },
+    [FRAME_GETACTUALVEL]            = { "FAS_GetActualVel", 0 },
+    [FRAME_CLEARPOSITION]           = { "FAS_ClearPosition", 0 },
+    [FRAME_POSTABLEREADITEM]        = { "FAS_PosTableReadItem", 2 },
+    [FRAME_POSTABLEWRITEITEM]       = { "FAS_PosTableWriteItem", FAS_FRAME_DATA_VARIABLE },
+    [FRAME_POSTABLEREADROM]         = { "FAS_PosTableReadROM", 0 },
+    [FRAME_POSTABLEWRITEROM]        = { "FAS_PosTableWriteROM", 0 },
+    [FRAME_POSTABLERUNITEM]         = { "FAS_PosTableRunItem", 2 },
+};
+
+static _Atomic(FAS_CONTEXT *) board_context[FAS_MAX_BOARD];
+static pthread_mutex_t board_lock = PTHREAD_MUTEX_INITIALIZER;
+
+ /**@brief context 초기화 (연결은 FAS_ContextOpen)
+  * @param int iBdID 통계/trace에 쓰는 드라이브 ID*/
+void FAS_ContextInit(FAS_CONTEXT *ctx, int iBdID){
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->link.iBdID = iBdID;
+    ctx->link.fd = -1;
+    ctx->link.codec = &FAS_CodecFastech;
+    ctx->link.sync_no = (BYTE)(rand() % 256);
+    ctx->codec = &FAS_CodecFastech;
+    ctx->timeout_ms = FAS_DEFAULT_COMMAND_TIMEOUT_MS;
+}
+
+ /**@brief 프레임 변형 고르기 (port가 다르면 다음 FAS_ContextOpen부터 적용)
+  * @param const FAS_CODEC *codec FAS_CodecFastech, FAS_CodecUser, FAS_CodecSerial 또는 등록한 codec*/
+void FAS_ContextSetCodec(FAS_CONTEXT *ctx, const FAS_CODEC *codec){
+    ctx->codec = codec;
+    FAS_LinkSetCodec(&ctx->link, codec);
+}
+
+ /**@brief 드라이브와 연결 (이미 열려 있으면 닫고 다시 연결, Header/Sync No.는 유지)
+  * @param const char *ip "192.168.0.2" 형식
+  * @param bool tcp TCP면 TRUE
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ContextOpen(FAS_CONTEXT *ctx, const char *ip, bool tcp){
+    BYTE sync_no = ctx->link.sync_no;
+    FAS_ContextClose(ctx);
+    if (!FAS_LinkOpenPort(&ctx->link, ctx->link.iBdID, ip, tcp, tcp ? ctx->codec->port_tcp : ctx->codec->port_udp))
+        return false;
+    ctx->link.sync_no = sync_no;
+    FAS_LinkSetCodec(&ctx->link, ctx->codec);
+    ctx->open = true;
+    return true;
+}
+
+ /**@brief 연결 해제*/
+void FAS_ContextClose(FAS_CONTEXT *ctx){
+    if (ctx->open)
+        FAS_LinkClose(&ctx->link);
+    ctx->open = false;
+}
+
+static void context_rx(const BYTE *frame, int len, void *user){
+    FAS_CONTEXT *ctx = user;
+    FAS_TRACE(FAS_TRACE_RECV, ctx->link.iBdID, frame[2], len);
+    if (ctx->wait_done || len > BUFFER_SIZE) {
+        ctx->stale_frames++;
+        return;
+    }
+    // 기다리는 동안 rx는 아직 의미가 없으므로 바로 거기에 풀어 씀 (serial codec은 제자리에서 고침)
+    memcpy(ctx->rx, frame, len);
+    if (!FAS_CodecDecode(ctx->codec, ctx->rx, len, &ctx->rx_view) || ctx->rx_view.sync != ctx->wait_sync) {
+        ctx->stale_frames++;
+        return;
+    }
+    ctx->rx_len = len;
+    ctx->wait_done = true;
+    ctx->ts_source = FAS_LinkWireUs(&ctx->link, ctx->wait_key, &ctx->wire_us);
+}
+
+ /**@brief 완성된 프레임을 그대로 보내고 같은 Sync No.의 응답을 기다림 (응답은 ctx->rx)
+  * @param const BYTE *frame Header부터 끝까지
+  * @param int len 프레임 길이
+  * @return 응답의 통신 상태, 응답이 없으면 FMC_TIMEOUT_ERROR*/
+FMM_ERROR FAS_ContextTransact(FAS_CONTEXT *ctx, const BYTE *frame, int len){
+    if (!ctx->open)
+        return FMM_NOT_OPEN;
+    if (len < FRAME_HEADER_SIZE || len > BUFFER_SIZE)
+        return FMP_PACKETERROR;
+
+    int iBdID = ctx->link.iBdID;
+    if (frame != ctx->tx)
+        memcpy(ctx->tx, frame, len);
+    ctx->tx_len = len;
+    ctx->rx_len = 0;
+    ctx->wait_sync = ctx->tx[2];		// Sync No. (serial은 같은 자리에 Slave ID)
+    ctx->wait_done = false;
+
+    uint64_t send_time = FAS_MonotonicUs();
+    if (FAS_LinkSendFrame(&ctx->link, ctx->tx, len) < 0) {
+        perror("send failed");
+        return FMC_DISCONNECTED;
+    }
+    FAS_TRACE(FAS_TRACE_SEND, iBdID, ctx->wait_sync, len);
+    FAS_MetricsSent(iBdID, len);
+    ctx->wait_key = ctx->link.tx_last;
+    ctx->ts_source = FAS_TS_NONE;
+
+    // SIGALRM 대신 poll timeout으로 기다림 (thread마다 따로 기다릴 수 있음)
+    uint64_t deadline = send_time + (uint64_t)ctx->timeout_ms * 1000u;
+    while (!ctx->wait_done) {
+        uint64_t now = FAS_MonotonicUs();
+        if (now >= deadline) {
+            FAS_MetricsTimeout(iBdID);
+            FAS_TRACE(FAS_TRACE_TIMEOUT, iBdID, ctx->wait_sync, 0);
+            return FMC_TIMEOUT_ERROR;
+        }
+        struct pollfd pfd = { .fd = ctx->link.fd, .events = POLLIN };
+        int ready = poll(&pfd, 1, (int)((deadline - now + 999) / 1000));
+        if (ready < 0 && errno != EINTR) {
+            perror("poll failed");
+            return FMC_DISCONNECTED;
+        }
+        if (ready > 0 && FAS_LinkReceive(&ctx->link, context_rx, ctx) < 0)
+            return FMC_DISCONNECTED;
+    }
+
+    uint64_t rtt = FAS_MonotonicUs() - send_time;
+    FMM_ERROR status = (FMM_ERROR)ctx->rx_view.status;
+    FAS_TRACE(FAS_TRACE_MATCH, iBdID, ctx->wait_sync, rtt);
+    FAS_MetricsReceived(iBdID, ctx->rx_len, status, rtt);
+    ctx->rtt_us = (uint32_t)rtt;
+    if (ctx->ts_source != FAS_TS_NONE)
+        FAS_MetricsWire(iBdID, ctx->wire_us, rtt);
+    else
+        ctx->wire_us = ctx->rtt_us;
+    return status;
+}
+
+ /**@brief 명령 하나 보내고 응답 받기 (Sync No.는 자동 증가)
+  * @param const void *data 명령 data (NULL 가능)
+  * @param BYTE *resp 통신 상태 뒤의 응답 data를 받을 곳 (NULL 가능)
+  * @param int resp_size resp 크기
+  * @param int *resp_len 응답 data 길이 (NULL 가능)
+  * @return 응답의 통신 상태*/
+FMM_ERROR FAS_ContextCommand(FAS_CONTEXT *ctx, BYTE frame_type, const void *data, int data_len,
+                             BYTE *resp, int resp_size, int *resp_len){
+    if (data_len < 0 || data_len > DATA_SIZE)
+        return FMP_DATAERROR;
+    BYTE sync = ctx->codec->sync ? ctx->link.sync_no++ : (BYTE)ctx->link.iBdID;
+    int len = FAS_CodecEncode(ctx->codec, ctx->tx, sync, frame_type, data, data_len);
+    if (len < 0)
+        return FMP_DATAERROR;
+    FAS_TRACE(FAS_TRACE_BUILD, ctx->link.iBdID, ctx->tx[2], frame_type);
+
+    FMM_ERROR status = FAS_ContextTransact(ctx, ctx->tx, len);
+    int n = 0;
+    if (ctx->rx_len > 0 && ctx->rx_view.data_len > 0) {
+        n = ctx->rx_view.data_len;
+        if (resp != NULL) {
+            if (n > resp_size)
+                n = resp_size;
+            memcpy(resp, ctx->rx_view.data, n);
+        }
+    }
+    if (resp_len != NULL)
+        *resp_len = n;
+    return status;
+}
+
+ /**@brief 보드 번호의 context (처음 부를 때 만듦, 만든 뒤에는 lock 없이 조회)
+  * @return 번호가 범위 밖이거나 메모리 부족이면 NULL*/
+FAS_CONTEXT *FAS_BoardContext(int iBdID){
+    if (iBdID < 0 || iBdID >= FAS_MAX_BOARD)
+        return NULL;
+    FAS_CONTEXT *ctx = atomic_load_explicit(&board_context[iBdID], memory_order_acquire);
+    if (ctx != NULL)
+        return ctx;
+
+    pthread_mutex_lock(&board_lock);
+    ctx = atomic_load_explicit(&board_context[iBdID], memory_order_relaxed);
+    if (ctx == NULL) {
+        ctx = malloc(sizeof(FAS_CONTEXT));
+        if (ctx != NULL) {
+            FAS_ContextInit(ctx, iBdID);
+            atomic_store_explicit(&board_context[iBdID], ctx, memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&board_lock);
+    return ctx;
+}
+
+ /**@brief 이미 만든 보드 context 조회 (만들지 않음, lock 없음)
+  * @return 아직 만들지 않았거나 번호가 범위 밖이면 NULL*/
+FAS_CONTEXT *FAS_BoardContextFind(int iBdID){
+    if (iBdID < 0 || iBdID >= FAS_MAX_BOARD)
+        return NULL;
+    return atomic_load_explicit(&board_context[iBdID], memory_order_acquire);
+}
+
+ /**@brief 명령 이름 (모르는 명령이면 "Transfer Fail")*/
+const char *FAS_FrameName(BYTE frame_type){
+    return frame_info[frame_type].name != NULL ? frame_info[frame_type].name : "Transfer Fail";
+}
+
+ /**@brief 명령의 요청 data 길이
+  * @return 모르는 명령이거나 길이가 정해지지 않았으면 FAS_FRAME_DATA_VARIABLE*/
+int FAS_FrameDataLength(BYTE frame_type){
+    return frame_info[frame_type].name != NULL ? frame_info[frame_type].data_len : FAS_FRAME_DATA_VARIABLE;
+}
+
+ /**@brief 통신 상태 이름*/
+const char *FAS_ErrorName(FMM_ERROR error){
+    switch (error) {
+        case FMM_OK:
+            return "FMM_OK";
+        case FMM_NOT_OPEN:
+            return "FMM_NOT_OPEN";
+        case FMM_INVALID_PORT_NUM:
+            return "FMM_INVALID_PORT_NUM";
+        case FMM_INVALID_SLAVE_NUM:
+            return "FMM_INVALID_SLAVE_NUM";
+        case FMC_DISCONNECTED:
+            return "FMC_DISCONNECTED";
+        case FMC_TIMEOUT_ERROR:
+            return "FMC_TIMEOUT_ERROR";
+        case FMC_CRCFAILED_ERROR:
+            return "FMC_CRCFAILED_ERROR";
+        case FMC_RECVPACKET_ERROR:
+            return "FMC_RECVPACKET_ERROR";
+        case FMM_POSTABLE_ERROR:
+            return "FMM_POSTABLE_ERROR";
+        case FMM_PREEMPTED:
+            return "FMM_PREEMPTED";
+        case FMP_FRAMETYPEERROR:
+            return "FMP_FRAMETYPEERROR";
+        case FMP_DATAERROR:
+            return "FMP_DATAERROR";
+        case FMP_PACKETERROR:
+            return "FMP_PACKETERROR";
+        case FMP_RUNFAIL:
+            return "FMP_RUNFAIL";
+        case FMP_RESETFAIL:
+            return "FMP_RESETFAIL";
+        case FMP_SERVOONFAIL1:
+            return "FMP_SERVOONFAIL1";
+        case FMP_SERVOONFAIL2:
+            return "FMP_SERVOONFAIL2";
+        case FMP_SERVOONFAIL3:
+            return "FMP_SERVOONFAIL3";
+        case FMP_SERVOOFF_FAIL:
+            return "FMP_SERVOOFF_FAIL";
+        case FMP_ROMACCESS:
+            return "FMP_ROMACCESS";
+        case FMP_PACKETCRCERROR:
+            return "FMP_PACKETCRCERROR";
+        case FMM_UNKNOWN_ERROR:
+            return "FMM_UNKNOWN_ERROR";
+        default:
+            return "Unknown error";
+    }
+}
+
+static const char hex_digit[] = "0123456789ABCDEF";
+
+ /**@brief 프레임을 "AA 03 12 00 01" 형식 문자열로 (heap을 쓰지 않음)
+  * @param char *text 결과, len * 3 byte면 충분
+  * @param int text_size text 크기
+  * @return 쓴 글자 수 (text_size가 모자라면 들어가는 만큼만)*/
+int FAS_FormatFrame(char *text, int text_size, const BYTE *frame, int len){
+    int n = 0;
+    if (text_size <= 0)
+        return 0;
+    for (int i = 0; i < len && n + 3 <= text_size; i++) {
+        if (i > 0)
+            text[n++] = ' ';
+        text[n++] = hex_digit[frame[i] >> 4];
+        text[n++] = hex_digit[frame[i] & 0x0F];
+    }
+    text[n] = '\0';
+    return n;
+}
+
+ /**@brief 공백으로 나뉜 숫자들을 byte 배열로 (heap을 쓰지 않음, '[' ']' 등 숫자가 아닌 글자는 구분자로 취급)
+  * @param int base 16 또는 10
+  * @return 읽은 byte 수 (out_size까지만)*/
+int FAS_ParseBytes(const char *text, int base, BYTE *out, int out_size){
+    int count = 0;
+    const char *p = text;
+    while (*p != '\0' && count < out_size) {
+        char *end;
+        unsigned long value = strtoul(p, &end, base);
+        if (end == p) {
+            p++;
+            continue;
+        }
+        out[count++] = (BYTE)value;
+        p = end;
+    }
+    return count;
+}
+
+/************************************************************************************************************************************
+ ******************************************* 보드 번호로 부르는 기존 FAS_* 함수 ***************************************************
+ ************************************************************************************************************************************/
+
+static bool board_connect(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID, bool tcp){
+    char ip[16]; //최대 길이 가정 "xxx.xxx.xxx.xxx\0"
+    snprintf(ip, sizeof(ip), "%u.%u.%u.%u", sb1, sb2, sb3, sb4);
+    FAS_CONTEXT *ctx = FAS_BoardContext(iBdID);
+    if (ctx == NULL)
+        return false;
+    return FAS_ContextOpen(ctx, ip, tcp);
+}
+
+static int board_command(int iBdID, BYTE frame_type, const void *data, int data_len, BYTE *resp, int resp_size, int *resp_len){
+    FAS_CONTEXT *ctx = FAS_BoardContext(iBdID);
+    if (ctx == NULL)
+        return FMM_INVALID_SLAVE_NUM;
+    return FAS_ContextCommand(ctx, frame_type, data, data_len, resp, resp_size, resp_len);
+}
+
+// 응답 data가 [Type][문자열]인 정보 조회 명령
+static int board_info(int iBdID, BYTE frame_type, BYTE *pType, LPSTR lpBuff, int nBuffSize){
+    BYTE resp[DATA_SIZE];
+    int resp_len;
+    int status = board_command(iBdID, frame_type, NULL, 0, resp, sizeof(resp), &resp_len);
+    if (status != FMM_OK)
+        return status;
+    if (pType != NULL && resp_len > 0)
+        *pType = resp[0];
+    if (lpBuff != NULL && nBuffSize > 0) {
+        int n = resp_len > 1 ? resp_len - 1 : 0;
+        if (n > nBuffSize - 1)
+            n = nBuffSize - 1;
+        memcpy(lpBuff, &resp[1], n);
+        lpBuff[n] = '\0';
+    }
+    return FMM_OK;
+}
+
+ /**@brief UDP 연결 시 사용
+  * @param BYTE sb1,sb2,sb3,sb4 IPv4주소 입력 시 각 자리
+  * @param int iBdID 드라이브 ID
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_Connect(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID){
+    return board_connect(sb1, sb2, sb3, sb4, iBdID, false);
+}
+
+ /**@brief TCP 연결 시 사용
+  * @param BYTE sb1,sb2,sb3,sb4 IPv4주소 입력 시 각 자리
+  * @param int iBdID 드라이브 ID
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ConnectTCP(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID){
+    return board_connect(sb1, sb2, sb3, sb4, iBdID, true);
+}
+
+ /**@brief 연결 해제 시 사용
+  * @param int iBdID 드라이브 ID */
+void FAS_Close(int iBdID){
+    FAS_CONTEXT *ctx = FAS_BoardContext(iBdID);
+    if (ctx != NULL)
+        FAS_ContextClose(ctx);
+}
+
+ /**@brief 연결되어 있는지
+  * @param int iBdID 드라이브 ID */
+bool FAS_IsConnected(int iBdID){
+    FAS_CONTEXT *ctx = FAS_BoardContext(iBdID);
+    return ctx != NULL && ctx->open;
+}
+
+ /**@brief 해당보드의 정보
+  * @param int iBdID 드라이브 ID
+  * @param BYTE *pType 보드의 Type
+  * @param LPSTR lpBuff 보드 정보를 받을 문자열
+  * @param int nBuffSize 버퍼의 사이즈
+  * @return 명령이 수행된 정보*/
+int FAS_GetboardInfo(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize){
+    return board_info(iBdID, FRAME_GETSLAVEINFO, pType, lpBuff, nBuffSize);
+}
+
+ /**@brief 해당모터의 정보
+  * @param int iBdID 드라이브 ID
+  * @param BYTE *pType 모터의 Type
+  * @param LPSTR lpBuff Motor정보를 받을 문자열
+  * @param int nBuffSize 버퍼의 사이즈
+  * @return 명령이 수행된 정보*/
+int FAS_GetMotorInfo(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize){
+    return board_info(iBdID, FRAME_GETMOTORINFO, pType, lpBuff, nBuffSize);
+}
+
+ /**@brief 해당엔코더의 정보
+  * @param int iBdID 드라이브 ID
+  * @param BYTE *pType 엔코더의 Type
+  * @param LPSTR lpBuff 엔코더 정보를 받을 문자열
+  * @param int nBuffSize 버퍼의 사이즈
+  * @return 명령이 수행된 정보*/
+int FAS_GetEncoder(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize){
+    return board_info(iBdID, FRAME_GETENCODER, pType, lpBuff, nBuffSize);
+}
+
+ /**@brief 펌웨어의 정보
+  * @param int iBdID 드라이브 ID
+  * @param BYTE *pType 펌웨어의 Type
+  * @param LPSTR lpBuff 펌웨어 정보를 받을 문자열
+  * @param int nBuffSize 버퍼의 사이즈
+  * @return 명령이 수행된 정보*/
+int FAS_GetFirmwareInfo(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize){
+    return board_info(iBdID, FRAME_GETFIRMWAREINFO, pType, lpBuff, nBuffSize);
+}
+
+ /**@brief 해당보드의 확장 정보
+  * @param int iBdID 드라이브 ID
+  * @param BYTE *pType 보드의 Type
+  * @param LPSTR lpBuff 보드 정보를 받을 문자열
+  * @param int nBuffSize 버퍼의 사이즈
+  * @return 명령이 수행된 정보*/
+int FAS_GetSlaveInfoEx(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize){
+    return board_info(iBdID, FRAME_GETSLAVEINFOEX, pType, lpBuff, nBuffSize);
+}
+
+ /**@brief 현재까지 수정된 파라미터 값과 입출력 신호를 ROM영역에 저장
+  * @param int iBdID 드라이브 ID
+  * @return 명령이 수행된 정보*/
+int FAS_SaveAllParameters(int iBdID){
+    return board_command(iBdID, FRAME_SAVEALLPARAMETERS, NULL, 0, NULL, 0, NULL);
+}
+
+ /**@brief Servo의 상태를 ON/OFF
+  * @param int iBdID 드라이브 ID
+  * @param bool bOnOff Enable/Disable
+  * @return 명령이 수행된 정보*/
+int FAS_ServoEnable(int iBdID, bool bOnOff){
+    BYTE on = bOnOff ? 1 : 0;
+    return board_command(iBdID, FRAME_SERVOENABLE, &on, 1, NULL, 0, NULL);
+}
+
+ /**@brief Alarm Reset명령 보냄
+  * @param int iBdID 드라이브 ID
+  * @return 명령이 수행된 정보*/
+int FAS_ServoAlarmReset(int iBdID){
+    return board_command(iBdID, FRAME_SERVOALARMRESET, NULL, 0, NULL, 0, NULL);
+}
+
+ /**@brief Alarm 정보 요청
+  * @param int iBdID 드라이브 ID
+  * @param BYTE *nAlarmType 현재 Alarm 번호
+  * @return 명령이 수행된 정보*/
+int FAS_GetAlarmType(int iBdID, BYTE *nAlarmType){
+    BYTE resp[DATA_SIZE];
+    int resp_len;
+    int status = board_command(iBdID, FRAME_GETALARMTYPE, NULL, 0, resp, sizeof(resp), &resp_len);
+    if (status == FMM_OK && nAlarmType != NULL)
+        *nAlarmType = resp_len > 0 ? resp[0] : 0;
+    return status;
+}
+
+ /**@brief Servo를 천천히 멈추는 기능
+  * @param int iBdID 드라이브 ID
+  * @return 명령이 수행된 정보*/
+int FAS_MoveStop(int iBdID){
+    return board_command(iBdID, FRAME_MOVESTOP, NULL, 0, NULL, 0, NULL);
+}
+
+ /**@brief 비상정지
+  * @param int iBdID 드라이브 ID
+  * @return 명령이 수행된 정보*/
+int FAS_EmergencyStop(int iBdID){
+    return board_command(iBdID, FRAME_EMERGENCYSTOP, NULL, 0, NULL, 0, NULL);
+}
+
+ /**@brief 원점 복귀 시작
+  * @param int iBdID 드라이브 ID
+  * @return 명령이 수행된 정보*/
+int FAS_MoveOriginSingleAxis(int iBdID){
+    return board_command(iBdID, FRAME_MOVEORIGINSINGLEAXIS, NULL, 0, NULL, 0, NULL);
+}
+
+/**@brief Jog 운전 시작을 요청
+  * @param int iBdID 드라이브 ID
+  * @param DWORD lVelocity 이동 시 속도 값 (pps)
+  * @param int iVelDir 이동할 방향 (0:-Jog, 1:+Jog)
+  * @return 명령이 수행된 정보*/
+int FAS_MoveVelocity(int iBdID, DWORD lVelocity, int iVelDir){
+    BYTE data[5];
+    fas_put_le32(data, lVelocity);
+    data[4] = (BYTE)iVelDir;
+    return board_command(iBdID, FRAME_MOVEVELOCITY, data, sizeof(data), NULL, 0, NULL);
+}
@@ -0,0 +1,94 @@
+
+#pragma once
+
+#ifndef FAS_LIBRARY_DEFINE
+#define FAS_LIBRARY_DEFINE
+
+/**
+ * @file FAS_Library.h
+ * @brief libfastech 공개 header (GTK 없이 쓰는 Ezi-SERVO Plus-E 통신 라이브러리)
+ * @details 모든 상태는 FAS_CONTEXT(드라이브 한 대)에 있고 전역 상태는 보드 번호 -> context 표 하나뿐이다.
+ * context마다 소켓과 송수신 buffer를 따로 가지므로, 서로 다른 context를 서로 다른 thread에서
+ * lock 없이 동시에 쓸 수 있다. 같은 context를 여러 thread에서 같이 쓰는 것은 호출자가 막아야 한다.
+ * 통계(FAS_Metrics)와 trace(FAS_Trace)는 보드별 atomic 카운터/thread별 ring이라 경합하지 않는다.
+ *
+ * 기존 FAS_*(iBdID, ...) 함수는 FAS_BoardContext(iBdID)를 통해 같은 context 함수를 부르는 얇은 wrapper이다.
+ * 빌드: make (libfastech.a, libfastech.so, ProtocolTest, FAS_Bench)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Protocol_Define.h"
+#include "ReturnCodes_Define.h"
+#include "FAS_Pipeline.h"
+
+#define FAS_DEFAULT_COMMAND_TIMEOUT_MS (TIMEOUT_SECONDS * 1000)
+#define FAS_FRAME_DATA_VARIABLE (-1)	// FAS_FrameDataLength: 길이가 정해지지 않은 명령
+
+/**@brief 드라이브 한 대와의 통신 상태 전부*/
+typedef struct _FAS_CONTEXT
+{
+	FAS_LINK link;				// 소켓, Header, 다음 Sync No., TCP 재조립 buffer
+	const FAS_CODEC *codec;		// 프레임 변형 (기본 FAS_CodecFastech), 연결 전에 FAS_ContextSetCodec으로 고름
+	bool open;
+	int timeout_ms;				// 응답 기다리는 시간
+
+	BYTE tx[BUFFER_SIZE];		// 마지막으로 보낸 프레임
+	int tx_len;
+	BYTE rx[BUFFER_SIZE];		// 마지막으로 받은 응답 프레임
+	int rx_len;
+	FAS_FRAME_VIEW rx_view;		// rx를 codec으로 나눈 것 (통신 상태, 응답 data)
+
+	BYTE wait_sync;				// 응답을 기다리는 Sync No.
+	bool wait_done;
+	uint32_t wait_key;			// 기다리는 요청의 송신 OPT_ID 번호 (송신 timestamp 찾기)
+	uint64_t stale_frames;		// Sync No.가 맞지 않아 버린 응답 수
+
+	uint32_t rtt_us;			// 마지막 교환: 송신 호출부터 응답 처리까지 (CLOCK_MONOTONIC)
+	uint32_t wire_us;			// 마지막 교환: kernel 송신~수신 시각 차 (드라이브 + 회선), timestamp가 없으면 rtt_us
+	BYTE ts_source;				// wire_us를 잰 방법 (FAS_TS_*), rtt_us - wire_us가 우리 쪽 stack 시간
+} FAS_CONTEXT;
+
+void FAS_ContextInit(FAS_CONTEXT *ctx, int iBdID);
+bool FAS_ContextOpen(FAS_CONTEXT *ctx, const char *ip, bool tcp);
+void FAS_ContextClose(FAS_CONTEXT *ctx);
+void FAS_ContextSetCodec(FAS_CONTEXT *ctx, const FAS_CODEC *codec);
+
+FMM_ERROR FAS_ContextTransact(FAS_CONTEXT *ctx, const BYTE *frame, int len);
+FMM_ERROR FAS_ContextCommand(FAS_CONTEXT *ctx, BYTE frame_type, const void *data, int data_len,
+                             BYTE *resp, int resp_size, int *resp_len);
+
+FAS_CONTEXT *FAS_BoardContext(int iBdID);
+FAS_CONTEXT *FAS_BoardContextFind(int iBdID);
+
+const char *FAS_FrameName(BYTE frame_type);
+int FAS_FrameDataLength(BYTE frame_type);
+const char *FAS_ErrorName(FMM_ERROR error);
+
+int FAS_FormatFrame(char *text, int text_size, const BYTE *frame, int len);
+int FAS_ParseBytes(const char *text, int base, BYTE *out, int out_size);
+
+//------------------------------------------------------------------
+//                 보드 번호로 부르는 기존 함수
+//------------------------------------------------------------------
+
+bool FAS_Connect(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID);
+bool FAS_ConnectTCP(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID);
+void FAS_Close(int iBdID);
+bool FAS_IsConnected(int iBdID);
+
+int FAS_GetboardInfo(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize);
+int FAS_GetMotorInfo(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize);
+int FAS_GetEncoder(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize);
+int FAS_GetFirmwareInfo(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize);
+int FAS_GetSlaveInfoEx(int iBdID, BYTE *pType, LPSTR lpBuff, int nBuffSize);
+int FAS_SaveAllParameters(int iBdID);
+int FAS_ServoEnable(int iBdID, bool bOnOff);
+int FAS_ServoAlarmReset(int iBdID);
+int FAS_GetAlarmType(int iBdID, BYTE *nAlarmType);
+int FAS_MoveStop(int iBdID);
+int FAS_EmergencyStop(int iBdID);
+int FAS_MoveOriginSingleAxis(int iBdID);
+int FAS_MoveVelocity(int iBdID, DWORD lVelocity, int iVelDir);
+
+#endif	//FAS_LIBRARY_DEFINE
@@ -0,0 +1,266 @@
+/**
+ * @file FAS_List.c
+ * @brief 명령 목록 글 해석, 의존 관계에 따른 묶음(wave) 실행, 결과 표
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "FAS_List.h"
+#include "FAS_Library.h"
+#include "FAS_Metrics.h"
+
+#define LIST_RESP_SHOW 8			// 결과 표에 보이는 응답 data byte 수
+
+/**@brief FAS_ExecuteBatch done callback에 넘기는 묶음 상태*/
+typedef struct _LIST_RUN
+{
+	FAS_LIST *list;
+	const FAS_REQUEST *reqs;	// 이번 묶음의 요청 배열
+	const int *index;			// reqs[k]에 해당하는 list->entry 번호
+	uint64_t t0;
+} LIST_RUN;
+
+ /**@brief 목록 비우기*/
+void FAS_ListClear(FAS_LIST *list){
+    list->count = 0;
+    list->waves = 0;
+    list->failed = 0;
+    list->total_us = 0;
+}
+
+ /**@brief 목록 끝에 명령 추가
+  * @param int link 보드 (links[] 안의 번호)
+  * @param int after 먼저 끝나야 하는 명령 번호 (0부터, 이미 있는 명령만), 없으면 FAS_LIST_NONE
+  * @return 추가한 명령 번호, 목록이 찼거나 after/data_len이 잘못되면 -1*/
+int FAS_ListAdd(FAS_LIST *list, int link, BYTE frame_type, const void *data, int data_len, int after){
+    if (list->count == FAS_LIST_MAX || data_len < 0 || data_len > DATA_SIZE
+        || after < FAS_LIST_NONE || after >= list->count)
+        return -1;
+    FAS_LIST_ENTRY *e = &list->entry[list->count];
+    memset(e, 0, sizeof(*e));
+    FAS_RequestInit(&e->req, link, frame_type, data, data_len);
+    e->after = after;
+    e->line = list->count + 1;
+    e->wave = -1;
+    return list->count++;
+}
+
+static bool parse_byte(const char *token, BYTE *out){
+    char *end;
+    unsigned long v = strtoul(token, &end, 16);
+    if (end == token || *end != '\0' || v > 0xFF)
+        return false;
+    *out = (BYTE)v;
+    return true;
+}
+
+/**@brief 한 줄 해석 (주석 뗀 뒤), 빈 줄이면 TRUE만 돌려주고 아무것도 안 넣음*/
+static bool parse_line(FAS_LIST *list, char *line, int line_no){
+    char *save, *token;
+    int after = FAS_LIST_NONE;
+    int link = -1, count = 0, data_len = 0;
+    BYTE frame_type = 0, data[DATA_SIZE];
+
+    while (isspace((unsigned char)*line))
+        line++;
+    if (*line == '>') {
+        if (list->count == 0)
+            return false;
+        after = list->count - 1;
+        line++;
+    }
+    for (token = strtok_r(line, " \t\r", &save); token != NULL; token = strtok_r(NULL, " \t\r", &save)) {
+        if (token[0] == '@') {
+            char *end;
+            long n = strtol(token + 1, &end, 10);
+            if (end == token + 1 || *end != '\0' || n < 1 || n > list->count)
+                return false;
+            after = (int)n - 1;
+            continue;
+        }
+        if (count == 0) {
+            char *end;
+            long v = strtol(token, &end, 10);
+            if (end == token || *end != '\0' || v < 0)
+                return false;
+            link = (int)v;
+        }
+        else if (count == 1) {
+            if (!parse_byte(token, &frame_type))
+                return false;
+        }
+        else {
+            if (data_len == DATA_SIZE || !parse_byte(token, &data[data_len]))
+                return false;
+            data_len++;
+        }
+        count++;
+    }
+    if (count == 0)
+        return after == FAS_LIST_NONE;
+    if (count < 2)
+        return false;
+
+    int index = FAS_ListAdd(list, link, frame_type, data, data_len, after);
+    if (index < 0)
+        return false;
+    list->entry[index].line = line_no;
+    return true;
+}
+
+ /**@brief 목록 글을 해석해서 list를 새로 채움 (형식은 FAS_List.h)
+  * @param int *error_line 실패하면 잘못된 줄 번호 (NULL 가능)
+  * @return boolean 성공시 TRUE 실패시 FALSE (list는 그 줄 앞까지 채워짐)*/
+bool FAS_ListParse(FAS_LIST *list, const char *text, int *error_line){
+    char line[1024];
+    int line_no = 0;
+
+    FAS_ListClear(list);
+    while (*text != '\0') {
+        const char *end = strchr(text, '\n');
+        size_t len = end != NULL ? (size_t)(end - text) : strlen(text);
+        line_no++;
+        if (len >= sizeof(line)) {
+            if (error_line != NULL)
+                *error_line = line_no;
+            return false;
+        }
+        memcpy(line, text, len);
+        line[len] = '\0';
+        char *comment = strchr(line, '#');
+        if (comment != NULL)
+            *comment = '\0';
+        if (!parse_line(list, line, line_no)) {
+            if (error_line != NULL)
+                *error_line = line_no;
+            return false;
+        }
+        text += len;
+        if (*text == '\n')
+            text++;
+    }
+    return true;
+}
+
+static void list_done(FAS_REQUEST *req, void *user){
+    LIST_RUN *run = user;
+    run->list->entry[run->index[req - run->reqs]].done_us = (uint32_t)(FAS_MonotonicUs() - run->t0);
+}
+
+ /**@brief 목록 실행, 의존 관계가 없는 명령끼리는 한 묶음으로 pipeline 송신
+  * @details 묶음 k에는 기다리는 명령이 묶음 k-1까지에서 성공한 명령이 들어간다.
+  * 같은 보드 명령은 한 묶음 안에서 목록 순서대로 보내지만 앞 응답을 기다리지 않는다 (option의 window만큼 겹침).
+  * 결과는 list->entry[].req (status, resp, rtt_us)와 done_us, 요약은 list->waves/failed/total_us.
+  * @param FAS_LINK *links 연결 목록 (명령의 보드 번호가 가리키는 곳)
+  * @param const FAS_BATCH_OPTION *option NULL이면 기본값 (done/user는 쓰지 않음)
+  * @return 실패(FMM_OK가 아닌) 명령 수 (skipped 포함), 메모리 부족이면 -1*/
+int FAS_ListExecute(FAS_LINK *links, int link_count, FAS_LIST *list, const FAS_BATCH_OPTION *option){
+    FAS_BATCH_OPTION opt = { 0 };
+    if (option != NULL)
+        opt = *option;
+    FAS_ARENA *scratch = opt.scratch;
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    int count = list->count, failed = 0;
+    FAS_REQUEST *reqs = FAS_ScratchAlloc(scratch, sizeof(FAS_REQUEST) * (count > 0 ? count : 1), false);
+    int *index = FAS_ScratchAlloc(scratch, sizeof(int) * (count > 0 ? count : 1), false);
+    if (reqs == NULL || index == NULL) {
+        FAS_ScratchFree(scratch, reqs);
+        FAS_ScratchFree(scratch, index);
+        if (scratch != NULL)
+            FAS_ArenaRelease(scratch, mark);
+        return -1;
+    }
+
+    LIST_RUN run = { .list = list, .reqs = reqs, .index = index, .t0 = FAS_MonotonicUs() };
+    opt.done = list_done;
+    opt.user = &run;
+    for (int i = 0; i < count; i++) {
+        FAS_LIST_ENTRY *e = &list->entry[i];
+        e->wave = -1;
+        e->skipped = false;
+        e->start_us = e->done_us = 0;
+        e->req.status = FMM_UNKNOWN_ERROR;
+        e->req.resp_len = 0;
+        e->req.rtt_us = 0;
+    }
+
+    int pending = count, wave = 0;
+    while (pending > 0) {
+        // after는 항상 앞 명령이므로 앞에서부터 한 번 훑으면 skip도 같은 번에 뒤로 전해짐
+        int n = 0;
+        uint32_t start_us = (uint32_t)(FAS_MonotonicUs() - run.t0);
+        for (int i = 0; i < count; i++) {
+            FAS_LIST_ENTRY *e = &list->entry[i];
+            if (e->wave >= 0 || e->skipped)
+                continue;
+            if (e->after != FAS_LIST_NONE) {
+                const FAS_LIST_ENTRY *a = &list->entry[e->after];
+                if (a->skipped || (a->wave >= 0 && a->wave < wave && a->req.status != FMM_OK)) {
+                    e->skipped = true;
+                    pending--;
+                    failed++;
+                    continue;
+                }
+                if (a->wave < 0 || a->wave == wave)
+                    continue;
+            }
+            e->wave = wave;
+            e->start_us = start_us;
+            index[n] = i;
+            reqs[n++] = e->req;
+        }
+        if (n == 0)
+            break;
+
+        int r = FAS_ExecuteBatch(links, link_count, reqs, n, &opt);
+        if (r < 0) {
+            failed = -1;
+            break;
+        }
+        // 보드 번호가 잘못된 요청은 done이 불리지 않으므로 결과는 여기서 한꺼번에 옮김
+        for (int k = 0; k < n; k++)
+            list->entry[index[k]].req = reqs[k];
+        failed += r;
+        pending -= n;
+        wave++;
+    }
+
+    list->waves = wave;
+    list->failed = failed;
+    list->total_us = (uint32_t)(FAS_MonotonicUs() - run.t0);
+    FAS_ScratchFree(scratch, index);
+    FAS_ScratchFree(scratch, reqs);
+    if (scratch != NULL)
+        FAS_ArenaRelease(scratch, mark);
+    return failed;
+}
+
+ /**@brief 실행 결과 표 (명령마다 한 줄: 줄 번호, 보드, 명령 이름, 통신 상태, 응답 data, 시간)
+  * @return 쓴 글자 수 (text_size - 1까지)*/
+int FAS_ListFormatResult(const FAS_LIST *list, char *text, int text_size){
+    int len = 0;
+    if (text_size <= 0)
+        return 0;
+    text[0] = '\0';
+    len += snprintf(text + len, text_size - len, "%d commands, %d waves, %d failed, %u us\n",
+                    list->count, list->waves, list->failed, list->total_us);
+    for (int i = 0; i < list->count && len < text_size; i++) {
+        const FAS_LIST_ENTRY *e = &list->entry[i];
+        len += snprintf(text + len, text_size - len, "%3d bd%-3d %-28s ", e->line, e->req.link, FAS_FrameName(e->req.frame_type));
+        if (len >= text_size)
+            break;
+        if (e->skipped) {
+            len += snprintf(text + len, text_size - len, "skipped (line %d failed)\n", list->entry[e->after].line);
+            continue;
+        }
+        len += snprintf(text + len, text_size - len, "%-22s wave %d  rtt %6u us (wire %6u)  done %7u us ",
+                        FAS_ErrorName(e->req.status), e->wave, e->req.rtt_us, e->req.wire_us, e->done_us);
+        for (int k = 0; k < e->req.resp_len && k < LIST_RESP_SHOW && len < text_size; k++)
+            len += snprintf(text + len, text_size - len, " %02X", e->req.resp[k]);
+        if (len < text_size)
+            len += snprintf(text + len, text_size - len, e->req.resp_len > LIST_RESP_SHOW ? " ..\n" : "\n");
+    }
+    return len < text_size ? len : text_size - 1;
+}
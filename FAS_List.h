@@ -0,0 +1,60 @@
+
+#pragma once
+
+#ifndef FAS_LIST_DEFINE
+#define FAS_LIST_DEFINE
+
+/**
+ * @file FAS_List.h
+ * @brief 명령 목록 (ProtocolTest의 Use List) 한 번에 실행
+ * @details 목록의 명령은 서로 기다리지 않고 pipeline으로 보내고, 목록에 표시한 의존 관계만 순서를 지킨다.
+ * 의존 관계가 없는 명령은 전부 첫 묶음, 앞 명령을 기다리는 명령은 그 명령이 든 묶음 다음 묶음에 들어가고,
+ * 묶음(wave) 하나는 FAS_ExecuteBatch 한 번이다. 50줄 설정 목록도 의존 관계가 없으면 pipeline 한 번에 끝난다.
+ * 기다리던 명령이 실패하면 그 뒤에 매달린 명령은 보내지 않는다 (skipped).
+ *
+ * 목록 글 형식 (한 줄에 명령 하나, '#' 뒤는 주석):
+ *   [>] 보드 FrameType [Data ...] [@N]
+ * - 보드: links[] 안의 번호 (10진수), FrameType/Data: 16진수 byte
+ * - 줄 앞의 '>': 바로 앞 명령이 끝난 뒤에 보냄
+ * - 줄 끝의 '@N': N번째 명령(1부터)이 끝난 뒤에 보냄 (앞에 있는 명령만)
+ * 예) 0 2A 01          # 서보 ON
+ *     > 0 37 00 00 10 27 00 00 01   # 서보 ON 응답 뒤에 JOG
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FAS_Pipeline.h"
+
+#define FAS_LIST_MAX 256			// 목록 하나에 넣을 수 있는 명령 수
+#define FAS_LIST_NONE -1			// 기다리는 명령 없음
+
+/**@brief 목록의 명령 한 개와 그 결과*/
+typedef struct _FAS_LIST_ENTRY
+{
+	FAS_REQUEST req;			// req.link = 보드 번호 (links[] 안의 번호), 결과는 req.status/resp/rtt_us
+	int after;					// 먼저 끝나야 하는 명령 번호 (0부터), 없으면 FAS_LIST_NONE
+	int line;					// 목록 글에서의 줄 번호 (1부터)
+
+	int wave;					// 실행된 묶음 번호 (0부터), 보내지 않았으면 -1
+	bool skipped;				// 기다리던 명령이 실패해서 보내지 않음
+	uint32_t start_us;			// 실행 시작부터 이 명령이 든 묶음 시작까지
+	uint32_t done_us;			// 실행 시작부터 응답까지
+} FAS_LIST_ENTRY;
+
+typedef struct _FAS_LIST
+{
+	int count;
+	FAS_LIST_ENTRY entry[FAS_LIST_MAX];
+
+	int waves;					// 마지막 실행의 묶음 수
+	int failed;					// 마지막 실행에서 FMM_OK가 아닌 명령 수 (skipped 포함)
+	uint32_t total_us;			// 마지막 실행 전체 시간
+} FAS_LIST;
+
+void FAS_ListClear(FAS_LIST *list);
+int FAS_ListAdd(FAS_LIST *list, int link, BYTE frame_type, const void *data, int data_len, int after);
+bool FAS_ListParse(FAS_LIST *list, const char *text, int *error_line);
+int FAS_ListExecute(FAS_LINK *links, int link_count, FAS_LIST *list, const FAS_BATCH_OPTION *option);
+int FAS_ListFormatResult(const FAS_LIST *list, char *text, int text_size);
+
+#endif	//FAS_LIST_DEFINE
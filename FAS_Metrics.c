@@ -0,0 +1,382 @@
+/**
+ * @file FAS_Metrics.c
+ * @brief 보드별 통신 통계 테이블과 export (Prometheus text over Unix socket, 공유메모리)
+ * @details 테이블은 mmap으로 잡는다. shm 이름을 주면 POSIX 공유메모리에 올려서
+ * 다른 프로세스가 같은 이름으로 mmap(PROT_READ)만 하면 snapshot을 볼 수 있다.
+ * export thread는 읽기만 하므로 송수신 경로와 lock을 주고받지 않는다.
+ * shm 이름과 socket 경로는 이 프로세스가 새로 만든 것만 지운다. 같은 이름을 살아 있는 다른 프로세스
+ * (ProtocolTest, FAS_BrokerDaemon 등)가 쓰고 있으면 "이름.pid"를 쓰고, 죽은 프로세스가 남긴 것이면 지우고 다시 만든다.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include "FAS_Metrics.h"
+
+FAS_METRICS_TABLE *fas_metrics = NULL;
+
+static char metrics_shm_name[64];		// 이 프로세스가 만든 shm 이름 (없으면 빈 문자열)
+static char metrics_sock_path[108];		// 이 프로세스가 bind한 socket 경로
+static int metrics_listen_fd = -1;
+static pthread_t metrics_thread;
+static bool metrics_thread_running = false;
+
+ // 이미 있는 shm 이름을 만든 프로세스가 죽었는지 (테이블의 owner_pid로)
+ // version과 크기가 다른 빌드가 남긴 테이블도 보므로 magic과 owner_pid까지만 읽는다 (두 자리는 version마다 같음)
+static bool metrics_shm_stale(const char *name){
+    const size_t head = offsetof(FAS_METRICS_TABLE, owner_pid) + sizeof(int32_t);
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return errno == ENOENT;
+    struct stat st;
+    bool stale = false;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < head) {
+        close(fd);	// 만드는 중이거나 테이블이 아님
+        return false;
+    }
+    const FAS_METRICS_TABLE *table = mmap(NULL, head, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (table != MAP_FAILED) {
+        stale = table->magic == FAS_METRICS_MAGIC && table->owner_pid > 0 && kill(table->owner_pid, 0) < 0 && errno == ESRCH;
+        munmap((void *)table, head);
+    }
+    return stale;
+}
+
+// 새 shm을 만듦 (O_EXCL), 이름이 이미 있으면 -1 / errno EEXIST
+static int metrics_shm_create(const char *name){
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST && metrics_shm_stale(name)) {
+        shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    return fd;
+}
+
+ /**@brief 통계 테이블 생성
+  * @param const char *shm_name NULL이면 프로세스 내부 메모리, 아니면 shm_open 이름 (예: FAS_METRICS_SHM)
+  * 살아 있는 다른 프로세스가 같은 이름을 쓰고 있으면 그 테이블은 건드리지 않고 "이름.pid"로 만든다 (FAS_MetricsShmName)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_MetricsInit(const char *shm_name){
+    if (fas_metrics != NULL)
+        return true;
+
+    void *mem;
+    if (shm_name != NULL) {
+        char name[sizeof(metrics_shm_name)];
+        snprintf(name, sizeof(name), "%s", shm_name);
+        int fd = metrics_shm_create(name);
+        if (fd < 0 && errno == EEXIST) {
+            snprintf(name, sizeof(name), "%s.%d", shm_name, (int)getpid());
+            fd = metrics_shm_create(name);
+        }
+        if (fd < 0) {
+            perror("shm_open failed");
+            return false;
+        }
+        if (ftruncate(fd, sizeof(FAS_METRICS_TABLE)) < 0) {
+            perror("ftruncate failed");
+            close(fd);
+            shm_unlink(name);
+            return false;
+        }
+        mem = mmap(NULL, sizeof(FAS_METRICS_TABLE), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mem == MAP_FAILED)
+            shm_unlink(name);
+        else
+            snprintf(metrics_shm_name, sizeof(metrics_shm_name), "%s", name);
+    }
+    else {
+        mem = mmap(NULL, sizeof(FAS_METRICS_TABLE), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (mem == MAP_FAILED) {
+        perror("mmap failed");
+        return false;
+    }
+
+    FAS_METRICS_TABLE *table = mem;
+    memset(table, 0, sizeof(*table));
+    table->board_count = FAS_MAX_BOARD;
+    table->board_size = sizeof(FAS_METRICS);
+    table->version = FAS_METRICS_VERSION;
+    table->owner_pid = (int32_t)getpid();
+    atomic_thread_fence(memory_order_release);
+    table->magic = FAS_METRICS_MAGIC;	// reader는 magic이 보이면 초기화가 끝난 것으로 본다
+
+    fas_metrics = table;
+    return true;
+}
+
+ /**@brief export thread 정지, 이 프로세스가 만든 공유메모리/소켓만 정리*/
+void FAS_MetricsShutdown(void){
+    if (metrics_thread_running) {
+        shutdown(metrics_listen_fd, SHUT_RDWR);
+        close(metrics_listen_fd);
+        pthread_join(metrics_thread, NULL);
+        unlink(metrics_sock_path);
+        metrics_sock_path[0] = '\0';
+        metrics_thread_running = false;
+        metrics_listen_fd = -1;
+    }
+    if (fas_metrics != NULL) {
+        munmap(fas_metrics, sizeof(FAS_METRICS_TABLE));
+        fas_metrics = NULL;
+    }
+    if (metrics_shm_name[0] != '\0') {
+        shm_unlink(metrics_shm_name);
+        metrics_shm_name[0] = '\0';
+    }
+}
+
+ /**@brief 보드 통계를 일반 변수로 복사 (relaxed load라서 카운터끼리 수 ns 차이는 날 수 있음)
+  * @param int iBdID 드라이브 ID
+  * @param FAS_METRICS_SNAPSHOT *snap 결과
+  * @return 보드가 한 번이라도 통신했으면 TRUE*/
+bool FAS_MetricsSnapshot(int iBdID, FAS_METRICS_SNAPSHOT *snap){
+    memset(snap, 0, sizeof(*snap));
+    FAS_METRICS *m = fas_metrics_board(iBdID);
+    if (m == NULL)
+        return false;
+
+    snap->frames_sent = atomic_load_explicit(&m->frames_sent.value, memory_order_relaxed);
+    snap->frames_recv = atomic_load_explicit(&m->frames_recv.value, memory_order_relaxed);
+    snap->bytes_sent = atomic_load_explicit(&m->bytes_sent.value, memory_order_relaxed);
+    snap->bytes_recv = atomic_load_explicit(&m->bytes_recv.value, memory_order_relaxed);
+    snap->timeouts = atomic_load_explicit(&m->timeouts.value, memory_order_relaxed);
+    snap->crc_fail = atomic_load_explicit(&m->crc_fail.value, memory_order_relaxed);
+    for (int i = 0; i < FAS_ERROR_CODES; i++)
+        snap->error_hist[i] = atomic_load_explicit(&m->error_hist[i], memory_order_relaxed);
+    for (int i = 0; i < FAS_RTT_BUCKETS; i++)
+        snap->rtt_hist[i] = atomic_load_explicit(&m->rtt_hist[i], memory_order_relaxed);
+    snap->rtt_sum_us = atomic_load_explicit(&m->rtt_sum_us, memory_order_relaxed);
+    for (int i = 0; i < FAS_RTT_BUCKETS; i++) {
+        snap->wire_hist[i] = atomic_load_explicit(&m->wire_hist[i], memory_order_relaxed);
+        snap->stack_hist[i] = atomic_load_explicit(&m->stack_hist[i], memory_order_relaxed);
+    }
+    snap->wire_sum_us = atomic_load_explicit(&m->wire_sum_us, memory_order_relaxed);
+    snap->stack_sum_us = atomic_load_explicit(&m->stack_sum_us, memory_order_relaxed);
+
+    uint64_t active = atomic_load_explicit(&fas_metrics->active[iBdID >> 6], memory_order_relaxed);
+    return (active >> (iBdID & 63)) & 1;
+}
+
+ /**@brief RTT histogram에서 백분위 값 근사 (해당 bucket의 상한값)
+  * @param double pct 0~100
+  * @return us*/
+uint64_t FAS_MetricsRttPercentile(const FAS_METRICS_SNAPSHOT *snap, double pct){
+    return FAS_MetricsHistPercentile(snap->rtt_hist, pct);
+}
+
+ /**@brief FAS_RTT_BUCKETS 구간 histogram (rtt_hist, wire_hist, stack_hist)에서 백분위 값 근사
+  * @return us*/
+uint64_t FAS_MetricsHistPercentile(const uint64_t *hist, double pct){
+    uint64_t total = 0;
+    for (int i = 0; i < FAS_RTT_BUCKETS; i++)
+        total += hist[i];
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(total * pct / 100.0);
+    uint64_t seen = 0;
+    for (int i = 0; i < FAS_RTT_BUCKETS; i++) {
+        seen += hist[i];
+        if (seen > rank)
+            return i == 0 ? 0 : 1ull << i;
+    }
+    return 1ull << (FAS_RTT_BUCKETS - 1);
+}
+
+// 보드마다 FAS_RTT_BUCKETS 구간 histogram 하나 (hist/sum은 FAS_METRICS_SNAPSHOT 안의 위치)
+static void write_histogram(FILE *fp, FAS_METRICS_SNAPSHOT *snap, const char *name, const char *help,
+                            size_t hist_offset, size_t sum_offset){
+    bool header = true;
+    for (int bd = 0; bd < FAS_MAX_BOARD; bd++) {
+        if (!FAS_MetricsSnapshot(bd, snap))
+            continue;
+        if (header) {
+            fprintf(fp, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+            header = false;
+        }
+        const uint64_t *hist = (const uint64_t *)((const char *)snap + hist_offset);
+        uint64_t cumulative = 0;
+        for (int i = 0; i < FAS_RTT_BUCKETS - 1; i++) {
+            cumulative += hist[i];
+            fprintf(fp, "%s_bucket{board=\"%d\",le=\"%" PRIu64 "\"} %" PRIu64 "\n",
+                    name, bd, (uint64_t)(i == 0 ? 0 : (1ull << i) - 1), cumulative);
+        }
+        cumulative += hist[FAS_RTT_BUCKETS - 1];
+        fprintf(fp, "%s_bucket{board=\"%d\",le=\"+Inf\"} %" PRIu64 "\n", name, bd, cumulative);
+        fprintf(fp, "%s_sum{board=\"%d\"} %" PRIu64 "\n", name, bd, *(const uint64_t *)((const char *)snap + sum_offset));
+        fprintf(fp, "%s_count{board=\"%d\"} %" PRIu64 "\n", name, bd, cumulative);
+    }
+}
+
+static void write_counter(FILE *fp, const char *name, const char *help, int iBdID, uint64_t value, bool header){
+    if (header)
+        fprintf(fp, "# HELP %s %s\n# TYPE %s counter\n", name, help, name);
+    fprintf(fp, "%s{board=\"%d\"} %" PRIu64 "\n", name, iBdID, value);
+}
+
+ /**@brief 통계 전체를 Prometheus text 형식으로 출력
+  * @param FILE *fp 출력 대상*/
+void FAS_MetricsWritePrometheus(FILE *fp){
+    static const struct {
+        const char *name;
+        const char *help;
+        size_t offset;
+    } counters[] = {
+        { "fastech_frames_sent_total", "Frames sent to the drive", offsetof(FAS_METRICS_SNAPSHOT, frames_sent) },
+        { "fastech_frames_received_total", "Frames received from the drive", offsetof(FAS_METRICS_SNAPSHOT, frames_recv) },
+        { "fastech_bytes_sent_total", "Bytes sent to the drive", offsetof(FAS_METRICS_SNAPSHOT, bytes_sent) },
+        { "fastech_bytes_received_total", "Bytes received from the drive", offsetof(FAS_METRICS_SNAPSHOT, bytes_recv) },
+        { "fastech_timeouts_total", "Requests without a response in time", offsetof(FAS_METRICS_SNAPSHOT, timeouts) },
+        { "fastech_crc_failures_total", "Responses reporting a CRC failure", offsetof(FAS_METRICS_SNAPSHOT, crc_fail) },
+    };
+    static FAS_METRICS_SNAPSHOT snap;	// export thread 하나만 사용
+
+    if (fas_metrics == NULL)
+        return;
+
+    for (size_t c = 0; c < sizeof(counters) / sizeof(counters[0]); c++) {
+        bool header = true;
+        for (int bd = 0; bd < FAS_MAX_BOARD; bd++) {
+            if (!FAS_MetricsSnapshot(bd, &snap))
+                continue;
+            write_counter(fp, counters[c].name, counters[c].help, bd,
+                          *(const uint64_t *)((const char *)&snap + counters[c].offset), header);
+            header = false;
+        }
+    }
+
+    bool header = true;
+    for (int bd = 0; bd < FAS_MAX_BOARD; bd++) {
+        if (!FAS_MetricsSnapshot(bd, &snap))
+            continue;
+        if (header) {
+            fputs("# HELP fastech_response_code_total Responses by communication status code\n"
+                  "# TYPE fastech_response_code_total counter\n", fp);
+            header = false;
+        }
+        for (int code = 0; code < FAS_ERROR_CODES; code++) {
+            if (snap.error_hist[code] != 0)
+                fprintf(fp, "fastech_response_code_total{board=\"%d\",code=\"0x%02X\"} %" PRIu64 "\n",
+                        bd, code, snap.error_hist[code]);
+        }
+    }
+
+    write_histogram(fp, &snap, "fastech_rtt_microseconds", "Request to response round trip time",
+                    offsetof(FAS_METRICS_SNAPSHOT, rtt_hist), offsetof(FAS_METRICS_SNAPSHOT, rtt_sum_us));
+    write_histogram(fp, &snap, "fastech_wire_microseconds", "Kernel send to receive timestamp difference (drive and network)",
+                    offsetof(FAS_METRICS_SNAPSHOT, wire_hist), offsetof(FAS_METRICS_SNAPSHOT, wire_sum_us));
+    write_histogram(fp, &snap, "fastech_stack_microseconds", "Round trip time minus wire time (host stack and scheduling)",
+                    offsetof(FAS_METRICS_SNAPSHOT, stack_hist), offsetof(FAS_METRICS_SNAPSHOT, stack_sum_us));
+}
+
+static void *metrics_thread_main(void *arg){
+    (void)arg;
+    while (1) {
+        int fd = accept(metrics_listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+            break;	// FAS_MetricsShutdown에서 listen 소켓을 닫음
+        }
+        FILE *fp = fdopen(fd, "w");
+        if (fp == NULL) {
+            close(fd);
+            continue;
+        }
+        FAS_MetricsWritePrometheus(fp);
+        fclose(fp);
+    }
+    return NULL;
+}
+
+ // 경로에 socket이 있고 누가 listen하고 있는지 (없거나 죽은 프로세스가 남긴 파일이면 FALSE)
+static bool metrics_sock_alive(const struct sockaddr_un *addr){
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+    bool alive = connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) == 0;
+    close(fd);
+    return alive;
+}
+
+// 경로에 bind, 살아 있는 socket이면 건드리지 않고 FALSE
+static bool metrics_sock_bind(int fd, struct sockaddr_un *addr, const char *path){
+    if (strlen(path) >= sizeof(addr->sun_path))
+        return false;
+    strcpy(addr->sun_path, path);
+    if (bind(fd, (struct sockaddr *)addr, sizeof(*addr)) == 0)
+        return true;
+    if (errno != EADDRINUSE || metrics_sock_alive(addr))
+        return false;
+    unlink(path);	// 죽은 프로세스가 남긴 파일
+    return bind(fd, (struct sockaddr *)addr, sizeof(*addr)) == 0;
+}
+
+ /**@brief Unix socket으로 Prometheus text export 시작 (접속할 때마다 한 번 출력하고 닫음)
+  * @param const char *socket_path 소켓 경로 (예: FAS_METRICS_SOCK)
+  * 살아 있는 다른 프로세스가 같은 경로로 내보내고 있으면 "경로.pid"를 쓴다 (FAS_MetricsSockPath)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_MetricsServe(const char *socket_path){
+    if (fas_metrics == NULL || metrics_thread_running)
+        return false;
+
+    struct sockaddr_un addr;
+    char path[sizeof(metrics_sock_path)];
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if ((metrics_listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+        perror("Metrics socket creation failed");
+        return false;
+    }
+    snprintf(path, sizeof(path), "%s", socket_path);
+    bool bound = metrics_sock_bind(metrics_listen_fd, &addr, path);
+    if (!bound && errno == EADDRINUSE) {
+        snprintf(path, sizeof(path), "%s.%d", socket_path, (int)getpid());
+        bound = metrics_sock_bind(metrics_listen_fd, &addr, path);
+    }
+    if (!bound || listen(metrics_listen_fd, 4) < 0) {
+        perror("Metrics socket bind failed");
+        if (bound)
+            unlink(path);
+        close(metrics_listen_fd);
+        metrics_listen_fd = -1;
+        return false;
+    }
+    snprintf(metrics_sock_path, sizeof(metrics_sock_path), "%s", path);
+
+    if (pthread_create(&metrics_thread, NULL, metrics_thread_main, NULL) != 0) {
+        close(metrics_listen_fd);
+        metrics_listen_fd = -1;
+        unlink(path);
+        metrics_sock_path[0] = '\0';
+        return false;
+    }
+    metrics_thread_running = true;
+    return true;
+}
+
+ /**@brief 실제로 쓰는 shm 이름 (FAS_MetricsInit에 NULL을 줬거나 실패했으면 빈 문자열)*/
+const char *FAS_MetricsShmName(void){
+    return metrics_shm_name;
+}
+
+ /**@brief 실제로 쓰는 export socket 경로 (FAS_MetricsServe 전이면 빈 문자열)*/
+const char *FAS_MetricsSockPath(void){
+    return metrics_sock_path;
+}
@@ -0,0 +1,182 @@
+
+#pragma once
+
+#ifndef FAS_METRICS_DEFINE
+#define FAS_METRICS_DEFINE
+
+/**
+ * @file FAS_Metrics.h
+ * @brief 드라이브(보드)별 통신 통계 카운터
+ * @details 카운터는 모두 cache line 단위로 떨어진 atomic 변수이고 I/O 경로에서는 relaxed 더하기만 한다.
+ * 읽는 쪽(GUI 패널, Prometheus export, 공유메모리를 보는 다른 프로세스)은 lock 없이 값을 읽기만 하므로
+ * 통계를 아무리 자주 읽어도 송수신 경로가 멈추는 일은 없다.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "ReturnCodes_Define.h"
+
+#define FAS_MAX_BOARD 256
+#define FAS_CACHELINE 64
+#define FAS_RTT_BUCKETS 24                          // log2(us) 구간, 마지막 구간은 8초 이상
+#define FAS_ERROR_CODES 256                         // FMM_ERROR는 1 byte
+
+#define FAS_METRICS_MAGIC 0x4641534D                // "FASM"
+#define FAS_METRICS_VERSION 3
+#define FAS_METRICS_SHM "/fastech_metrics"          // shm_open 이름 (다른 프로세스가 쓰고 있으면 "이름.pid")
+#define FAS_METRICS_SOCK "/tmp/fastech_metrics.sock" // Prometheus text를 내보내는 Unix socket (쓰고 있으면 "경로.pid")
+
+/**@brief cache line 하나를 혼자 쓰는 카운터 (false sharing 방지)*/
+typedef struct _FAS_COUNTER
+{
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t value;
+} FAS_COUNTER;
+
+/**@brief 보드 한 개의 통계*/
+typedef struct _FAS_METRICS
+{
+	FAS_COUNTER frames_sent;
+	FAS_COUNTER frames_recv;
+	FAS_COUNTER bytes_sent;
+	FAS_COUNTER bytes_recv;
+	FAS_COUNTER timeouts;
+	FAS_COUNTER crc_fail;
+
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t error_hist[FAS_ERROR_CODES];	// 응답의 통신 상태(FMM_ERROR/FMP_*) 별 횟수
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t rtt_hist[FAS_RTT_BUCKETS];	// bucket i : [2^(i-1), 2^i) us
+	_Atomic uint64_t rtt_sum_us;
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t wire_hist[FAS_RTT_BUCKETS];	// kernel 송신~수신 시각 차 (드라이브 + 회선)
+	_Atomic uint64_t wire_sum_us;
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t stack_hist[FAS_RTT_BUCKETS];	// RTT - wire (우리 쪽 stack/scheduling)
+	_Atomic uint64_t stack_sum_us;
+} FAS_METRICS;
+
+/**@brief 공유메모리에 그대로 올라가는 전체 통계 테이블
+ * @details version이 바뀌어도 magic(0)과 owner_pid(16) 자리는 옮기지 않는다 (다른 빌드가 남긴 이름 정리에 씀)*/
+typedef struct _FAS_METRICS_TABLE
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t board_count;
+	uint32_t board_size;		// sizeof(FAS_METRICS), 외부 reader가 layout 확인용
+	int32_t owner_pid;			// 테이블을 만든 프로세스 (죽은 프로세스가 남긴 이름인지 확인)
+	uint32_t reserved;
+	_Atomic uint64_t active[FAS_MAX_BOARD / 64];	// 한 번이라도 통신한 보드 bitmap
+	FAS_METRICS board[FAS_MAX_BOARD];
+} FAS_METRICS_TABLE;
+
+_Static_assert(offsetof(FAS_METRICS_TABLE, magic) == 0 && offsetof(FAS_METRICS_TABLE, owner_pid) == 16,
+               "FAS_METRICS_TABLE magic/owner_pid offsets are fixed across versions");
+
+/**@brief GUI 등에서 쓰는 일반 변수 사본*/
+typedef struct _FAS_METRICS_SNAPSHOT
+{
+	uint64_t frames_sent, frames_recv;
+	uint64_t bytes_sent, bytes_recv;
+	uint64_t timeouts, crc_fail;
+	uint64_t error_hist[FAS_ERROR_CODES];
+	uint64_t rtt_hist[FAS_RTT_BUCKETS];
+	uint64_t rtt_sum_us;
+	uint64_t wire_hist[FAS_RTT_BUCKETS];
+	uint64_t wire_sum_us;
+	uint64_t stack_hist[FAS_RTT_BUCKETS];
+	uint64_t stack_sum_us;
+} FAS_METRICS_SNAPSHOT;
+
+extern FAS_METRICS_TABLE *fas_metrics;
+
+bool FAS_MetricsInit(const char *shm_name);
+void FAS_MetricsShutdown(void);
+bool FAS_MetricsServe(const char *socket_path);
+const char *FAS_MetricsShmName(void);
+const char *FAS_MetricsSockPath(void);
+
+bool FAS_MetricsSnapshot(int iBdID, FAS_METRICS_SNAPSHOT *snap);
+uint64_t FAS_MetricsRttPercentile(const FAS_METRICS_SNAPSHOT *snap, double pct);
+uint64_t FAS_MetricsHistPercentile(const uint64_t *hist, double pct);
+void FAS_MetricsWritePrometheus(FILE *fp);
+
+/**@brief CLOCK_MONOTONIC 기준 us*/
+static inline uint64_t FAS_MonotonicUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static inline FAS_METRICS *fas_metrics_board(int iBdID) {
+    if (fas_metrics == NULL || iBdID < 0 || iBdID >= FAS_MAX_BOARD)
+        return NULL;
+    return &fas_metrics->board[iBdID];
+}
+
+static inline void fas_metrics_add(_Atomic uint64_t *counter, uint64_t n) {
+    atomic_fetch_add_explicit(counter, n, memory_order_relaxed);
+}
+
+static inline int fas_metrics_bucket(uint64_t us) {
+    int bucket = us == 0 ? 0 : 64 - __builtin_clzll(us);
+    return bucket >= FAS_RTT_BUCKETS ? FAS_RTT_BUCKETS - 1 : bucket;
+}
+
+/**@brief 프레임 송신 기록
+  * @param int iBdID 드라이브 ID
+  * @param size_t bytes 보낸 byte 수*/
+static inline void FAS_MetricsSent(int iBdID, size_t bytes) {
+    FAS_METRICS *m = fas_metrics_board(iBdID);
+    if (m == NULL)
+        return;
+    uint64_t bit = 1ull << (iBdID & 63);
+    if (!(atomic_load_explicit(&fas_metrics->active[iBdID >> 6], memory_order_relaxed) & bit))
+        atomic_fetch_or_explicit(&fas_metrics->active[iBdID >> 6], bit, memory_order_relaxed);
+    fas_metrics_add(&m->frames_sent.value, 1);
+    fas_metrics_add(&m->bytes_sent.value, bytes);
+}
+
+/**@brief 응답 수신 기록
+  * @param int iBdID 드라이브 ID
+  * @param size_t bytes 받은 byte 수
+  * @param FMM_ERROR code 응답 프레임의 통신 상태 byte
+  * @param uint64_t rtt_us 송신부터 수신까지 걸린 시간*/
+static inline void FAS_MetricsReceived(int iBdID, size_t bytes, FMM_ERROR code, uint64_t rtt_us) {
+    FAS_METRICS *m = fas_metrics_board(iBdID);
+    if (m == NULL)
+        return;
+    fas_metrics_add(&m->frames_recv.value, 1);
+    fas_metrics_add(&m->bytes_recv.value, bytes);
+    fas_metrics_add(&m->error_hist[(uint8_t)code], 1);
+    if (code == FMC_CRCFAILED_ERROR || code == FMP_PACKETCRCERROR)
+        fas_metrics_add(&m->crc_fail.value, 1);
+
+    fas_metrics_add(&m->rtt_hist[fas_metrics_bucket(rtt_us)], 1);
+    fas_metrics_add(&m->rtt_sum_us, rtt_us);
+}
+
+/**@brief kernel timestamp로 나눈 RTT 기록 (FAS_MetricsReceived와 같은 응답, timestamp가 있을 때만)
+  * @param int iBdID 드라이브 ID
+  * @param uint64_t wire_us kernel 송신~수신 시각 차
+  * @param uint64_t rtt_us FAS_MetricsReceived에 넘긴 RTT (나머지가 stack 시간)*/
+static inline void FAS_MetricsWire(int iBdID, uint64_t wire_us, uint64_t rtt_us) {
+    FAS_METRICS *m = fas_metrics_board(iBdID);
+    if (m == NULL)
+        return;
+    uint64_t stack_us = rtt_us > wire_us ? rtt_us - wire_us : 0;
+    fas_metrics_add(&m->wire_hist[fas_metrics_bucket(wire_us)], 1);
+    fas_metrics_add(&m->wire_sum_us, wire_us);
+    fas_metrics_add(&m->stack_hist[fas_metrics_bucket(stack_us)], 1);
+    fas_metrics_add(&m->stack_sum_us, stack_us);
+}
+
+/**@brief 응답 시간 초과 기록 (signal handler에서 불러도 됨)
+  * @param int iBdID 드라이브 ID*/
+static inline void FAS_MetricsTimeout(int iBdID) {
+    FAS_METRICS *m = fas_metrics_board(iBdID);
+    if (m == NULL)
+        return;
+    fas_metrics_add(&m->timeouts.value, 1);
+}
+
+#endif	//FAS_METRICS_DEFINE
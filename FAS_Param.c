@@ -0,0 +1,269 @@
+/**
+ * @file FAS_Param.c
+ * @brief 파라미터 cache, pipeline 읽기/쓰기, binary 파일 저장/불러오기
+ * @details 파일 형식 (little endian)
+ * [magic 4][version 2][board 수 2] { [iBdID 2][count 2][mask 8][value 4 * count] } * board 수 [CRC32 4]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FAS_Param.h"
+
+ /**@brief cache 초기화
+  * @param int iBdID 드라이브 ID
+  * @param int count 파라미터 수 (0이면 FAS_PARAM_COUNT)*/
+void FAS_ParamCacheInit(FAS_PARAM_CACHE *cache, int iBdID, int count){
+    memset(cache, 0, sizeof(*cache));
+    cache->iBdID = iBdID;
+    cache->count = (count <= 0 || count > FAS_PARAM_MAX) ? FAS_PARAM_COUNT : count;
+}
+
+ /**@brief cache에 값 설정 (드라이브에는 FAS_ParamWriteDirty 때 보냄)
+  * @return 번호가 범위 밖이면 FALSE*/
+bool FAS_ParamSet(FAS_PARAM_CACHE *cache, int param_no, int32_t value){
+    if (param_no < 0 || param_no >= cache->count)
+        return false;
+    uint64_t bit = 1ull << param_no;
+    cache->value[param_no] = value;
+    if ((cache->valid & bit) && cache->drive[param_no] == value)
+        cache->dirty &= ~bit;
+    else
+        cache->dirty |= bit;
+    return true;
+}
+
+ /**@brief cache의 값 조회
+  * @return 읽었거나 설정한 적 없는 번호면 FALSE*/
+bool FAS_ParamGet(const FAS_PARAM_CACHE *cache, int param_no, int32_t *value){
+    if (param_no < 0 || param_no >= cache->count)
+        return false;
+    if (!((cache->valid | cache->dirty) & (1ull << param_no)))
+        return false;
+    *value = cache->value[param_no];
+    return true;
+}
+
+static void read_done(FAS_REQUEST *req, void *user){
+    FAS_PARAM_CACHE *cache = &((FAS_PARAM_CACHE *)user)[req->link];
+    int param_no = req->data[0];
+    if (req->status != FMM_OK || req->resp_len < 4)
+        return;
+
+    uint64_t bit = 1ull << param_no;
+    cache->drive[param_no] = (int32_t)fas_get_le32(req->resp);
+    cache->valid |= bit;
+    if (!(cache->dirty & bit))
+        cache->value[param_no] = cache->drive[param_no];
+    else if (cache->value[param_no] == cache->drive[param_no])
+        cache->dirty &= ~bit;
+}
+
+static void write_done(FAS_REQUEST *req, void *user){
+    FAS_PARAM_CACHE *cache = &((FAS_PARAM_CACHE *)user)[req->link];
+    int param_no = req->data[0];
+    if (req->status != FMM_OK)
+        return;
+
+    uint64_t bit = 1ull << param_no;
+    cache->drive[param_no] = (int32_t)fas_get_le32(&req->data[1]);
+    cache->valid |= bit;
+    if (cache->value[param_no] == cache->drive[param_no])
+        cache->dirty &= ~bit;
+    cache->rom_dirty = true;
+}
+
+static void save_done(FAS_REQUEST *req, void *user){
+    if (req->status == FMM_OK)
+        ((FAS_PARAM_CACHE *)user)[req->link].rom_dirty = false;
+}
+
+static FAS_ARENA *option_scratch(const FAS_BATCH_OPTION *option){
+    return option != NULL ? option->scratch : NULL;
+}
+
+static int run_batch(FAS_LINK *links, FAS_PARAM_CACHE *caches, int count, FAS_REQUEST *reqs, int req_count,
+                     const FAS_BATCH_OPTION *option, FAS_REQUEST_DONE done, size_t mark){
+    FAS_BATCH_OPTION opt = { 0 };
+    if (option != NULL)
+        opt = *option;
+    opt.done = done;
+    opt.user = caches;
+    int failed = FAS_ExecuteBatch(links, count, reqs, req_count, &opt);
+    FAS_ScratchFree(opt.scratch, reqs);
+    if (opt.scratch != NULL)
+        FAS_ArenaRelease(opt.scratch, mark);
+    return failed;
+}
+
+ /**@brief 모든 보드의 전체 파라미터를 읽어 cache 갱신 (links[i]와 caches[i]가 같은 보드)
+  * @param int count 보드 수
+  * @return 실패한 요청 수, 메모리 부족이면 -1*/
+int FAS_ParamReadAll(FAS_LINK *links, FAS_PARAM_CACHE *caches, int count, const FAS_BATCH_OPTION *option){
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += caches[i].count;
+    FAS_ARENA *scratch = option_scratch(option);
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    FAS_REQUEST *reqs = FAS_ScratchAlloc(scratch, sizeof(FAS_REQUEST) * (total > 0 ? total : 1), false);
+    if (reqs == NULL)
+        return -1;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        for (int p = 0; p < caches[i].count; p++) {
+            BYTE param_no = (BYTE)p;
+            FAS_RequestInit(&reqs[n++], i, FRAME_GETPARAMETER, &param_no, 1);
+        }
+    }
+    return run_batch(links, caches, count, reqs, n, option, read_done, mark);
+}
+
+ /**@brief cache에서 바뀐 값만 드라이브 RAM에 씀
+  * @return 실패한 요청 수, 메모리 부족이면 -1*/
+int FAS_ParamWriteDirty(FAS_LINK *links, FAS_PARAM_CACHE *caches, int count, const FAS_BATCH_OPTION *option){
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += __builtin_popcountll(caches[i].dirty);
+    if (total == 0)
+        return 0;
+    FAS_ARENA *scratch = option_scratch(option);
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    FAS_REQUEST *reqs = FAS_ScratchAlloc(scratch, sizeof(FAS_REQUEST) * total, false);
+    if (reqs == NULL)
+        return -1;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        for (uint64_t bits = caches[i].dirty; bits != 0; bits &= bits - 1) {
+            int p = __builtin_ctzll(bits);
+            BYTE data[5];
+            data[0] = (BYTE)p;
+            fas_put_le32(&data[1], (uint32_t)caches[i].value[p]);
+            FAS_RequestInit(&reqs[n++], i, FRAME_SETPARAMETER, data, sizeof(data));
+        }
+    }
+    return run_batch(links, caches, count, reqs, n, option, write_done, mark);
+}
+
+ /**@brief RAM에 쓴 값이 있는 보드만 ROM 저장 (FAS_SaveAllParameters)
+  * @return 실패한 요청 수, 메모리 부족이면 -1*/
+int FAS_ParamSaveToROM(FAS_LINK *links, FAS_PARAM_CACHE *caches, int count, const FAS_BATCH_OPTION *option){
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += caches[i].rom_dirty;
+    if (total == 0)
+        return 0;
+    FAS_ARENA *scratch = option_scratch(option);
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    FAS_REQUEST *reqs = FAS_ScratchAlloc(scratch, sizeof(FAS_REQUEST) * total, false);
+    if (reqs == NULL)
+        return -1;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (caches[i].rom_dirty)
+            FAS_RequestInit(&reqs[n++], i, FRAME_SAVEALLPARAMETERS, NULL, 0);
+    }
+    return run_batch(links, caches, count, reqs, n, option, save_done, mark);
+}
+
+static uint32_t crc32_update(uint32_t crc, const BYTE *p, size_t len){
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static void put_le16(BYTE *p, uint16_t v){ p[0] = v & 0xFF; p[1] = v >> 8; }
+static uint16_t get_le16(const BYTE *p){ return (uint16_t)(p[0] | (p[1] << 8)); }
+static void put_le64(BYTE *p, uint64_t v){ fas_put_le32(p, (uint32_t)v); fas_put_le32(p + 4, (uint32_t)(v >> 32)); }
+static uint64_t get_le64(const BYTE *p){ return fas_get_le32(p) | ((uint64_t)fas_get_le32(p + 4) << 32); }
+
+ /**@brief cache의 값(읽었거나 설정한 것)을 binary 파일로 저장
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ParamExport(const char *path, const FAS_PARAM_CACHE *caches, int count){
+    size_t size = 8 + 4;
+    for (int i = 0; i < count; i++)
+        size += 12 + 4 * (size_t)caches[i].count;
+    BYTE *buf = malloc(size);
+    if (buf == NULL)
+        return false;
+
+    BYTE *p = buf;
+    fas_put_le32(p, FAS_PARAM_FILE_MAGIC); put_le16(p + 4, FAS_PARAM_FILE_VERSION); put_le16(p + 6, (uint16_t)count);
+    p += 8;
+    for (int i = 0; i < count; i++) {
+        const FAS_PARAM_CACHE *c = &caches[i];
+        put_le16(p, (uint16_t)c->iBdID); put_le16(p + 2, (uint16_t)c->count); put_le64(p + 4, c->valid | c->dirty);
+        p += 12;
+        for (int k = 0; k < c->count; k++, p += 4)
+            fas_put_le32(p, (uint32_t)c->value[k]);
+    }
+    fas_put_le32(p, crc32_update(0, buf, p - buf));
+
+    FILE *fp = fopen(path, "wb");
+    bool ok = fp != NULL && fwrite(buf, 1, size, fp) == size;
+    if (fp != NULL && fclose(fp) != 0)
+        ok = false;
+    free(buf);
+    return ok;
+}
+
+ /**@brief binary 파일의 값을 같은 iBdID의 cache에 설정 (바뀐 값은 dirty가 됨)
+  * @return 값을 받은 보드 수, 파일 오류면 -1*/
+int FAS_ParamImport(const char *path, FAS_PARAM_CACHE *caches, int count){
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+        return -1;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 12) {
+        fclose(fp);
+        return -1;
+    }
+    BYTE *buf = malloc(size);
+    if (buf == NULL || fread(buf, 1, size, fp) != (size_t)size) {
+        free(buf);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    int updated = -1;
+    if (fas_get_le32(buf) != FAS_PARAM_FILE_MAGIC || get_le16(buf + 4) != FAS_PARAM_FILE_VERSION ||
+        crc32_update(0, buf, size - 4) != fas_get_le32(buf + size - 4))
+        goto out;
+
+    int boards = get_le16(buf + 6);
+    const BYTE *p = buf + 8, *end = buf + size - 4;
+    updated = 0;
+    for (int b = 0; b < boards; b++) {
+        if (end - p < 12)
+            break;
+        int iBdID = get_le16(p), nparam = get_le16(p + 2);
+        uint64_t mask = get_le64(p + 4);
+        p += 12;
+        if (end - p < 4 * nparam)
+            break;
+
+        for (int i = 0; i < count; i++) {
+            if (caches[i].iBdID != iBdID)
+                continue;
+            for (int k = 0; k < nparam && k < caches[i].count && k < 64; k++) {
+                if (mask & (1ull << k))
+                    FAS_ParamSet(&caches[i], k, (int32_t)fas_get_le32(p + 4 * k));
+            }
+            updated++;
+            break;
+        }
+        p += 4 * nparam;
+    }
+out:
+    free(buf);
+    return updated;
+}
@@ -0,0 +1,49 @@
+
+#pragma once
+
+#ifndef FAS_PARAM_DEFINE
+#define FAS_PARAM_DEFINE
+
+/**
+ * @file FAS_Param.h
+ * @brief 드라이브 파라미터 일괄 읽기/쓰기와 로컬 cache
+ * @details 전체 파라미터를 FAS_GetParameter(0x13)로 pipeline 읽기 해서 cache에 두고,
+ * 값을 바꾸면 dirty 표시만 한다. FAS_ParamWriteDirty는 바뀐 값만 FAS_SetParameter(0x12)로 보내고,
+ * FAS_ParamSaveToROM은 RAM에 쓴 값이 있는 보드에만 FAS_SaveAllParameters(0x10)를 보낸다.
+ * 여러 보드를 한 번에 넘기면 보드끼리도 동시에 진행한다.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FAS_Pipeline.h"
+
+#define FAS_PARAM_MAX 64		// cache가 담을 수 있는 파라미터 번호 범위
+#define FAS_PARAM_COUNT 36		// Ezi-SERVO Plus-E 파라미터 번호 0~35
+
+#define FAS_PARAM_FILE_MAGIC 0x50534146	// "FASP"
+#define FAS_PARAM_FILE_VERSION 1
+
+/**@brief 보드 한 개의 파라미터 cache*/
+typedef struct _FAS_PARAM_CACHE
+{
+	int iBdID;
+	int count;						// 사용하는 파라미터 수 (0 ~ count-1)
+	int32_t value[FAS_PARAM_MAX];	// 원하는 값
+	int32_t drive[FAS_PARAM_MAX];	// 드라이브 RAM에 있다고 확인된 값
+	uint64_t valid;					// drive[]를 읽었거나 써서 알고 있는 번호
+	uint64_t dirty;					// value[] != drive[] 이고 아직 안 보낸 번호
+	bool rom_dirty;					// RAM에 썼지만 ROM 저장 안 함
+} FAS_PARAM_CACHE;
+
+void FAS_ParamCacheInit(FAS_PARAM_CACHE *cache, int iBdID, int count);
+bool FAS_ParamSet(FAS_PARAM_CACHE *cache, int param_no, int32_t value);
+bool FAS_ParamGet(const FAS_PARAM_CACHE *cache, int param_no, int32_t *value);
+
+int FAS_ParamReadAll(FAS_LINK *links, FAS_PARAM_CACHE *caches, int count, const FAS_BATCH_OPTION *option);
+int FAS_ParamWriteDirty(FAS_LINK *links, FAS_PARAM_CACHE *caches, int count, const FAS_BATCH_OPTION *option);
+int FAS_ParamSaveToROM(FAS_LINK *links, FAS_PARAM_CACHE *caches, int count, const FAS_BATCH_OPTION *option);
+
+bool FAS_ParamExport(const char *path, const FAS_PARAM_CACHE *caches, int count);
+int FAS_ParamImport(const char *path, FAS_PARAM_CACHE *caches, int count);
+
+#endif	//FAS_PARAM_DEFINE
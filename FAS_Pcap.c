@@ -0,0 +1,611 @@
+/**
+ * @file FAS_Pcap.c
+ * @brief pcap/pcapng 읽기 (mmap), link/IPv4/UDP/TCP 해석, TCP 재조립, 요청/응답 짝 맞추기, 보고서
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "FAS_Pcap.h"
+#include "FAS_Codec.h"
+
+#define PCAP_MAGIC_US 0xA1B2C3D4u
+#define PCAP_MAGIC_NS 0xA1B23C4Du
+#define PCAPNG_SHB 0x0A0D0D0Au
+#define PCAPNG_IDB 1u
+#define PCAPNG_SPB 3u
+#define PCAPNG_EPB 6u
+#define PCAPNG_BOM 0x1A2B3C4Du
+
+#define LINK_NULL 0
+#define LINK_ETHERNET 1
+#define LINK_RAW 101
+#define LINK_RAW_BSD 12
+#define LINK_LOOP 108
+#define LINK_SLL 113
+#define LINK_SLL2 276
+
+#define TCP_FIN 0x01
+#define TCP_SYN 0x02
+#define TCP_RST 0x04
+
+/**@brief pcapng interface (link type, timestamp 단위)*/
+typedef struct _PCAP_IF
+{
+	int link;
+	uint64_t ts_per_sec;
+} PCAP_IF;
+
+static inline uint16_t rd16(const BYTE *p, bool swap){
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return swap ? __builtin_bswap16(v) : v;
+}
+
+static inline uint32_t rd32(const BYTE *p, bool swap){
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return swap ? __builtin_bswap32(v) : v;
+}
+
+static inline uint16_t be16(const BYTE *p){
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static inline uint32_t be32(const BYTE *p){
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+// FNV-1a, 재전송 판별용
+static uint32_t frame_hash(const BYTE *p, int len){
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < len; i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+ /**@brief 통계 비우기
+  * @param uint16_t port_udp Fastech UDP port (0이면 PORT_UDP)
+  * @param uint16_t port_tcp Fastech TCP port (0이면 PORT_TCP)*/
+void FAS_PcapInit(FAS_PCAP_STATS *stats, uint16_t port_udp, uint16_t port_tcp){
+    memset(stats, 0, sizeof(*stats));
+    stats->port_udp = port_udp != 0 ? port_udp : PORT_UDP;
+    stats->port_tcp = port_tcp != 0 ? port_tcp : PORT_TCP;
+}
+
+static FAS_PCAP_DRIVE *drive_find(FAS_PCAP_STATS *stats, uint32_t ip, bool tcp){
+    uint32_t h = ((ip * 2654435761u) ^ (tcp ? 0x9E3779B9u : 0)) & (FAS_PCAP_SLOTS - 1);
+    for (;; h = (h + 1) & (FAS_PCAP_SLOTS - 1)) {
+        int i = stats->slot[h];
+        if (i == 0)
+            break;
+        FAS_PCAP_DRIVE *d = &stats->drive[i - 1];
+        if (d->ip == ip && d->tcp == tcp)
+            return d;
+    }
+    if (stats->drive_count == FAS_PCAP_MAX_DRIVES) {
+        stats->drives_full = true;
+        return NULL;
+    }
+    FAS_PCAP_DRIVE *d = &stats->drive[stats->drive_count++];
+    memset(d, 0, sizeof(*d));
+    d->ip = ip;
+    d->tcp = tcp;
+    stats->slot[h] = stats->drive_count;
+    return d;
+}
+
+// 연결을 찾고 없으면 만듦 (드라이브도 함께), 표가 차면 NULL
+static FAS_PCAP_CONN *conn_find(FAS_PCAP_STATS *stats, uint32_t host_ip, uint16_t host_port, uint32_t drive_ip,
+                                uint16_t drive_port, bool tcp){
+    uint32_t h = (host_ip * 2654435761u) ^ (drive_ip * 2246822519u) ^ ((uint32_t)host_port << 16 | drive_port) * 3266489917u;
+    h = (h ^ (h >> 15) ^ (tcp ? 0x9E3779B9u : 0)) & (FAS_PCAP_CONN_SLOTS - 1);
+    for (;; h = (h + 1) & (FAS_PCAP_CONN_SLOTS - 1)) {
+        int i = stats->conn_slot[h];
+        if (i == 0)
+            break;
+        FAS_PCAP_CONN *c = &stats->conn[i - 1];
+        if (c->host_ip == host_ip && c->drive_ip == drive_ip && c->host_port == host_port && c->drive_port == drive_port
+            && c->tcp == tcp)
+            return c;
+    }
+    if (stats->conn_count == FAS_PCAP_MAX_CONNS) {
+        stats->conns_full = true;
+        return NULL;
+    }
+    FAS_PCAP_DRIVE *d = drive_find(stats, drive_ip, tcp);
+    if (d == NULL)
+        return NULL;
+    d->connections++;
+    FAS_PCAP_CONN *c = &stats->conn[stats->conn_count++];
+    memset(c, 0, sizeof(*c));
+    c->host_ip = host_ip;
+    c->drive_ip = drive_ip;
+    c->host_port = host_port;
+    c->drive_port = drive_port;
+    c->tcp = tcp;
+    c->drive = (int)(d - stats->drive);
+    stats->conn_slot[h] = stats->conn_count;
+    return c;
+}
+
+/************************************************************************************************************************************
+ ************************************************** Fastech 프레임 ********************************************************************
+ ************************************************************************************************************************************/
+
+static void frame_request(FAS_PCAP_STATS *stats, FAS_PCAP_CONN *c, uint64_t t_us, const BYTE *frame, int len){
+    FAS_PCAP_DRIVE *d = &stats->drive[c->drive];
+    stats->frames++;
+    if (len < FRAME_HEADER_SIZE || frame[0] != FRAME_HEADER || frame[1] + 2 != len) {
+        d->bad_frames++;
+        return;
+    }
+    BYTE sync = frame[2], type = frame[4];
+    int data_len = len - FRAME_HEADER_SIZE;
+    int expect = FAS_FrameDataLength(type);
+    if (expect != FAS_FRAME_DATA_VARIABLE && expect != data_len)
+        d->bad_frames++;
+    d->requests++;
+    d->type_count[type]++;
+
+    uint32_t h = frame_hash(frame + FRAME_HEADER_SIZE - 1, data_len + 1);
+    uint16_t *recent = &c->recent[h & (FAS_PCAP_RECENT - 1)];
+    if (*recent != 0) {
+        // 응답 없이 같은 요청을 다시 보냄 (Sync No.가 같든 새로 받았든)
+        FAS_PCAP_PENDING *prev = &c->pending[*recent - 1];
+        if (prev->valid && prev->frame_type == type && prev->hash == h && t_us >= prev->t_us + FAS_PCAP_RETRY_US) {
+            d->retransmits++;
+            prev->valid = false;
+        }
+    }
+    if (c->pending[sync].valid)
+        d->unanswered++;
+    c->pending[sync] = (FAS_PCAP_PENDING){ .t_us = t_us, .hash = h, .frame_type = type, .valid = true };
+    *recent = (uint16_t)(sync + 1);
+}
+
+static void frame_response(FAS_PCAP_STATS *stats, FAS_PCAP_CONN *c, uint64_t t_us, const BYTE *frame, int len){
+    FAS_PCAP_DRIVE *d = &stats->drive[c->drive];
+    stats->frames++;
+    if (len < FRAME_HEADER_SIZE + 1 || frame[0] != FRAME_HEADER || frame[1] + 2 != len) {
+        d->bad_frames++;
+        return;
+    }
+    BYTE sync = frame[2], type = frame[4];
+    d->responses++;
+    d->error_hist[frame[FRAME_HEADER_SIZE]]++;
+
+    FAS_PCAP_PENDING *p = &c->pending[sync];
+    if (!p->valid || p->frame_type != type) {
+        d->unmatched++;
+        return;
+    }
+    uint64_t rtt = t_us > p->t_us ? t_us - p->t_us : 0;
+    d->matched++;
+    d->rtt_sum_us += rtt;
+    if (rtt > d->rtt_max_us)
+        d->rtt_max_us = rtt;
+    d->rtt_hist[fas_metrics_bucket(rtt)]++;
+    p->valid = false;
+}
+
+static void frame_dispatch(FAS_PCAP_STATS *stats, FAS_PCAP_CONN *c, int dir, uint64_t t_us, const BYTE *frame, int len){
+    if (dir == 0)
+        frame_request(stats, c, t_us, frame, len);
+    else
+        frame_response(stats, c, t_us, frame, len);
+}
+
+// stream buffer 앞에서부터 완성된 프레임을 잘라 냄, 남은 조각은 앞으로 당김
+static void stream_cut(FAS_PCAP_STATS *stats, FAS_PCAP_CONN *c, int dir, uint64_t t_us){
+    FAS_PCAP_STREAM *s = &c->stream[dir];
+    int off = 0;
+    while (off < s->len) {
+        // 머리가 아니면 1 byte씩 넘기며 다시 맞춤 (gap 뒤), 한 번 어긋난 구간은 프레임 하나로 셈
+        if (s->buf[off] != FRAME_HEADER || (s->len - off >= 2 && s->buf[off + 1] < 3)) {
+            if (!c->skipping)
+                stats->drive[c->drive].bad_frames++;
+            c->skipping = true;
+            off++;
+            continue;
+        }
+        int n = FAS_CodecFastech.frame_length(s->buf + off, s->len - off);
+        if (n <= 0)
+            break;
+        c->skipping = false;
+        frame_dispatch(stats, c, dir, t_us, s->buf + off, n);
+        off += n;
+    }
+    if (off > 0) {
+        memmove(s->buf, s->buf + off, s->len - off);
+        s->len -= off;
+    }
+}
+
+static void tcp_segment(FAS_PCAP_STATS *stats, FAS_PCAP_CONN *c, int dir, uint64_t t_us, uint32_t seq, BYTE flags,
+                        const BYTE *payload, uint32_t len){
+    FAS_PCAP_STREAM *s = &c->stream[dir];
+    FAS_PCAP_DRIVE *d = &stats->drive[c->drive];
+    if (flags & (TCP_SYN | TCP_RST)) {
+        s->known = (flags & TCP_SYN) != 0;
+        s->next_seq = seq + 1;
+        s->len = 0;
+        if (flags & TCP_RST)
+            return;
+        seq++;
+    }
+    if (len == 0)
+        return;
+    if (!s->known) {
+        s->known = true;
+        s->next_seq = seq;
+    }
+
+    int32_t diff = (int32_t)(seq - s->next_seq);
+    if (diff > 0) {
+        // capture가 놓친 구간, 프레임 경계를 모르므로 buffer를 버리고 다음 머리부터
+        d->tcp_gaps++;
+        s->len = 0;
+        s->next_seq = seq;
+    }
+    else if (diff < 0) {
+        d->tcp_retransmits++;
+        if ((uint32_t)-diff >= len)
+            return;
+        payload += -diff;
+        len -= (uint32_t)-diff;
+    }
+    s->next_seq += len;
+
+    while (len > 0) {
+        uint32_t room = FAS_PCAP_STREAM_SIZE - s->len;
+        uint32_t take = len < room ? len : room;
+        memcpy(s->buf + s->len, payload, take);
+        s->len += (int)take;
+        payload += take;
+        len -= take;
+        stream_cut(stats, c, dir, t_us);
+        // 프레임 하나(최대 BUFFER_SIZE)보다 많이 남을 수 없음
+        if (s->len == FAS_PCAP_STREAM_SIZE)
+            s->len = 0;
+    }
+}
+
+/************************************************************************************************************************************
+ ************************************************** link / IPv4 / UDP / TCP **********************************************************
+ ************************************************************************************************************************************/
+
+// link header를 벗겨 IPv4 패킷 위치를 찾음
+static const BYTE *link_ipv4(int link, const BYTE *p, uint32_t len, uint32_t *ip_len){
+    uint32_t off;
+    switch (link) {
+        case LINK_ETHERNET: {
+            off = 12;
+            if (len < off + 2)
+                return NULL;
+            uint16_t type = be16(p + off);
+            while ((type == 0x8100 || type == 0x88A8) && len >= off + 6) {
+                off += 4;
+                type = be16(p + off);
+            }
+            if (type != 0x0800)
+                return NULL;
+            off += 2;
+            break;
+        }
+        case LINK_SLL:
+            if (len < 16 || be16(p + 14) != 0x0800)
+                return NULL;
+            off = 16;
+            break;
+        case LINK_SLL2:
+            if (len < 20 || be16(p) != 0x0800)
+                return NULL;
+            off = 20;
+            break;
+        case LINK_RAW:
+        case LINK_RAW_BSD:
+            off = 0;
+            break;
+        case LINK_NULL:
+        case LINK_LOOP:
+            off = 4;
+            break;
+        default:
+            return NULL;
+    }
+    if (len < off + 20 || (p[off] >> 4) != 4)
+        return NULL;
+    *ip_len = len - off;
+    return p + off;
+}
+
+static void packet(FAS_PCAP_STATS *stats, int link, uint64_t t_us, const BYTE *p, uint32_t len){
+    uint32_t ip_len;
+    stats->packets++;
+    const BYTE *ip = link_ipv4(link, p, len, &ip_len);
+    if (ip == NULL) {
+        stats->skipped++;
+        return;
+    }
+    uint32_t ihl = (ip[0] & 0x0F) * 4u, total = be16(ip + 2);
+    // 조각난 IP는 보지 않음 (Fastech 프레임은 258 byte 이하)
+    if (ihl < 20 || (be16(ip + 6) & 0x3FFF) != 0) {
+        stats->skipped++;
+        return;
+    }
+    if (total < ip_len)
+        ip_len = total;
+    if (ip_len < ihl) {
+        stats->skipped++;
+        return;
+    }
+    BYTE proto = ip[9];
+    uint32_t src, dst;
+    memcpy(&src, ip + 12, 4);
+    memcpy(&dst, ip + 16, 4);
+    const BYTE *l4 = ip + ihl;
+    uint32_t l4_len = ip_len - ihl;
+
+    if (proto == 17 && l4_len >= 8) {
+        uint16_t sport = be16(l4), dport = be16(l4 + 2);
+        int dir = dport == stats->port_udp ? 0 : sport == stats->port_udp ? 1 : -1;
+        if (dir < 0)
+            return;
+        uint32_t n = be16(l4 + 4);
+        n = n >= 8 && n <= l4_len ? n - 8 : l4_len - 8;
+        FAS_PCAP_CONN *c = dir == 0 ? conn_find(stats, src, sport, dst, dport, false)
+                                    : conn_find(stats, dst, dport, src, sport, false);
+        stats->fastech_packets++;
+        if (c == NULL)
+            return;
+        FAS_PCAP_DRIVE *d = &stats->drive[c->drive];
+        if (d->first_us == 0)
+            d->first_us = t_us;
+        d->last_us = t_us;
+        d->bytes += n;
+        frame_dispatch(stats, c, dir, t_us, l4 + 8, (int)n);
+    }
+    else if (proto == 6 && l4_len >= 20) {
+        uint16_t sport = be16(l4), dport = be16(l4 + 2);
+        int dir = dport == stats->port_tcp ? 0 : sport == stats->port_tcp ? 1 : -1;
+        uint32_t doff = (l4[12] >> 4) * 4u;
+        if (dir < 0)
+            return;
+        if (doff < 20 || doff > l4_len) {
+            stats->skipped++;
+            return;
+        }
+        FAS_PCAP_CONN *c = dir == 0 ? conn_find(stats, src, sport, dst, dport, true)
+                                    : conn_find(stats, dst, dport, src, sport, true);
+        stats->fastech_packets++;
+        if (c == NULL)
+            return;
+        FAS_PCAP_DRIVE *d = &stats->drive[c->drive];
+        if (d->first_us == 0)
+            d->first_us = t_us;
+        d->last_us = t_us;
+        d->bytes += l4_len - doff;
+        tcp_segment(stats, c, dir, t_us, be32(l4 + 4), l4[13], l4 + doff, l4_len - doff);
+    }
+}
+
+/************************************************************************************************************************************
+ ************************************************** pcap / pcapng ********************************************************************
+ ************************************************************************************************************************************/
+
+static bool parse_pcap(FAS_PCAP_STATS *stats, const BYTE *data, size_t size){
+    uint32_t magic = rd32(data, false);
+    bool swap = magic == __builtin_bswap32(PCAP_MAGIC_US) || magic == __builtin_bswap32(PCAP_MAGIC_NS);
+    bool nsec = magic == PCAP_MAGIC_NS || magic == __builtin_bswap32(PCAP_MAGIC_NS);
+    int link = (int)(rd32(data + 20, swap) & 0x0FFFFFFF);
+    size_t off = 24;
+    while (off + 16 <= size) {
+        uint32_t sec = rd32(data + off, swap), frac = rd32(data + off + 4, swap), incl = rd32(data + off + 8, swap);
+        if (incl > size - off - 16) {
+            stats->truncated = true;
+            break;
+        }
+        uint64_t t_us = (uint64_t)sec * 1000000u + (nsec ? frac / 1000u : frac);
+        packet(stats, link, t_us, data + off + 16, incl);
+        off += 16 + (size_t)incl;
+    }
+    return true;
+}
+
+// IDB option에서 if_tsresol(9)을 찾아 초당 timestamp 단위 수로
+static uint64_t idb_ts_per_sec(const BYTE *opt, const BYTE *end, bool swap){
+    while (opt + 4 <= end) {
+        uint16_t code = rd16(opt, swap), len = rd16(opt + 2, swap);
+        if (code == 0 || opt + 4 + len > end)
+            break;
+        if (code == 9 && len >= 1) {
+            BYTE v = opt[4];
+            uint64_t per_sec = 1;
+            for (int i = 0; i < (v & 0x7F) && per_sec < (1ull << 60); i++)
+                per_sec *= (v & 0x80) ? 2 : 10;
+            return per_sec;
+        }
+        opt += 4 + ((len + 3u) & ~3u);
+    }
+    return 1000000u;
+}
+
+static bool parse_pcapng(FAS_PCAP_STATS *stats, const BYTE *data, size_t size){
+    PCAP_IF ifs[FAS_PCAP_MAX_IF];
+    int if_count = 0;
+    bool swap = false;
+    uint64_t last_us = 0;
+    size_t off = 0;
+    stats->pcapng = true;
+
+    while (off + 12 <= size) {
+        uint32_t type = rd32(data + off, swap);
+        if (type == PCAPNG_SHB) {
+            swap = rd32(data + off + 8, false) != PCAPNG_BOM;
+            if_count = 0;
+        }
+        uint32_t len = rd32(data + off + 4, swap);
+        if (len < 12 || (len & 3) != 0 || len > size - off) {
+            stats->truncated = true;
+            break;
+        }
+        const BYTE *b = data + off;
+        switch (type) {
+            case PCAPNG_IDB:
+                if (len >= 20 && if_count < FAS_PCAP_MAX_IF) {
+                    ifs[if_count].link = rd16(b + 8, swap);
+                    ifs[if_count].ts_per_sec = idb_ts_per_sec(b + 16, b + len - 4, swap);
+                    if_count++;
+                }
+                break;
+            case PCAPNG_EPB: {
+                if (len < 32)
+                    break;
+                uint32_t id = rd32(b + 8, swap), cap = rd32(b + 20, swap);
+                if (id >= (uint32_t)if_count || cap > len - 32) {
+                    stats->skipped++;
+                    break;
+                }
+                uint64_t ts = (uint64_t)rd32(b + 12, swap) << 32 | rd32(b + 16, swap);
+                uint64_t per_sec = ifs[id].ts_per_sec;
+                last_us = per_sec == 1000000u ? ts : (uint64_t)((unsigned __int128)ts * 1000000u / per_sec);
+                packet(stats, ifs[id].link, last_us, b + 28, cap);
+                break;
+            }
+            case PCAPNG_SPB: {
+                // 시각이 없으므로 앞 패킷 시각을 씀
+                if (len < 16 || if_count == 0)
+                    break;
+                uint32_t orig = rd32(b + 8, swap), cap = len - 16;
+                packet(stats, ifs[0].link, last_us, b + 12, orig < cap ? orig : cap);
+                break;
+            }
+            default:
+                break;
+        }
+        off += len;
+    }
+    return true;
+}
+
+ /**@brief 메모리에 있는 capture 분석 (FAS_PcapInit 뒤, 여러 번 부르면 합쳐서 셈)
+  * @return boolean pcap/pcapng이면 TRUE, 형식을 모르면 FALSE*/
+bool FAS_PcapAnalyzeBuffer(FAS_PCAP_STATS *stats, const BYTE *data, size_t size){
+    if (size < 24)
+        return false;
+    uint32_t magic = rd32(data, false);
+    uint64_t t0 = FAS_MonotonicUs();
+    bool ok;
+    if (magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS || magic == __builtin_bswap32(PCAP_MAGIC_US)
+        || magic == __builtin_bswap32(PCAP_MAGIC_NS))
+        ok = parse_pcap(stats, data, size);
+    else if (magic == PCAPNG_SHB)
+        ok = parse_pcapng(stats, data, size);
+    else
+        return false;
+
+    // 파일 끝까지 응답이 없는 요청
+    for (int i = 0; i < stats->conn_count; i++) {
+        FAS_PCAP_CONN *c = &stats->conn[i];
+        for (int s = 0; s < 256; s++) {
+            if (c->pending[s].valid) {
+                stats->drive[c->drive].unanswered++;
+                c->pending[s].valid = false;
+            }
+        }
+    }
+    stats->file_bytes += size;
+    stats->elapsed_us += FAS_MonotonicUs() - t0;
+    return ok;
+}
+
+ /**@brief capture 파일을 mmap으로 열어 분석
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_PcapAnalyze(FAS_PCAP_STATS *stats, const char *path){
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        fprintf(stderr, "%s: empty or unreadable\n", path);
+        close(fd);
+        return false;
+    }
+    BYTE *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("capture mmap failed");
+        return false;
+    }
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+    bool ok = FAS_PcapAnalyzeBuffer(stats, data, (size_t)st.st_size);
+    if (!ok)
+        fprintf(stderr, "%s: not a pcap/pcapng file\n", path);
+    munmap(data, (size_t)st.st_size);
+    return ok;
+}
+
+/************************************************************************************************************************************
+ ************************************************** 보고서 ****************************************************************************
+ ************************************************************************************************************************************/
+
+static void report_drive(const FAS_PCAP_DRIVE *d, FILE *fp){
+    char ip[16];
+    const BYTE *a = (const BYTE *)&d->ip;
+    snprintf(ip, sizeof(ip), "%u.%u.%u.%u", a[0], a[1], a[2], a[3]);
+    double span = d->last_us > d->first_us ? (d->last_us - d->first_us) / 1e6 : 0;
+
+    fprintf(fp, "%-15s %s  requests %" PRIu64 " responses %" PRIu64 " matched %" PRIu64 " over %.3f s, %u connection%s\n", ip,
+            d->tcp ? "tcp" : "udp", d->requests, d->responses, d->matched, span, d->connections, d->connections == 1 ? "" : "s");
+    if (d->matched > 0)
+        fprintf(fp, "  rtt us: avg %.0f p50 %" PRIu64 " p99 %" PRIu64 " max %" PRIu64 "\n", (double)d->rtt_sum_us / d->matched,
+                FAS_MetricsHistPercentile(d->rtt_hist, 50), FAS_MetricsHistPercentile(d->rtt_hist, 99), d->rtt_max_us);
+    fprintf(fp, "  retransmits %" PRIu64 " unanswered %" PRIu64 " unmatched %" PRIu64 " bad frames %" PRIu64, d->retransmits,
+            d->unanswered, d->unmatched, d->bad_frames);
+    if (d->tcp)
+        fprintf(fp, " tcp retransmits %" PRIu64 " capture gaps %" PRIu64, d->tcp_retransmits, d->tcp_gaps);
+    fprintf(fp, "\n");
+    for (int code = 1; code < FAS_ERROR_CODES; code++) {
+        if (d->error_hist[code] != 0)
+            fprintf(fp, "  error %s (0x%02X): %" PRIu64 "\n", FAS_ErrorName((FMM_ERROR)code), code, d->error_hist[code]);
+    }
+    for (int type = 0; type < 256; type++) {
+        if (d->type_count[type] != 0)
+            fprintf(fp, "  0x%02X %-28s %" PRIu64 "\n", type, FAS_FrameName((BYTE)type), d->type_count[type]);
+    }
+}
+
+ /**@brief 드라이브별 보고서 (드라이브 IP 순)*/
+void FAS_PcapReport(const FAS_PCAP_STATS *stats, FILE *fp){
+    fprintf(fp, "%s, %" PRIu64 " bytes, %" PRIu64 " packets (%" PRIu64 " Fastech, %" PRIu64 " skipped), %" PRIu64
+            " frames, %d drives, %.1f ms (%.0f MB/s)%s\n", stats->pcapng ? "pcapng" : "pcap", stats->file_bytes,
+            stats->packets, stats->fastech_packets, stats->skipped, stats->frames, stats->drive_count,
+            stats->elapsed_us / 1000.0, stats->elapsed_us ? stats->file_bytes / (double)stats->elapsed_us : 0.0,
+            stats->truncated ? ", truncated" : "");
+    if (stats->drives_full)
+        fprintf(fp, "more than %d drives, the rest not counted\n", FAS_PCAP_MAX_DRIVES);
+    if (stats->conns_full)
+        fprintf(fp, "more than %d connections, the rest not counted\n", FAS_PCAP_MAX_CONNS);
+
+    // 드라이브 IP(host 순서) 순으로 보여 줌, 드라이브 수가 적으므로 선택 정렬
+    bool shown[FAS_PCAP_MAX_DRIVES] = { false };
+    for (int n = 0; n < stats->drive_count; n++) {
+        int best = -1;
+        for (int i = 0; i < stats->drive_count; i++) {
+            if (shown[i])
+                continue;
+            if (best < 0 || be32((const BYTE *)&stats->drive[i].ip) < be32((const BYTE *)&stats->drive[best].ip)
+                || (stats->drive[i].ip == stats->drive[best].ip && !stats->drive[i].tcp))
+                best = i;
+        }
+        shown[best] = true;
+        report_drive(&stats->drive[best], fp);
+    }
+}
@@ -0,0 +1,133 @@
+
+#pragma once
+
+#ifndef FAS_PCAP_DEFINE
+#define FAS_PCAP_DEFINE
+
+/**
+ * @file FAS_Pcap.h
+ * @brief 현장 Wireshark capture(pcap/pcapng)에서 Fastech 프레임을 골라 드라이브별 통계를 내는 offline 분석
+ * @details 파일은 mmap으로 열어 처음부터 끝까지 한 번만 읽고, 패킷마다 할당 없이 고정 크기 표만 고친다.
+ * Ethernet(VLAN 포함), Linux cooked(SLL, SLL2), raw IP, BSD loopback 위의 IPv4만 보고
+ * UDP port_udp(기본 3001)와 TCP port_tcp(기본 2001)를 Fastech 흐름으로 본다. 드라이브 port로 가는 쪽이 요청,
+ * 드라이브 port에서 오는 쪽이 응답이다.
+ * 재조립과 짝 맞추기는 연결(host IP/port, 드라이브 IP/port, UDP/TCP)마다 따로 하고 통계만 드라이브별로 합친다.
+ * 그래서 한 드라이브에 여러 host나 여러 TCP 연결이 붙어 있어도 stream과 Sync No.가 섞이지 않는다.
+ * TCP는 연결의 방향마다 순번(seq)으로 이어 붙여서 segment 경계와 무관하게 FAS_CodecFastech.frame_length로 프레임을 자른다.
+ * 이미 받은 구간이 다시 오면 TCP 재전송으로 세고 버리며, capture가 놓친 구간(gap)이 있으면 그 방향 buffer를 비우고 다시 맞춘다.
+ *
+ * 요청과 응답은 연결별 Sync No. 표로 짝을 맞춰 RTT(capture 시각 차)를 FAS_RTT_BUCKETS histogram에 넣는다.
+ * 응답을 받지 못한 요청과 같은 frame type, 같은 data인 요청이 FAS_PCAP_RETRY_US 넘게 지나서 다시 오면 재전송(retransmit)으로
+ * 세고 (shard는 재전송 때 Sync No.를 새로 받으므로 내용으로 봄, 원래 요청의 늦은 응답은 unmatched),
+ * 응답 없이 다른 요청으로 Sync No.가 덮이거나 파일이 끝날 때까지 응답이 없으면 unanswered로 센다.
+ * 이름은 libfastech의 표(FAS_FrameName, FAS_ErrorName, FAS_FrameDataLength)를 그대로 쓰므로 ProtocolTest 화면과 같다.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "FAS_Library.h"
+#include "FAS_Metrics.h"
+
+#define FAS_PCAP_MAX_DRIVES 512				// 구분하는 드라이브 (IP, UDP/TCP) 수
+#define FAS_PCAP_SLOTS 1024					// 드라이브 hash 칸 수 (2^n, FAS_PCAP_MAX_DRIVES의 2배)
+#define FAS_PCAP_MAX_CONNS 1024				// 구분하는 연결 (host IP/port, 드라이브 IP/port, UDP/TCP) 수
+#define FAS_PCAP_CONN_SLOTS 2048			// 연결 hash 칸 수 (2^n, FAS_PCAP_MAX_CONNS의 2배)
+#define FAS_PCAP_MAX_IF 16					// pcapng interface 수
+#define FAS_PCAP_RECENT 64					// 재전송 판별용 요청 내용 hash 칸 수 (2^n)
+#define FAS_PCAP_RETRY_US 1000				// 같은 요청이 이만큼 지나서 다시 오면 재전송 (window 안의 같은 조회는 제외)
+#define FAS_PCAP_STREAM_SIZE (BUFFER_SIZE * 2)	// TCP 방향마다 이어 붙이는 buffer
+
+/**@brief 응답을 기다리는 요청 (Sync No.마다 하나)*/
+typedef struct _FAS_PCAP_PENDING
+{
+	uint64_t t_us;
+	uint32_t hash;					// frame type + data hash (재전송 판별)
+	BYTE frame_type;
+	bool valid;
+} FAS_PCAP_PENDING;
+
+/**@brief TCP 한 방향 재조립 상태*/
+typedef struct _FAS_PCAP_STREAM
+{
+	bool known;						// next_seq를 앎
+	uint32_t next_seq;
+	int len;
+	BYTE buf[FAS_PCAP_STREAM_SIZE];
+} FAS_PCAP_STREAM;
+
+/**@brief 드라이브 하나 (IP와 UDP/TCP 조합)의 통계*/
+typedef struct _FAS_PCAP_DRIVE
+{
+	uint32_t ip;					// network byte order
+	bool tcp;
+	uint64_t first_us;
+	uint64_t last_us;
+
+	uint64_t requests;
+	uint64_t responses;
+	uint64_t matched;				// 요청과 짝이 맞은 응답
+	uint64_t unmatched;				// 기다리는 요청이 없는 응답 (또는 frame type이 다름)
+	uint64_t retransmits;			// 응답 없이 같은 요청을 다시 보냄
+	uint64_t unanswered;			// 응답을 끝내 못 받은 요청
+	uint64_t bad_frames;			// 형식이 틀린 프레임, 요청 data 길이가 표와 다른 프레임
+	uint64_t tcp_retransmits;		// 이미 받은 TCP 구간
+	uint64_t tcp_gaps;				// capture가 놓친 TCP 구간
+	uint64_t bytes;
+	uint32_t connections;			// 이 드라이브에 붙은 연결 수
+
+	uint64_t rtt_sum_us;
+	uint64_t rtt_max_us;
+	uint64_t rtt_hist[FAS_RTT_BUCKETS];
+	uint64_t error_hist[FAS_ERROR_CODES];	// 응답 통신 상태 byte별 수 (FMM_OK 포함)
+	uint64_t type_count[256];				// 요청 frame type별 수
+} FAS_PCAP_DRIVE;
+
+/**@brief 연결 하나의 재조립, 짝 맞추기 상태 (통계는 drive에 합침)*/
+typedef struct _FAS_PCAP_CONN
+{
+	uint32_t host_ip;				// network byte order
+	uint32_t drive_ip;				// network byte order
+	uint16_t host_port;
+	uint16_t drive_port;
+	bool tcp;
+	int drive;						// FAS_PCAP_STATS.drive 번호
+
+	uint16_t recent[FAS_PCAP_RECENT];	// 요청 내용 hash -> 그 내용의 마지막 Sync No. + 1 (0이면 없음)
+	bool skipping;					// TCP stream에서 프레임 머리를 찾는 중
+	FAS_PCAP_PENDING pending[256];
+	FAS_PCAP_STREAM stream[2];		// 0: host -> 드라이브, 1: 드라이브 -> host
+} FAS_PCAP_CONN;
+
+/**@brief FAS_PcapAnalyze 결과 (크므로 heap이나 static에)*/
+typedef struct _FAS_PCAP_STATS
+{
+	uint16_t port_udp;				// 0이면 PORT_UDP
+	uint16_t port_tcp;				// 0이면 PORT_TCP
+
+	bool pcapng;
+	uint64_t file_bytes;
+	uint64_t packets;				// 파일 안의 모든 패킷
+	uint64_t fastech_packets;		// Fastech port의 UDP/TCP 패킷
+	uint64_t frames;				// 잘라 낸 Fastech 프레임
+	uint64_t skipped;				// IPv4가 아님, 조각, 잘린 패킷, 모르는 link type
+	uint64_t elapsed_us;			// 분석에 걸린 시간
+	bool truncated;					// 파일이 블록 중간에서 끝남
+
+	int drive_count;
+	bool drives_full;				// FAS_PCAP_MAX_DRIVES를 넘는 드라이브는 세지 않음
+	int slot[FAS_PCAP_SLOTS];		// (IP, tcp) hash -> drive 번호 + 1
+	FAS_PCAP_DRIVE drive[FAS_PCAP_MAX_DRIVES];
+
+	int conn_count;
+	bool conns_full;				// FAS_PCAP_MAX_CONNS를 넘는 연결은 세지 않음
+	int conn_slot[FAS_PCAP_CONN_SLOTS];	// 연결 hash -> conn 번호 + 1
+	FAS_PCAP_CONN conn[FAS_PCAP_MAX_CONNS];
+} FAS_PCAP_STATS;
+
+void FAS_PcapInit(FAS_PCAP_STATS *stats, uint16_t port_udp, uint16_t port_tcp);
+bool FAS_PcapAnalyze(FAS_PCAP_STATS *stats, const char *path);
+bool FAS_PcapAnalyzeBuffer(FAS_PCAP_STATS *stats, const BYTE *data, size_t size);
+void FAS_PcapReport(const FAS_PCAP_STATS *stats, FILE *fp);
+
+#endif	//FAS_PCAP_DEFINE
@@ -0,0 +1,35 @@
+/**
+ * @file FAS_PcapStat.c
+ * @brief Wireshark capture에서 Fastech 드라이브별 통계 (GTK 없음)
+ * @details 사용법: FAS_PcapStat [-u udp_port] [-t tcp_port] capture.pcap|capture.pcapng ...
+ * 파일을 여러 개 주면 같은 드라이브는 합쳐서 센다 (Sync No. 짝은 파일마다 새로 맞춤).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FAS_Pcap.h"
+
+int main(int argc, char *argv[]){
+    static FAS_PCAP_STATS stats;
+    int port_udp = 0, port_tcp = 0, opt;
+
+    while ((opt = getopt(argc, argv, "u:t:")) != -1) {
+        switch (opt) {
+            case 'u': port_udp = atoi(optarg); break;
+            case 't': port_tcp = atoi(optarg); break;
+            default: optind = argc + 1; break;
+        }
+    }
+    if (optind >= argc || port_udp < 0 || port_udp > 65535 || port_tcp < 0 || port_tcp > 65535) {
+        fprintf(stderr, "usage: %s [-u udp_port] [-t tcp_port] capture.pcap ...\n", argv[0]);
+        return 1;
+    }
+
+    FAS_PcapInit(&stats, (uint16_t)port_udp, (uint16_t)port_tcp);
+    bool ok = true;
+    for (int i = optind; i < argc; i++)
+        ok &= FAS_PcapAnalyze(&stats, argv[i]);
+    FAS_PcapReport(&stats, stdout);
+    return ok && !stats.truncated ? 0 : 1;
+}
@@ -0,0 +1,507 @@
+/**
+ * @file FAS_Pipeline.c
+ * @brief 요청 엔진 구현 (보드별 in-flight window, Sync No. 매칭, 시간 초과 재전송)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include "FAS_Pipeline.h"
+#include "FAS_Metrics.h"
+#include "FAS_Trace.h"
+
+#define SLOT_EMPTY (-1)
+#define TS_CONTROL_SIZE 256			// recvmsg control buffer (SCM_TIMESTAMPING + IP_RECVERR)
+
+// 송신/수신 software 시각, NIC가 지원하면 hardware 시각도 (OPT_TSONLY: error queue로 프레임 내용은 안 돌려받음)
+#define TS_FLAGS (SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE \
+                  | SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE \
+                  | SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY)
+
+/**@brief FAS_ExecuteBatch 동안 보드 하나의 상태*/
+typedef struct _LINK_STATE
+{
+	int *queue;					// 이 보드로 보낼 요청 번호 (순서 유지)
+	int queue_len, queue_pos;
+	int active_count;
+	BYTE active[FAS_WINDOW_MAX];	// 응답 기다리는 Sync No.
+	int slot_req[256];			// Sync No. -> 요청 번호
+	uint64_t slot_sent[256];
+	uint32_t slot_key[256];		// Sync No. -> 송신 OPT_ID 번호
+} LINK_STATE;
+
+ /**@brief 드라이브와 연결 (UDP는 소켓만, TCP는 timeout 있는 connect)
+  * @param FAS_LINK *link 결과
+  * @param int iBdID 드라이브 ID
+  * @param const char *ip "192.168.0.2" 형식
+  * @param bool tcp TCP면 TRUE
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_LinkOpen(FAS_LINK *link, int iBdID, const char *ip, bool tcp){
+    return FAS_LinkOpenPort(link, iBdID, ip, tcp, tcp ? PORT_TCP : PORT_UDP);
+}
+
+ /**@brief FAS_LinkOpen과 같고 port만 지정 (사용자 port)
+  * @param uint16_t port UDP/TCP port*/
+bool FAS_LinkOpenPort(FAS_LINK *link, int iBdID, const char *ip, bool tcp, uint16_t port){
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid address: %s\n", ip);
+        return false;
+    }
+
+    int fd = socket(AF_INET, (tcp ? SOCK_STREAM : SOCK_DGRAM) | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("Socket creation failed");
+        return false;
+    }
+    if (tcp) {
+        // SIGALRM은 프로세스 전체에 하나라서 쓰지 않고 non-blocking connect + poll로 시간 제한
+        int flags = fcntl(fd, F_GETFL);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        int result = connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+        if (result < 0 && errno == EINPROGRESS) {
+            struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+            int err = ETIMEDOUT;
+            socklen_t len = sizeof(err);
+            if (poll(&pfd, 1, TIMEOUT_SECONDS * 1000) == 1)
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            result = err == 0 ? 0 : -1;
+            errno = err;
+        }
+        if (result < 0) {
+            perror("Connection failed");
+            close(fd);
+            return false;
+        }
+        fcntl(fd, F_SETFL, flags);
+    }
+    FAS_LinkAttach(link, iBdID, fd, tcp, &addr);
+    FAS_LinkEnableTimestamps(link);
+    return true;
+}
+
+ /**@brief 이미 열린 소켓으로 link 구성
+  * @param const struct sockaddr_in *addr UDP 목적지 (TCP는 NULL 가능)*/
+void FAS_LinkAttach(FAS_LINK *link, int iBdID, int fd, bool tcp, const struct sockaddr_in *addr){
+    memset(link, 0, sizeof(*link));
+    link->iBdID = iBdID;
+    link->fd = fd;
+    link->tcp = tcp;
+    if (addr != NULL)
+        link->addr = *addr;
+    link->codec = &FAS_CodecFastech;
+    link->sync_no = (BYTE)(rand() % 256);
+}
+
+ /**@brief 연결 해제*/
+void FAS_LinkClose(FAS_LINK *link){
+    if (link->fd >= 0)
+        close(link->fd);
+    link->fd = -1;
+}
+
+ /**@brief 프레임 변형 바꾸기 (FAS_LinkOpen/FAS_LinkAttach는 FAS_CodecFastech로 되돌리므로 연 뒤에 부름)
+  * @param const FAS_CODEC *codec sync가 FALSE인 codec(serial)은 Slave ID로 짝을 맞추므로 보드당 요청 하나씩만 보냄*/
+void FAS_LinkSetCodec(FAS_LINK *link, const FAS_CODEC *codec){
+    link->codec = codec;
+    link->rx_len = 0;
+}
+
+ /**@brief FAS_LinkReceive handler가 받은 응답 프레임을 link의 codec으로 분해
+  * @return 형식/CRC가 맞으면 TRUE*/
+bool FAS_LinkDecode(const FAS_LINK *link, const BYTE *frame, int len, FAS_FRAME_VIEW *view){
+    // handler에 넘어오는 frame은 FAS_LinkReceive의 수신 buffer라 serial codec이 제자리에서 고쳐 써도 됨
+    return FAS_CodecDecode(link->codec, (BYTE *)frame, len, view);
+}
+
+ /**@brief 송수신 kernel timestamp 켜기 (FAS_LinkOpen이 부름, 실패하면 CLOCK_MONOTONIC만 씀)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_LinkEnableTimestamps(FAS_LINK *link){
+    int flags = TS_FLAGS;
+    link->timestamps = setsockopt(link->fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0;
+    link->tx_key = 0;
+    link->tx_stamp_pos = 0;
+    memset(link->tx_stamp, 0, sizeof(link->tx_stamp));
+    return link->timestamps;
+}
+
+/**@brief recvmsg control에서 SCM_TIMESTAMPING 시각 (hardware가 있으면 hardware)과 OPT_ID 번호를 꺼냄
+ * @return 시각이 있으면 TRUE*/
+static bool link_cmsg_stamp(struct msghdr *msg, uint64_t *ns, bool *hw, uint32_t *key){
+    bool found = false;
+    for (struct cmsghdr *c = CMSG_FIRSTHDR(msg); c != NULL; c = CMSG_NXTHDR(msg, c)) {
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_TIMESTAMPING) {
+            struct scm_timestamping ts;
+            memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            *hw = ts.ts[2].tv_sec != 0 || ts.ts[2].tv_nsec != 0;
+            const struct timespec *t = *hw ? &ts.ts[2] : &ts.ts[0];
+            *ns = (uint64_t)t->tv_sec * 1000000000u + (uint64_t)t->tv_nsec;
+            found = *ns != 0;
+        }
+        else if (key != NULL && c->cmsg_level == SOL_IP && c->cmsg_type == IP_RECVERR) {
+            struct sock_extended_err err;
+            memcpy(&err, CMSG_DATA(c), sizeof(err));
+            if (err.ee_errno == ENOMSG && err.ee_origin == SO_EE_ORIGIN_TIMESTAMPING)
+                *key = err.ee_data;
+        }
+    }
+    return found;
+}
+
+/**@brief error queue에 돌아온 송신 timestamp를 모두 꺼내 ring에 둠*/
+static void link_drain_tx_stamps(FAS_LINK *link){
+    char control[TS_CONTROL_SIZE];
+    struct msghdr msg;
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(link->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            break;
+        FAS_TX_STAMP stamp = { 0 };
+        if (link_cmsg_stamp(&msg, &stamp.ns, &stamp.hw, &stamp.key))
+            link->tx_stamp[link->tx_stamp_pos++ % FAS_TS_RING] = stamp;
+    }
+}
+
+/**@brief 수신, timestamp를 켰으면 recvmsg로 수신 kernel 시각도 받아 link->rx_ns에 둠*/
+static ssize_t link_recv(FAS_LINK *link, BYTE *buf, size_t len){
+    if (!link->timestamps)
+        return recv(link->fd, buf, len, MSG_DONTWAIT);
+
+    char control[TS_CONTROL_SIZE];
+    struct iovec iov = { .iov_base = buf, .iov_len = len };
+    struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1, .msg_control = control, .msg_controllen = sizeof(control) };
+    ssize_t n = recvmsg(link->fd, &msg, MSG_DONTWAIT);
+    link->rx_ns = 0;
+    if (n > 0)
+        link_cmsg_stamp(&msg, &link->rx_ns, &link->rx_hw, NULL);
+    return n;
+}
+
+ /**@brief 지금 handler가 받은 프레임과 tx_key 송신 사이의 kernel 시각 차 (FAS_FRAME_HANDLER 안에서만 부름)
+  * @param uint32_t tx_key 송신 직후의 link->tx_last
+  * @param uint32_t *wire_us 드라이브 + 회선 시간
+  * @return 쓴 시각의 출처, 두 시각 중 하나라도 없거나 출처가 다르면 FAS_TS_NONE (wire_us는 그대로)*/
+FAS_TS_SOURCE FAS_LinkWireUs(const FAS_LINK *link, uint32_t tx_key, uint32_t *wire_us){
+    if (!link->timestamps || link->rx_ns == 0)
+        return FAS_TS_NONE;
+    for (int i = 0; i < FAS_TS_RING; i++) {
+        const FAS_TX_STAMP *s = &link->tx_stamp[i];
+        if (s->ns == 0 || s->key != tx_key || s->hw != link->rx_hw || s->ns > link->rx_ns)
+            continue;
+        *wire_us = (uint32_t)((link->rx_ns - s->ns) / 1000u);
+        return s->hw ? FAS_TS_HARDWARE : FAS_TS_SOFTWARE;
+    }
+    return FAS_TS_NONE;
+}
+
+ /**@brief 완성된 프레임 송신 (기다리지 않음), timestamp를 켰으면 이 프레임의 OPT_ID 번호는 link->tx_last
+  * @return 보낸 byte 수, 실패시 -1*/
+int FAS_LinkSendFrame(FAS_LINK *link, const BYTE *frame, int len){
+    ssize_t sent = link->tcp ? send(link->fd, frame, len, MSG_NOSIGNAL | MSG_DONTWAIT)
+                             : sendto(link->fd, frame, len, MSG_DONTWAIT, (const struct sockaddr *)&link->addr, sizeof(link->addr));
+    if (sent != len)
+        return -1;
+    // kernel의 OPT_ID 번호: UDP는 datagram마다 1, TCP는 byte마다 1 (마지막 byte 번호)
+    if (link->tcp) {
+        link->tx_key += (uint32_t)len;
+        link->tx_last = link->tx_key - 1;
+    }
+    else {
+        link->tx_last = link->tx_key++;
+    }
+    return len;
+}
+
+ /**@brief 지금 도착해 있는 응답을 모두 읽어서 프레임 단위로 handler 호출 (기다리지 않음)
+  * @return 처리한 프레임 수, TCP 연결이 끊겼으면 -1*/
+int FAS_LinkReceive(FAS_LINK *link, FAS_FRAME_HANDLER handler, void *user){
+    int frames = 0;
+    // 송신 시각이 먼저 와 있어야 응답과 짝을 맞출 수 있으므로 error queue부터 비움
+    if (link->timestamps)
+        link_drain_tx_stamps(link);
+    if (!link->tcp) {
+        BYTE frame[BUFFER_SIZE];
+        ssize_t n;
+        while ((n = link_recv(link, frame, sizeof(frame))) > 0) {
+            int flen = link->codec->frame_length(frame, (int)n);
+            if (flen > 0) {
+                handler(frame, flen, user);
+                frames++;
+            }
+        }
+        return frames;
+    }
+
+    ssize_t n;
+    while ((n = link_recv(link, link->rx + link->rx_len, sizeof(link->rx) - link->rx_len)) > 0) {
+        link->rx_len += (int)n;
+
+        // TCP는 stream이라 codec의 길이 규칙(기본은 Length byte)으로 프레임 경계를 찾음
+        int pos = 0, flen;
+        while ((flen = link->codec->frame_length(link->rx + pos, link->rx_len - pos)) != 0) {
+            if (flen < 0) {
+                pos++;				// 프레임 시작이 아님, 1 byte 버리고 다시 찾음
+                continue;
+            }
+            handler(link->rx + pos, flen, user);
+            frames++;
+            pos += flen;
+        }
+        memmove(link->rx, link->rx + pos, link->rx_len - pos);
+        link->rx_len -= pos;
+    }
+    return n == 0 ? -1 : frames;
+}
+
+ /**@brief 요청 초기화
+  * @param int link links[] 안의 번호
+  * @param BYTE frame_type 명령
+  * @param const void *data 명령 data (NULL 가능)
+  * @param int data_len data 길이*/
+void FAS_RequestInit(FAS_REQUEST *req, int link, BYTE frame_type, const void *data, int data_len){
+    req->link = link;
+    req->frame_type = frame_type;
+    req->data_len = (BYTE)data_len;
+    if (data_len > 0)
+        memcpy(req->data, data, data_len);
+    req->status = FMM_UNKNOWN_ERROR;
+    req->resp_len = 0;
+    req->retries = 0;
+    req->rtt_us = 0;
+    req->wire_us = 0;
+    req->ts_source = FAS_TS_NONE;
+}
+
+static void request_finish(FAS_REQUEST *req, const FAS_BATCH_OPTION *opt, int *remaining, int *failed){
+    (*remaining)--;
+    if (req->status != FMM_OK)
+        (*failed)++;
+    if (opt->done != NULL)
+        opt->done(req, opt->user);
+}
+
+static bool request_send(FAS_LINK *link, LINK_STATE *st, FAS_REQUEST *req, int req_index){
+    BYTE frame[BUFFER_SIZE];
+
+    // window가 256보다 훨씬 작으므로 비어 있는 Sync No.는 금방 찾음
+    // Sync No.가 없는 codec은 Slave ID로 짝을 맞춤 (window 1이라 겹치지 않음)
+    BYTE sync = (BYTE)link->iBdID;
+    if (link->codec->sync) {
+        while (st->slot_req[link->sync_no] != SLOT_EMPTY)
+            link->sync_no++;
+        sync = link->sync_no++;
+    }
+
+    int len = FAS_CodecEncode(link->codec, frame, sync, req->frame_type, req->data, req->data_len);
+    FAS_TRACE(FAS_TRACE_BUILD, link->iBdID, sync, req->frame_type);
+    if (len < 0 || FAS_LinkSendFrame(link, frame, len) < 0)
+        return false;
+    FAS_TRACE(FAS_TRACE_SEND, link->iBdID, sync, len);
+    FAS_MetricsSent(link->iBdID, len);
+
+    st->slot_req[sync] = req_index;
+    st->slot_sent[sync] = FAS_MonotonicUs();
+    st->slot_key[sync] = link->tx_last;
+    st->active[st->active_count++] = sync;
+    return true;
+}
+
+static void active_remove(LINK_STATE *st, BYTE sync){
+    for (int i = 0; i < st->active_count; i++) {
+        if (st->active[i] == sync) {
+            st->active[i] = st->active[--st->active_count];
+            break;
+        }
+    }
+    st->slot_req[sync] = SLOT_EMPTY;
+}
+
+/**@brief FAS_LinkReceive handler에 넘기는 batch 상태*/
+typedef struct _BATCH_RX
+{
+	FAS_LINK *link;
+	LINK_STATE *st;
+	FAS_REQUEST *reqs;
+	const FAS_BATCH_OPTION *opt;
+	int *remaining, *failed;
+} BATCH_RX;
+
+static void frame_received(const BYTE *frame, int len, void *user){
+    BATCH_RX *rx = user;
+    FAS_LINK *link = rx->link;
+    LINK_STATE *st = rx->st;
+    FAS_REQUEST *reqs = rx->reqs;
+    FAS_FRAME_VIEW view;
+    if (!FAS_LinkDecode(link, frame, len, &view))
+        return;
+    BYTE sync = view.sync;
+    FAS_TRACE(FAS_TRACE_RECV, link->iBdID, sync, len);
+
+    int index = st->slot_req[sync];
+    if (index == SLOT_EMPTY || reqs[index].frame_type != view.frame_type)
+        return;	// 이미 재전송해서 버린 요청의 늦은 응답
+
+    FAS_REQUEST *req = &reqs[index];
+    uint64_t rtt = FAS_MonotonicUs() - st->slot_sent[sync];
+    active_remove(st, sync);
+    req->wire_us = (uint32_t)rtt;
+    req->ts_source = FAS_LinkWireUs(link, st->slot_key[sync], &req->wire_us);
+
+    req->status = (FMM_ERROR)view.status;
+    req->resp_len = (BYTE)(view.data_len > DATA_SIZE ? DATA_SIZE : view.data_len);
+    memcpy(req->resp, view.data, req->resp_len);
+    req->rtt_us = (uint32_t)rtt;
+    FAS_TRACE(FAS_TRACE_MATCH, link->iBdID, sync, rtt);
+    FAS_MetricsReceived(link->iBdID, len, req->status, rtt);
+    if (req->ts_source != FAS_TS_NONE)
+        FAS_MetricsWire(link->iBdID, req->wire_us, rtt);
+    request_finish(req, rx->opt, rx->remaining, rx->failed);
+}
+
+ /**@brief 요청 묶음 실행, 보드마다 window만큼 겹쳐서 보내고 모든 요청이 끝나면 반환
+  * @param FAS_LINK *links 연결 목록
+  * @param int link_count 연결 수
+  * @param FAS_REQUEST *reqs 요청 목록, 같은 보드 요청은 배열 순서대로 보냄
+  * @param int req_count 요청 수
+  * @param const FAS_BATCH_OPTION *option NULL이면 기본값
+  * @return 실패(FMM_OK가 아닌) 요청 수, 메모리 부족이면 -1*/
+int FAS_ExecuteBatch(FAS_LINK *links, int link_count, FAS_REQUEST *reqs, int req_count, const FAS_BATCH_OPTION *option){
+    FAS_BATCH_OPTION opt = { 0 };
+    int failed = 0;
+    if (option != NULL)
+        opt = *option;
+    if (opt.window <= 0)
+        opt.window = FAS_DEFAULT_WINDOW;
+    if (opt.window > FAS_WINDOW_MAX)
+        opt.window = FAS_WINDOW_MAX;
+    if (opt.timeout_ms <= 0)
+        opt.timeout_ms = FAS_DEFAULT_TIMEOUT_MS;
+    if (opt.retries < 0)
+        opt.retries = 0;
+
+    FAS_ARENA *scratch = opt.scratch;
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    LINK_STATE *state = FAS_ScratchAlloc(scratch, sizeof(LINK_STATE) * link_count, true);
+    int *order = FAS_ScratchAlloc(scratch, sizeof(int) * (req_count > 0 ? req_count : 1), false);
+    struct pollfd *pfds = FAS_ScratchAlloc(scratch, sizeof(struct pollfd) * link_count, true);
+    if (state == NULL || order == NULL || pfds == NULL) {
+        failed = -1;
+        goto out;
+    }
+
+    // 보드별로 요청 번호를 모음 (counting sort, 같은 보드 안에서는 순서 유지)
+    int remaining = 0;
+    for (int i = 0; i < req_count; i++) {
+        if (reqs[i].link >= 0 && reqs[i].link < link_count)
+            state[reqs[i].link].queue_len++;
+    }
+    int offset = 0;
+    for (int l = 0; l < link_count; l++) {
+        state[l].queue = order + offset;
+        offset += state[l].queue_len;
+        state[l].queue_len = 0;
+        for (int s = 0; s < 256; s++)
+            state[l].slot_req[s] = SLOT_EMPTY;
+        pfds[l].fd = links[l].fd;
+        pfds[l].events = POLLIN;
+    }
+    for (int i = 0; i < req_count; i++) {
+        reqs[i].status = FMM_UNKNOWN_ERROR;
+        reqs[i].retries = 0;
+        if (reqs[i].link < 0 || reqs[i].link >= link_count) {
+            reqs[i].status = FMM_INVALID_SLAVE_NUM;
+            failed++;
+            continue;
+        }
+        LINK_STATE *st = &state[reqs[i].link];
+        st->queue[st->queue_len++] = i;
+        remaining++;
+    }
+
+    uint64_t timeout_us = (uint64_t)opt.timeout_ms * 1000;
+    while (remaining > 0) {
+        // window 채우기
+        for (int l = 0; l < link_count; l++) {
+            LINK_STATE *st = &state[l];
+            int window = links[l].codec->sync ? opt.window : 1;
+            while (st->active_count < window && st->queue_pos < st->queue_len) {
+                int index = st->queue[st->queue_pos++];
+                if (!request_send(&links[l], st, &reqs[index], index)) {
+                    reqs[index].status = FMC_DISCONNECTED;
+                    request_finish(&reqs[index], &opt, &remaining, &failed);
+                }
+            }
+        }
+        if (remaining == 0)
+            break;
+
+        // 가장 먼저 시간 초과될 요청까지 대기
+        uint64_t now = FAS_MonotonicUs(), deadline = UINT64_MAX;
+        for (int l = 0; l < link_count; l++) {
+            for (int a = 0; a < state[l].active_count; a++) {
+                uint64_t d = state[l].slot_sent[state[l].active[a]] + timeout_us;
+                if (d < deadline)
+                    deadline = d;
+            }
+        }
+        int wait_ms = deadline == UINT64_MAX ? 0 : deadline <= now ? 0 : (int)((deadline - now + 999) / 1000);
+        int ready = poll(pfds, link_count, wait_ms);
+        if (ready < 0 && errno != EINTR)
+            break;
+
+        for (int l = 0; ready > 0 && l < link_count; l++) {
+            if (pfds[l].revents & (POLLIN | POLLERR | POLLHUP)) {
+                BATCH_RX rx = { &links[l], &state[l], reqs, &opt, &remaining, &failed };
+                if (FAS_LinkReceive(&links[l], frame_received, &rx) < 0)
+                    pfds[l].fd = -1;	// 끊긴 TCP는 더 보지 않고 남은 요청은 시간 초과로 정리
+            }
+        }
+
+        // 시간 초과: 재전송하거나 실패 처리
+        now = FAS_MonotonicUs();
+        for (int l = 0; l < link_count; l++) {
+            LINK_STATE *st = &state[l];
+            for (int a = 0; a < st->active_count; ) {
+                BYTE sync = st->active[a];
+                if (now - st->slot_sent[sync] < timeout_us) {
+                    a++;
+                    continue;
+                }
+                int index = st->slot_req[sync];
+                FAS_REQUEST *req = &reqs[index];
+                FAS_TRACE(FAS_TRACE_TIMEOUT, links[l].iBdID, sync, req->retries);
+                FAS_MetricsTimeout(links[l].iBdID);
+                active_remove(st, sync);	// active[a] 자리에 마지막 항목이 옮겨 옴
+                if (req->retries < opt.retries) {
+                    req->retries++;
+                    if (request_send(&links[l], st, req, index))
+                        continue;
+                }
+                req->status = FMC_TIMEOUT_ERROR;
+                request_finish(req, &opt, &remaining, &failed);
+            }
+        }
+    }
+
+out:
+    FAS_ScratchFree(scratch, state);
+    FAS_ScratchFree(scratch, order);
+    FAS_ScratchFree(scratch, pfds);
+    if (scratch != NULL)
+        FAS_ArenaRelease(scratch, mark);
+    return failed;
+}
@@ -0,0 +1,118 @@
+
+#pragma once
+
+#ifndef FAS_PIPELINE_DEFINE
+#define FAS_PIPELINE_DEFINE
+
+/**
+ * @file FAS_Pipeline.h
+ * @brief 여러 요청을 응답 기다리지 않고 연속으로 보내는 요청 엔진
+ * @details 보드마다 in-flight window만큼 요청을 보내 두고, 응답은 Sync No.로 요청과 짝을 맞춘다.
+ * 한 번에 여러 보드(각자 소켓)를 poll()로 같이 돌리므로 보드 수가 늘어도 전체 시간은 가장 느린 보드 수준이다.
+ * 시간 초과된 요청은 새 Sync No.로 다시 보내고, 늦게 온 옛 응답은 버린다.
+ * 프레임 조립/분해는 link의 codec이 하고, Sync No.가 없는 codec(serial)은 Slave ID로 짝을 맞추므로 보드당 한 개씩만 보낸다.
+ *
+ * 연결마다 SO_TIMESTAMPING을 켜서 송신/수신 프레임에 kernel 시각(NIC가 지원하면 hardware 시각)을 붙인다.
+ * 송신 시각은 error queue로 돌아오고 (OPT_ID 번호로 프레임과 짝을 맞춤), 수신 시각은 프레임과 같이 온다.
+ * 두 시각의 차가 드라이브 + 회선 시간이고, CLOCK_MONOTONIC으로 잰 RTT에서 이를 빼면 우리 쪽 stack/scheduling 시간이다.
+ * kernel 시각을 못 얻으면 FAS_TS_NONE이고 CLOCK_MONOTONIC RTT만 쓴다.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <netinet/in.h>
+#include "Protocol_Define.h"
+#include "ReturnCodes_Define.h"
+#include "FAS_Arena.h"
+#include "FAS_Codec.h"
+
+#define FAS_WINDOW_MAX 32
+#define FAS_DEFAULT_WINDOW 4
+#define FAS_DEFAULT_TIMEOUT_MS 200
+#define FAS_DEFAULT_RETRIES 2
+#define FAS_TS_RING 64				// 짝을 기다리는 송신 timestamp 수 (window보다 크게)
+
+/**@brief kernel timestamp 출처*/
+typedef enum
+{
+	FAS_TS_NONE = 0,			// kernel 시각 없음 (CLOCK_MONOTONIC만)
+	FAS_TS_SOFTWARE,			// kernel software 시각 (CLOCK_REALTIME, 드라이버 송신 직전/수신 직후)
+	FAS_TS_HARDWARE,			// NIC hardware 시각 (관리자가 NIC timestamping을 켰을 때)
+} FAS_TS_SOURCE;
+
+/**@brief error queue로 돌아온 송신 timestamp 하나*/
+typedef struct _FAS_TX_STAMP
+{
+	uint32_t key;				// OPT_ID 번호 (UDP는 송신 순번, TCP는 마지막 byte의 순번)
+	bool hw;
+	uint64_t ns;				// 0이면 빈 칸
+} FAS_TX_STAMP;
+
+/**@brief 드라이브 한 대와의 연결*/
+typedef struct _FAS_LINK
+{
+	int iBdID;
+	int fd;
+	bool tcp;
+	struct sockaddr_in addr;	// UDP 목적지
+	const FAS_CODEC *codec;		// 프레임 변형 (기본 FAS_CodecFastech), 조립/분해/경계 모두 이것으로
+	BYTE sync_no;				// 다음 요청에 쓸 Sync No.
+
+	int rx_len;					// TCP 수신 재조립 buffer
+	BYTE rx[BUFFER_SIZE * 2];
+
+	bool timestamps;			// SO_TIMESTAMPING을 켬
+	uint32_t tx_key;			// 다음 송신의 OPT_ID 번호
+	uint32_t tx_last;			// 마지막 FAS_LinkSendFrame의 OPT_ID 번호 (FAS_LinkWireUs에 넘김)
+	uint32_t tx_stamp_pos;
+	FAS_TX_STAMP tx_stamp[FAS_TS_RING];
+	uint64_t rx_ns;				// handler에 넘기는 프레임의 수신 kernel 시각 (없으면 0)
+	bool rx_hw;
+} FAS_LINK;
+
+/**@brief 요청 한 개와 그 결과*/
+typedef struct _FAS_REQUEST
+{
+	int link;					// FAS_ExecuteBatch에 넘긴 links[] 안의 번호
+	BYTE frame_type;
+	BYTE data_len;
+	BYTE data[DATA_SIZE];
+
+	FMM_ERROR status;			// 응답의 통신 상태, 응답이 없으면 FMC_TIMEOUT_ERROR
+	BYTE resp_len;				// 통신 상태 byte 뒤의 data 길이
+	BYTE resp[DATA_SIZE];
+	BYTE retries;				// 다시 보낸 횟수
+	uint32_t rtt_us;			// 마지막 송신부터 응답까지
+	uint32_t wire_us;			// 같은 구간의 kernel 시각 차 (드라이브 + 회선), timestamp가 없으면 rtt_us
+	BYTE ts_source;				// wire_us를 잰 방법 (FAS_TS_*)
+} FAS_REQUEST;
+
+typedef void (*FAS_REQUEST_DONE)(FAS_REQUEST *req, void *user);
+typedef void (*FAS_FRAME_HANDLER)(const BYTE *frame, int len, void *user);
+
+/**@brief FAS_ExecuteBatch 동작 설정, 0인 항목은 기본값 사용*/
+typedef struct _FAS_BATCH_OPTION
+{
+	int window;					// 보드당 동시에 보내 둘 요청 수
+	int timeout_ms;
+	int retries;
+	FAS_REQUEST_DONE done;		// 요청 하나가 끝날 때마다 호출 (NULL 가능)
+	void *user;
+	FAS_ARENA *scratch;			// 작업 배열을 떼어 올 session arena (NULL이면 heap)
+} FAS_BATCH_OPTION;
+
+bool FAS_LinkOpen(FAS_LINK *link, int iBdID, const char *ip, bool tcp);
+bool FAS_LinkOpenPort(FAS_LINK *link, int iBdID, const char *ip, bool tcp, uint16_t port);
+void FAS_LinkAttach(FAS_LINK *link, int iBdID, int fd, bool tcp, const struct sockaddr_in *addr);
+void FAS_LinkClose(FAS_LINK *link);
+void FAS_LinkSetCodec(FAS_LINK *link, const FAS_CODEC *codec);
+bool FAS_LinkDecode(const FAS_LINK *link, const BYTE *frame, int len, FAS_FRAME_VIEW *view);
+bool FAS_LinkEnableTimestamps(FAS_LINK *link);
+FAS_TS_SOURCE FAS_LinkWireUs(const FAS_LINK *link, uint32_t tx_key, uint32_t *wire_us);
+int FAS_LinkSendFrame(FAS_LINK *link, const BYTE *frame, int len);
+int FAS_LinkReceive(FAS_LINK *link, FAS_FRAME_HANDLER handler, void *user);
+
+void FAS_RequestInit(FAS_REQUEST *req, int link, BYTE frame_type, const void *data, int data_len);
+int FAS_ExecuteBatch(FAS_LINK *links, int link_count, FAS_REQUEST *reqs, int req_count, const FAS_BATCH_OPTION *option);
+
+#endif	//FAS_PIPELINE_DEFINE
@@ -0,0 +1,259 @@
+/**
+ * @file FAS_Poll.c
+ * @brief 적응형 상태 polling (AxisStatus로 단계 정하기, budget 나누기, 다음 조회 예약)
+ */
+
+#include <string.h>
+#include "FAS_Poll.h"
+
+static int poll_state_hz(const FAS_POLLER *p, int state){
+    switch (state) {
+        case FAS_POLL_FAST: return p->option.fast_hz;
+        case FAS_POLL_NORMAL: return p->option.normal_hz;
+        default: return p->option.slow_hz;
+    }
+}
+
+// 보드 하나의 목표 rate 합 반영 (fast와 나머지를 따로 셈)
+static void poll_demand(FAS_POLLER *p, int state, int sign){
+    int64_t hz = (int64_t)poll_state_hz(p, state) * sign;
+    if (state == FAS_POLL_FAST)
+        atomic_fetch_add_explicit(&p->demand_fast, hz, memory_order_relaxed);
+    else
+        atomic_fetch_add_explicit(&p->demand_other, hz, memory_order_relaxed);
+}
+
+static FAS_POLL_STATE poll_classify(const FAS_POLL_BOARD *b, uint64_t now){
+    uint32_t st = b->status.axis_status;
+    if ((st & (FAS_AXIS_MOTIONING | FAS_AXIS_ORIGINRETURNING | FAS_AXIS_ERROR_MASK)) || b->alarm_pending
+        || now < b->fast_until_us)
+        return FAS_POLL_FAST;
+    if (!(st & FAS_AXIS_SERVOON) || (st & FAS_AXIS_INPOSITION))
+        return FAS_POLL_SLOW;
+    return FAS_POLL_NORMAL;
+}
+
+ /**@brief budget을 나눈 뒤 이 보드의 목표 rate [mHz]
+  * @details fast 보드는 budget 안에서 먼저 목표대로, 넘치면 fast끼리 비율대로 줄인다.
+  * 나머지 보드는 fast가 쓰고 남은 budget을 목표 rate 비율대로 나눈다.*/
+static uint32_t poll_target_mhz(const FAS_POLLER *p, int state){
+    uint64_t want = (uint64_t)poll_state_hz(p, state) * 1000u;
+    int64_t budget = p->option.budget_fps;
+    if (budget > 0) {
+        int64_t fast = atomic_load_explicit(&p->demand_fast, memory_order_relaxed);
+        int64_t other = atomic_load_explicit(&p->demand_other, memory_order_relaxed);
+        if (state == FAS_POLL_FAST) {
+            if (fast > budget)
+                want = want * (uint64_t)budget / (uint64_t)fast;
+        }
+        else {
+            int64_t left = budget > fast ? budget - fast : 0;
+            if (other > left)
+                want = want * (uint64_t)left / (uint64_t)other;
+        }
+    }
+    if (want < FAS_POLL_MIN_HZ * 1000u)
+        want = FAS_POLL_MIN_HZ * 1000u;
+    return (uint32_t)want;
+}
+
+static bool poll_submit(FAS_POLLER *p, FAS_POLL_BOARD *b, BYTE frame_type, uint64_t not_before_us){
+    FAS_RequestInit(&b->r.req, b->iBdID, frame_type, NULL, 0);
+    b->r.priority = FAS_PRIO_POLL;
+    b->r.not_before_us = not_before_us;
+    if (!FAS_ShardsSubmit(p->set, &b->r)) {
+        atomic_fetch_add_explicit(&b->failed, 1, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// 받은 상태 반영, AxisStatus가 바뀌었으면 TRUE
+static bool poll_update(FAS_POLLER *p, FAS_POLL_BOARD *b, const FAS_ALL_STATUS *st, uint64_t now){
+    uint32_t old = b->status.axis_status;
+    bool changed = !b->seen || st->axis_status != old;
+    b->status = *st;
+    b->seen = true;
+    if (!changed)
+        return false;
+
+    b->fast_until_us = now + (uint64_t)p->option.hold_ms * 1000u;
+    if ((st->axis_status & FAS_AXIS_ERRORALL) && !(old & FAS_AXIS_ERRORALL))
+        b->alarm_pending = true;
+    if (!(st->axis_status & FAS_AXIS_ERRORALL))
+        atomic_store_explicit(&b->alarm, 0, memory_order_relaxed);
+    atomic_store_explicit(&b->axis_status, st->axis_status, memory_order_relaxed);
+    atomic_fetch_add_explicit(&b->changes, 1, memory_order_relaxed);
+    if (p->option.on_change != NULL)
+        p->option.on_change(b->iBdID, st, old, p->option.user);
+    return true;
+}
+
+// shard thread에서 조회 하나가 끝날 때마다 불림, 결과 반영 후 다음 조회 예약
+static void poll_done(FAS_SHARD_REQUEST *r, void *user){
+    FAS_POLL_BOARD *b = user;
+    FAS_POLLER *p = b->poller;
+    uint64_t now = FAS_MonotonicUs();
+    bool changed = false;
+
+    if (r->req.status != FMM_OK) {
+        atomic_fetch_add_explicit(&b->failed, 1, memory_order_relaxed);
+        // 알람 종류를 못 읽으면 (0x2E를 거절하거나 응답 없음) 조르지 않고 상태 조회로 돌아감 (alarm은 0 = 모름)
+        if (r->req.frame_type == FRAME_GETALARMTYPE)
+            b->alarm_pending = false;
+    }
+    else if (r->req.frame_type == FRAME_GETALARMTYPE) {
+        if (r->req.resp_len >= 1)
+            atomic_store_explicit(&b->alarm, r->req.resp[0], memory_order_relaxed);
+        b->alarm_pending = false;
+    }
+    else {
+        FAS_ALL_STATUS st;
+        if (FAS_DecodeAllStatus(r->req.resp, r->req.resp_len, &st))
+            changed = poll_update(p, b, &st, now);
+        atomic_fetch_add_explicit(&b->polls, 1, memory_order_relaxed);
+        // 실제 rate는 FAS_POLL_RATE_MS 구간마다 응답 수로 다시 셈 (느린 보드도 구간 하나 안에 맞춰짐)
+        if (b->rate_start_us == 0) {
+            b->rate_start_us = now;
+        }
+        else if (++b->rate_polls, now - b->rate_start_us >= FAS_POLL_RATE_MS * 1000u) {
+            uint32_t rate = (uint32_t)((uint64_t)b->rate_polls * 1000000000ull / (now - b->rate_start_us));
+            atomic_store_explicit(&b->achieved_mhz, rate, memory_order_relaxed);
+            b->rate_start_us = now;
+            b->rate_polls = 0;
+        }
+    }
+
+    if (!atomic_load_explicit(&p->running, memory_order_relaxed)) {
+        poll_demand(p, b->state, -1);
+        atomic_fetch_sub_explicit(&p->outstanding, 1, memory_order_release);
+        return;
+    }
+
+    FAS_POLL_STATE state = poll_classify(b, now);
+    if (state != b->state) {
+        poll_demand(p, b->state, -1);
+        poll_demand(p, state, +1);
+        b->state = (BYTE)state;
+        atomic_store_explicit(&b->state_pub, state, memory_order_relaxed);
+    }
+    uint32_t target = poll_target_mhz(p, state);
+    atomic_store_explicit(&b->target_mhz, target, memory_order_relaxed);
+
+    bool ok;
+    if (b->alarm_pending) {
+        ok = poll_submit(p, b, FRAME_GETALARMTYPE, 0);
+    }
+    else {
+        // 주기는 예약 시각 기준 (응답 시간만큼 밀리지 않게), 밀렸으면 지금부터
+        uint64_t period = 1000000000ull / target;
+        b->next_us += period;
+        if (changed && b->next_us > now + period)
+            b->next_us = now + period;
+        if (b->next_us < now)
+            b->next_us = now;
+        ok = poll_submit(p, b, FRAME_GETALLSTATUS, b->next_us);
+    }
+    if (!ok) {
+        poll_demand(p, b->state, -1);
+        atomic_fetch_sub_explicit(&p->outstanding, 1, memory_order_release);
+    }
+}
+
+ /**@brief poller 준비
+  * @param FAS_SHARDS *set 조회를 보낼 shard 묶음 (보드는 FAS_ShardsAddBoard로 미리 넣음)*/
+void FAS_PollerInit(FAS_POLLER *poller, FAS_SHARDS *set, const FAS_POLL_OPTION *option){
+    memset(poller, 0, sizeof(*poller));
+    poller->set = set;
+    if (option != NULL)
+        poller->option = *option;
+    if (poller->option.fast_hz <= 0)
+        poller->option.fast_hz = FAS_POLL_FAST_HZ;
+    if (poller->option.normal_hz <= 0)
+        poller->option.normal_hz = FAS_POLL_NORMAL_HZ;
+    if (poller->option.slow_hz <= 0)
+        poller->option.slow_hz = FAS_POLL_SLOW_HZ;
+    if (poller->option.hold_ms <= 0)
+        poller->option.hold_ms = FAS_POLL_HOLD_MS;
+    if (poller->option.budget_fps < 0)
+        poller->option.budget_fps = 0;
+}
+
+ /**@brief 조회할 보드 추가 (FAS_PollerStart 전에)
+  * @return poller 안의 번호 (FAS_PollerGetInfo), 가득 찼으면 -1*/
+int FAS_PollerAdd(FAS_POLLER *poller, int iBdID){
+    if (poller->count == FAS_MAX_BOARD || iBdID < 0 || iBdID >= FAS_MAX_BOARD
+        || atomic_load(&poller->running))
+        return -1;
+    FAS_POLL_BOARD *b = &poller->board[poller->count];
+    memset(b, 0, sizeof(*b));
+    b->poller = poller;
+    b->iBdID = iBdID;
+    b->r.done = poll_done;
+    b->r.user = b;
+    return poller->count++;
+}
+
+ /**@brief 모든 보드 조회 시작 (처음 응답까지는 fast로 셈)
+  * @return boolean 성공시 TRUE, shard queue가 차서 하나라도 못 넣으면 FALSE (넣은 보드는 돌아감)*/
+bool FAS_PollerStart(FAS_POLLER *poller){
+    if (atomic_exchange(&poller->running, true))
+        return false;
+    uint64_t now = FAS_MonotonicUs();
+    bool ok = true;
+    for (int i = 0; i < poller->count; i++) {
+        FAS_POLL_BOARD *b = &poller->board[i];
+        b->state = FAS_POLL_FAST;
+        b->next_us = now;
+        atomic_store(&b->state_pub, FAS_POLL_FAST);
+        poll_demand(poller, FAS_POLL_FAST, +1);
+        atomic_fetch_add(&poller->outstanding, 1);
+        if (!poll_submit(poller, b, FRAME_GETALLSTATUS, 0)) {
+            poll_demand(poller, FAS_POLL_FAST, -1);
+            atomic_fetch_sub(&poller->outstanding, 1);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+ /**@brief 조회를 더 넣지 않음
+  * @details 예약해 둔 조회는 응답이 오거나 FAS_ShardsStop에서 끝난다. poller는 outstanding이 0이 된 뒤
+  * (또는 FAS_ShardsStop 뒤) 버린다.*/
+void FAS_PollerStop(FAS_POLLER *poller){
+    atomic_store(&poller->running, false);
+}
+
+ /**@brief 보드 하나의 조회 상황 (아무 thread에서나)
+  * @return boolean 성공시 TRUE, index가 잘못되면 FALSE*/
+bool FAS_PollerGetInfo(FAS_POLLER *poller, int index, FAS_POLL_INFO *info){
+    if (index < 0 || index >= poller->count)
+        return false;
+    FAS_POLL_BOARD *b = &poller->board[index];
+    info->iBdID = b->iBdID;
+    info->state = (FAS_POLL_STATE)atomic_load_explicit(&b->state_pub, memory_order_relaxed);
+    info->axis_status = atomic_load_explicit(&b->axis_status, memory_order_relaxed);
+    info->alarm = (BYTE)atomic_load_explicit(&b->alarm, memory_order_relaxed);
+    info->target_hz = atomic_load_explicit(&b->target_mhz, memory_order_relaxed) / 1000.0;
+    info->achieved_hz = atomic_load_explicit(&b->achieved_mhz, memory_order_relaxed) / 1000.0;
+    info->polls = atomic_load_explicit(&b->polls, memory_order_relaxed);
+    info->changes = atomic_load_explicit(&b->changes, memory_order_relaxed);
+    info->failed = atomic_load_explicit(&b->failed, memory_order_relaxed);
+    return true;
+}
+
+ /**@brief 모든 보드의 실제 조회 rate 합 [Hz]*/
+double FAS_PollerTotalHz(FAS_POLLER *poller){
+    double total = 0;
+    for (int i = 0; i < poller->count; i++)
+        total += atomic_load_explicit(&poller->board[i].achieved_mhz, memory_order_relaxed) / 1000.0;
+    return total;
+}
+
+const char *FAS_PollStateName(FAS_POLL_STATE state){
+    switch (state) {
+        case FAS_POLL_FAST: return "fast";
+        case FAS_POLL_NORMAL: return "normal";
+        default: return "slow";
+    }
+}
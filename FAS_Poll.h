@@ -0,0 +1,121 @@
+
+#pragma once
+
+#ifndef FAS_POLL_DEFINE
+#define FAS_POLL_DEFINE
+
+/**
+ * @file FAS_Poll.h
+ * @brief 축 상태에 따라 보드마다 조회 주기를 바꾸는 상태 polling
+ * @details 보드마다 GetAllStatus(0x43) 하나를 shard transport로 계속 돌리고, 응답의 AxisStatus로 다음 주기를 정한다.
+ * - fast  : 운전 중, 원점 복귀 중, 알람 있음, 또는 상태가 바뀐 뒤 hold_ms 동안
+ * - normal: 서보 ON이고 멈춰 있지만 inposition이 아님
+ * - slow  : 서보 OFF 또는 inposition
+ * 응답에서 AxisStatus가 바뀌면 그 자리에서 fast로 올리고 다음 조회를 fast 주기 안에 보낸다.
+ * 알람 flag가 새로 서면 다음 조회 전에 GetAlarmType(0x2E)을 한 번 보내서 알람 종류를 남긴다.
+ *
+ * budget_fps를 주면 모든 보드의 조회 합이 그 안에 들도록 주기를 늘린다. fast 보드가 먼저 budget을 쓰고,
+ * 나머지 보드는 남은 budget을 목표 rate 비율대로 나눈다 (어느 보드도 FAS_POLL_MIN_HZ 아래로는 안 내려감).
+ * 다음 조회는 shard의 지연 송신(not_before_us)으로 예약하므로 timer thread가 없고, 조회는 조회 class(FAS_PRIO_POLL)라
+ * 같은 보드의 운전 명령을 밀어내지 않는다. 보드별 목표/실제 rate는 FAS_PollerGetInfo로 아무 thread에서나 읽는다.
+ * 상태 callback(option.on_change)은 AxisStatus가 바뀔 때 그 보드를 맡은 shard thread에서 불린다.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "FAS_Shard.h"
+#include "FAS_Status.h"
+
+#define FAS_POLL_FAST_HZ 500
+#define FAS_POLL_NORMAL_HZ 50
+#define FAS_POLL_SLOW_HZ 5
+#define FAS_POLL_HOLD_MS 500		// 상태가 바뀐 뒤 fast로 두는 시간
+#define FAS_POLL_MIN_HZ 1			// budget이 모자라도 이 아래로는 내리지 않음
+#define FAS_POLL_RATE_MS 500			// 실제 rate를 세는 구간
+
+/**@brief 보드 조회 단계*/
+typedef enum _FAS_POLL_STATE
+{
+	FAS_POLL_SLOW = 0,
+	FAS_POLL_NORMAL,
+	FAS_POLL_FAST,
+} FAS_POLL_STATE;
+
+typedef void (*FAS_POLL_CHANGE_FN)(int iBdID, const FAS_ALL_STATUS *status, uint32_t old_axis_status, void *user);
+
+/**@brief FAS_PollerInit 설정, 0인 항목은 기본값 사용*/
+typedef struct _FAS_POLL_OPTION
+{
+	int fast_hz;				// FAS_POLL_FAST_HZ
+	int normal_hz;				// FAS_POLL_NORMAL_HZ
+	int slow_hz;				// FAS_POLL_SLOW_HZ
+	int hold_ms;				// FAS_POLL_HOLD_MS
+	int budget_fps;				// 모든 보드 합 초당 조회 프레임 (0이면 제한 없음)
+	FAS_POLL_CHANGE_FN on_change;	// NULL 가능
+	void *user;
+} FAS_POLL_OPTION;
+
+/**@brief 조회하는 보드 하나*/
+typedef struct _FAS_POLL_BOARD
+{
+	FAS_SHARD_REQUEST r;
+	struct _FAS_POLLER *poller;
+	int iBdID;
+
+	// shard thread 전용
+	FAS_ALL_STATUS status;			// 마지막 응답
+	bool seen;						// 응답을 한 번이라도 받음
+	bool alarm_pending;				// 알람 flag가 섰는데 종류를 아직 안 읽음
+	BYTE state;						// FAS_POLL_STATE
+	uint64_t next_us;				// 다음 조회 시각
+	uint64_t fast_until_us;			// 이 시각까지 fast
+	uint64_t rate_start_us;			// 실제 rate를 세는 구간 시작
+	uint32_t rate_polls;			// 구간 안에서 받은 응답 수
+
+	// 공개 (shard thread가 쓰고 아무 thread에서나 읽음)
+	_Atomic uint32_t axis_status;
+	_Atomic uint32_t alarm;			// 마지막 GetAlarmType 결과 (알람 flag가 내려가면 0)
+	_Atomic uint32_t state_pub;
+	_Atomic uint32_t target_mhz;	// budget을 적용한 목표 rate [mHz]
+	_Atomic uint32_t achieved_mhz;	// 실제 조회 rate, 지난 FAS_POLL_RATE_MS 구간의 응답 수 [mHz]
+	_Atomic uint64_t polls;
+	_Atomic uint64_t changes;		// AxisStatus가 바뀐 횟수
+	_Atomic uint64_t failed;
+} FAS_POLL_BOARD;
+
+typedef struct _FAS_POLLER
+{
+	FAS_SHARDS *set;
+	FAS_POLL_OPTION option;
+	_Atomic bool running;
+	_Atomic int outstanding;		// shard에 넣어 둔 조회 수 (보드당 하나)
+	_Atomic int64_t demand_fast;	// fast 보드 목표 rate 합 [Hz]
+	_Atomic int64_t demand_other;	// 나머지 보드 목표 rate 합 [Hz]
+	int count;
+	FAS_POLL_BOARD board[FAS_MAX_BOARD];
+} FAS_POLLER;
+
+/**@brief 보드 하나의 조회 상황 (FAS_PollerGetInfo)*/
+typedef struct _FAS_POLL_INFO
+{
+	int iBdID;
+	FAS_POLL_STATE state;
+	uint32_t axis_status;
+	BYTE alarm;
+	double target_hz;
+	double achieved_hz;
+	uint64_t polls;
+	uint64_t changes;
+	uint64_t failed;
+} FAS_POLL_INFO;
+
+void FAS_PollerInit(FAS_POLLER *poller, FAS_SHARDS *set, const FAS_POLL_OPTION *option);
+int FAS_PollerAdd(FAS_POLLER *poller, int iBdID);
+bool FAS_PollerStart(FAS_POLLER *poller);
+void FAS_PollerStop(FAS_POLLER *poller);
+bool FAS_PollerGetInfo(FAS_POLLER *poller, int index, FAS_POLL_INFO *info);
+double FAS_PollerTotalHz(FAS_POLLER *poller);
+const char *FAS_PollStateName(FAS_POLL_STATE state);
+
+#endif	//FAS_POLL_DEFINE
@@ -0,0 +1,323 @@
+/**
+ * @file FAS_PosTable.c
+ * @brief position table cache, pipeline 쓰기 + 확인 읽기, ROM 저장
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FAS_PosTable.h"
+#include "FAS_Metrics.h"
+
+/**@brief FAS_ExecuteBatch done callback에 넘기는 상태*/
+typedef struct _PT_RUN
+{
+	FAS_PT_CACHE *caches;
+	uint64_t *write_failed;		// 보드마다 FAS_PT_WORDS개, 쓰기가 실패한 항목 (확인 읽기가 와도 실패로 셈)
+	FAS_PT_PROGRESS progress;
+	FAS_PT_PROGRESS_FN fn;
+	void *user;
+	uint64_t t0;
+} PT_RUN;
+
+static void put_le16(BYTE *p, uint16_t v){ p[0] = v & 0xFF; p[1] = v >> 8; }
+static uint16_t get_le16(const BYTE *p){ return (uint16_t)(p[0] | (p[1] << 8)); }
+
+static inline bool bit_test(const uint64_t *bits, int n){ return (bits[n >> 6] >> (n & 63)) & 1; }
+static inline void bit_set(uint64_t *bits, int n){ bits[n >> 6] |= 1ull << (n & 63); }
+static inline void bit_clear(uint64_t *bits, int n){ bits[n >> 6] &= ~(1ull << (n & 63)); }
+
+ /**@brief 항목을 ITEM_NODE byte로 바꿈
+  * @param BYTE *node FAS_PT_ITEM_SIZE byte*/
+void FAS_PtItemEncode(const FAS_PT_ITEM *item, BYTE *node){
+    fas_put_le32(node, (uint32_t)item->position);
+    fas_put_le32(node + 4, item->start_speed);
+    fas_put_le32(node + 8, item->move_speed);
+    put_le16(node + 12, item->accel);
+    put_le16(node + 14, item->decel);
+    put_le16(node + 16, item->command);
+    put_le16(node + 18, item->wait_time);
+    put_le16(node + 20, item->continuous);
+    put_le16(node + 22, item->branch);
+    for (int i = 0; i < 3; i++)
+        put_le16(node + 24 + 2 * i, item->cond_branch[i]);
+    put_le16(node + 30, item->loop_count);
+    put_le16(node + 32, item->branch_after_loop);
+    put_le16(node + 34, item->pt_set);
+    put_le16(node + 36, item->loop_count_clear);
+    put_le16(node + 38, item->check_inpos);
+}
+
+ /**@brief ITEM_NODE byte를 항목으로 바꿈*/
+void FAS_PtItemDecode(const BYTE *node, FAS_PT_ITEM *item){
+    item->position = (int32_t)fas_get_le32(node);
+    item->start_speed = fas_get_le32(node + 4);
+    item->move_speed = fas_get_le32(node + 8);
+    item->accel = get_le16(node + 12);
+    item->decel = get_le16(node + 14);
+    item->command = get_le16(node + 16);
+    item->wait_time = get_le16(node + 18);
+    item->continuous = get_le16(node + 20);
+    item->branch = get_le16(node + 22);
+    for (int i = 0; i < 3; i++)
+        item->cond_branch[i] = get_le16(node + 24 + 2 * i);
+    item->loop_count = get_le16(node + 30);
+    item->branch_after_loop = get_le16(node + 32);
+    item->pt_set = get_le16(node + 34);
+    item->loop_count_clear = get_le16(node + 36);
+    item->check_inpos = get_le16(node + 38);
+}
+
+ /**@brief cache 초기화
+  * @param int iBdID 드라이브 ID
+  * @param int count 사용하는 항목 수 (0이면 FAS_PT_ITEM_COUNT)*/
+void FAS_PtCacheInit(FAS_PT_CACHE *cache, int iBdID, int count){
+    memset(cache, 0, sizeof(*cache));
+    cache->iBdID = iBdID;
+    cache->count = (count <= 0 || count > FAS_PT_ITEM_COUNT) ? FAS_PT_ITEM_COUNT : count;
+}
+
+ /**@brief cache에 항목 설정 (드라이브와 같다고 확인된 값이면 dirty가 되지 않음)
+  * @return 번호가 범위 밖이면 FALSE*/
+bool FAS_PtSet(FAS_PT_CACHE *cache, int item_no, const FAS_PT_ITEM *item){
+    if (item_no < 0 || item_no >= cache->count)
+        return false;
+    FAS_PtItemEncode(item, cache->value[item_no]);
+    if (bit_test(cache->valid, item_no) && memcmp(cache->drive[item_no], cache->value[item_no], FAS_PT_ITEM_SIZE) == 0)
+        bit_clear(cache->dirty, item_no);
+    else
+        bit_set(cache->dirty, item_no);
+    return true;
+}
+
+ /**@brief cache의 항목 조회
+  * @return 읽었거나 설정한 적 없는 번호면 FALSE*/
+bool FAS_PtGet(const FAS_PT_CACHE *cache, int item_no, FAS_PT_ITEM *item){
+    if (item_no < 0 || item_no >= cache->count)
+        return false;
+    if (!bit_test(cache->valid, item_no) && !bit_test(cache->dirty, item_no))
+        return false;
+    FAS_PtItemDecode(cache->value[item_no], item);
+    return true;
+}
+
+ /**@brief 다음 FAS_PtUpload가 보낼 항목 수*/
+int FAS_PtDirtyCount(const FAS_PT_CACHE *cache){
+    int n = 0;
+    for (int w = 0; w < FAS_PT_WORDS; w++)
+        n += __builtin_popcountll(cache->dirty[w]);
+    return n;
+}
+
+static void run_item_done(PT_RUN *run){
+    FAS_PT_PROGRESS *p = &run->progress;
+    p->done++;
+    p->elapsed_us = FAS_MonotonicUs() - run->t0;
+    if (run->fn != NULL)
+        run->fn(p, run->user);
+}
+
+static void run_bytes(PT_RUN *run, const FAS_REQUEST *req){
+    run->progress.bytes += FRAME_HEADER_SIZE + req->data_len;
+    if (req->status != FMC_TIMEOUT_ERROR && req->status != FMC_DISCONNECTED)
+        run->progress.bytes += FRAME_HEADER_SIZE + 1 + req->resp_len;
+}
+
+static void read_done(FAS_REQUEST *req, void *user){
+    PT_RUN *run = user;
+    FAS_PT_CACHE *cache = &run->caches[req->link];
+    int item_no = get_le16(req->data);
+    run_bytes(run, req);
+    if (req->status != FMM_OK || req->resp_len < FAS_PT_ITEM_SIZE) {
+        run->progress.failed++;
+        run_item_done(run);
+        return;
+    }
+
+    memcpy(cache->drive[item_no], req->resp, FAS_PT_ITEM_SIZE);
+    bit_set(cache->valid, item_no);
+    if (!bit_test(cache->dirty, item_no))
+        memcpy(cache->value[item_no], cache->drive[item_no], FAS_PT_ITEM_SIZE);
+    else if (memcmp(cache->value[item_no], cache->drive[item_no], FAS_PT_ITEM_SIZE) == 0)
+        bit_clear(cache->dirty, item_no);
+    run->progress.verified++;
+    run_item_done(run);
+}
+
+static void write_done(FAS_REQUEST *req, void *user){
+    PT_RUN *run = user;
+    run_bytes(run, req);
+    if (req->status != FMM_OK)
+        bit_set(&run->write_failed[req->link * FAS_PT_WORDS], get_le16(req->data));
+    else
+        run->caches[req->link].rom_dirty = true;
+}
+
+static void verify_done(FAS_REQUEST *req, void *user){
+    PT_RUN *run = user;
+    FAS_PT_CACHE *cache = &run->caches[req->link];
+    int item_no = get_le16(req->data);
+    run_bytes(run, req);
+    if (bit_test(&run->write_failed[req->link * FAS_PT_WORDS], item_no) || req->status != FMM_OK
+        || req->resp_len < FAS_PT_ITEM_SIZE) {
+        run->progress.failed++;
+        run_item_done(run);
+        return;
+    }
+
+    // 다시 읽은 값이 드라이브에 있는 값, 원하는 값과 다르면 dirty로 남김
+    memcpy(cache->drive[item_no], req->resp, FAS_PT_ITEM_SIZE);
+    bit_set(cache->valid, item_no);
+    if (memcmp(cache->value[item_no], cache->drive[item_no], FAS_PT_ITEM_SIZE) == 0) {
+        bit_clear(cache->dirty, item_no);
+        run->progress.verified++;
+    }
+    else {
+        run->progress.mismatched++;
+    }
+    run_item_done(run);
+}
+
+static void upload_done(FAS_REQUEST *req, void *user){
+    if (req->frame_type == FRAME_POSTABLEWRITEITEM)
+        write_done(req, user);
+    else
+        verify_done(req, user);
+}
+
+static FAS_ARENA *option_scratch(const FAS_BATCH_OPTION *option){
+    return option != NULL ? option->scratch : NULL;
+}
+
+static int run_batch(FAS_LINK *links, int count, FAS_REQUEST *reqs, int req_count, const FAS_BATCH_OPTION *option,
+                     FAS_REQUEST_DONE done, PT_RUN *run, FAS_PT_PROGRESS *result){
+    FAS_BATCH_OPTION opt = { 0 };
+    if (option != NULL)
+        opt = *option;
+    opt.done = done;
+    opt.user = run;
+    int failed = FAS_ExecuteBatch(links, count, reqs, req_count, &opt);
+    run->progress.elapsed_us = FAS_MonotonicUs() - run->t0;
+    if (result != NULL)
+        *result = run->progress;
+    return failed;
+}
+
+ /**@brief 모든 보드의 사용하는 항목을 읽어 cache 갱신 (links[i]와 caches[i]가 같은 보드)
+  * @param FAS_PT_PROGRESS_FN progress 항목 하나가 끝날 때마다 호출 (NULL 가능)
+  * @param FAS_PT_PROGRESS *result 마지막 진행 상황 (NULL 가능)
+  * @return 실패한 요청 수, 메모리 부족이면 -1*/
+int FAS_PtReadAll(FAS_LINK *links, FAS_PT_CACHE *caches, int count, const FAS_BATCH_OPTION *option,
+                  FAS_PT_PROGRESS_FN progress, void *user, FAS_PT_PROGRESS *result){
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += caches[i].count;
+    FAS_ARENA *scratch = option_scratch(option);
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    FAS_REQUEST *reqs = FAS_ScratchAlloc(scratch, sizeof(FAS_REQUEST) * (total > 0 ? total : 1), false);
+    if (reqs == NULL)
+        return -1;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < caches[i].count; k++) {
+            BYTE data[2];
+            put_le16(data, (uint16_t)k);
+            FAS_RequestInit(&reqs[n++], i, FRAME_POSTABLEREADITEM, data, sizeof(data));
+        }
+    }
+    PT_RUN run = { .caches = caches, .fn = progress, .user = user, .t0 = FAS_MonotonicUs() };
+    run.progress.total = n;
+    int failed = run_batch(links, count, reqs, n, option, read_done, &run, result);
+    FAS_ScratchFree(scratch, reqs);
+    if (scratch != NULL)
+        FAS_ArenaRelease(scratch, mark);
+    return failed;
+}
+
+ /**@brief cache에서 바뀐 항목만 드라이브 RAM에 쓰고 다시 읽어 확인
+  * @details 항목마다 [쓰기][확인 읽기] 두 요청을 보드별 순서대로 넣고 FAS_ExecuteBatch 한 번으로 보낸다.
+  * 확인된 항목만 dirty가 지워지고, 쓰기나 읽기가 실패했거나 값이 다르면 dirty로 남는다.
+  * @param FAS_PT_PROGRESS_FN progress 항목 하나가 확인(또는 실패)될 때마다 호출 (NULL 가능)
+  * @param FAS_PT_PROGRESS *result 마지막 진행 상황 (NULL 가능)
+  * @return 확인되지 않은 항목 수 (통신 실패 + 값 다름), 메모리 부족이면 -1*/
+int FAS_PtUpload(FAS_LINK *links, FAS_PT_CACHE *caches, int count, const FAS_BATCH_OPTION *option,
+                 FAS_PT_PROGRESS_FN progress, void *user, FAS_PT_PROGRESS *result){
+    PT_RUN run = { .caches = caches, .fn = progress, .user = user, .t0 = FAS_MonotonicUs() };
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += FAS_PtDirtyCount(&caches[i]);
+    if (total == 0) {
+        if (result != NULL)
+            *result = run.progress;
+        return 0;
+    }
+    FAS_ARENA *scratch = option_scratch(option);
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    FAS_REQUEST *reqs = FAS_ScratchAlloc(scratch, sizeof(FAS_REQUEST) * total * 2, false);
+    run.write_failed = FAS_ScratchAlloc(scratch, sizeof(uint64_t) * FAS_PT_WORDS * count, true);
+    if (reqs == NULL || run.write_failed == NULL) {
+        FAS_ScratchFree(scratch, reqs);
+        FAS_ScratchFree(scratch, run.write_failed);
+        if (scratch != NULL)
+            FAS_ArenaRelease(scratch, mark);
+        return -1;
+    }
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        for (int w = 0; w < FAS_PT_WORDS; w++) {
+            for (uint64_t bits = caches[i].dirty[w]; bits != 0; bits &= bits - 1) {
+                int k = w * 64 + __builtin_ctzll(bits);
+                BYTE data[2 + FAS_PT_ITEM_SIZE];
+                put_le16(data, (uint16_t)k);
+                memcpy(&data[2], caches[i].value[k], FAS_PT_ITEM_SIZE);
+                FAS_RequestInit(&reqs[n++], i, FRAME_POSTABLEWRITEITEM, data, sizeof(data));
+                FAS_RequestInit(&reqs[n++], i, FRAME_POSTABLEREADITEM, data, 2);
+            }
+        }
+    }
+    run.progress.total = total;
+    run_batch(links, count, reqs, n, option, upload_done, &run, result);
+    FAS_ScratchFree(scratch, run.write_failed);
+    FAS_ScratchFree(scratch, reqs);
+    if (scratch != NULL)
+        FAS_ArenaRelease(scratch, mark);
+    return run.progress.failed + run.progress.mismatched;
+}
+
+static void save_done(FAS_REQUEST *req, void *user){
+    if (req->status == FMM_OK)
+        ((FAS_PT_CACHE *)user)[req->link].rom_dirty = false;
+}
+
+ /**@brief RAM에 쓴 항목이 있는 보드만 table ROM 저장 (PosTableWriteROM)
+  * @return 실패한 요청 수, 메모리 부족이면 -1*/
+int FAS_PtSaveToROM(FAS_LINK *links, FAS_PT_CACHE *caches, int count, const FAS_BATCH_OPTION *option){
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += caches[i].rom_dirty;
+    if (total == 0)
+        return 0;
+    FAS_ARENA *scratch = option_scratch(option);
+    size_t mark = scratch != NULL ? FAS_ArenaMark(scratch) : 0;
+    FAS_REQUEST *reqs = FAS_ScratchAlloc(scratch, sizeof(FAS_REQUEST) * total, false);
+    if (reqs == NULL)
+        return -1;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (caches[i].rom_dirty)
+            FAS_RequestInit(&reqs[n++], i, FRAME_POSTABLEWRITEROM, NULL, 0);
+    }
+    FAS_BATCH_OPTION opt = { 0 };
+    if (option != NULL)
+        opt = *option;
+    opt.done = save_done;
+    opt.user = caches;
+    int failed = FAS_ExecuteBatch(links, count, reqs, n, &opt);
+    FAS_ScratchFree(scratch, reqs);
+    if (scratch != NULL)
+        FAS_ArenaRelease(scratch, mark);
+    return failed;
+}
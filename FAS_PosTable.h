@@ -0,0 +1,88 @@
+
+#pragma once
+
+#ifndef FAS_POSTABLE_DEFINE
+#define FAS_POSTABLE_DEFINE
+
+/**
+ * @file FAS_PosTable.h
+ * @brief 드라이브 position table 일괄 올리기/확인과 로컬 cache
+ * @details FAS_PARAM_CACHE와 같은 방식으로 보드마다 원하는 table(value)과 드라이브에 있다고 확인된 table(drive)을 둔다.
+ * 항목을 바꾸면 dirty 표시만 하고, FAS_PtUpload가 바뀐 항목만 PosTableWriteItem(0x61)으로 보낸다.
+ * 쓰기 바로 뒤에 같은 항목의 PosTableReadItem(0x60)을 같은 묶음에 넣으므로, 확인 읽기는 다음 항목들의 쓰기와
+ * window 안에서 겹쳐 간다 (같은 보드 요청은 보낸 순서대로 처리되므로 읽기는 항상 방금 쓴 값을 봄).
+ * 읽어 온 값이 value와 같아야 그 항목을 확인된 것으로 보고 dirty를 지운다. 다르면 dirty로 남아 다음 FAS_PtUpload에 다시 간다.
+ * 여러 보드를 한 번에 넘기면 보드끼리도 동시에 진행하므로 축 20개 recipe 교체도 가장 느린 보드 하나 수준으로 끝난다.
+ *
+ * 항목 형식은 Ezi-SERVO Plus-E ITEM_NODE (little endian 40 byte), 요청 data는 [항목 번호 2][ITEM_NODE 40].
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FAS_Pipeline.h"
+
+#define FAS_PT_ITEM_COUNT 256		// 보드당 항목 수 (0 ~ 255)
+#define FAS_PT_ITEM_SIZE 40			// ITEM_NODE byte 수
+#define FAS_PT_WORDS (FAS_PT_ITEM_COUNT / 64)
+
+/**@brief position table 항목 한 개 (ITEM_NODE)*/
+typedef struct _FAS_PT_ITEM
+{
+	int32_t position;				// 목표 위치 [pulse]
+	uint32_t start_speed;			// 시작 속도 [pps]
+	uint32_t move_speed;			// 운전 속도 [pps]
+	uint16_t accel;					// 가속 시간 [ms]
+	uint16_t decel;					// 감속 시간 [ms]
+	uint16_t command;				// 운전 방식 (0: ABS, 1: INC, 2: 원점 ...)
+	uint16_t wait_time;				// 끝난 뒤 기다리는 시간 [ms]
+	uint16_t continuous;			// 다음 항목으로 연속 운전
+	uint16_t branch;				// 다음 항목 번호
+	uint16_t cond_branch[3];		// 입력 조건별 분기 항목
+	uint16_t loop_count;
+	uint16_t branch_after_loop;
+	uint16_t pt_set;				// 항목 실행 때 내보내는 출력
+	uint16_t loop_count_clear;
+	uint16_t check_inpos;			// inposition을 확인하고 다음 항목
+} FAS_PT_ITEM;
+
+/**@brief 보드 한 개의 position table cache*/
+typedef struct _FAS_PT_CACHE
+{
+	int iBdID;
+	int count;									// 사용하는 항목 수 (0 ~ count-1)
+	BYTE value[FAS_PT_ITEM_COUNT][FAS_PT_ITEM_SIZE];	// 원하는 항목 (ITEM_NODE로 바꿔 둠)
+	BYTE drive[FAS_PT_ITEM_COUNT][FAS_PT_ITEM_SIZE];	// 드라이브 RAM에 있다고 확인된 항목
+	uint64_t valid[FAS_PT_WORDS];				// drive[]를 읽었거나 쓰고 확인해서 알고 있는 번호
+	uint64_t dirty[FAS_PT_WORDS];				// value[] != drive[] 이고 아직 확인 안 된 번호
+	bool rom_dirty;								// RAM에 썼지만 ROM 저장 안 함
+} FAS_PT_CACHE;
+
+/**@brief FAS_PtUpload/FAS_PtReadAll 진행 상황 (전체 보드 합)*/
+typedef struct _FAS_PT_PROGRESS
+{
+	int total;						// 이번에 처리할 항목 수
+	int done;						// 끝난 항목 수 (성공, 실패 모두)
+	int verified;					// 쓰고 다시 읽어서 같음을 확인한 항목 수 (읽기만 할 때는 읽은 항목 수)
+	int mismatched;					// 다시 읽은 값이 다른 항목 수
+	int failed;						// 통신 실패 항목 수
+	uint64_t bytes;					// 주고받은 프레임 byte 수
+	uint64_t elapsed_us;
+} FAS_PT_PROGRESS;
+
+typedef void (*FAS_PT_PROGRESS_FN)(const FAS_PT_PROGRESS *progress, void *user);
+
+void FAS_PtItemEncode(const FAS_PT_ITEM *item, BYTE *node);
+void FAS_PtItemDecode(const BYTE *node, FAS_PT_ITEM *item);
+
+void FAS_PtCacheInit(FAS_PT_CACHE *cache, int iBdID, int count);
+bool FAS_PtSet(FAS_PT_CACHE *cache, int item_no, const FAS_PT_ITEM *item);
+bool FAS_PtGet(const FAS_PT_CACHE *cache, int item_no, FAS_PT_ITEM *item);
+int FAS_PtDirtyCount(const FAS_PT_CACHE *cache);
+
+int FAS_PtReadAll(FAS_LINK *links, FAS_PT_CACHE *caches, int count, const FAS_BATCH_OPTION *option,
+                  FAS_PT_PROGRESS_FN progress, void *user, FAS_PT_PROGRESS *result);
+int FAS_PtUpload(FAS_LINK *links, FAS_PT_CACHE *caches, int count, const FAS_BATCH_OPTION *option,
+                 FAS_PT_PROGRESS_FN progress, void *user, FAS_PT_PROGRESS *result);
+int FAS_PtSaveToROM(FAS_LINK *links, FAS_PT_CACHE *caches, int count, const FAS_BATCH_OPTION *option);
+
+#endif	//FAS_POSTABLE_DEFINE
@@ -0,0 +1,240 @@
+/**
+ * @file FAS_Scope.c
+ * @brief scope poll thread, SPSC ring, min/max pyramid
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "FAS_Scope.h"
+#include "FAS_Status.h"
+
+ /**@brief scope 준비 (history, pyramid 메모리를 한 번에 잡음)
+  * @param uint32_t history 남길 sample 수, 2^n으로 올림 (예: 100Hz 10분 = 60000 -> 65536)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ScopeInit(FAS_SCOPE *scope, int iBdID, uint32_t history){
+    memset(scope, 0, sizeof(*scope));
+    FAS_ContextInit(&scope->ctx, iBdID);
+
+    int levels = 1;
+    while (levels < FAS_SCOPE_MAX_LEVEL && (1u << levels) < history)
+        levels++;
+    scope->levels = levels;
+    scope->history = 1u << levels;
+
+    // level L은 칸 history >> L개, 채널마다 min/max (level 0은 min/max가 같은 배열)
+    size_t cells = scope->history;
+    for (int level = 1; level <= levels; level++)
+        cells += 2 * (size_t)(scope->history >> level);
+    size_t bytes = (size_t)scope->history * sizeof(uint64_t) + cells * FAS_SCOPE_CHANNELS * sizeof(int32_t);
+    scope->storage = malloc(bytes);
+    if (scope->storage == NULL) {
+        perror("scope allocation failed");
+        return false;
+    }
+
+    scope->t_us = scope->storage;
+    int32_t *p = (int32_t *)(scope->t_us + scope->history);
+    for (int ch = 0; ch < FAS_SCOPE_CHANNELS; ch++) {
+        scope->min[ch][0] = scope->max[ch][0] = p;
+        p += scope->history;
+        for (int level = 1; level <= levels; level++) {
+            scope->min[ch][level] = p;
+            p += scope->history >> level;
+            scope->max[ch][level] = p;
+            p += scope->history >> level;
+        }
+    }
+    return true;
+}
+
+ /**@brief FAS_ScopeInit이 잡은 메모리 반환 (poll 중이면 먼저 멈춤)*/
+void FAS_ScopeFree(FAS_SCOPE *scope){
+    FAS_ScopeStop(scope);
+    free(scope->storage);
+    scope->storage = NULL;
+}
+
+/************************************************************************************************************************************
+ ************************************************** poll thread -> ring (SPSC) ******************************************************
+ ************************************************************************************************************************************/
+
+ /**@brief sample 하나를 ring에 넣음 (poll thread 하나만 호출)
+  * @return ring이 차 있으면 FALSE (overruns 증가)*/
+bool FAS_ScopePush(FAS_SCOPE *scope, const FAS_SCOPE_SAMPLE *sample){
+    uint64_t head = atomic_load_explicit(&scope->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&scope->tail, memory_order_acquire);
+    if (head - tail >= FAS_SCOPE_RING) {
+        atomic_fetch_add_explicit(&scope->overruns, 1, memory_order_relaxed);
+        return false;
+    }
+    scope->ring[head & (FAS_SCOPE_RING - 1)] = *sample;
+    atomic_store_explicit(&scope->head, head + 1, memory_order_release);
+    return true;
+}
+
+static void *scope_thread_main(void *arg){
+    FAS_SCOPE *scope = arg;
+    FAS_ALL_STATUS status;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (atomic_load_explicit(&scope->running, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&scope->polls, 1, memory_order_relaxed);
+        if (FAS_ContextGetAllStatus(&scope->ctx, &status) == FMM_OK) {
+            FAS_SCOPE_SAMPLE sample = {
+                .t_us = FAS_MonotonicUs(),
+                .value = { status.actual_pos, status.actual_vel, status.pos_error },
+                .axis_status = status.axis_status,
+            };
+            FAS_ScopePush(scope, &sample);
+            if (scope->telemetry != NULL)
+                FAS_TelemetryAppend(scope->telemetry, scope->ctx.link.iBdID, sample.t_us, &status);
+        }
+        else {
+            atomic_fetch_add_explicit(&scope->failures, 1, memory_order_relaxed);
+        }
+
+        // 다음 주기까지 대기, 늦었으면 밀린 주기는 건너뜀
+        uint64_t next_ns = (uint64_t)next.tv_sec * 1000000000u + next.tv_nsec + (uint64_t)scope->period_us * 1000u;
+        uint64_t now_us = FAS_MonotonicUs();
+        if (next_ns < now_us * 1000u)
+            next_ns = now_us * 1000u;
+        next.tv_sec = (time_t)(next_ns / 1000000000u);
+        next.tv_nsec = (long)(next_ns % 1000000000u);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+            ;
+    }
+    return NULL;
+}
+
+ /**@brief 드라이브에 따로 연결해서 주기 polling 시작 (GUI의 context와 소켓을 공유하지 않음)
+  * @param uint32_t period_us polling 주기 (10000 = 100Hz)*/
+bool FAS_ScopeStart(FAS_SCOPE *scope, const char *ip, bool tcp, uint32_t period_us){
+    if (atomic_load(&scope->running))
+        return false;
+    scope->period_us = period_us ? period_us : 10000;
+    scope->ctx.timeout_ms = (int)(scope->period_us / 1000) > 20 ? (int)(scope->period_us / 1000) : 20;
+    if (!FAS_ContextOpen(&scope->ctx, ip, tcp))
+        return false;
+
+    atomic_store(&scope->running, true);
+    if (pthread_create(&scope->thread, NULL, scope_thread_main, scope) != 0) {
+        perror("scope thread create failed");
+        atomic_store(&scope->running, false);
+        FAS_ContextClose(&scope->ctx);
+        return false;
+    }
+    return true;
+}
+
+ /**@brief polling 정지 (최대 한 주기 + 응답 대기 시간)*/
+void FAS_ScopeStop(FAS_SCOPE *scope){
+    if (!atomic_exchange(&scope->running, false))
+        return;
+    pthread_join(scope->thread, NULL);
+    FAS_ContextClose(&scope->ctx);
+}
+
+/************************************************************************************************************************************
+ ************************************************** ring -> history/pyramid (화면 쪽) *************************************************
+ ************************************************************************************************************************************/
+
+static void scope_append(FAS_SCOPE *scope, const FAS_SCOPE_SAMPLE *sample){
+    uint64_t i = scope->count;
+    scope->t_us[i & (scope->history - 1)] = sample->t_us;
+    for (int ch = 0; ch < FAS_SCOPE_CHANNELS; ch++) {
+        int32_t v = sample->value[ch];
+        scope->min[ch][0][i & (scope->history - 1)] = v;
+        for (int level = 1; level <= scope->levels; level++) {
+            uint64_t slot = (i >> level) & ((scope->history >> level) - 1);
+            int32_t *lo = &scope->min[ch][level][slot], *hi = &scope->max[ch][level][slot];
+            if ((i & ((1ull << level) - 1)) == 0) {
+                *lo = *hi = v;		// 새 칸의 첫 sample
+            }
+            else {
+                if (v < *lo)
+                    *lo = v;
+                if (v > *hi)
+                    *hi = v;
+            }
+        }
+    }
+    scope->last = *sample;
+    scope->count++;
+}
+
+ /**@brief ring에 쌓인 sample을 history/pyramid로 옮김 (화면 쪽 thread 하나만 호출)
+  * @return 옮긴 sample 수*/
+int FAS_ScopeDrain(FAS_SCOPE *scope){
+    uint64_t tail = atomic_load_explicit(&scope->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&scope->head, memory_order_acquire);
+    int n = 0;
+    for (; tail != head; tail++, n++)
+        scope_append(scope, &scope->ring[tail & (FAS_SCOPE_RING - 1)]);
+    atomic_store_explicit(&scope->tail, tail, memory_order_release);
+    return n;
+}
+
+ /**@brief history에 남아 있는 가장 오래된 sample 번호*/
+uint64_t FAS_ScopeOldest(const FAS_SCOPE *scope){
+    return scope->count > scope->history ? scope->count - scope->history : 0;
+}
+
+ /**@brief sample 번호의 시각 (FAS_MonotonicUs), history 밖이면 0*/
+uint64_t FAS_ScopeTime(const FAS_SCOPE *scope, uint64_t index){
+    if (index >= scope->count || index < FAS_ScopeOldest(scope))
+        return 0;
+    return scope->t_us[index & (scope->history - 1)];
+}
+
+ /**@brief [end - span, end) 구간을 columns 열로 줄인 열별 최소/최대
+  * @details 열 하나가 sample n개면 2^L <= n/2인 가장 큰 level L의 칸을 합친다 (열마다 칸 2~3개).
+  * @param uint64_t end 화면 오른쪽 끝 sample 번호 + 1 (실시간이면 scope->count)
+  * @return 값을 채운 열 수, 데이터가 없는 열은 out_min > out_max*/
+int FAS_ScopeQuery(const FAS_SCOPE *scope, FAS_SCOPE_CHANNEL channel, uint64_t end, uint64_t span,
+                   int columns, int32_t *out_min, int32_t *out_max){
+    if (columns <= 0 || span == 0)
+        return 0;
+    if (end > scope->count)
+        end = scope->count;
+    uint64_t start = end > span ? end - span : 0;
+    uint64_t oldest = FAS_ScopeOldest(scope);
+
+    uint64_t per_column = span / (uint64_t)columns;
+    int level = 0;
+    while (level < scope->levels && (2ull << level) <= per_column / 2)
+        level++;
+
+    int filled = 0;
+    for (int c = 0; c < columns; c++) {
+        uint64_t s = start + span * c / columns;
+        uint64_t e = start + span * (c + 1) / columns;
+        if (e <= s)
+            e = s + 1;
+        if (e > end)
+            e = end;
+        int32_t lo = INT32_MAX, hi = INT32_MIN;
+
+        // 가장 오래된 sample보다 앞에서 시작하는 칸은 이미 덮어쓴 칸이므로 건너뜀
+        uint64_t first = s >> level, last = (e - 1) >> level;
+        if ((first << level) < oldest)
+            first = (oldest + (1ull << level) - 1) >> level;
+        uint64_t slots = scope->history >> level;
+        for (uint64_t b = first; s < e && b <= last; b++) {
+            int32_t bl = scope->min[channel][level][b & (slots - 1)];
+            int32_t bh = scope->max[channel][level][b & (slots - 1)];
+            if (bl < lo)
+                lo = bl;
+            if (bh > hi)
+                hi = bh;
+        }
+        out_min[c] = lo;
+        out_max[c] = hi;
+        if (lo <= hi)
+            filled++;
+    }
+    return filled;
+}
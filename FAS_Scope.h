@@ -0,0 +1,88 @@
+
+#pragma once
+
+#ifndef FAS_SCOPE_DEFINE
+#define FAS_SCOPE_DEFINE
+
+/**
+ * @file FAS_Scope.h
+ * @brief 상태 주기 polling 결과(위치, 속도, 위치 오차)를 화면 폭만큼 줄여서 보여주는 scope 저장소
+ * @details poll thread가 자기 context로 FAS_GetAllStatus(0x43)를 주기마다 보내고, decode한 값을
+ * lock 없는 SPSC ring에 넣는다. 화면 쪽(한 thread)은 FAS_ScopeDrain으로 ring을 비우면서 history와
+ * min/max pyramid(level L의 칸 하나 = sample 2^L개의 최소/최대)를 갱신한다.
+ * FAS_ScopeQuery는 화면 한 열이 sample 몇 개인지에 맞는 level을 골라 열마다 칸 2~3개만 합치므로
+ * 그리는 비용은 sample 수가 아니라 화면 폭에 비례한다.
+ * history는 가장 최근 history개(2^n)만 남고, 오래된 것부터 덮어쓴다.
+ * telemetry를 지정하면 poll thread가 같은 결과를 FAS_TelemetryAppend로 넘긴다 (압축/쓰기는 telemetry writer thread).
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "FAS_Library.h"
+#include "FAS_Metrics.h"
+#include "FAS_Telemetry.h"
+
+#define FAS_SCOPE_RING 1024				// poll thread -> 화면 쪽 ring (2^n)
+#define FAS_SCOPE_MAX_LEVEL 20			// pyramid 최대 level (history 2^20 sample까지)
+
+/**@brief scope 채널*/
+typedef enum _FAS_SCOPE_CHANNEL
+{
+	FAS_SCOPE_POSITION = 0,			// 실제 위치 (pulse)
+	FAS_SCOPE_VELOCITY,				// 실제 속도 (pps)
+	FAS_SCOPE_POS_ERROR,			// 위치 오차 (pulse)
+	FAS_SCOPE_CHANNELS,
+} FAS_SCOPE_CHANNEL;
+
+/**@brief poll 한 번의 결과*/
+typedef struct _FAS_SCOPE_SAMPLE
+{
+	uint64_t t_us;					// FAS_MonotonicUs
+	int32_t value[FAS_SCOPE_CHANNELS];
+	uint32_t axis_status;
+} FAS_SCOPE_SAMPLE;
+
+typedef struct _FAS_SCOPE
+{
+	// poll thread
+	FAS_CONTEXT ctx;
+	uint32_t period_us;
+	pthread_t thread;
+	_Atomic bool running;
+	_Atomic uint64_t polls;
+	_Atomic uint64_t failures;		// 응답 없음/통신 오류
+	_Atomic uint64_t overruns;		// ring이 차서 버린 sample
+	FAS_TELEMETRY *telemetry;		// NULL이 아니면 poll 결과를 파일에도 기록 (FAS_ScopeStart 전에 지정)
+
+	// SPSC ring
+	FAS_SCOPE_SAMPLE ring[FAS_SCOPE_RING];
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t head;	// poll thread만 씀
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t tail;	// 화면 쪽만 씀
+
+	// history와 pyramid (화면 쪽 thread 전용)
+	uint64_t count;					// 지금까지 받은 sample 수 (다음 sample 번호)
+	uint32_t history;				// 남겨 두는 sample 수 (2^levels)
+	int levels;
+	uint64_t *t_us;					// [history]
+	int32_t *min[FAS_SCOPE_CHANNELS][FAS_SCOPE_MAX_LEVEL + 1];	// level 0은 sample 그대로 (min == max)
+	int32_t *max[FAS_SCOPE_CHANNELS][FAS_SCOPE_MAX_LEVEL + 1];
+	void *storage;
+	FAS_SCOPE_SAMPLE last;			// 가장 최근 sample
+} FAS_SCOPE;
+
+bool FAS_ScopeInit(FAS_SCOPE *scope, int iBdID, uint32_t history);
+void FAS_ScopeFree(FAS_SCOPE *scope);
+
+bool FAS_ScopeStart(FAS_SCOPE *scope, const char *ip, bool tcp, uint32_t period_us);
+void FAS_ScopeStop(FAS_SCOPE *scope);
+
+bool FAS_ScopePush(FAS_SCOPE *scope, const FAS_SCOPE_SAMPLE *sample);
+int FAS_ScopeDrain(FAS_SCOPE *scope);
+uint64_t FAS_ScopeOldest(const FAS_SCOPE *scope);
+int FAS_ScopeQuery(const FAS_SCOPE *scope, FAS_SCOPE_CHANNEL channel, uint64_t end, uint64_t span,
+                   int columns, int32_t *out_min, int32_t *out_max);
+uint64_t FAS_ScopeTime(const FAS_SCOPE *scope, uint64_t index);
+
+#endif	//FAS_SCOPE_DEFINE
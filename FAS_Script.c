@@ -0,0 +1,123 @@
+/**
+ * @file FAS_Script.c
+ * @brief stackless coroutine sequence 실행 (명령 송신, 응답 뒤 이어서 실행, 시간 집계)
+ */
+
+#include <string.h>
+#include "FAS_Script.h"
+
+static void script_finish(FAS_SCRIPT *s, int result){
+    FAS_SCRIPT_RUNNER *runner = s->runner;
+    s->result = (BYTE)result;
+    s->end_us = FAS_MonotonicUs();
+    atomic_fetch_add_explicit(&runner->finished, 1, memory_order_relaxed);
+    if (result == FAS_SCRIPT_FAILED)
+        atomic_fetch_add_explicit(&runner->failed, 1, memory_order_relaxed);
+    if (s->done != NULL)
+        s->done(s, s->user);
+    // caller가 running이 0이 되기를 기다렸다가 s를 버릴 수 있으므로 맨 마지막
+    atomic_fetch_sub_explicit(&runner->running, 1, memory_order_release);
+}
+
+// shard thread에서 명령 하나가 끝날 때마다 불림, sequence를 다음 AWAIT까지 실행
+static void script_done(FAS_SHARD_REQUEST *r, void *user){
+    FAS_SCRIPT *s = user;
+    uint32_t wait = (uint32_t)(FAS_MonotonicUs() - r->queued_us);
+    s->command_us += wait;
+    if (wait > s->step_us)
+        s->step_us = wait;
+    if (r->req.status == FMM_OK)
+        FAS_AxisStatusFromResponse(r->req.frame_type, r->req.resp, r->req.resp_len, &s->axis_status);
+
+    // 시작할 때 읽는 상태부터 실패하면 sequence를 돌리지 않음
+    if (s->pc == 0 && r->req.status != FMM_OK) {
+        FAS_ScriptFail(s);
+        script_finish(s, FAS_SCRIPT_FAILED);
+        return;
+    }
+    int result = s->fn(s);
+    if (result != FAS_SCRIPT_WAITING)
+        script_finish(s, result);
+}
+
+ /**@brief 실행기 준비
+  * @param FAS_SHARDS *set 명령을 보낼 shard 묶음 (보드는 미리 FAS_ShardsAddBoard, FAS_ShardsStart)*/
+void FAS_ScriptRunnerInit(FAS_SCRIPT_RUNNER *runner, FAS_SHARDS *set){
+    memset(runner, 0, sizeof(*runner));
+    runner->set = set;
+}
+
+ /**@brief sequence 시작 (아무 thread에서나)
+  * @details 먼저 AxisStatus를 한 번 읽고, 그 응답이 오면 shard thread에서 fn을 처음부터 실행한다.
+  * s는 끝날 때(done 호출 뒤 runner->running이 줄 때)까지 그대로 두어야 한다.
+  * @param FAS_SCRIPT_FN fn sequence 함수 (FAS_SCRIPT_BEGIN ~ FAS_SCRIPT_END)
+  * @param FAS_SCRIPT_DONE_FN done 끝나면 호출 (NULL 가능)
+  * @return boolean 성공시 TRUE, shard queue가 차면 FALSE (done은 불리지 않음)*/
+bool FAS_ScriptStart(FAS_SCRIPT_RUNNER *runner, FAS_SCRIPT *s, int iBdID, FAS_SCRIPT_FN fn, FAS_SCRIPT_DONE_FN done, void *user){
+    memset(s, 0, sizeof(*s));
+    s->runner = runner;
+    s->fn = fn;
+    s->done = done;
+    s->user = user;
+    s->iBdID = iBdID;
+    s->start_us = FAS_MonotonicUs();
+
+    atomic_fetch_add_explicit(&runner->running, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&runner->started, 1, memory_order_relaxed);
+    if (!FAS_ScriptSend(s, FRAME_GETAXISSTATUS, NULL, 0, 0)) {
+        atomic_fetch_sub_explicit(&runner->running, 1, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&runner->started, 1, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+ /**@brief sequence의 다음 명령 송신 (AWAIT 매크로 안에서 부름)
+  * @param uint32_t delay_us 0이 아니면 지금부터 이만큼 뒤에 보냄
+  * @return boolean 성공시 TRUE, 실패시 FALSE (r.req.status = FMM_NOT_OPEN)*/
+bool FAS_ScriptSend(FAS_SCRIPT *s, BYTE frame_type, const void *data, int data_len, uint32_t delay_us){
+    if (data_len < 0 || data_len > DATA_SIZE) {
+        s->r.req.frame_type = frame_type;
+        s->r.req.status = FMP_DATAERROR;
+        return false;
+    }
+    FAS_RequestInit(&s->r.req, s->iBdID, frame_type, data, data_len);
+    s->r.done = script_done;
+    s->r.user = s;
+    s->r.priority = FAS_PRIO_AUTO;
+    s->r.not_before_us = delay_us != 0 ? FAS_MonotonicUs() + delay_us : 0;
+    s->commands++;
+    atomic_fetch_add_explicit(&s->runner->commands, 1, memory_order_relaxed);
+    if (!FAS_ShardsSubmit(s->runner->set, &s->r)) {
+        s->r.req.status = FMM_NOT_OPEN;
+        return false;
+    }
+    return true;
+}
+
+ /**@brief 지금 명령의 상태를 sequence 실패 원인으로 남김
+  * @return FAS_SCRIPT_FAILED*/
+int FAS_ScriptFail(FAS_SCRIPT *s){
+    s->error = s->r.req.status;
+    s->failed_type = s->r.req.frame_type;
+    s->pc = 0;
+    return FAS_SCRIPT_FAILED;
+}
+
+ /**@brief 상태 조건이 아직 안 맞을 때 다음 조회 예약 (FAS_SCRIPT_AWAIT_STATUS 안에서 부름)
+  * @return FAS_SCRIPT_WAITING, timeout이 지났으면 FAS_SCRIPT_FAILED (error = FMC_TIMEOUT_ERROR)*/
+int FAS_ScriptPoll(FAS_SCRIPT *s){
+    if (FAS_MonotonicUs() >= s->deadline_us) {
+        s->r.req.status = FMC_TIMEOUT_ERROR;
+        return FAS_ScriptFail(s);
+    }
+    if (!FAS_ScriptSend(s, FRAME_GETAXISSTATUS, NULL, 0, s->poll_us))
+        return FAS_ScriptFail(s);
+    return FAS_SCRIPT_WAITING;
+}
+
+ /**@brief 시작부터 끝까지 (아직 돌고 있으면 지금까지) 걸린 시간 [us]*/
+uint32_t FAS_ScriptElapsedUs(const FAS_SCRIPT *s){
+    uint64_t end = s->end_us != 0 ? s->end_us : FAS_MonotonicUs();
+    return (uint32_t)(end - s->start_us);
+}
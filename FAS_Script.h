@@ -0,0 +1,145 @@
+
+#pragma once
+
+#ifndef FAS_SCRIPT_DEFINE
+#define FAS_SCRIPT_DEFINE
+
+/**
+ * @file FAS_Script.h
+ * @brief 여러 단계 운전 sequence (서보 ON → 원점 → 이동 → inposition 대기 → 엔코더 읽기) 를 stackless coroutine으로 실행
+ * @details sequence는 보통 C 함수 하나로 쓰고, 명령 결과나 상태 조건을 기다리는 곳에서 FAS_SCRIPT_AWAIT* 매크로를 부른다.
+ * 매크로는 다시 들어올 위치(__LINE__)를 FAS_SCRIPT.pc에 적고 함수를 빠져나가며, 응답이 오면 같은 함수가
+ * switch로 그 위치부터 이어서 실행된다 (protothread 방식). 그래서 sequence마다 thread나 stack이 없고
+ * 상태는 FAS_SCRIPT 하나(요청 buffer 포함)와 user가 넘긴 구조체가 전부다.
+ * 명령은 shard transport(FAS_Shard)로 보내고 sequence 함수는 그 보드를 맡은 shard thread(I/O event loop)에서만 돈다.
+ * 상태 조건은 GetAxisStatus(0x40)를 period마다 다시 읽어서 보고, 대기(FAS_SCRIPT_SLEEP)도 그 시각에 상태를 한 번 읽는다.
+ * 주기 조회는 shard의 지연 송신(not_before_us)을 쓰므로 timer thread도 없다.
+ *
+ * 규칙 (protothread와 같음):
+ * - 지역 변수는 AWAIT 뒤에 남지 않는다. 단계 사이에 들고 갈 값은 s->user 구조체에 둔다.
+ * - 한 줄에 AWAIT 매크로를 두 번 쓰지 않는다 (줄 번호가 다시 들어올 위치).
+ * - AWAIT 매크로는 FAS_SCRIPT_BEGIN/END 사이의 switch 안에서만 쓴다 (안쪽에 다른 switch를 두지 않음).
+ * - 명령이 실패하거나 조건이 timeout까지 안 맞으면 sequence는 FAS_SCRIPT_FAILED로 끝나고 error/failed_type에 남는다.
+ *
+ * 예)
+ *   static int home_and_move(FAS_SCRIPT *s){
+ *       FAS_SCRIPT_BEGIN(s);
+ *       FAS_SCRIPT_AWAIT(s, FRAME_SERVOENABLE, on, 1);
+ *       FAS_SCRIPT_AWAIT_STATUS(s, FAS_SCRIPT_FLAG(s, FAS_AXIS_SERVOON), 1, 500);
+ *       FAS_SCRIPT_AWAIT(s, FRAME_MOVEORIGINSINGLEAXIS, NULL, 0);
+ *       FAS_SCRIPT_AWAIT_STATUS(s, FAS_SCRIPT_FLAG(s, FAS_AXIS_ORIGINRETOK), 2, 5000);
+ *       FAS_SCRIPT_AWAIT(s, FRAME_GETACTUALPOS, NULL, 0);
+ *       ((MY_AXIS *)s->user)->pos = (int32_t)fas_get_le32(s->r.req.resp);
+ *       FAS_SCRIPT_END(s);
+ *   }
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "FAS_Shard.h"
+#include "FAS_Status.h"
+
+/**@brief sequence 함수가 돌려주는 값*/
+typedef enum _FAS_SCRIPT_RESULT
+{
+	FAS_SCRIPT_WAITING = 0,			// 명령이나 조건을 기다리는 중 (다시 불림)
+	FAS_SCRIPT_DONE,				// 끝까지 실행
+	FAS_SCRIPT_FAILED,				// 명령 실패 또는 조건 timeout
+} FAS_SCRIPT_RESULT;
+
+struct _FAS_SCRIPT;
+struct _FAS_SCRIPT_RUNNER;
+typedef int (*FAS_SCRIPT_FN)(struct _FAS_SCRIPT *s);
+typedef void (*FAS_SCRIPT_DONE_FN)(struct _FAS_SCRIPT *s, void *user);
+
+/**@brief 실행 중인 sequence 하나 (FAS_ScriptStart부터 끝날 때까지 caller가 유지)*/
+typedef struct _FAS_SCRIPT
+{
+	FAS_SHARD_REQUEST r;				// 지금 기다리는 명령 (sequence당 하나), AWAIT 뒤에는 r.req.resp에 응답
+	struct _FAS_SCRIPT_RUNNER *runner;
+	FAS_SCRIPT_FN fn;
+	FAS_SCRIPT_DONE_FN done;			// 끝나면 shard thread에서 호출 (NULL 가능)
+	void *user;
+
+	int iBdID;
+	uint16_t pc;						// 다시 들어올 위치 (0이면 처음)
+	BYTE result;						// FAS_SCRIPT_RESULT
+	BYTE failed_type;					// 실패한 명령의 frame type
+	FMM_ERROR error;					// 실패한 명령의 상태 (조건 timeout은 FMC_TIMEOUT_ERROR)
+	uint32_t axis_status;				// 마지막으로 읽은 AxisStatus (상태를 담은 응답이면 자동으로 갱신)
+	uint32_t poll_us;					// 상태 조건 다시 읽는 주기
+	uint64_t deadline_us;				// 상태 조건 timeout 시각
+
+	// 시간 (us)
+	uint64_t start_us;
+	uint64_t end_us;
+	uint32_t commands;					// 보낸 명령 수 (상태 조회 포함)
+	uint32_t command_us;				// 명령 응답을 기다린 시간 합 (shard가 받은 때부터 응답까지, 주기 대기 제외)
+	uint32_t step_us;					// 가장 오래 걸린 명령 하나
+} FAS_SCRIPT;
+
+/**@brief sequence 실행기, 여러 sequence가 같은 shard 묶음을 씀*/
+typedef struct _FAS_SCRIPT_RUNNER
+{
+	FAS_SHARDS *set;
+	_Atomic int running;				// 끝나지 않은 sequence 수
+	_Atomic uint64_t started;
+	_Atomic uint64_t finished;
+	_Atomic uint64_t failed;
+	_Atomic uint64_t commands;
+} FAS_SCRIPT_RUNNER;
+
+#define FAS_SCRIPT_BEGIN(s)		switch ((s)->pc) { case 0:
+#define FAS_SCRIPT_END(s)		} (s)->pc = 0; return FAS_SCRIPT_DONE
+
+// 명령 하나 보내고 응답까지 기다림, FMM_OK가 아니면 sequence 실패
+#define FAS_SCRIPT_AWAIT(s, frame_type, data, data_len)										\
+	do {																					\
+		(s)->pc = __LINE__;																	\
+		if (!FAS_ScriptSend((s), (frame_type), (data), (data_len), 0))						\
+			return FAS_ScriptFail(s);														\
+		return FAS_SCRIPT_WAITING;															\
+	case __LINE__:																			\
+		if ((s)->r.req.status != FMM_OK)													\
+			return FAS_ScriptFail(s);														\
+	} while (0)
+
+// cond가 참이 될 때까지 period_ms마다 AxisStatus를 읽음 (처음 한 번은 바로), timeout_ms 넘으면 sequence 실패
+#define FAS_SCRIPT_AWAIT_STATUS(s, cond, period_ms, timeout_ms)								\
+	do {																					\
+		(s)->poll_us = (uint32_t)(period_ms) * 1000u;										\
+		(s)->deadline_us = FAS_MonotonicUs() + (uint64_t)(timeout_ms) * 1000u;				\
+		(s)->pc = __LINE__;																	\
+		if (!FAS_ScriptSend((s), FRAME_GETAXISSTATUS, NULL, 0, 0))							\
+			return FAS_ScriptFail(s);														\
+		return FAS_SCRIPT_WAITING;															\
+	case __LINE__:																			\
+		if ((s)->r.req.status != FMM_OK)													\
+			return FAS_ScriptFail(s);														\
+		if (!(cond))																		\
+			return FAS_ScriptPoll(s);														\
+	} while (0)
+
+// ms 동안 쉼 (끝날 때 AxisStatus를 한 번 읽어 둠)
+#define FAS_SCRIPT_SLEEP(s, ms)																\
+	do {																					\
+		(s)->pc = __LINE__;																	\
+		if (!FAS_ScriptSend((s), FRAME_GETAXISSTATUS, NULL, 0, (uint32_t)(ms) * 1000u))		\
+			return FAS_ScriptFail(s);														\
+		return FAS_SCRIPT_WAITING;															\
+	case __LINE__:																			\
+		if ((s)->r.req.status != FMM_OK)													\
+			return FAS_ScriptFail(s);														\
+	} while (0)
+
+#define FAS_SCRIPT_FLAG(s, flag)	(((s)->axis_status & (flag)) != 0)
+
+void FAS_ScriptRunnerInit(FAS_SCRIPT_RUNNER *runner, FAS_SHARDS *set);
+bool FAS_ScriptStart(FAS_SCRIPT_RUNNER *runner, FAS_SCRIPT *s, int iBdID, FAS_SCRIPT_FN fn, FAS_SCRIPT_DONE_FN done, void *user);
+bool FAS_ScriptSend(FAS_SCRIPT *s, BYTE frame_type, const void *data, int data_len, uint32_t delay_us);
+int FAS_ScriptFail(FAS_SCRIPT *s);
+int FAS_ScriptPoll(FAS_SCRIPT *s);
+uint32_t FAS_ScriptElapsedUs(const FAS_SCRIPT *s);
+
+#endif	//FAS_SCRIPT_DEFINE
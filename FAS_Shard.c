@@ -0,0 +1,1070 @@
+/**
+ * @file FAS_Shard.c
+ * @brief shard I/O thread (MPSC 요청 queue, sendmmsg/recvmmsg, Sync No. 매칭, 시간 초과 재전송)
+ */
+
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "FAS_Shard.h"
+#include "FAS_Trace.h"
+
+#define STAT(field) (offsetof(FAS_SHARD_STATS, field) / sizeof(uint64_t))
+
+// io_uring user_data: 위 32bit는 종류, 아래 32bit는 송신 칸 번호
+#define URING_RECV (1ull << 32)
+#define URING_WAKE (2ull << 32)
+#define URING_SEND (3ull << 32)
+
+static inline void shard_stat(FAS_SHARD *sh, size_t index, uint64_t n){
+    atomic_fetch_add_explicit(&sh->stats[index], n, memory_order_relaxed);
+}
+
+ /**@brief 보드 번호 -> shard 번호 (곱셈 hash라서 연속된 보드 번호도 고르게 퍼짐)*/
+int FAS_ShardOf(const FAS_SHARDS *set, int iBdID){
+    return (int)((((uint32_t)iBdID * 2654435761u) >> 16) % (uint32_t)set->count);
+}
+
+ /**@brief frame type의 기본 송신 class (FAS_SHARD_REQUEST.priority가 FAS_PRIO_AUTO일 때)
+  * @param const BYTE *data 명령 data (서보 ON/OFF 구분용, NULL 가능)*/
+FAS_PRIORITY FAS_FramePriority(BYTE frame_type, const BYTE *data, int data_len){
+    switch (frame_type) {
+        case FRAME_MOVESTOP:
+        case FRAME_EMERGENCYSTOP:
+            return FAS_PRIO_SAFETY;
+        case FRAME_SERVOENABLE:
+            return (data_len >= 1 && data != NULL && data[0] == 0) ? FAS_PRIO_SAFETY : FAS_PRIO_MOTION;
+        case FRAME_MOVEORIGINSINGLEAXIS: case FRAME_MOVESINGLEAXISABSPOS: case FRAME_MOVESINGLEAXISINCPOS:
+        case FRAME_MOVETOLIMIT: case FRAME_MOVEVELOCITY: case FRAME_POSITIONABSOVERRIDE:
+        case FRAME_POSITIONINCOVERRIDE: case FRAME_VELOCITYOVERRIDE: case FRAME_POSTABLERUNITEM:
+            return FAS_PRIO_MOTION;
+        case FRAME_GETSLAVEINFO: case FRAME_GETMOTORINFO: case FRAME_GETENCODER: case FRAME_GETFIRMWAREINFO:
+        case FRAME_GETSLAVEINFOEX: case FRAME_GETROMPARAMETER: case FRAME_GETPARAMETER: case FRAME_GETALARMTYPE:
+        case FRAME_GETAXISSTATUS: case FRAME_GETIOAXISSTATUS: case FRAME_GETMOTIONSTATUS: case FRAME_GETALLSTATUS:
+        case FRAME_GETCOMMANDPOS: case FRAME_GETACTUALPOS: case FRAME_GETPOSERROR: case FRAME_GETACTUALVEL:
+        case FRAME_POSTABLEREADITEM:
+            return FAS_PRIO_POLL;
+        default:
+            return FAS_PRIO_CONFIG;
+    }
+}
+
+static uint32_t addr_hash(const struct sockaddr_in *addr){
+    return ((addr->sin_addr.s_addr * 2654435761u) ^ addr->sin_port) & (FAS_SHARD_ADDR_SLOTS - 1);
+}
+
+static void addr_insert(FAS_SHARD *sh, FAS_SHARD_BOARD *bd){
+    uint32_t i = addr_hash(&bd->addr);
+    while (sh->addr_slot[i] != NULL)
+        i = (i + 1) & (FAS_SHARD_ADDR_SLOTS - 1);
+    sh->addr_slot[i] = bd;
+}
+
+static FAS_SHARD_BOARD *board_by_addr(FAS_SHARD *sh, const struct sockaddr_in *addr){
+    for (uint32_t i = addr_hash(addr), n = 0; n < FAS_SHARD_ADDR_SLOTS; i = (i + 1) & (FAS_SHARD_ADDR_SLOTS - 1), n++) {
+        FAS_SHARD_BOARD *bd = sh->addr_slot[i];
+        if (bd == NULL)
+            return NULL;
+        if (bd->addr.sin_addr.s_addr == addr->sin_addr.s_addr && bd->addr.sin_port == addr->sin_port)
+            return bd;
+    }
+    return NULL;
+}
+
+/************************************************************************************************************************************
+ ************************************************** 요청 queue (MPSC) **************************************************************
+ ************************************************************************************************************************************/
+
+static bool queue_push(FAS_SHARD *sh, FAS_SHARD_REQUEST *req){
+    uint64_t pos = atomic_load_explicit(&sh->enqueue_pos, memory_order_relaxed);
+    FAS_SHARD_CELL *cell;
+    for (;;) {
+        cell = &sh->queue[pos & (FAS_SHARD_QUEUE - 1)];
+        uint64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&sh->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) {
+            return false;	// 한 바퀴 전 칸을 shard가 아직 안 꺼냄 = 가득 참
+        }
+        else {
+            pos = atomic_load_explicit(&sh->enqueue_pos, memory_order_relaxed);
+        }
+    }
+    cell->req = req;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+static FAS_SHARD_REQUEST *queue_pop(FAS_SHARD *sh){
+    FAS_SHARD_CELL *cell = &sh->queue[sh->dequeue_pos & (FAS_SHARD_QUEUE - 1)];
+    if (atomic_load_explicit(&cell->seq, memory_order_acquire) != sh->dequeue_pos + 1)
+        return NULL;
+    FAS_SHARD_REQUEST *req = cell->req;
+    atomic_store_explicit(&cell->seq, sh->dequeue_pos + FAS_SHARD_QUEUE, memory_order_release);
+    sh->dequeue_pos++;
+    return req;
+}
+
+static bool queue_empty(FAS_SHARD *sh){
+    FAS_SHARD_CELL *cell = &sh->queue[sh->dequeue_pos & (FAS_SHARD_QUEUE - 1)];
+    return atomic_load_explicit(&cell->seq, memory_order_acquire) != sh->dequeue_pos + 1;
+}
+
+static void shard_wake(FAS_SHARD *sh){
+    uint64_t one = 1;
+    if (write(sh->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        perror("shard wakeup failed");
+}
+
+ /**@brief 요청을 그 보드를 맡은 shard에 넘김 (아무 thread에서나, 완료 callback 안에서도 가능)
+  * @return queue가 차 있거나 보드 번호, data 길이가 맞지 않으면 FALSE (요청은 그대로 호출자 것)*/
+bool FAS_ShardsSubmit(FAS_SHARDS *set, FAS_SHARD_REQUEST *req){
+    // shard 보드는 Header 계열 codec만 쓰므로 Length byte(data + 3)가 한 byte에 들어가야 함
+    if (req->req.link < 0 || req->req.link >= FAS_MAX_BOARD || req->req.data_len > DATA_SIZE - 1)
+        return false;
+    FAS_SHARD *sh = set->shard[FAS_ShardOf(set, req->req.link)];
+    if (!queue_push(sh, req)) {
+        shard_stat(sh, STAT(queue_full), 1);
+        return false;
+    }
+    shard_stat(sh, STAT(submitted), 1);
+
+    // shard thread가 sleeping을 올린 뒤 queue를 다시 보므로, 둘 중 하나는 반드시 상대를 봄
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&sh->sleeping, memory_order_relaxed))
+        shard_wake(sh);
+    return true;
+}
+
+/************************************************************************************************************************************
+ ************************************************** 송수신 (shard thread 전용) ******************************************************
+ ************************************************************************************************************************************/
+
+static void tx_flush(FAS_SHARD *sh){
+    struct mmsghdr msg[FAS_SHARD_IO_BATCH];
+    struct iovec iov[FAS_SHARD_IO_BATCH];
+    int n = sh->tx_count, done = 0;
+    if (n == 0)
+        return;
+    for (int i = 0; i < n; i++) {
+        iov[i].iov_base = sh->tx_frame[i];
+        iov[i].iov_len = sh->tx_len[i];
+        memset(&msg[i], 0, sizeof(msg[i]));
+        msg[i].msg_hdr.msg_name = &sh->tx_addr[i];
+        msg[i].msg_hdr.msg_namelen = sizeof(sh->tx_addr[i]);
+        msg[i].msg_hdr.msg_iov = &iov[i];
+        msg[i].msg_hdr.msg_iovlen = 1;
+    }
+    while (done < n) {
+        int sent = sendmmsg(sh->fd, &msg[done], n - done, 0);
+        shard_stat(sh, STAT(syscalls), 1);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            // 못 보낸 프레임은 in-flight에 그대로 두고 시간 초과 재전송에 맡김
+            perror("shard sendmmsg failed");
+            break;
+        }
+        done += sent;
+    }
+    shard_stat(sh, STAT(sent), done);
+    sh->tx_count = 0;
+}
+
+static void inflight_append(FAS_SHARD *sh, FAS_SHARD_REQUEST *r){
+    r->next = NULL;
+    r->prev = sh->inflight_tail;
+    if (sh->inflight_tail != NULL)
+        sh->inflight_tail->next = r;
+    else
+        sh->inflight_head = r;
+    sh->inflight_tail = r;
+}
+
+static void inflight_remove(FAS_SHARD *sh, FAS_SHARD_BOARD *bd, FAS_SHARD_REQUEST *r){
+    if (r->prev != NULL)
+        r->prev->next = r->next;
+    else
+        sh->inflight_head = r->next;
+    if (r->next != NULL)
+        r->next->prev = r->prev;
+    else
+        sh->inflight_tail = r->prev;
+    bd->slot[r->sync] = NULL;
+    bd->inflight--;
+    sh->inflight--;
+}
+
+static void request_send(FAS_SHARD *sh, FAS_SHARD_BOARD *bd, FAS_SHARD_REQUEST *r){
+    // window가 256보다 훨씬 작으므로 비어 있는 Sync No.는 금방 찾음
+    while (bd->slot[bd->sync_no] != NULL)
+        bd->sync_no++;
+    r->sync = bd->sync_no++;
+
+    // io_uring이면 빈 송신 칸에 바로 만들고 SQE만 채움 (칸이 모자라면 sendmmsg 묶음으로)
+    int len;
+    if (sh->uring_on && sh->tx_free_count > 0) {
+        int slot = sh->tx_free[--sh->tx_free_count];
+        FAS_SHARD_TX_SLOT *t = &sh->tx_slot[slot];
+        len = FAS_CodecEncode(bd->codec, t->frame, r->sync, r->req.frame_type, r->req.data, r->req.data_len);
+        t->addr = bd->addr;
+        t->iov.iov_len = len;
+        if (FAS_UringSendmsg(&sh->uring, &t->msg, URING_SEND | (uint64_t)slot))
+            shard_stat(sh, STAT(sent), 1);
+        else
+            sh->tx_free[sh->tx_free_count++] = slot;	// SQ가 막힘: 시간 초과 재전송에 맡김
+    }
+    else {
+        if (sh->tx_count == FAS_SHARD_IO_BATCH)
+            tx_flush(sh);
+        int i = sh->tx_count++;
+        len = sh->tx_len[i] = FAS_CodecEncode(bd->codec, sh->tx_frame[i], r->sync, r->req.frame_type, r->req.data, r->req.data_len);
+        sh->tx_addr[i] = bd->addr;
+    }
+    FAS_TRACE(FAS_TRACE_BUILD, bd->iBdID, r->sync, r->req.frame_type);
+    FAS_MetricsSent(bd->iBdID, len);
+
+    r->sent_us = FAS_MonotonicUs();
+    r->deadline_us = r->sent_us + (uint64_t)sh->set->option.timeout_ms * 1000u;
+    bd->slot[r->sync] = r;
+    bd->inflight++;
+    sh->inflight++;
+    inflight_append(sh, r);
+
+    // class별 대기 시간은 처음 송신만 (재전송은 제외)
+    if (r->req.retries == 0) {
+        uint64_t wait = r->sent_us - r->queued_us;
+        size_t max = STAT(class_queue_max_us) + r->klass;
+        shard_stat(sh, STAT(class_sent) + r->klass, 1);
+        shard_stat(sh, STAT(class_queue_us) + r->klass, wait);
+        if (wait > atomic_load_explicit(&sh->stats[max], memory_order_relaxed))
+            atomic_store_explicit(&sh->stats[max], wait, memory_order_relaxed);
+    }
+}
+
+/************************************************************************************************************************************
+ ************************************************** 송신 순서 (class 우선, class 안에서 보드별 deficit round-robin) ****************
+ ************************************************************************************************************************************/
+
+static inline bool seq_before(uint32_t a, uint32_t b){
+    return (int32_t)(a - b) < 0;
+}
+
+// 보드 하나에서 class별로 동시에 보내 둘 수 있는 요청 수
+static int class_limit(const FAS_SHARD_OPTION *opt, int klass){
+    if (opt->no_priority)
+        return opt->window;
+    if (klass == FAS_PRIO_SAFETY - 1)
+        return opt->window + opt->reserve + 1;
+    if (klass == FAS_PRIO_MOTION - 1)
+        return opt->window + opt->reserve;
+    if (klass == FAS_PRIO_POLL - 1)
+        return opt->poll_window;
+    return opt->window;
+}
+
+static bool shard_budget_full(const FAS_SHARD *sh, int klass){
+    const FAS_SHARD_OPTION *opt = &sh->set->option;
+    return opt->inflight_max > 0 && sh->inflight >= opt->inflight_max && (opt->no_priority || klass != FAS_PRIO_SAFETY - 1);
+}
+
+// 이 보드의 class 맨 앞 요청을 지금 보낼 수 있는지 (shard 전체 제한은 따로 봄)
+static bool board_can_send(const FAS_SHARD *sh, const FAS_SHARD_BOARD *bd, int klass){
+    const FAS_SHARD_REQUEST *r = bd->pending_head[klass];
+    if (r == NULL || bd->inflight >= class_limit(&sh->set->option, klass))
+        return false;
+    // 운전 명령은 같은 보드에 먼저 들어온 설정 명령을 앞지르지 않음
+    if (klass == FAS_PRIO_MOTION - 1 && !sh->set->option.no_priority) {
+        const FAS_SHARD_REQUEST *cfg = bd->pending_head[FAS_PRIO_CONFIG - 1];
+        if (cfg != NULL && seq_before(cfg->seq, r->seq))
+            return false;
+    }
+    return true;
+}
+
+static void active_push(FAS_SHARD *sh, FAS_SHARD_BOARD *bd, int klass, bool front){
+    bd->active_next[klass] = NULL;
+    if (sh->active_head[klass] == NULL) {
+        sh->active_head[klass] = sh->active_tail[klass] = bd;
+    }
+    else if (front) {
+        bd->active_next[klass] = sh->active_head[klass];
+        sh->active_head[klass] = bd;
+    }
+    else {
+        sh->active_tail[klass]->active_next[klass] = bd;
+        sh->active_tail[klass] = bd;
+    }
+}
+
+static FAS_SHARD_BOARD *active_pop(FAS_SHARD *sh, int klass){
+    FAS_SHARD_BOARD *bd = sh->active_head[klass];
+    if (bd != NULL) {
+        sh->active_head[klass] = bd->active_next[klass];
+        if (sh->active_head[klass] == NULL)
+            sh->active_tail[klass] = NULL;
+    }
+    return bd;
+}
+
+ /**@brief 기다리는 요청이 있고 차례 목록에 없는 class를 목록 끝에 넣음
+  * @return 새로 넣은 가장 높은 class (없으면 FAS_PRIO_CLASSES)*/
+static int board_activate(FAS_SHARD *sh, FAS_SHARD_BOARD *bd){
+    int first = FAS_PRIO_CLASSES;
+    for (int k = FAS_PRIO_CLASSES - 1; k >= 0; k--) {
+        if (bd->pending_head[k] != NULL && !bd->active[k]) {
+            bd->active[k] = true;
+            active_push(sh, bd, k, false);
+            first = k;
+        }
+    }
+    return first;
+}
+
+static FAS_SHARD_REQUEST *pending_pop(FAS_SHARD_BOARD *bd, int klass){
+    FAS_SHARD_REQUEST *r = bd->pending_head[klass];
+    bd->pending_head[klass] = r->next;
+    if (bd->pending_head[klass] == NULL)
+        bd->pending_tail[klass] = NULL;
+    return r;
+}
+
+ /**@brief 기다리는 요청을 class 순서로 보냄
+  * @details 높은 class의 보낼 수 있는 요청을 다 보낸 뒤에 낮은 class로 간다.
+  * 한 class 안에서는 보드가 차례마다 FAS_SHARD_QUANTUM byte씩 얻어서 그만큼 보내고 목록 끝으로 간다 (deficit round-robin).
+  * 보드 window가 찬 보드는 목록에서 빠지고 응답이 오면 다시 들어온다.
+  * shard 전체 제한(inflight_max)에 걸리면 그 보드를 목록 맨 앞에 돌려놓고 멈춘다 (자리가 나면 같은 순서로 이어감).*/
+static void shard_schedule(FAS_SHARD *sh){
+    for (int k = 0; k < FAS_PRIO_CLASSES; k++) {
+        int restart = FAS_PRIO_CLASSES;
+        FAS_SHARD_BOARD *bd;
+        while ((bd = active_pop(sh, k)) != NULL) {
+            if (shard_budget_full(sh, k)) {
+                active_push(sh, bd, k, true);
+                return;
+            }
+            if (!board_can_send(sh, bd, k)) {
+                bd->active[k] = false;
+                if (bd->pending_head[k] == NULL)
+                    bd->deficit[k] = 0;
+                continue;
+            }
+            bd->deficit[k] += FAS_SHARD_QUANTUM;
+            while (board_can_send(sh, bd, k) && !shard_budget_full(sh, k)) {
+                int cost = FRAME_HEADER_SIZE + bd->pending_head[k]->req.data_len;
+                if (cost > bd->deficit[k])
+                    break;
+                bd->deficit[k] -= cost;
+                request_send(sh, bd, pending_pop(bd, k));
+                // 설정 명령이 나가면 그 뒤를 기다리던 운전 명령이 풀릴 수 있음
+                int first = board_activate(sh, bd);
+                if (first < restart)
+                    restart = first;
+            }
+            if (bd->pending_head[k] == NULL) {
+                bd->active[k] = false;
+                bd->deficit[k] = 0;
+            }
+            else {
+                active_push(sh, bd, k, false);
+            }
+        }
+        if (restart < k)
+            k = restart - 1;
+    }
+}
+
+static void request_finish(FAS_SHARD *sh, FAS_SHARD_BOARD *bd, FAS_SHARD_REQUEST *r){
+    // 자리가 났으니 막혀 있던 class를 차례 목록에 다시 넣음 (송신은 이번 바퀴 끝 shard_schedule에서)
+    if (bd != NULL)
+        board_activate(sh, bd);
+    shard_stat(sh, STAT(completed), 1);
+    if (r->done != NULL)
+        r->done(r, r->user);
+}
+
+// 새 값이 옛 값을 완전히 대신하는 설정값 명령 (증분 위치 override는 값이 더해지므로 제외)
+static bool frame_supersedes(BYTE frame_type){
+    return frame_type == FRAME_MOVEVELOCITY || frame_type == FRAME_POSITIONABSOVERRIDE || frame_type == FRAME_VELOCITYOVERRIDE;
+}
+
+// 드라이브 상태를 바꾸지 않는 조회 명령 (합칠 때 이것만 건너뛸 수 있음)
+static bool frame_read_only(BYTE frame_type){
+    switch (frame_type) {
+        case FRAME_GETSLAVEINFO: case FRAME_GETMOTORINFO: case FRAME_GETENCODER: case FRAME_GETFIRMWAREINFO:
+        case FRAME_GETSLAVEINFOEX: case FRAME_GETROMPARAMETER: case FRAME_GETPARAMETER: case FRAME_GETALARMTYPE:
+        case FRAME_GETAXISSTATUS: case FRAME_GETIOAXISSTATUS: case FRAME_GETMOTIONSTATUS: case FRAME_GETALLSTATUS:
+        case FRAME_GETCOMMANDPOS: case FRAME_GETACTUALPOS: case FRAME_GETPOSERROR: case FRAME_GETACTUALVEL:
+        case FRAME_POSTABLEREADITEM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+ /**@brief 기다리는 요청 중 r로 바꿀 수 있는 같은 종류의 요청을 찾아 그 자리에 r을 넣음
+  * @return 바꿨으면 TRUE (옛 요청은 coalesced로 끝냄)*/
+static bool pending_coalesce(FAS_SHARD *sh, FAS_SHARD_BOARD *bd, FAS_SHARD_REQUEST *r){
+    FAS_SHARD_REQUEST *prev = NULL, *found = NULL, *found_prev = NULL;
+    int k = r->klass;
+    for (FAS_SHARD_REQUEST *p = bd->pending_head[k]; p != NULL; prev = p, p = p->next) {
+        if (p->req.frame_type == r->req.frame_type) {
+            found = p;
+            found_prev = prev;
+        }
+        else if (!frame_read_only(p->req.frame_type)) {
+            found = NULL;		// 뒤에 상태를 바꾸는 명령이 있으면 그 앞의 것과는 합칠 수 없음
+        }
+    }
+    if (found == NULL)
+        return false;
+    // 다른 class에 둔 설정 명령이 found와 r 사이에 들어왔으면 r을 앞으로 당기는 셈이므로 합치지 않음
+    const FAS_SHARD_REQUEST *cfg = bd->pending_tail[FAS_PRIO_CONFIG - 1];
+    if (k != FAS_PRIO_CONFIG - 1 && cfg != NULL && seq_before(found->seq, cfg->seq))
+        return false;
+
+    r->next = found->next;
+    if (found_prev != NULL)
+        found_prev->next = r;
+    else
+        bd->pending_head[k] = r;
+    if (bd->pending_tail[k] == found)
+        bd->pending_tail[k] = r;
+
+    found->coalesced = true;
+    found->req.status = FMM_OK;
+    shard_stat(sh, STAT(coalesced), 1);
+    request_finish(sh, bd, found);
+    return true;
+}
+
+// 정지 명령 (아직 안 보낸 운전 명령을 대신함)
+static bool frame_stops(const FAS_REQUEST *req){
+    return req->frame_type == FRAME_MOVESTOP || req->frame_type == FRAME_EMERGENCYSTOP
+        || (req->frame_type == FRAME_SERVOENABLE && req->data_len >= 1 && req->data[0] == 0);
+}
+
+static void pending_preempt(FAS_SHARD *sh, FAS_SHARD_BOARD *bd){
+    const int k = FAS_PRIO_MOTION - 1;
+    FAS_SHARD_REQUEST *r;
+    while ((r = bd->pending_head[k]) != NULL) {
+        pending_pop(bd, k);
+        r->req.status = FMM_PREEMPTED;
+        shard_stat(sh, STAT(preempted), 1);
+        request_finish(sh, bd, r);
+    }
+}
+
+static void request_accept(FAS_SHARD *sh, FAS_SHARD_REQUEST *r){
+    const FAS_SHARD_OPTION *opt = &sh->set->option;
+    FAS_SHARD_BOARD *bd = sh->board[r->req.link];
+    r->req.status = FMM_UNKNOWN_ERROR;
+    r->req.resp_len = 0;
+    r->req.retries = 0;
+    r->coalesced = false;
+    if (bd == NULL) {
+        r->req.status = FMM_INVALID_SLAVE_NUM;
+        request_finish(sh, NULL, r);
+        return;
+    }
+
+    FAS_PRIORITY prio = r->priority;
+    if (prio <= FAS_PRIO_AUTO || prio > FAS_PRIO_POLL)
+        prio = FAS_FramePriority(r->req.frame_type, r->req.data, r->req.data_len);
+    r->klass = (BYTE)((opt->no_priority ? FAS_PRIO_CONFIG : prio) - 1);
+    r->seq = bd->seq++;
+    r->queued_us = FAS_MonotonicUs();
+
+    if (!opt->no_priority && frame_stops(&r->req))
+        pending_preempt(sh, bd);
+    // 기다리지 않고 바로 나갈 요청은 합칠 상대가 없음
+    if (!opt->no_coalesce && frame_supersedes(r->req.frame_type) && bd->pending_head[r->klass] != NULL
+        && pending_coalesce(sh, bd, r))
+        return;
+
+    r->next = NULL;
+    if (bd->pending_tail[r->klass] != NULL)
+        bd->pending_tail[r->klass]->next = r;
+    else
+        bd->pending_head[r->klass] = r;
+    bd->pending_tail[r->klass] = r;
+    board_activate(sh, bd);
+}
+
+static void frame_received(FAS_SHARD *sh, BYTE *frame, int len, const struct sockaddr_in *from){
+    FAS_SHARD_BOARD *bd = board_by_addr(sh, from);
+    FAS_FRAME_VIEW view;
+    if (bd == NULL || !FAS_CodecDecode(bd->codec, frame, len, &view)) {
+        shard_stat(sh, STAT(stale), 1);
+        return;
+    }
+    BYTE sync = view.sync;
+    FAS_TRACE(FAS_TRACE_RECV, bd->iBdID, sync, len);
+
+    FAS_SHARD_REQUEST *r = bd->slot[sync];
+    if (r == NULL || r->req.frame_type != view.frame_type) {
+        shard_stat(sh, STAT(stale), 1);	// 이미 재전송해서 버린 요청의 늦은 응답
+        return;
+    }
+
+    uint64_t rtt = FAS_MonotonicUs() - r->sent_us;
+    inflight_remove(sh, bd, r);
+    r->req.status = (FMM_ERROR)view.status;
+    r->req.resp_len = (BYTE)(view.data_len > DATA_SIZE ? DATA_SIZE : view.data_len);
+    memcpy(r->req.resp, view.data, r->req.resp_len);
+    r->req.rtt_us = (uint32_t)rtt;
+    FAS_TRACE(FAS_TRACE_MATCH, bd->iBdID, sync, rtt);
+    FAS_MetricsReceived(bd->iBdID, len, r->req.status, rtt);
+    request_finish(sh, bd, r);
+}
+
+static void rx_drain(FAS_SHARD *sh){
+    struct mmsghdr msg[FAS_SHARD_IO_BATCH];
+    struct iovec iov[FAS_SHARD_IO_BATCH];
+    for (;;) {
+        for (int i = 0; i < FAS_SHARD_IO_BATCH; i++) {
+            iov[i].iov_base = sh->rx_frame[i];
+            iov[i].iov_len = BUFFER_SIZE;
+            memset(&msg[i], 0, sizeof(msg[i]));
+            msg[i].msg_hdr.msg_name = &sh->rx_addr[i];
+            msg[i].msg_hdr.msg_namelen = sizeof(sh->rx_addr[i]);
+            msg[i].msg_hdr.msg_iov = &iov[i];
+            msg[i].msg_hdr.msg_iovlen = 1;
+        }
+        int n = recvmmsg(sh->fd, msg, FAS_SHARD_IO_BATCH, MSG_DONTWAIT, NULL);
+        shard_stat(sh, STAT(syscalls), 1);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("shard recvmmsg failed");
+            return;
+        }
+        shard_stat(sh, STAT(received), n);
+        for (int i = 0; i < n; i++)
+            frame_received(sh, sh->rx_frame[i], (int)msg[i].msg_len, &sh->rx_addr[i]);
+        if (n < FAS_SHARD_IO_BATCH)
+            return;
+    }
+}
+
+static void expire(FAS_SHARD *sh, uint64_t now){
+    // 보낸 순서 = 마감 순서이므로 앞에서부터 마감 안 된 요청을 만나면 끝
+    while (sh->inflight_head != NULL && sh->inflight_head->deadline_us <= now) {
+        FAS_SHARD_REQUEST *r = sh->inflight_head;
+        FAS_SHARD_BOARD *bd = sh->board[r->req.link];
+        FAS_TRACE(FAS_TRACE_TIMEOUT, bd->iBdID, r->sync, 0);
+        FAS_MetricsTimeout(bd->iBdID);
+        inflight_remove(sh, bd, r);
+        if (r->req.retries < sh->set->option.retries) {
+            r->req.retries++;
+            shard_stat(sh, STAT(retries), 1);
+            request_send(sh, bd, r);
+        }
+        else {
+            r->req.status = FMC_TIMEOUT_ERROR;
+            shard_stat(sh, STAT(timeouts), 1);
+            request_finish(sh, bd, r);
+        }
+    }
+}
+
+// 보낼 시각 순서로 넣음, 같은 지연으로 들어오는 요청이 대부분이라 뒤에서부터 찾음
+static void deferred_insert(FAS_SHARD *sh, FAS_SHARD_REQUEST *r){
+    FAS_SHARD_REQUEST *after = sh->deferred_tail;
+    while (after != NULL && after->not_before_us > r->not_before_us)
+        after = after->prev;
+    r->prev = after;
+    r->next = after != NULL ? after->next : sh->deferred_head;
+    if (r->next != NULL)
+        r->next->prev = r;
+    else
+        sh->deferred_tail = r;
+    if (after != NULL)
+        after->next = r;
+    else
+        sh->deferred_head = r;
+}
+
+static void deferred_release(FAS_SHARD *sh, uint64_t now){
+    FAS_SHARD_REQUEST *r;
+    while ((r = sh->deferred_head) != NULL && r->not_before_us <= now) {
+        sh->deferred_head = r->next;
+        if (sh->deferred_head != NULL)
+            sh->deferred_head->prev = NULL;
+        else
+            sh->deferred_tail = NULL;
+        r->not_before_us = 0;
+        shard_stat(sh, STAT(deferred), 1);
+        request_accept(sh, r);
+    }
+}
+
+static void shard_drain_queue(FAS_SHARD *sh){
+    FAS_SHARD_REQUEST *r;
+    uint64_t now = FAS_MonotonicUs();
+    while ((r = queue_pop(sh)) != NULL) {
+        if (r->not_before_us > now) {
+            deferred_insert(sh, r);
+        }
+        else {
+            r->not_before_us = 0;
+            request_accept(sh, r);
+        }
+    }
+    deferred_release(sh, now);
+}
+
+// 잠들기 전에 queue를 한 번 더 봄 (FAS_ShardsSubmit와 짝), 다음 마감까지 남은 us (없으면 -1)
+static int64_t shard_prepare_sleep(FAS_SHARD *sh){
+    int64_t timeout_us = -1;
+    if (sh->inflight_head != NULL || sh->deferred_head != NULL) {
+        uint64_t now = FAS_MonotonicUs(), next = UINT64_MAX;
+        if (sh->inflight_head != NULL)
+            next = sh->inflight_head->deadline_us;
+        if (sh->deferred_head != NULL && sh->deferred_head->not_before_us < next)
+            next = sh->deferred_head->not_before_us;
+        timeout_us = next > now ? (int64_t)(next - now) : 0;
+    }
+    atomic_store_explicit(&sh->sleeping, true, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!queue_empty(sh))
+        timeout_us = 0;
+    return timeout_us;
+}
+
+static void shard_loop_epoll(FAS_SHARD *sh){
+    struct epoll_event events[2];
+
+    while (atomic_load_explicit(&sh->set->running, memory_order_relaxed)) {
+        shard_stat(sh, STAT(loops), 1);
+        shard_drain_queue(sh);
+        shard_schedule(sh);
+        tx_flush(sh);
+
+        int64_t timeout_us = shard_prepare_sleep(sh);
+        int n = epoll_wait(sh->epoll_fd, events, 2, timeout_us < 0 ? -1 : (int)((timeout_us + 999) / 1000));
+        shard_stat(sh, STAT(syscalls), 1);
+        atomic_store_explicit(&sh->sleeping, false, memory_order_relaxed);
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.fd == sh->event_fd) {
+                uint64_t count;
+                shard_stat(sh, STAT(syscalls), 1);
+                if (read(sh->event_fd, &count, sizeof(count)) == sizeof(count))
+                    shard_stat(sh, STAT(wakeups), 1);
+            }
+            else {
+                rx_drain(sh);
+            }
+        }
+        expire(sh, FAS_MonotonicUs());
+        shard_schedule(sh);
+        tx_flush(sh);
+    }
+}
+
+static void shard_uring_close(FAS_SHARD *sh){
+    FAS_UringFree(&sh->uring);
+    free(sh->tx_slot);
+    free(sh->tx_free);
+    sh->tx_slot = NULL;
+    sh->tx_free = NULL;
+    sh->tx_free_count = 0;
+    sh->uring_on = false;
+}
+
+// ring, 송신 칸 준비 후 multishot recvmsg/poll을 걸어 봄, 커널이 거절하면 FALSE
+static bool shard_uring_open(FAS_SHARD *sh){
+    if (!FAS_UringInit(&sh->uring, FAS_SHARD_URING_ENTRIES, sh->fd, FAS_SHARD_URING_BUFFERS))
+        return false;
+
+    // 송신 칸은 in-flight 요청 수(보드 수 x 정지 명령 class 한도)만큼이면 모자라지 않음
+    int boards = (int)atomic_load(&sh->stats[STAT(boards)]);
+    int slots = boards * class_limit(&sh->set->option, FAS_PRIO_SAFETY - 1);
+    if (slots < FAS_SHARD_IO_BATCH)
+        slots = FAS_SHARD_IO_BATCH;
+    sh->tx_slot = calloc(slots, sizeof(*sh->tx_slot));
+    sh->tx_free = malloc(slots * sizeof(*sh->tx_free));
+    if (sh->tx_slot == NULL || sh->tx_free == NULL) {
+        perror("shard io_uring slot allocation failed");
+        shard_uring_close(sh);
+        return false;
+    }
+    for (int i = 0; i < slots; i++) {
+        FAS_SHARD_TX_SLOT *t = &sh->tx_slot[i];
+        t->iov.iov_base = t->frame;
+        t->msg.msg_name = &t->addr;
+        t->msg.msg_namelen = sizeof(t->addr);
+        t->msg.msg_iov = &t->iov;
+        t->msg.msg_iovlen = 1;
+        sh->tx_free[i] = slots - 1 - i;
+    }
+    sh->tx_free_count = slots;
+
+    FAS_URING_CQE cqe;
+    FAS_UringRecvMultishot(&sh->uring, URING_RECV);
+    FAS_UringPollMultishot(&sh->uring, sh->event_fd, URING_WAKE);
+    if (FAS_UringSubmit(&sh->uring, false, 0) != 2) {
+        shard_uring_close(sh);
+        return false;
+    }
+    // multishot recvmsg를 모르는 커널은 바로 EINVAL로 끝냄
+    while (FAS_UringNext(&sh->uring, &cqe)) {
+        if (cqe.res < 0 && !(cqe.flags & FAS_URING_MORE)) {
+            shard_uring_close(sh);
+            return false;
+        }
+    }
+    sh->uring_on = true;
+    return true;
+}
+
+static void uring_complete(FAS_SHARD *sh, const FAS_URING_CQE *cqe){
+    switch (cqe->user_data & ~0xFFFFFFFFull) {
+        case URING_RECV: {
+            struct sockaddr_in from;
+            const BYTE *data;
+            int len = FAS_UringRecvData(&sh->uring, cqe, &from, &data);
+            if (len >= 0) {
+                shard_stat(sh, STAT(received), 1);
+                // provided buffer는 FAS_UringRecycle 전까지 이쪽 것이라 codec이 제자리에서 고쳐 써도 됨
+                frame_received(sh, (BYTE *)data, len, &from);
+            }
+            FAS_UringRecycle(&sh->uring, cqe);
+            // buffer가 바닥나는 등으로 multishot이 끝났으면 다시 걺
+            if (!(cqe->flags & FAS_URING_MORE))
+                FAS_UringRecvMultishot(&sh->uring, URING_RECV);
+            break;
+        }
+        case URING_WAKE: {
+            uint64_t count;
+            shard_stat(sh, STAT(syscalls), 1);
+            if (read(sh->event_fd, &count, sizeof(count)) == sizeof(count))
+                shard_stat(sh, STAT(wakeups), 1);
+            if (!(cqe->flags & FAS_URING_MORE))
+                FAS_UringPollMultishot(&sh->uring, sh->event_fd, URING_WAKE);
+            break;
+        }
+        case URING_SEND:
+            // 실패한 송신은 시간 초과 재전송에 맡김
+            sh->tx_free[sh->tx_free_count++] = (int)(cqe->user_data & 0xFFFFFFFFu);
+            break;
+    }
+}
+
+static void shard_loop_uring(FAS_SHARD *sh){
+    FAS_URING_CQE cqe;
+
+    while (atomic_load_explicit(&sh->set->running, memory_order_relaxed)) {
+        shard_stat(sh, STAT(loops), 1);
+        shard_drain_queue(sh);
+        shard_schedule(sh);
+        tx_flush(sh);
+
+        // 송신 SQE 제출, 완료 수거, 다음 마감까지 대기를 syscall 한 번으로
+        int64_t timeout_us = shard_prepare_sleep(sh);
+        uint64_t enters = sh->uring.enters;
+        FAS_UringSubmit(&sh->uring, true, timeout_us);
+        shard_stat(sh, STAT(syscalls), sh->uring.enters - enters);
+        atomic_store_explicit(&sh->sleeping, false, memory_order_relaxed);
+
+        while (FAS_UringNext(&sh->uring, &cqe))
+            uring_complete(sh, &cqe);
+        expire(sh, FAS_MonotonicUs());
+        shard_schedule(sh);
+        tx_flush(sh);
+    }
+    shard_uring_close(sh);
+}
+
+static void *shard_thread_main(void *arg){
+    FAS_SHARD *sh = arg;
+    FAS_IO_BACKEND backend = FAS_IO_EPOLL;
+    if (sh->set->option.backend == FAS_IO_URING) {
+        if (shard_uring_open(sh))
+            backend = FAS_IO_URING;
+        else if (sh->index == 0)
+            fprintf(stderr, "io_uring not available, shards use epoll\n");
+    }
+    atomic_store(&sh->stats[STAT(backend)], backend);
+
+    if (backend == FAS_IO_URING)
+        shard_loop_uring(sh);
+    else
+        shard_loop_epoll(sh);
+
+    struct timespec cpu;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    shard_stat(sh, STAT(cpu_us), (uint64_t)cpu.tv_sec * 1000000u + (uint64_t)cpu.tv_nsec / 1000u);
+    return NULL;
+}
+
+/************************************************************************************************************************************
+ ************************************************** 준비/정리 *********************************************************************
+ ************************************************************************************************************************************/
+
+static void shard_close(FAS_SHARD *sh){
+    if (sh->fd >= 0)
+        close(sh->fd);
+    if (sh->epoll_fd >= 0)
+        close(sh->epoll_fd);
+    if (sh->event_fd >= 0)
+        close(sh->event_fd);
+    for (int i = 0; i < FAS_MAX_BOARD; i++)
+        free(sh->board[i]);
+    free(sh);
+}
+
+static FAS_SHARD *shard_open(FAS_SHARDS *set, int index){
+    FAS_SHARD *sh = aligned_alloc(FAS_CACHELINE, sizeof(FAS_SHARD));
+    if (sh == NULL) {
+        perror("shard allocation failed");
+        return NULL;
+    }
+    memset(sh, 0, sizeof(*sh));
+    sh->set = set;
+    sh->index = index;
+    for (uint64_t i = 0; i < FAS_SHARD_QUEUE; i++)
+        atomic_init(&sh->queue[i].seq, i);
+
+    sh->fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    sh->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    sh->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (sh->fd < 0 || sh->epoll_fd < 0 || sh->event_fd < 0) {
+        perror("shard socket/epoll creation failed");
+        shard_close(sh);
+        return NULL;
+    }
+
+    // 보드 수백 대의 응답이 한꺼번에 와도 버리지 않도록 수신 buffer를 키움
+    int rcvbuf = 4 << 20;
+    setsockopt(sh->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct sockaddr_in local = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_ANY), .sin_port = 0 };
+    if (bind(sh->fd, (struct sockaddr *)&local, sizeof(local)) < 0) {
+        perror("shard bind failed");
+        shard_close(sh);
+        return NULL;
+    }
+
+    struct epoll_event ev = { .events = EPOLLIN };
+    ev.data.fd = sh->fd;
+    epoll_ctl(sh->epoll_fd, EPOLL_CTL_ADD, sh->fd, &ev);
+    ev.data.fd = sh->event_fd;
+    epoll_ctl(sh->epoll_fd, EPOLL_CTL_ADD, sh->event_fd, &ev);
+    return sh;
+}
+
+ /**@brief shard 준비 (소켓, epoll, eventfd), thread는 FAS_ShardsStart에서 시작
+  * @param int shards I/O thread 수 (1 ~ FAS_SHARD_MAX, 보통 코어 수)
+  * @param const FAS_SHARD_OPTION *option NULL이면 기본값
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ShardsInit(FAS_SHARDS *set, int shards, const FAS_SHARD_OPTION *option){
+    memset(set, 0, sizeof(*set));
+    if (shards < 1 || shards > FAS_SHARD_MAX) {
+        fprintf(stderr, "Invalid shard count: %d\n", shards);
+        return false;
+    }
+    if (option != NULL)
+        set->option = *option;
+    if (set->option.window <= 0)
+        set->option.window = FAS_DEFAULT_WINDOW;
+    if (set->option.window > FAS_WINDOW_MAX)
+        set->option.window = FAS_WINDOW_MAX;
+    if (set->option.timeout_ms <= 0)
+        set->option.timeout_ms = FAS_DEFAULT_TIMEOUT_MS;
+    if (set->option.retries == 0)
+        set->option.retries = FAS_DEFAULT_RETRIES;
+    else if (set->option.retries < 0)
+        set->option.retries = 0;
+    if (set->option.reserve == 0)
+        set->option.reserve = 1;
+    else if (set->option.reserve < 0)
+        set->option.reserve = 0;
+    if (set->option.poll_window <= 0)
+        set->option.poll_window = set->option.window - set->option.reserve;
+    if (set->option.poll_window < 1)
+        set->option.poll_window = 1;
+    if (set->option.poll_window > set->option.window)
+        set->option.poll_window = set->option.window;
+    if (set->option.inflight_max < 0)
+        set->option.inflight_max = 0;
+    if (set->option.backend == FAS_IO_AUTO) {
+        const char *env = getenv("FAS_IO_BACKEND");
+        set->option.backend = (env != NULL && strcmp(env, "uring") == 0) ? FAS_IO_URING : FAS_IO_EPOLL;
+    }
+
+    for (int i = 0; i < shards; i++) {
+        set->shard[i] = shard_open(set, i);
+        if (set->shard[i] == NULL) {
+            FAS_ShardsFree(set);
+            return false;
+        }
+        set->count++;
+    }
+    return true;
+}
+
+ /**@brief 보드 등록 (FAS_ShardsStart 전에), 보드는 FAS_ShardOf가 고른 shard에 붙음
+  * @param const char *ip "192.168.0.2" 형식
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ShardsAddBoard(FAS_SHARDS *set, int iBdID, const char *ip){
+    if (atomic_load(&set->running) || iBdID < 0 || iBdID >= FAS_MAX_BOARD)
+        return false;
+    FAS_SHARD *sh = set->shard[FAS_ShardOf(set, iBdID)];
+    if (sh->board[iBdID] != NULL)
+        return false;
+
+    FAS_SHARD_BOARD *bd = calloc(1, sizeof(*bd));
+    if (bd == NULL) {
+        perror("shard board allocation failed");
+        return false;
+    }
+    bd->iBdID = iBdID;
+    bd->codec = &FAS_CodecFastech;
+    bd->sync_no = (BYTE)rand();
+    bd->addr.sin_family = AF_INET;
+    bd->addr.sin_port = htons(PORT_UDP);
+    if (inet_pton(AF_INET, ip, &bd->addr.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid address: %s\n", ip);
+        free(bd);
+        return false;
+    }
+
+    addr_insert(sh, bd);
+    sh->board[iBdID] = bd;
+    shard_stat(sh, STAT(boards), 1);
+    return true;
+}
+
+ /**@brief 보드의 프레임 변형 바꾸기 (FAS_ShardsAddBoard 뒤, FAS_ShardsStart 전에), 목적지 port도 codec의 UDP port로 바뀜
+  * @param const FAS_CODEC *codec Sync No.를 쓰는 codec만 (serial처럼 Slave ID로 짝을 맞추면 window를 못 씀)
+  * @return boolean 성공시 TRUE, 없는 보드나 Sync No.가 없는 codec이면 FALSE*/
+bool FAS_ShardsSetCodec(FAS_SHARDS *set, int iBdID, const FAS_CODEC *codec){
+    if (atomic_load(&set->running) || iBdID < 0 || iBdID >= FAS_MAX_BOARD || !codec->sync)
+        return false;
+    FAS_SHARD *sh = set->shard[FAS_ShardOf(set, iBdID)];
+    FAS_SHARD_BOARD *bd = sh->board[iBdID];
+    if (bd == NULL)
+        return false;
+
+    bd->codec = codec;
+    bd->addr.sin_port = htons(codec->port_udp);
+    // addr_slot은 주소 hash의 linear probing이라 한 칸만 지우면 뒤 보드를 못 찾으므로 shard 표를 다시 만듦 (시작 전 한 번)
+    memset(sh->addr_slot, 0, sizeof(sh->addr_slot));
+    for (int b = 0; b < FAS_MAX_BOARD; b++)
+        if (sh->board[b] != NULL)
+            addr_insert(sh, sh->board[b]);
+    return true;
+}
+
+ /**@brief shard thread 시작, option.pin_cpu면 shard i를 CPU (i % CPU 수)에 고정
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_ShardsStart(FAS_SHARDS *set){
+    if (atomic_exchange(&set->running, true))
+        return false;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 0; i < set->count; i++) {
+        FAS_SHARD *sh = set->shard[i];
+        if (pthread_create(&sh->thread, NULL, shard_thread_main, sh) != 0) {
+            perror("shard thread create failed");
+            atomic_store(&set->running, false);
+            for (int j = 0; j < i; j++) {
+                shard_wake(set->shard[j]);
+                pthread_join(set->shard[j]->thread, NULL);
+            }
+            return false;
+        }
+        if (set->option.pin_cpu && cpus > 0) {
+            cpu_set_t cpu;
+            CPU_ZERO(&cpu);
+            CPU_SET(i % cpus, &cpu);
+            pthread_setaffinity_np(sh->thread, sizeof(cpu), &cpu);
+        }
+    }
+    return true;
+}
+
+ /**@brief shard thread 정지, 남아 있던 요청은 FMM_NOT_OPEN으로 끝냄 (callback은 호출한 thread에서)*/
+void FAS_ShardsStop(FAS_SHARDS *set){
+    if (!atomic_exchange(&set->running, false))
+        return;
+    for (int i = 0; i < set->count; i++)
+        shard_wake(set->shard[i]);
+    for (int i = 0; i < set->count; i++)
+        pthread_join(set->shard[i]->thread, NULL);
+
+    for (int i = 0; i < set->count; i++) {
+        FAS_SHARD *sh = set->shard[i];
+        FAS_SHARD_REQUEST *r;
+        sh->tx_count = 0;
+        while ((r = sh->inflight_head) != NULL) {
+            inflight_remove(sh, sh->board[r->req.link], r);
+            r->req.status = FMM_NOT_OPEN;
+            shard_stat(sh, STAT(completed), 1);
+            if (r->done != NULL)
+                r->done(r, r->user);
+        }
+        for (int b = 0; b < FAS_MAX_BOARD; b++) {
+            FAS_SHARD_BOARD *bd = sh->board[b];
+            for (int k = 0; bd != NULL && k < FAS_PRIO_CLASSES; k++) {
+                while ((r = bd->pending_head[k]) != NULL) {
+                    pending_pop(bd, k);
+                    r->req.status = FMM_NOT_OPEN;
+                    shard_stat(sh, STAT(completed), 1);
+                    if (r->done != NULL)
+                        r->done(r, r->user);
+                }
+                bd->active[k] = false;
+                bd->deficit[k] = 0;
+            }
+        }
+        for (int k = 0; k < FAS_PRIO_CLASSES; k++)
+            sh->active_head[k] = sh->active_tail[k] = NULL;
+        while ((r = sh->deferred_head) != NULL) {
+            sh->deferred_head = r->next;
+            r->not_before_us = 0;
+            r->req.status = FMM_NOT_OPEN;
+            shard_stat(sh, STAT(completed), 1);
+            if (r->done != NULL)
+                r->done(r, r->user);
+        }
+        sh->deferred_tail = NULL;
+        while ((r = queue_pop(sh)) != NULL) {
+            r->req.status = FMM_NOT_OPEN;
+            shard_stat(sh, STAT(completed), 1);
+            if (r->done != NULL)
+                r->done(r, r->user);
+        }
+    }
+}
+
+ /**@brief FAS_ShardsInit이 잡은 자원 반환 (돌고 있으면 먼저 멈춤)*/
+void FAS_ShardsFree(FAS_SHARDS *set){
+    FAS_ShardsStop(set);
+    for (int i = 0; i < set->count; i++)
+        shard_close(set->shard[i]);
+    set->count = 0;
+}
+
+ /**@brief shard 하나의 통계 사본 (lock 없이 읽음, shard thread는 멈추지 않음)*/
+void FAS_ShardsGetStats(FAS_SHARDS *set, int shard, FAS_SHARD_STATS *stats){
+    uint64_t *out = (uint64_t *)stats;
+    memset(stats, 0, sizeof(*stats));
+    if (shard < 0 || shard >= set->count)
+        return;
+    for (size_t i = 0; i < sizeof(*stats) / sizeof(uint64_t); i++)
+        out[i] = atomic_load_explicit(&set->shard[shard]->stats[i], memory_order_relaxed);
+}
@@ -0,0 +1,235 @@
+
+#pragma once
+
+#ifndef FAS_SHARD_DEFINE
+#define FAS_SHARD_DEFINE
+
+/**
+ * @file FAS_Shard.h
+ * @brief 보드를 여러 I/O thread(shard)로 나눠서 주고받는 UDP transport
+ * @details shard마다 thread 하나, UDP 소켓 하나, epoll 하나와 맡은 보드 목록을 가진다.
+ * 보드는 보드 번호의 hash로 shard 하나에 정해지고, 그 보드의 Sync No./in-flight 표는 그 shard thread만 만진다.
+ * 다른 thread에서 보내는 요청은 shard마다 있는 MPSC queue로 넘어가고, 자고 있는 shard는 eventfd로 깨운다.
+ * 송신은 한 바퀴 동안 모아서 sendmmsg로, 수신은 recvmmsg로 한꺼번에 처리한다.
+ * 응답은 보낸 주소와 Sync No.로 요청과 짝을 맞추고, 시간 초과된 요청은 새 Sync No.로 다시 보낸다.
+ * 프레임은 보드마다 고른 codec(기본 FAS_CodecFastech, FAS_ShardsSetCodec)으로 만들고 푼다.
+ * 완료 callback은 그 보드를 맡은 shard thread에서 불린다 (callback 안에서 다시 FAS_ShardsSubmit 가능).
+ * I/O backend는 epoll(sendmmsg/recvmmsg)과 io_uring(FAS_Uring.h) 중에서 실행 중에 고른다.
+ * io_uring은 multishot recvmsg를 걸어 두고 송신 SQE 제출과 CQE 수거를 한 번의 io_uring_enter로 하므로
+ * 바쁠 때 한 바퀴에 syscall이 하나뿐이다. 커널이 지원하지 않으면 그 shard는 epoll로 돌아간다.
+ * window가 차서 기다리는 설정값 명령(MoveVelocity, 절대 위치/속도 override)은 같은 보드, 같은 종류의
+ * 새 요청이 오면 그 자리에서 새 요청으로 바뀐다 (옛 요청은 coalesced로 끝남). 그 사이에 상태를 바꾸는
+ * 다른 명령(ServoEnable, MoveStop, EmergencyStop 등)이 있으면 순서가 바뀌므로 합치지 않는다.
+ *
+ * 송신은 우선순위 class(정지 > 운전 > 설정 > 조회) 순서로 정하고, 같은 class 안에서는 보드끼리
+ * deficit round-robin으로 돌아가며 보내서 요청을 몰아 넣는 보드가 다른 보드를 밀어내지 못한다.
+ * 보드마다 window 위에 운전/정지 명령만 쓰는 reserve 칸이 있어 조회가 window를 채우고 있어도
+ * 같은 보드의 운전 명령은 기다리지 않는다 (정지 명령은 그 위에 한 칸 더).
+ * 드라이브는 받은 프레임을 하나씩 처리하므로 운전 명령은 먼저 가 있는 조회가 끝나야 처리된다.
+ * 그래서 조회는 보드마다 poll_window개(기본 window - reserve)까지만 보내 두어 운전 명령 앞에 쌓이는 조회 수를 줄인다.
+ * option.inflight_max를 주면 shard 전체의 in-flight 수도 제한하고 (정지 명령 제외), 자리가 나면 높은 class부터 받는다.
+ * 같은 보드에서 운전 명령은 먼저 들어온 설정 명령을 앞지르지 않고, 정지 명령은 아직 안 보낸 운전 명령을 대신한다
+ * (대신한 운전 명령은 req.status FMM_PREEMPTED로 끝난다).
+ * class별 대기 시간(들어온 때부터 송신까지)은 FAS_SHARD_STATS의 class_* 항목으로 본다.
+ * not_before_us를 준 요청은 그 시각까지 shard 안에서 기다렸다가 보통 요청처럼 들어간다 (주기 조회, FAS_Script의 대기).
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include "FAS_Pipeline.h"
+#include "FAS_Metrics.h"
+#include "FAS_Uring.h"
+
+#define FAS_SHARD_MAX 16
+#define FAS_SHARD_QUEUE 4096				// shard마다 MPSC queue 크기 (2^n)
+#define FAS_SHARD_ADDR_SLOTS 512			// 응답 주소 -> 보드 hash 칸 수 (2^n, 보드 수의 2배 이상)
+#define FAS_SHARD_IO_BATCH 64				// sendmmsg/recvmmsg 한 번에 처리하는 프레임 수
+#define FAS_SHARD_URING_ENTRIES 256			// io_uring SQ 크기
+#define FAS_SHARD_URING_BUFFERS 1024		// io_uring 수신 buffer 수 (2^n)
+
+/**@brief shard I/O backend*/
+typedef enum _FAS_IO_BACKEND
+{
+	FAS_IO_AUTO = 0,				// 환경 변수 FAS_IO_BACKEND=uring|epoll, 없으면 epoll
+	FAS_IO_EPOLL,
+	FAS_IO_URING,					// 지원하지 않는 커널이면 epoll로 대신함
+} FAS_IO_BACKEND;
+
+#define FAS_PRIO_CLASSES 4
+#define FAS_SHARD_QUANTUM BUFFER_SIZE		// deficit round-robin에서 보드가 한 바퀴에 얻는 byte 수
+
+/**@brief 송신 우선순위 class (번호가 작을수록 먼저)*/
+typedef enum _FAS_PRIORITY
+{
+	FAS_PRIO_AUTO = 0,				// frame type으로 정함 (FAS_FramePriority)
+	FAS_PRIO_SAFETY,				// 정지, 비상정지, 서보 OFF
+	FAS_PRIO_MOTION,				// 운전, override, 서보 ON
+	FAS_PRIO_CONFIG,				// 파라미터, position table, 위치 설정, 알람 리셋
+	FAS_PRIO_POLL,					// 상태/위치 조회
+} FAS_PRIORITY;
+
+struct _FAS_SHARD_REQUEST;
+typedef void (*FAS_SHARD_DONE)(struct _FAS_SHARD_REQUEST *req, void *user);
+
+/**@brief shard로 보내는 요청 (호출자가 메모리를 가지고, done이 불릴 때까지 유지)
+ * req.link에는 보드 번호를 넣는다: FAS_RequestInit(&r->req, iBdID, frame_type, data, len)*/
+typedef struct _FAS_SHARD_REQUEST
+{
+	FAS_REQUEST req;
+	FAS_SHARD_DONE done;
+	void *user;
+	BYTE priority;						// FAS_PRIORITY, FAS_PRIO_AUTO면 frame type으로 정함
+	bool coalesced;						// 보내기 전에 같은 종류의 새 요청으로 바뀜 (req.status는 FMM_OK, 응답 없음)
+	uint64_t not_before_us;				// 0이 아니면 이 시각(FAS_MonotonicUs) 전에는 보내지 않음, shard가 받으면 0으로 돌림
+
+	// shard 내부 상태
+	BYTE klass;							// 실제 class 번호 (0 ~ FAS_PRIO_CLASSES-1)
+	uint32_t seq;						// 보드 안에서 들어온 순번
+	uint64_t queued_us;					// shard가 받은 시각
+	uint64_t sent_us;
+	uint64_t deadline_us;
+	BYTE sync;
+	struct _FAS_SHARD_REQUEST *next;	// pending/in-flight 목록
+	struct _FAS_SHARD_REQUEST *prev;
+} FAS_SHARD_REQUEST;
+
+/**@brief shard가 맡은 보드 하나 (shard thread 전용)*/
+typedef struct _FAS_SHARD_BOARD
+{
+	int iBdID;
+	struct sockaddr_in addr;
+	const FAS_CODEC *codec;				// 프레임 변형 (기본 FAS_CodecFastech, Sync No.를 쓰는 codec만)
+	BYTE sync_no;
+	int inflight;
+	uint32_t seq;
+	FAS_SHARD_REQUEST *slot[256];		// Sync No. -> in-flight 요청
+	FAS_SHARD_REQUEST *pending_head[FAS_PRIO_CLASSES];	// class별로 보내기를 기다리는 요청
+	FAS_SHARD_REQUEST *pending_tail[FAS_PRIO_CLASSES];
+	int deficit[FAS_PRIO_CLASSES];		// deficit round-robin 남은 byte
+	bool active[FAS_PRIO_CLASSES];		// class별 송신 차례 목록에 있음
+	struct _FAS_SHARD_BOARD *active_next[FAS_PRIO_CLASSES];
+} FAS_SHARD_BOARD;
+
+/**@brief shard 하나의 통계 (FAS_ShardsGetStats로 읽음)*/
+typedef struct _FAS_SHARD_STATS
+{
+	uint64_t boards;
+	uint64_t submitted;
+	uint64_t queue_full;			// queue가 차서 FAS_ShardsSubmit가 실패한 횟수
+	uint64_t sent;
+	uint64_t received;
+	uint64_t completed;
+	uint64_t timeouts;				// 재시도까지 다 쓰고 실패한 요청
+	uint64_t retries;
+	uint64_t coalesced;				// 보내기 전에 새 요청으로 바뀐 설정값 명령
+	uint64_t deferred;				// not_before_us 때문에 기다렸다 들어간 요청
+	uint64_t preempted;				// 보내기 전에 정지 명령으로 대신한 운전 명령
+	uint64_t class_sent[FAS_PRIO_CLASSES];		// class별 처음 송신한 요청 수
+	uint64_t class_queue_us[FAS_PRIO_CLASSES];	// class별 대기 시간 합 (shard가 받은 때부터 처음 송신까지)
+	uint64_t class_queue_max_us[FAS_PRIO_CLASSES];
+	uint64_t stale;					// 짝이 없는 응답 (늦게 온 응답, 모르는 주소)
+	uint64_t wakeups;				// eventfd로 깨운 횟수
+	uint64_t loops;
+	uint64_t syscalls;				// I/O syscall 수 (epoll_wait, sendmmsg, recvmmsg, io_uring_enter 등)
+	uint64_t cpu_us;				// shard thread CPU 시간 (thread가 끝날 때 더함)
+	uint64_t backend;				// 실제로 쓰는 FAS_IO_BACKEND
+} FAS_SHARD_STATS;
+
+/**@brief io_uring 송신 칸 (CQE가 올 때까지 frame과 msghdr를 유지)*/
+typedef struct _FAS_SHARD_TX_SLOT
+{
+	BYTE frame[BUFFER_SIZE];
+	struct sockaddr_in addr;
+	struct iovec iov;
+	struct msghdr msg;
+} FAS_SHARD_TX_SLOT;
+
+/**@brief MPSC queue 칸 (bounded, 칸마다 순번)*/
+typedef struct _FAS_SHARD_CELL
+{
+	_Atomic uint64_t seq;
+	FAS_SHARD_REQUEST *req;
+} FAS_SHARD_CELL;
+
+typedef struct _FAS_SHARD
+{
+	struct _FAS_SHARDS *set;
+	int index;
+	int fd;
+	int epoll_fd;
+	int event_fd;
+	pthread_t thread;
+
+	// MPSC queue: 아무 thread나 넣고 shard thread만 꺼냄
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t enqueue_pos;
+	_Alignas(FAS_CACHELINE) uint64_t dequeue_pos;
+	_Atomic bool sleeping;			// epoll_wait 들어가기 직전 TRUE
+	FAS_SHARD_CELL queue[FAS_SHARD_QUEUE];
+
+	// shard thread 전용
+	FAS_SHARD_BOARD *board[FAS_MAX_BOARD];
+	FAS_SHARD_BOARD *addr_slot[FAS_SHARD_ADDR_SLOTS];
+	FAS_SHARD_REQUEST *inflight_head;	// 보낸 순서 = 시간 초과 순서
+	FAS_SHARD_REQUEST *inflight_tail;
+	FAS_SHARD_REQUEST *deferred_head;	// not_before_us 순서로 기다리는 요청
+	FAS_SHARD_REQUEST *deferred_tail;
+	int inflight;					// shard 전체 in-flight 수
+	FAS_SHARD_BOARD *active_head[FAS_PRIO_CLASSES];	// class별로 보낼 요청이 있는 보드 (deficit round-robin 순서)
+	FAS_SHARD_BOARD *active_tail[FAS_PRIO_CLASSES];
+	int tx_count;
+	BYTE tx_frame[FAS_SHARD_IO_BATCH][BUFFER_SIZE];
+	int tx_len[FAS_SHARD_IO_BATCH];
+	struct sockaddr_in tx_addr[FAS_SHARD_IO_BATCH];
+	BYTE rx_frame[FAS_SHARD_IO_BATCH][BUFFER_SIZE];
+	struct sockaddr_in rx_addr[FAS_SHARD_IO_BATCH];
+
+	// io_uring backend (shard thread 전용, thread 시작할 때 준비)
+	bool uring_on;
+	FAS_URING uring;
+	FAS_SHARD_TX_SLOT *tx_slot;		// 보드 수 x (window + reserve + 1) 칸
+	int *tx_free;					// 비어 있는 칸 번호 stack
+	int tx_free_count;
+
+	// 통계 (submitted/queue_full은 요청 thread, 나머지는 shard thread가 relaxed로 더함)
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t stats[sizeof(FAS_SHARD_STATS) / sizeof(uint64_t)];
+} FAS_SHARD;
+
+/**@brief FAS_ShardsInit 설정, 0인 항목은 기본값 사용*/
+typedef struct _FAS_SHARD_OPTION
+{
+	int window;					// 보드당 동시에 보내 둘 요청 수 (FAS_DEFAULT_WINDOW)
+	int timeout_ms;				// FAS_DEFAULT_TIMEOUT_MS
+	int retries;				// FAS_DEFAULT_RETRIES, 음수면 재시도 없음
+	bool pin_cpu;				// shard i를 CPU i에 고정
+	bool no_coalesce;			// TRUE면 기다리는 설정값 명령도 합치지 않고 전부 보냄
+	int inflight_max;			// shard 전체에서 동시에 보내 둘 요청 수 (0이면 제한 없음, 정지 명령은 이 제한을 받지 않음)
+	int reserve;				// 보드마다 window 위에 운전/정지 명령만 쓰는 칸 (0이면 1, 음수면 없음)
+	int poll_window;			// 보드마다 조회가 동시에 보내 둘 수 있는 수 (0이면 window - reserve, 최소 1, window 이하)
+	bool no_priority;			// TRUE면 class 없이 들어온 순서대로 (예전 동작, 비교용)
+	FAS_IO_BACKEND backend;
+} FAS_SHARD_OPTION;
+
+typedef struct _FAS_SHARDS
+{
+	int count;
+	FAS_SHARD_OPTION option;
+	_Atomic bool running;
+	FAS_SHARD *shard[FAS_SHARD_MAX];
+} FAS_SHARDS;
+
+bool FAS_ShardsInit(FAS_SHARDS *set, int shards, const FAS_SHARD_OPTION *option);
+void FAS_ShardsFree(FAS_SHARDS *set);
+bool FAS_ShardsAddBoard(FAS_SHARDS *set, int iBdID, const char *ip);
+bool FAS_ShardsSetCodec(FAS_SHARDS *set, int iBdID, const FAS_CODEC *codec);
+bool FAS_ShardsStart(FAS_SHARDS *set);
+void FAS_ShardsStop(FAS_SHARDS *set);
+
+FAS_PRIORITY FAS_FramePriority(BYTE frame_type, const BYTE *data, int data_len);
+int FAS_ShardOf(const FAS_SHARDS *set, int iBdID);
+bool FAS_ShardsSubmit(FAS_SHARDS *set, FAS_SHARD_REQUEST *req);
+void FAS_ShardsGetStats(FAS_SHARDS *set, int shard, FAS_SHARD_STATS *stats);
+
+#endif	//FAS_SHARD_DEFINE
@@ -0,0 +1,340 @@
+/**
+ * @file FAS_StandIn.c
+ * @brief 가짜 드라이브 구현 (명령마다 FMM_OK, 속도 명령은 위치를 적분해서 움직이는 것처럼 보이게 함)
+ * @details 위치 결정 운전(MoveSingleAxisAbs/IncPos)과 원점 복귀는 지정 속도로 목표까지 적분한 뒤 INPOSITION이 된다.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include "FAS_StandIn.h"
+#include "ReturnCodes_Define.h"
+#include "FAS_Status.h"
+
+static uint64_t standin_us(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static int put_status(FAS_STANDIN *drive, BYTE *p){
+    int32_t pos_error = drive->command_pos - drive->actual_pos;
+    fas_put_le32(p, 0);							// input
+    fas_put_le32(p + 4, 0);						// output
+    fas_put_le32(p + 8, drive->axis_status);
+    fas_put_le32(p + 12, (uint32_t)drive->command_pos);
+    fas_put_le32(p + 16, (uint32_t)drive->actual_pos);
+    fas_put_le32(p + 20, (uint32_t)pos_error);
+    fas_put_le32(p + 24, (uint32_t)drive->actual_vel);
+    p[28] = 0; p[29] = 0;						// PT item
+    return 30;
+}
+
+// 받은 명령으로 상태를 바꾸고 응답 data(통신 상태 뒤)를 채움, data 길이 반환
+static int standin_handle(FAS_STANDIN *drive, const BYTE *req, int req_data_len, BYTE type, BYTE *out){
+    if (type != 0 && type == atomic_load_explicit(&drive->reject_type, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&drive->rejected, 1, memory_order_relaxed);
+        return -FMP_FRAMETYPEERROR;
+    }
+    switch (type) {
+        case FRAME_GETSLAVEINFO:
+        case FRAME_GETMOTORINFO:
+        case FRAME_GETENCODER:
+        case FRAME_GETFIRMWAREINFO:
+        case FRAME_GETSLAVEINFOEX: {
+            static const char info[] = "Ezi-SERVO Plus-E stand-in";
+            out[0] = 1;
+            memcpy(&out[1], info, sizeof(info) - 1);
+            return (int)sizeof(info);
+        }
+        case FRAME_GETROMPARAMETER:
+        case FRAME_GETPARAMETER:
+            if (req_data_len < 1 || req[0] >= FAS_STANDIN_PARAMS)
+                return -FMP_DATAERROR;
+            fas_put_le32(out, (uint32_t)drive->param[req[0]]);
+            return 4;
+        case FRAME_SETPARAMETER:
+            if (req_data_len < 5 || req[0] >= FAS_STANDIN_PARAMS)
+                return -FMP_DATAERROR;
+            drive->param[req[0]] = (int32_t)fas_get_le32(&req[1]);
+            drive->param_writes++;
+            drive->param_written |= 1ull << req[0];
+            return 0;
+        case FRAME_SAVEALLPARAMETERS:
+            drive->param_rom_saves++;
+            return 0;
+        case FRAME_SERVOENABLE:
+            if (req_data_len >= 1 && req[0])
+                drive->axis_status |= FAS_AXIS_SERVOON;
+            else
+                drive->axis_status &= ~FAS_AXIS_SERVOON;
+            return 0;
+        case FRAME_GETALARMTYPE:
+            out[0] = atomic_load_explicit(&drive->alarm, memory_order_relaxed);
+            return 1;
+        case FRAME_SERVOALARMRESET:
+            atomic_store_explicit(&drive->alarm, 0, memory_order_relaxed);
+            drive->axis_status &= ~FAS_AXIS_ERROR_MASK;
+            return 0;
+        case FRAME_MOVESTOP:
+        case FRAME_EMERGENCYSTOP:
+            drive->actual_vel = 0;
+            drive->positioning = false;
+            drive->axis_status &= ~FAS_AXIS_ORIGINRETURNING;
+            drive->axis_status &= ~FAS_AXIS_MOTIONING;
+            drive->axis_status |= FAS_AXIS_INPOSITION;
+            return 0;
+        case FRAME_MOVESINGLEAXISABSPOS:
+        case FRAME_MOVESINGLEAXISINCPOS: {
+            if (req_data_len < 8)
+                return -FMP_DATAERROR;
+            int32_t pos = (int32_t)fas_get_le32(req);
+            int32_t speed = (int32_t)fas_get_le32(req + 4);
+            if (!(drive->axis_status & FAS_AXIS_SERVOON))
+                return -FMP_RUNFAIL;
+            drive->target_pos = type == FRAME_MOVESINGLEAXISABSPOS ? pos : drive->actual_pos + pos;
+            drive->actual_vel = drive->target_pos >= drive->actual_pos ? speed : -speed;
+            drive->positioning = true;
+            drive->axis_status = (drive->axis_status | FAS_AXIS_MOTIONING) & ~FAS_AXIS_INPOSITION;
+            return 0;
+        }
+        case FRAME_MOVEORIGINSINGLEAXIS:
+            if (!(drive->axis_status & FAS_AXIS_SERVOON))
+                return -FMP_RUNFAIL;
+            drive->target_pos = 0;
+            drive->actual_vel = drive->actual_pos > 0 ? -FAS_STANDIN_ORIGIN_SPEED : FAS_STANDIN_ORIGIN_SPEED;
+            drive->positioning = true;
+            drive->axis_status = (drive->axis_status | FAS_AXIS_MOTIONING | FAS_AXIS_ORIGINRETURNING)
+                                 & ~(FAS_AXIS_INPOSITION | FAS_AXIS_ORIGINRETOK);
+            return 0;
+        case FRAME_MOVEVELOCITY:
+            if (req_data_len < 5)
+                return -FMP_DATAERROR;
+            drive->positioning = false;
+            drive->actual_vel = (int32_t)fas_get_le32(req) * (req[4] ? 1 : -1);
+            drive->axis_status = (drive->axis_status | FAS_AXIS_MOTIONING) & ~FAS_AXIS_INPOSITION;
+            return 0;
+        case FRAME_VELOCITYOVERRIDE:
+            if (req_data_len < 4)
+                return -FMP_DATAERROR;
+            drive->actual_vel = (drive->actual_vel < 0 ? -1 : 1) * (int32_t)fas_get_le32(req);
+            return 0;
+        case FRAME_POSITIONABSOVERRIDE:
+        case FRAME_SETCOMMANDPOS:
+            if (req_data_len < 4)
+                return -FMP_DATAERROR;
+            drive->command_pos = (int32_t)fas_get_le32(req);
+            return 0;
+        case FRAME_SETACTUALPOS:
+            if (req_data_len < 4)
+                return -FMP_DATAERROR;
+            drive->actual_pos = (int32_t)fas_get_le32(req);
+            return 0;
+        case FRAME_CLEARPOSITION:
+            drive->command_pos = drive->actual_pos = 0;
+            return 0;
+        case FRAME_POSTABLEREADITEM:
+        case FRAME_POSTABLEWRITEITEM: {
+            int item = req_data_len >= 2 ? req[0] | (req[1] << 8) : FAS_STANDIN_PT_ITEMS;
+            if (item >= FAS_STANDIN_PT_ITEMS)
+                return -FMP_DATAERROR;
+            if (type == FRAME_POSTABLEREADITEM) {
+                memcpy(out, drive->pt[item], FAS_STANDIN_PT_SIZE);
+                return FAS_STANDIN_PT_SIZE;
+            }
+            if (req_data_len < 2 + FAS_STANDIN_PT_SIZE)
+                return -FMP_DATAERROR;
+            memcpy(drive->pt[item], &req[2], FAS_STANDIN_PT_SIZE);
+            return 0;
+        }
+        case FRAME_POSTABLEWRITEROM:
+            drive->pt_rom_saves++;
+            return 0;
+        case FRAME_GETAXISSTATUS:
+            fas_put_le32(out, drive->axis_status);
+            return 4;
+        case FRAME_GETIOAXISSTATUS:
+            fas_put_le32(out, 0);
+            fas_put_le32(out + 4, 0);
+            fas_put_le32(out + 8, drive->axis_status);
+            return 12;
+        case FRAME_GETMOTIONSTATUS: {
+            BYTE all[30];
+            put_status(drive, all);
+            memcpy(out, all + 12, 18);
+            return 18;
+        }
+        case FRAME_GETALLSTATUS:
+            return put_status(drive, out);
+        case FRAME_GETCOMMANDPOS:
+            fas_put_le32(out, (uint32_t)drive->command_pos);
+            return 4;
+        case FRAME_GETACTUALPOS:
+            fas_put_le32(out, (uint32_t)drive->actual_pos);
+            return 4;
+        case FRAME_GETPOSERROR:
+            fas_put_le32(out, (uint32_t)(drive->command_pos - drive->actual_pos));
+            return 4;
+        case FRAME_GETACTUALVEL:
+            fas_put_le32(out, (uint32_t)drive->actual_vel);
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+// 시각이 된 응답을 모두 보내고, 남은 맨 앞 응답의 시각에 timer를 다시 맞춤
+static void standin_send_due(FAS_STANDIN *drive, uint64_t now){
+    while (drive->reply_head != drive->reply_tail) {
+        FAS_STANDIN_REPLY *r = &drive->reply[drive->reply_head & (FAS_STANDIN_QUEUE - 1)];
+        if (r->due_us > now) {
+            struct itimerspec its = { .it_value = { .tv_sec = (time_t)(r->due_us / 1000000u),
+                                                    .tv_nsec = (long)(r->due_us % 1000000u) * 1000 } };
+            timerfd_settime(drive->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+            return;
+        }
+        sendto(drive->fd, r->frame, r->len, 0, (struct sockaddr *)&r->to, sizeof(r->to));
+        drive->reply_head++;
+    }
+}
+
+static void *standin_thread_main(void *arg){
+    FAS_STANDIN *drive = arg;
+    BYTE req[BUFFER_SIZE];
+    uint64_t last_us = standin_us();
+
+    while (atomic_load_explicit(&drive->running, memory_order_relaxed)) {
+        // queue가 차 있으면 받기는 쉬고 timer만 기다림 (요청은 socket buffer에 남음)
+        bool full = drive->reply_tail - drive->reply_head == FAS_STANDIN_QUEUE;
+        struct pollfd pfd[2] = { { .fd = drive->timer_fd, .events = POLLIN }, { .fd = drive->fd, .events = POLLIN } };
+        if (poll(pfd, full ? 1 : 2, 100) <= 0)
+            continue;
+        if (pfd[0].revents & POLLIN) {
+            uint64_t expirations;
+            if (read(drive->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+                break;
+            standin_send_due(drive, standin_us());
+        }
+        if (full || !(pfd[1].revents & POLLIN))
+            continue;
+
+        // 와 있는 요청을 queue가 찰 때까지 한꺼번에 처리
+        while (drive->reply_tail - drive->reply_head < FAS_STANDIN_QUEUE) {
+            FAS_STANDIN_REPLY *r = &drive->reply[drive->reply_tail & (FAS_STANDIN_QUEUE - 1)];
+            socklen_t from_len = sizeof(r->to);
+            ssize_t n = recvfrom(drive->fd, req, sizeof(req), MSG_DONTWAIT, (struct sockaddr *)&r->to, &from_len);
+            if (n < 0)
+                break;
+            if (n < FRAME_HEADER_SIZE || req[1] + 2 > n)
+                continue;
+            atomic_fetch_add_explicit(&drive->frames, 1, memory_order_relaxed);
+
+            // 속도 운전 중이면 지난 시간만큼 위치 적분
+            uint64_t now = standin_us();
+            if (drive->axis_status & FAS_AXIS_MOTIONING)
+                drive->actual_pos += (int32_t)((int64_t)drive->actual_vel * (int64_t)(now - last_us) / 1000000);
+            last_us = now;
+            // 알람이 나면 운전을 멈추고 상태에 올림
+            if (atomic_load_explicit(&drive->alarm, memory_order_relaxed) != 0 && !(drive->axis_status & FAS_AXIS_ERRORALL)) {
+                drive->axis_status = (drive->axis_status | FAS_AXIS_ERRORALL | FAS_AXIS_ERROVERLOAD) & ~FAS_AXIS_MOTIONING;
+                drive->actual_vel = 0;
+                drive->positioning = false;
+            }
+            if (drive->positioning && (drive->actual_vel >= 0 ? drive->actual_pos >= drive->target_pos
+                                                               : drive->actual_pos <= drive->target_pos)) {
+                drive->actual_pos = drive->target_pos;
+                drive->actual_vel = 0;
+                drive->positioning = false;
+                if (drive->axis_status & FAS_AXIS_ORIGINRETURNING)
+                    drive->axis_status = (drive->axis_status & ~FAS_AXIS_ORIGINRETURNING) | FAS_AXIS_ORIGINRETOK;
+                drive->axis_status = (drive->axis_status & ~FAS_AXIS_MOTIONING) | FAS_AXIS_INPOSITION;
+            }
+            if (drive->axis_status & FAS_AXIS_MOTIONING)
+                drive->command_pos = drive->actual_pos;
+
+            BYTE *resp = r->frame;
+            int result = standin_handle(drive, &req[FRAME_HEADER_SIZE], req[1] + 2 - FRAME_HEADER_SIZE,
+                                        req[4], &resp[FRAME_HEADER_SIZE + 1]);
+            int data_len = result < 0 ? 0 : result;
+            resp[0] = req[0];
+            resp[1] = (BYTE)(data_len + 4);
+            resp[2] = req[2];
+            resp[3] = 0;
+            resp[4] = req[4];
+            resp[5] = result < 0 ? (BYTE)-result : FMM_OK;
+            r->len = (uint16_t)(data_len + FRAME_HEADER_SIZE + 1);
+            r->due_us = now + drive->delay_us;
+            if (atomic_load_explicit(&drive->serial, memory_order_relaxed)) {
+                // 앞 요청을 처리하는 동안은 줄을 섬 (due_us가 늘 커지므로 queue 순서는 그대로)
+                if (drive->busy_until_us > now)
+                    r->due_us = drive->busy_until_us + drive->delay_us;
+                drive->busy_until_us = r->due_us;
+            }
+            drive->reply_tail++;
+        }
+        standin_send_due(drive, standin_us());
+    }
+    return NULL;
+}
+
+ /**@brief 가짜 드라이브 시작
+  * @param const char *ip bind할 주소 ("127.0.0.11" 등)
+  * @param uint32_t delay_us 요청을 받고 응답을 보내기까지의 시간 (thread는 그동안 다른 요청을 받음)
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_StandInStart(FAS_STANDIN *drive, const char *ip, uint32_t delay_us){
+    memset(drive, 0, sizeof(*drive));
+    drive->delay_us = delay_us;
+    drive->axis_status = FAS_AXIS_INPOSITION;
+    for (int i = 0; i < FAS_STANDIN_PARAMS; i++)
+        drive->param[i] = i * 10;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PORT_UDP);
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid address: %s\n", ip);
+        return false;
+    }
+    drive->fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (drive->fd < 0) {
+        perror("Socket creation failed");
+        return false;
+    }
+    int on = 1;
+    setsockopt(drive->fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(drive->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind failed");
+        close(drive->fd);
+        return false;
+    }
+    drive->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (drive->timer_fd < 0) {
+        perror("timerfd_create failed");
+        close(drive->fd);
+        return false;
+    }
+
+    atomic_store(&drive->running, true);
+    if (pthread_create(&drive->thread, NULL, standin_thread_main, drive) != 0) {
+        close(drive->timer_fd);
+        close(drive->fd);
+        return false;
+    }
+    return true;
+}
+
+ /**@brief 가짜 드라이브 정지 (최대 0.1초)*/
+void FAS_StandInStop(FAS_STANDIN *drive){
+    if (!atomic_exchange(&drive->running, false))
+        return;
+    pthread_join(drive->thread, NULL);
+    close(drive->timer_fd);
+    close(drive->fd);
+}
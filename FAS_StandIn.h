@@ -0,0 +1,76 @@
+
+#pragma once
+
+#ifndef FAS_STANDIN_DEFINE
+#define FAS_STANDIN_DEFINE
+
+/**
+ * @file FAS_StandIn.h
+ * @brief 실제 드라이브 없이 시험할 때 쓰는 가짜 드라이브 (UDP)
+ * @details ip:PORT_UDP에 bind하고 받은 프레임마다 FMM_OK 응답을 돌려준다.
+ * 127.0.0.x는 모두 loopback이므로 127.0.0.11, 127.0.0.12 ...로 여러 대를 한 프로세스에 띄울 수 있다.
+ * 파라미터와 position table 읽기/쓰기, 위치/상태 조회처럼 응답 data가 있는 명령은 그럴듯한 값을 채운다.
+ * 응답 지연(delay_us)은 thread를 재우지 않고 응답을 도착 시각 + delay_us에 보내도록 queue에 넣어 흉내 내므로,
+ * 요청이 겹쳐 와도 드라이브 한 대가 동시에 여러 요청을 처리 중인 것처럼 보인다 (queue가 차면 받기를 잠시 멈춤).
+ * serial을 켜면 실제 드라이브처럼 요청마다 앞 요청이 끝난 뒤 delay_us가 걸려서, 먼저 보낸 요청 뒤에 줄을 선다.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include "Protocol_Define.h"
+
+#define FAS_STANDIN_PARAMS 64
+#define FAS_STANDIN_PT_ITEMS 256
+#define FAS_STANDIN_PT_SIZE 40		// position table ITEM_NODE byte 수
+#define FAS_STANDIN_ORIGIN_SPEED 100000	// 원점 복귀 속도 [pps]
+#define FAS_STANDIN_QUEUE 64		// 보내기를 기다리는 응답 수 (2의 거듭제곱)
+
+/**@brief 보낼 시각을 기다리는 응답 하나*/
+typedef struct _FAS_STANDIN_REPLY
+{
+	uint64_t due_us;			// 보낼 시각 (CLOCK_MONOTONIC)
+	struct sockaddr_in to;
+	uint16_t len;
+	BYTE frame[BUFFER_SIZE];
+} FAS_STANDIN_REPLY;
+
+typedef struct _FAS_STANDIN
+{
+	int fd;
+	int timer_fd;				// 맨 앞 응답의 due_us에 울림
+	pthread_t thread;
+	_Atomic bool running;
+
+	uint32_t delay_us;			// 응답 전에 기다리는 시간 (드라이브 처리 시간 흉내)
+	_Atomic bool serial;		// TRUE면 실제 드라이브처럼 한 번에 하나씩 처리 (앞 요청 응답 뒤에 delay_us), 시작 뒤 트래픽 전에 켬
+	uint64_t busy_until_us;		// serial일 때 마지막으로 넣은 응답의 due_us
+	int32_t param[FAS_STANDIN_PARAMS];
+	uint32_t axis_status;
+	int32_t command_pos;
+	int32_t actual_pos;
+	int32_t actual_vel;
+	int32_t target_pos;			// 위치 결정 운전 목표 (MoveSingleAxisAbs/IncPos, 원점 복귀는 0)
+	bool positioning;			// 목표에 닿으면 멈추고 INPOSITION
+	_Atomic BYTE alarm;			// 0이 아니면 알람 발생 (다른 thread에서 넣음, ServoAlarmReset으로 지움), GetAlarmType 응답
+	_Atomic BYTE reject_type;	// 0이 아니면 이 Frame Type은 FMP_FRAMETYPEERROR로 응답 (그 명령을 모르는 펌웨어 흉내)
+	_Atomic uint64_t rejected;	// reject_type으로 거절한 수
+	BYTE pt[FAS_STANDIN_PT_ITEMS][FAS_STANDIN_PT_SIZE];	// position table (RAM)
+	uint64_t pt_rom_saves;		// PosTableWriteROM 받은 횟수
+	uint64_t param_writes;		// SetParameter 받은 횟수
+	uint64_t param_written;		// SetParameter로 쓴 번호 (bit)
+	uint64_t param_rom_saves;	// SaveAllParameters 받은 횟수
+
+	FAS_STANDIN_REPLY reply[FAS_STANDIN_QUEUE];	// delay_us가 모두 같으므로 due_us 순서 = 넣은 순서
+	uint32_t reply_head;		// 다음에 보낼 응답
+	uint32_t reply_tail;		// 다음에 넣을 자리
+
+	_Atomic uint64_t frames;	// 받은 프레임 수
+} FAS_STANDIN;
+
+bool FAS_StandInStart(FAS_STANDIN *drive, const char *ip, uint32_t delay_us);
+void FAS_StandInStop(FAS_STANDIN *drive);
+
+#endif	//FAS_STANDIN_DEFINE
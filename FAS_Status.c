@@ -0,0 +1,127 @@
+/**
+ * @file FAS_Status.c
+ * @brief 상태 응답 프레임 decode, AxisStatus flag 이름과 여러 보드의 변화 찾기
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "FAS_Status.h"
+
+#define AXIS_BLOCK 16				// FAS_AxisStatusChanges가 한 번에 비교하는 보드 수
+
+typedef uint32_t axis_vec __attribute__((vector_size(16)));
+
+static const char *const axis_flag_name[32] = {
+    "ERRORALL", "HWPOSILMT", "HWNEGALMT", "SWPOSILMT", "SWNEGALMT", "RESERVED5", "RESERVED6", "ERRPOSOVERFLOW",
+    "ERROVERCURRENT", "ERROVERSPEED", "ERRPOSTRACKING", "ERROVERLOAD", "ERROVERHEAT", "ERRBACKEMF", "ERRMOTORPOWER", "ERRINPOSITION",
+    "EMGSTOP", "SLOWSTOP", "ORIGINRETURNING", "INPOSITION", "SERVOON", "ALARMRESET", "PTSTOPPED", "ORIGINSENSOR",
+    "ZPULSE", "ORIGINRETOK", "MOTIONDIR", "MOTIONING", "MOTIONPAUSE", "MOTIONACCEL", "MOTIONDECEL", "MOTIONCONST",
+};
+
+ /**@brief FAS_GetAllStatus 응답 data(통신 상태 뒤)를 구조체로
+  * @return 길이가 모자라면 FALSE*/
+bool FAS_DecodeAllStatus(const BYTE *data, int len, FAS_ALL_STATUS *status){
+    if (len < FAS_ALL_STATUS_SIZE)
+        return false;
+    status->input = fas_get_le32(data);
+    status->output = fas_get_le32(data + 4);
+    status->axis_status = fas_get_le32(data + 8);
+    status->command_pos = (int32_t)fas_get_le32(data + 12);
+    status->actual_pos = (int32_t)fas_get_le32(data + 16);
+    status->pos_error = (int32_t)fas_get_le32(data + 20);
+    status->actual_vel = (int32_t)fas_get_le32(data + 24);
+    status->pt_item = (uint16_t)(data[28] | (data[29] << 8));
+    return true;
+}
+
+ /**@brief FAS_GetAllStatus(0x43) 보내고 응답을 구조체로
+  * @return 응답의 통신 상태, 응답이 짧으면 FMP_PACKETERROR*/
+FMM_ERROR FAS_ContextGetAllStatus(FAS_CONTEXT *ctx, FAS_ALL_STATUS *status){
+    BYTE resp[FAS_ALL_STATUS_SIZE];
+    int resp_len;
+    FMM_ERROR err = FAS_ContextCommand(ctx, FRAME_GETALLSTATUS, NULL, 0, resp, sizeof(resp), &resp_len);
+    if (err == FMM_OK && !FAS_DecodeAllStatus(resp, resp_len, status))
+        return FMP_PACKETERROR;
+    return err;
+}
+
+ /**@brief 보드 번호로 부르는 FAS_ContextGetAllStatus*/
+int FAS_GetAllStatus(int iBdID, FAS_ALL_STATUS *status){
+    FAS_CONTEXT *ctx = FAS_BoardContext(iBdID);
+    if (ctx == NULL)
+        return FMM_INVALID_SLAVE_NUM;
+    return FAS_ContextGetAllStatus(ctx, status);
+}
+
+ /**@brief AxisStatus bit 번호의 이름 (범위 밖이면 "?")*/
+const char *FAS_AxisFlagName(int bit){
+    if (bit < 0 || bit >= 32)
+        return "?";
+    return axis_flag_name[bit];
+}
+
+ /**@brief 켜진 flag 이름을 "SERVOON INPOSITION" 처럼 공백으로 이어 붙임
+  * @return 쓴 글자 수 (text_size가 모자라면 잘림)*/
+int FAS_AxisStatusFormat(char *text, int text_size, uint32_t status){
+    int len = 0;
+    if (text_size <= 0)
+        return 0;
+    text[0] = '\0';
+    for (uint32_t bits = status; bits != 0 && len < text_size - 1; bits &= bits - 1) {
+        int n = snprintf(text + len, text_size - len, "%s%s", len ? " " : "", axis_flag_name[__builtin_ctz(bits)]);
+        len += n < text_size - len ? n : text_size - 1 - len;
+    }
+    return len;
+}
+
+ /**@brief 상태 응답 data(통신 상태 뒤)에서 AxisStatus 꺼내기
+  * @param BYTE frame_type 응답의 명령 (0x40 AxisStatus, 0x41 IO+AxisStatus, 0x43 AllStatus)
+  * @return AxisStatus가 없는 명령이거나 길이가 모자라면 FALSE*/
+bool FAS_AxisStatusFromResponse(BYTE frame_type, const BYTE *data, int len, uint32_t *status){
+    int offset;
+    switch (frame_type) {
+        case FRAME_GETAXISSTATUS: offset = 0; break;
+        case FRAME_GETIOAXISSTATUS: offset = 8; break;
+        case FRAME_GETALLSTATUS: offset = 8; break;
+        default: return false;
+    }
+    if (len < offset + 4)
+        return false;
+    *status = fas_get_le32(data + offset);
+    return true;
+}
+
+ /**@brief 여러 보드의 AxisStatus를 지난 값과 비교해서 바뀐 보드만 changes에 씀
+  * @details 16대씩 XOR를 OR로 모아서 하나도 안 바뀐 묶음은 한 번에 건너뛴다.
+  * 바뀐 보드는 last를 새 값으로 고치므로 같은 변화는 한 번만 나온다.
+  * changes가 차면 멈추고, 남은 보드는 다음에 부를 때 나온다.
+  * @param uint32_t *last 지난 값 (보드 수만큼, 고쳐짐)
+  * @param const uint32_t *now 이번 값
+  * @return changes에 쓴 수*/
+int FAS_AxisStatusChanges(uint32_t *last, const uint32_t *now, int count, FAS_AXIS_CHANGE *changes, int max_changes){
+    int n = 0, i = 0;
+    for (; i + AXIS_BLOCK <= count && n < max_changes; i += AXIS_BLOCK) {
+        axis_vec a[AXIS_BLOCK / 4], b[AXIS_BLOCK / 4], diff = { 0 };
+        memcpy(a, &last[i], sizeof(a));
+        memcpy(b, &now[i], sizeof(b));
+        for (int k = 0; k < AXIS_BLOCK / 4; k++)
+            diff |= a[k] ^ b[k];
+        if ((diff[0] | diff[1] | diff[2] | diff[3]) == 0)
+            continue;
+        for (int j = i; j < i + AXIS_BLOCK && n < max_changes; j++) {
+            uint32_t changed = last[j] ^ now[j];
+            if (changed == 0)
+                continue;
+            changes[n++] = (FAS_AXIS_CHANGE){ .index = j, .status = now[j], .rose = changed & now[j], .fell = changed & last[j] };
+            last[j] = now[j];
+        }
+    }
+    for (; i < count && n < max_changes; i++) {
+        uint32_t changed = last[i] ^ now[i];
+        if (changed == 0)
+            continue;
+        changes[n++] = (FAS_AXIS_CHANGE){ .index = i, .status = now[i], .rose = changed & now[i], .fell = changed & last[i] };
+        last[i] = now[i];
+    }
+    return n;
+}
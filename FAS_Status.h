@@ -0,0 +1,88 @@
+
+#pragma once
+
+#ifndef FAS_STATUS_DEFINE
+#define FAS_STATUS_DEFINE
+
+/**
+ * @file FAS_Status.h
+ * @brief 상태 응답 프레임(0x40~0x43)을 구조체로 읽기
+ * @details 응답 data(통신 상태 byte 뒤)는 모두 little endian 4 byte 값의 나열이다.
+ * FAS_GetAllStatus(0x43): Input, Output, AxisStatus, CmdPos, ActPos, PosErr, ActVel, PT item(2 byte), 30 byte
+ * AxisStatus는 32개 flag이고, 이름은 bit 번호로 찾는 표에 있다.
+ * 보드가 많을 때는 FAS_AxisStatusChanges로 지난 값과 XOR해서 바뀐 보드만 골라낸다 (16대씩 vector로 비교).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FAS_Library.h"
+
+#define FAS_ALL_STATUS_SIZE 30
+
+/**@brief AxisStatus flag (Ezi-SERVO Plus-E)*/
+#define FAS_AXIS_ERRORALL			(1u << 0)		// 알람 하나라도 있음
+#define FAS_AXIS_HWPOSILMT			(1u << 1)		// +Limit 센서
+#define FAS_AXIS_HWNEGALMT			(1u << 2)		// -Limit 센서
+#define FAS_AXIS_SWPOSILMT			(1u << 3)		// +S/W Limit
+#define FAS_AXIS_SWNEGALMT			(1u << 4)		// -S/W Limit
+#define FAS_AXIS_ERRPOSOVERFLOW		(1u << 7)
+#define FAS_AXIS_ERROVERCURRENT		(1u << 8)
+#define FAS_AXIS_ERROVERSPEED		(1u << 9)
+#define FAS_AXIS_ERRPOSTRACKING		(1u << 10)
+#define FAS_AXIS_ERROVERLOAD		(1u << 11)
+#define FAS_AXIS_ERROVERHEAT		(1u << 12)
+#define FAS_AXIS_ERRBACKEMF			(1u << 13)
+#define FAS_AXIS_ERRMOTORPOWER		(1u << 14)
+#define FAS_AXIS_ERRINPOSITION		(1u << 15)
+#define FAS_AXIS_EMGSTOP			(1u << 16)
+#define FAS_AXIS_SLOWSTOP			(1u << 17)
+#define FAS_AXIS_ORIGINRETURNING	(1u << 18)
+#define FAS_AXIS_INPOSITION			(1u << 19)
+#define FAS_AXIS_SERVOON			(1u << 20)
+#define FAS_AXIS_ALARMRESET			(1u << 21)
+#define FAS_AXIS_PTSTOPPED			(1u << 22)
+#define FAS_AXIS_ORIGINSENSOR		(1u << 23)
+#define FAS_AXIS_ZPULSE				(1u << 24)
+#define FAS_AXIS_ORIGINRETOK		(1u << 25)
+#define FAS_AXIS_MOTIONDIR			(1u << 26)
+#define FAS_AXIS_MOTIONING			(1u << 27)
+#define FAS_AXIS_MOTIONPAUSE		(1u << 28)
+#define FAS_AXIS_MOTIONACCEL		(1u << 29)
+#define FAS_AXIS_MOTIONDECEL		(1u << 30)
+#define FAS_AXIS_MOTIONCONST		(1u << 31)
+
+#define FAS_AXIS_ERROR_MASK			(FAS_AXIS_ERRORALL | 0xFF80u)		// 알람 flag 전부
+#define FAS_AXIS_LIMIT_MASK			(0x1Eu)								// H/W, S/W Limit
+
+/**@brief FAS_GetAllStatus 응답*/
+typedef struct _FAS_ALL_STATUS
+{
+	uint32_t input;
+	uint32_t output;
+	uint32_t axis_status;
+	int32_t command_pos;		// pulse
+	int32_t actual_pos;			// pulse
+	int32_t pos_error;			// pulse
+	int32_t actual_vel;			// pps
+	uint16_t pt_item;			// 실행 중인 position table 번호
+} FAS_ALL_STATUS;
+
+/**@brief 보드 하나의 AxisStatus 변화 (FAS_AxisStatusChanges)*/
+typedef struct _FAS_AXIS_CHANGE
+{
+	int index;					// status 배열 안의 번호
+	uint32_t status;			// 새 값
+	uint32_t rose;				// 0 -> 1이 된 flag
+	uint32_t fell;				// 1 -> 0이 된 flag
+} FAS_AXIS_CHANGE;
+
+bool FAS_DecodeAllStatus(const BYTE *data, int len, FAS_ALL_STATUS *status);
+FMM_ERROR FAS_ContextGetAllStatus(FAS_CONTEXT *ctx, FAS_ALL_STATUS *status);
+int FAS_GetAllStatus(int iBdID, FAS_ALL_STATUS *status);
+
+const char *FAS_AxisFlagName(int bit);
+int FAS_AxisStatusFormat(char *text, int text_size, uint32_t status);
+bool FAS_AxisStatusFromResponse(BYTE frame_type, const BYTE *data, int len, uint32_t *status);
+int FAS_AxisStatusChanges(uint32_t *last, const uint32_t *now, int count, FAS_AXIS_CHANGE *changes, int max_changes);
+
+#endif	//FAS_STATUS_DEFINE
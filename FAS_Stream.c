@@ -0,0 +1,294 @@
+/**
+ * @file FAS_Stream.c
+ * @brief override 스트리밍 thread (timerfd 주기, 응답은 기다리지 않음)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "FAS_Stream.h"
+#include "FAS_Metrics.h"
+#include "FAS_Trace.h"
+
+static uint64_t monotonic_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static struct timespec ns_to_timespec(uint64_t ns){
+    struct timespec ts = { .tv_sec = (time_t)(ns / 1000000000u), .tv_nsec = (long)(ns % 1000000000u) };
+    return ts;
+}
+
+ /**@brief 스트림 초기화 (setpoint 공급 방법 기본값은 FAS_StreamPost)
+  * @param FAS_LINK *link 보낼 드라이브, 스트리밍 중에는 다른 곳에서 쓰지 말 것
+  * @param FAS_STREAM_MODE mode 속도/위치
+  * @param uint32_t period_us 주기 (1000 = 1kHz)*/
+void FAS_StreamInit(FAS_STREAM *stream, FAS_LINK *link, FAS_STREAM_MODE mode, uint32_t period_us){
+    memset(stream, 0, sizeof(*stream));
+    stream->link = link;
+    stream->mode = mode;
+    stream->period_ns = (uint64_t)(period_us ? period_us : 1000) * 1000u;
+    stream->source = FAS_STREAM_SOURCE_POST;
+    stream->timer_fd = -1;
+}
+
+ /**@brief 주기마다 호출할 setpoint 공급 함수 지정*/
+void FAS_StreamSetProducer(FAS_STREAM *stream, FAS_STREAM_PRODUCER producer, void *user){
+    stream->source = FAS_STREAM_SOURCE_PRODUCER;
+    stream->producer = producer;
+    stream->user = user;
+}
+
+ /**@brief 주기마다 하나씩 보낼 setpoint 배열 지정, 다 보내면 스트림이 끝남*/
+void FAS_StreamSetBuffer(FAS_STREAM *stream, const int32_t *setpoints, size_t count){
+    stream->source = FAS_STREAM_SOURCE_BUFFER;
+    stream->setpoints = setpoints;
+    stream->setpoint_count = count;
+}
+
+ /**@brief 최신 setpoint 갱신 (아무 thread에서 호출 가능, 다음 주기에 마지막 값만 나감)*/
+void FAS_StreamPost(FAS_STREAM *stream, int32_t setpoint){
+    uint64_t old = atomic_load_explicit(&stream->posted, memory_order_relaxed), next;
+    do {
+        next = ((old >> 32) + 1) << 32 | (uint32_t)setpoint;
+    } while (!atomic_compare_exchange_weak_explicit(&stream->posted, &old, next,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+/**@brief 응답 정리 때 handler에 넘기는 값*/
+typedef struct _STREAM_RX
+{
+	FAS_STREAM *stream;
+	FAS_STREAM_STATS *local;
+} STREAM_RX;
+
+static void stream_ack(const BYTE *frame, int len, void *user){
+    STREAM_RX *rx = user;
+    FAS_STREAM *stream = rx->stream;
+    FAS_STREAM_STATS *local = rx->local;
+    FAS_FRAME_VIEW view;
+    if (!FAS_LinkDecode(stream->link, frame, len, &view))
+        return;
+    FAS_TRACE(FAS_TRACE_RECV, stream->link->iBdID, view.sync, len);
+    // 같은 Sync No.로 보낸 시각이 남아 있을 때만 RTT를 기록 (중복 응답이나 256번 넘게 늦은 응답은 세기만 함)
+    uint64_t sent = stream->sent_us[view.sync];
+    if (sent != 0) {
+        uint64_t rtt_us = monotonic_ns() / 1000u - sent;
+        stream->sent_us[view.sync] = 0;
+        FAS_MetricsReceived(stream->link->iBdID, len, (FMM_ERROR)view.status, rtt_us);
+        local->rtt_count++;
+        local->rtt_sum_us += rtt_us;
+        if (rtt_us > local->rtt_max_us)
+            local->rtt_max_us = rtt_us;
+    }
+    if (view.status == FMM_OK)
+        local->acks++;
+    else
+        local->nacks++;
+}
+
+static void stream_send(FAS_STREAM *stream, FAS_STREAM_STATS *local, int32_t setpoint){
+    FAS_LINK *link = stream->link;
+    BYTE frame[BUFFER_SIZE], value[4];
+    BYTE type = stream->mode == FAS_STREAM_VELOCITY ? FRAME_VELOCITYOVERRIDE : FRAME_POSITIONABSOVERRIDE;
+
+    fas_put_le32(value, (uint32_t)setpoint);
+    // Sync No.가 없는 codec은 Slave ID 자리에 보드 번호 (RTT는 마지막 송신부터 잼)
+    BYTE sync = link->codec->sync ? link->sync_no++ : (BYTE)link->iBdID;
+    int len = FAS_CodecEncode(link->codec, frame, sync, type, value, sizeof(value));
+    if (len < 0 || FAS_LinkSendFrame(link, frame, len) < 0) {
+        local->send_errors++;
+        return;
+    }
+    FAS_TRACE(FAS_TRACE_SEND, link->iBdID, sync, len);
+    FAS_MetricsSent(link->iBdID, len);
+    stream->sent_us[sync] = monotonic_ns() / 1000u;
+    local->frames_sent++;
+}
+
+static void stream_publish(FAS_STREAM *stream, const FAS_STREAM_STATS *local){
+    uint32_t seq = atomic_load_explicit(&stream->stats_seq, memory_order_relaxed);
+    atomic_store_explicit(&stream->stats_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    stream->stats = *local;
+    atomic_store_explicit(&stream->stats_seq, seq + 2, memory_order_release);
+}
+
+static void *stream_thread_main(void *arg){
+    FAS_STREAM *stream = arg;
+    FAS_STREAM_STATS local;
+    memset(&local, 0, sizeof(local));
+    local.jitter_min_ns = INT64_MAX;
+    local.jitter_max_ns = INT64_MIN;
+
+    // 권한이 있으면 SCHED_FIFO로 올림 (없으면 그냥 진행)
+    struct sched_param sp = { .sched_priority = sched_get_priority_min(SCHED_FIFO) + 10 };
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+
+    uint64_t start_ns = monotonic_ns() + stream->period_ns;
+    struct itimerspec its = { .it_interval = ns_to_timespec(stream->period_ns), .it_value = ns_to_timespec(start_ns) };
+    timerfd_settime(stream->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+
+    uint64_t tick = 0;
+    STREAM_RX rx = { stream, &local };
+    int nfds = 2;			// TCP 연결이 끊기면 timer만 기다림 (보내기는 send_errors로 셈)
+    while (atomic_load_explicit(&stream->running, memory_order_relaxed)) {
+        // 주기 사이에 온 응답은 바로 정리해서 RTT가 다음 주기까지 늘어나지 않게 함
+        struct pollfd pfd[2] = { { .fd = stream->timer_fd, .events = POLLIN }, { .fd = stream->link->fd, .events = POLLIN } };
+        if (poll(pfd, nfds, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        // 송신 timestamp를 켠 link는 error queue가 차면 POLLERR로 깨므로 같이 비움
+        if (nfds == 2 && (pfd[1].revents & (POLLIN | POLLERR | POLLHUP))) {
+            if (FAS_LinkReceive(stream->link, stream_ack, &rx) < 0)
+                nfds = 1;
+            if (!(pfd[0].revents & POLLIN)) {
+                stream_publish(stream, &local);
+                continue;
+            }
+        }
+        uint64_t expirations;
+        if (read(stream->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        tick += expirations;
+        uint64_t current = tick - 1;	// 이번에 처리하는 주기 번호
+
+        // 예정 시각 대비 늦게 깬 정도
+        int64_t late = (int64_t)(monotonic_ns() - (start_ns + current * stream->period_ns));
+        local.ticks++;
+        local.missed_ticks += expirations - 1;
+        if (late < local.jitter_min_ns)
+            local.jitter_min_ns = late;
+        if (late > local.jitter_max_ns)
+            local.jitter_max_ns = late;
+        uint64_t abs_late = late < 0 ? (uint64_t)-late : (uint64_t)late;
+        local.jitter_sum_ns += abs_late;
+        int bucket = abs_late < 1000 ? 0 : 64 - __builtin_clzll(abs_late / 1000);
+        local.jitter_hist[bucket < FAS_STREAM_JITTER_BUCKETS ? bucket : FAS_STREAM_JITTER_BUCKETS - 1]++;
+
+        int32_t setpoint;
+        bool has_setpoint = false;
+        switch (stream->source) {
+            case FAS_STREAM_SOURCE_PRODUCER:
+                has_setpoint = stream->producer(current, &setpoint, stream->user);
+                break;
+            case FAS_STREAM_SOURCE_BUFFER:
+                if (current >= stream->setpoint_count) {
+                    // 건너뛴 주기에 있던 마지막 setpoint들도 dropped
+                    uint64_t prev = current + 1 - expirations;
+                    if (prev < stream->setpoint_count)
+                        local.dropped += stream->setpoint_count - prev;
+                    atomic_store_explicit(&stream->running, false, memory_order_relaxed);
+                    break;
+                }
+                local.dropped += expirations - 1;	// 늦은 setpoint는 버리고 지금 것만 보냄
+                setpoint = stream->setpoints[current];
+                has_setpoint = true;
+                break;
+            case FAS_STREAM_SOURCE_POST: {
+                uint64_t posted = atomic_load_explicit(&stream->posted, memory_order_acquire);
+                uint32_t seq = (uint32_t)(posted >> 32);
+                if (seq != stream->posted_seen) {
+                    local.superseded += seq - stream->posted_seen - 1;
+                    stream->posted_seen = seq;
+                    setpoint = (int32_t)(uint32_t)posted;
+                    has_setpoint = true;
+                }
+                break;
+            }
+        }
+        if (has_setpoint)
+            stream_send(stream, &local, setpoint);
+        stream_publish(stream, &local);
+    }
+    return NULL;
+}
+
+ /**@brief 스트리밍 thread 시작
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_StreamStart(FAS_STREAM *stream){
+    if (atomic_load(&stream->running))
+        return false;
+    if (stream->source == FAS_STREAM_SOURCE_PRODUCER && stream->producer == NULL)
+        return false;
+    // buffer를 다 보내고 스스로 끝난 스트림은 thread와 timer가 남아 있음
+    if (stream->timer_fd >= 0)
+        FAS_StreamStop(stream);
+    memset(stream->sent_us, 0, sizeof(stream->sent_us));
+
+    stream->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (stream->timer_fd < 0) {
+        perror("timerfd_create failed");
+        return false;
+    }
+    stream->posted_seen = (uint32_t)(atomic_load(&stream->posted) >> 32);
+    atomic_store(&stream->running, true);
+    if (pthread_create(&stream->thread, NULL, stream_thread_main, stream) != 0) {
+        atomic_store(&stream->running, false);
+        close(stream->timer_fd);
+        stream->timer_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+ /**@brief 스트리밍 정지 (최대 한 주기 기다림), buffer를 다 보내고 끝난 경우에도 호출해서 정리*/
+void FAS_StreamStop(FAS_STREAM *stream){
+    if (stream->timer_fd < 0)
+        return;
+    atomic_store(&stream->running, false);
+    pthread_join(stream->thread, NULL);
+    close(stream->timer_fd);
+    stream->timer_fd = -1;
+}
+
+ /**@brief 스트리밍 중인지 (buffer를 다 보내면 FALSE)*/
+bool FAS_StreamIsRunning(FAS_STREAM *stream){
+    return atomic_load_explicit(&stream->running, memory_order_relaxed);
+}
+
+ /**@brief 통계 복사 (stream thread를 멈추지 않음)*/
+void FAS_StreamGetStats(FAS_STREAM *stream, FAS_STREAM_STATS *stats){
+    uint32_t before, after;
+    do {
+        before = atomic_load_explicit(&stream->stats_seq, memory_order_acquire);
+        *stats = stream->stats;
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&stream->stats_seq, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+}
+
+ /**@brief 통계 출력*/
+void FAS_StreamPrintStats(FAS_STREAM *stream, FILE *fp){
+    FAS_STREAM_STATS st;
+    FAS_StreamGetStats(stream, &st);
+    double period_us = stream->period_ns / 1000.0;
+    fprintf(fp, "period %.0f us, ticks %" PRIu64 " (missed %" PRIu64 ")\n", period_us, st.ticks, st.missed_ticks);
+    fprintf(fp, "frames %" PRIu64 " (send error %" PRIu64 "), ack %" PRIu64 ", nack %" PRIu64 "\n",
+            st.frames_sent, st.send_errors, st.acks, st.nacks);
+    if (st.rtt_count > 0)
+        fprintf(fp, "rtt mean %.1f us, max %" PRIu64 " us (%" PRIu64 " matched)\n", (double)st.rtt_sum_us / st.rtt_count,
+                st.rtt_max_us, st.rtt_count);
+    fprintf(fp, "dropped setpoints %" PRIu64 ", superseded setpoints %" PRIu64 "\n", st.dropped, st.superseded);
+    if (st.ticks > 0) {
+        fprintf(fp, "jitter min %.1f us, max %.1f us, mean |jitter| %.1f us\n",
+                st.jitter_min_ns / 1000.0, st.jitter_max_ns / 1000.0, st.jitter_sum_ns / 1000.0 / st.ticks);
+        for (int i = 0; i < FAS_STREAM_JITTER_BUCKETS; i++) {
+            if (st.jitter_hist[i] != 0)
+                fprintf(fp, "  < %6" PRIu64 " us : %" PRIu64 "\n", (uint64_t)1 << i, st.jitter_hist[i]);
+        }
+    }
+}
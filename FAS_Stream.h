@@ -0,0 +1,103 @@
+
+#pragma once
+
+#ifndef FAS_STREAM_DEFINE
+#define FAS_STREAM_DEFINE
+
+/**
+ * @file FAS_Stream.h
+ * @brief 고정 주기(500Hz~1kHz) 속도/위치 override 스트리밍
+ * @details 전용 thread가 timerfd 주기마다 override 프레임(0x3A VelocityOverride, 0x38 PositionAbsOverride)을
+ * 응답을 기다리지 않고 보낸다. 응답은 주기 사이에 도착하는 대로 non-blocking으로 모아서, 보낸 시각과 Sync No.로
+ * 짝을 맞춰 RTT와 함께 통계에만 반영한다.
+ * setpoint 공급 방법은 셋 중 하나이다.
+ * - producer callback : 주기마다 호출
+ * - setpoint buffer   : 주기마다 하나씩, thread가 늦어서 주기를 건너뛰면 가장 최근 것만 보내고 나머지는 dropped
+ * - FAS_StreamPost    : 아무 thread에서나 최신 값 갱신, 주기 사이에 여러 번 오면 마지막 값만 보냄 (superseded)
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "FAS_Pipeline.h"
+
+#define FAS_STREAM_JITTER_BUCKETS 16	// log2(us)
+
+typedef enum _FAS_STREAM_MODE
+{
+	FAS_STREAM_VELOCITY = 0,		// FRAME_VELOCITYOVERRIDE, setpoint는 pps
+	FAS_STREAM_POSITION,			// FRAME_POSITIONABSOVERRIDE, setpoint는 pulse
+} FAS_STREAM_MODE;
+
+typedef enum _FAS_STREAM_SOURCE
+{
+	FAS_STREAM_SOURCE_POST = 0,
+	FAS_STREAM_SOURCE_PRODUCER,
+	FAS_STREAM_SOURCE_BUFFER,
+} FAS_STREAM_SOURCE;
+
+/**@brief 주기마다 호출되는 setpoint 공급 함수
+  * @param uint64_t tick 시작 후 주기 번호
+  * @param int32_t *setpoint 보낼 값
+  * @return 이번 주기에 보낼 값이 없으면 FALSE*/
+typedef bool (*FAS_STREAM_PRODUCER)(uint64_t tick, int32_t *setpoint, void *user);
+
+/**@brief 스트리밍 통계 (stream thread 혼자 쓰고 FAS_StreamGetStats로 읽음)*/
+typedef struct _FAS_STREAM_STATS
+{
+	uint64_t ticks;				// 처리한 주기 수
+	uint64_t missed_ticks;		// thread가 늦어서 건너뛴 주기 수
+	uint64_t frames_sent;
+	uint64_t send_errors;
+	uint64_t acks;				// FMM_OK 응답
+	uint64_t nacks;				// FMM_OK가 아닌 응답
+	uint64_t rtt_count;			// 보낸 시각과 Sync No.로 짝을 맞춘 응답 (나머지는 RTT를 모름)
+	uint64_t rtt_sum_us;
+	uint64_t rtt_max_us;
+	uint64_t dropped;			// 보내지 못하고 건너뛴 buffer setpoint
+	uint64_t superseded;		// 새 값에 덮여서 안 보낸 posted setpoint
+	int64_t jitter_min_ns;		// 예정 시각 대비 깨어난 시각
+	int64_t jitter_max_ns;
+	uint64_t jitter_sum_ns;
+	uint64_t jitter_hist[FAS_STREAM_JITTER_BUCKETS];
+} FAS_STREAM_STATS;
+
+typedef struct _FAS_STREAM
+{
+	FAS_LINK *link;				// 스트리밍 동안 stream thread 전용
+	FAS_STREAM_MODE mode;
+	uint64_t period_ns;
+
+	FAS_STREAM_SOURCE source;
+	FAS_STREAM_PRODUCER producer;
+	void *user;
+	const int32_t *setpoints;
+	size_t setpoint_count;
+
+	_Atomic uint64_t posted;	// 상위 32bit 순번, 하위 32bit 값
+	uint32_t posted_seen;
+	uint64_t sent_us[256];		// Sync No.별 보낸 시각, 응답을 받으면 0 (stream thread 전용)
+
+	pthread_t thread;
+	int timer_fd;
+	_Atomic bool running;
+
+	_Atomic uint32_t stats_seq;	// seqlock, 홀수면 stream thread가 갱신 중
+	FAS_STREAM_STATS stats;
+} FAS_STREAM;
+
+void FAS_StreamInit(FAS_STREAM *stream, FAS_LINK *link, FAS_STREAM_MODE mode, uint32_t period_us);
+void FAS_StreamSetProducer(FAS_STREAM *stream, FAS_STREAM_PRODUCER producer, void *user);
+void FAS_StreamSetBuffer(FAS_STREAM *stream, const int32_t *setpoints, size_t count);
+void FAS_StreamPost(FAS_STREAM *stream, int32_t setpoint);
+
+bool FAS_StreamStart(FAS_STREAM *stream);
+void FAS_StreamStop(FAS_STREAM *stream);
+bool FAS_StreamIsRunning(FAS_STREAM *stream);
+
+void FAS_StreamGetStats(FAS_STREAM *stream, FAS_STREAM_STATS *stats);
+void FAS_StreamPrintStats(FAS_STREAM *stream, FILE *fp);
+
+#endif	//FAS_STREAM_DEFINE
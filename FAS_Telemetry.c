@@ -0,0 +1,335 @@
+/**
+ * @file FAS_Telemetry.c
+ * @brief column 압축 telemetry writer/reader
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FAS_Telemetry.h"
+
+#define TELEMETRY_IDLE_NS 2000000		// ring이 비었을 때 writer thread가 쉬는 시간 (2ms)
+
+/************************************************************************************************************************************
+ ***************************************************** varint / zigzag *************************************************************
+ ************************************************************************************************************************************/
+
+static inline uint64_t zigzag(int64_t v){
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t v){
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline uint8_t *put_varint(uint8_t *p, uint64_t v){
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static inline const uint8_t *get_varint(const uint8_t *p, const uint8_t *end, uint64_t *v){
+    uint64_t result = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        result |= (uint64_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            *v = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// 정수 column: 첫 값, delta, 그 뒤로 delta-of-delta
+static uint8_t *encode_int_column(uint8_t *p, const int64_t *value, int rows){
+    int64_t prev = 0, prev_delta = 0;
+    for (int i = 0; i < rows; i++) {
+        int64_t delta = value[i] - prev;
+        p = put_varint(p, zigzag(i == 0 ? value[i] : delta - prev_delta));
+        prev_delta = i == 0 ? 0 : delta;
+        prev = value[i];
+    }
+    return p;
+}
+
+static const uint8_t *decode_int_column(const uint8_t *p, const uint8_t *end, int64_t *value, int rows){
+    int64_t prev = 0, prev_delta = 0;
+    for (int i = 0; i < rows && p != NULL; i++) {
+        uint64_t v;
+        if ((p = get_varint(p, end, &v)) == NULL)
+            return NULL;
+        if (i == 0) {
+            value[i] = unzigzag(v);
+        }
+        else {
+            prev_delta += unzigzag(v);
+            value[i] = prev + prev_delta;
+        }
+        prev = value[i];
+    }
+    return p;
+}
+
+// 상태 bit column: 앞 행과 다른 행 bitmap, 다른 행마다 XOR 값
+static uint8_t *encode_flag_column(uint8_t *p, const uint32_t *flags, int rows){
+    uint8_t *bitmap = p;
+    int bitmap_len = (rows + 7) / 8;
+    memset(bitmap, 0, bitmap_len);
+    p += bitmap_len;
+    uint32_t prev = 0;
+    for (int i = 0; i < rows; i++) {
+        if (flags[i] != prev) {
+            bitmap[i / 8] |= (uint8_t)(1u << (i % 8));
+            p = put_varint(p, flags[i] ^ prev);
+            prev = flags[i];
+        }
+    }
+    return p;
+}
+
+static const uint8_t *decode_flag_column(const uint8_t *p, const uint8_t *end, uint32_t *flags, int rows){
+    int bitmap_len = (rows + 7) / 8;
+    if (end - p < bitmap_len)
+        return NULL;
+    const uint8_t *bitmap = p;
+    p += bitmap_len;
+    uint32_t prev = 0;
+    for (int i = 0; i < rows; i++) {
+        if (bitmap[i / 8] & (1u << (i % 8))) {
+            uint64_t v;
+            if ((p = get_varint(p, end, &v)) == NULL)
+                return NULL;
+            prev ^= (uint32_t)v;
+        }
+        flags[i] = prev;
+    }
+    return p;
+}
+
+/************************************************************************************************************************************
+ ************************************************************ writer ***************************************************************
+ ************************************************************************************************************************************/
+
+static bool write_block(FAS_TELEMETRY *tm, int iBdID, FAS_TELEMETRY_BLOCK *block){
+    if (block->rows == 0)
+        return true;
+    uint8_t *p = tm->payload + FAS_TELEMETRY_BLOCK_HEADER;
+    for (int col = 0; col < FAS_TELEMETRY_INT_COLUMNS; col++)
+        p = encode_int_column(p, block->value[col], block->rows);
+    for (int col = 0; col < FAS_TELEMETRY_FLAG_COLUMNS; col++)
+        p = encode_flag_column(p, block->flags[col], block->rows);
+
+    uint32_t payload_len = (uint32_t)(p - tm->payload - FAS_TELEMETRY_BLOCK_HEADER);
+    tm->payload[0] = (uint8_t)iBdID;
+    tm->payload[1] = block->rows & 0xFF;
+    tm->payload[2] = (block->rows >> 8) & 0xFF;
+    fas_put_le32(tm->payload + 3, payload_len);
+
+    size_t len = FAS_TELEMETRY_BLOCK_HEADER + payload_len;
+    int rows = block->rows;
+    block->rows = 0;
+    if (fwrite(tm->payload, 1, len, tm->fp) != len) {
+        perror("telemetry write failed");
+        atomic_fetch_add_explicit(&tm->dropped, rows, memory_order_relaxed);
+        return false;
+    }
+    atomic_fetch_add_explicit(&tm->samples, rows, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tm->bytes, len, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tm->blocks, 1, memory_order_relaxed);
+    return true;
+}
+
+static void add_row(FAS_TELEMETRY *tm, const FAS_TELEMETRY_SAMPLE *s){
+    FAS_TELEMETRY_BLOCK *block = tm->block[s->iBdID];
+    if (block == NULL) {
+        block = calloc(1, sizeof(*block));
+        if (block == NULL) {
+            atomic_fetch_add_explicit(&tm->dropped, 1, memory_order_relaxed);
+            return;
+        }
+        tm->block[s->iBdID] = block;
+    }
+    int r = block->rows++;
+    block->value[0][r] = (int64_t)s->t_us;
+    block->value[1][r] = s->status.command_pos;
+    block->value[2][r] = s->status.actual_pos;
+    block->value[3][r] = s->status.pos_error;
+    block->value[4][r] = s->status.actual_vel;
+    block->value[5][r] = s->status.pt_item;
+    block->flags[0][r] = s->status.axis_status;
+    block->flags[1][r] = s->status.input;
+    block->flags[2][r] = s->status.output;
+    if (block->rows == FAS_TELEMETRY_BLOCK_ROWS)
+        write_block(tm, s->iBdID, block);
+}
+
+static int drain_ring(FAS_TELEMETRY *tm){
+    uint64_t tail = atomic_load_explicit(&tm->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&tm->head, memory_order_acquire);
+    int n = 0;
+    for (; tail != head; tail++, n++)
+        add_row(tm, &tm->ring[tail & (FAS_TELEMETRY_RING - 1)]);
+    atomic_store_explicit(&tm->tail, tail, memory_order_release);
+    return n;
+}
+
+static void *telemetry_thread_main(void *arg){
+    FAS_TELEMETRY *tm = arg;
+    const struct timespec idle = { 0, TELEMETRY_IDLE_NS };
+    while (atomic_load_explicit(&tm->running, memory_order_relaxed)) {
+        if (drain_ring(tm) == 0)
+            nanosleep(&idle, NULL);
+    }
+    drain_ring(tm);
+    return NULL;
+}
+
+ /**@brief 파일을 만들고 writer thread 시작
+  * @return boolean 성공시 TRUE 실패시 FALSE (파일을 만들지 못했거나 header를 쓰지 못함)*/
+bool FAS_TelemetryOpen(FAS_TELEMETRY *tm, const char *path){
+    memset(tm, 0, sizeof(*tm));
+    tm->fp = fopen(path, "wb");
+    if (tm->fp == NULL) {
+        perror("telemetry open failed");
+        return false;
+    }
+    setvbuf(tm->fp, NULL, _IOFBF, 64 * 1024);
+
+    uint8_t header[8];
+    fas_put_le32(header, FAS_TELEMETRY_MAGIC);
+    fas_put_le32(header + 4, FAS_TELEMETRY_VERSION);
+    if (fwrite(header, 1, sizeof(header), tm->fp) != sizeof(header) || fflush(tm->fp) != 0) {
+        perror("telemetry header write failed");
+        fclose(tm->fp);
+        tm->fp = NULL;
+        return false;
+    }
+    atomic_store(&tm->bytes, sizeof(header));
+
+    atomic_store(&tm->running, true);
+    if (pthread_create(&tm->thread, NULL, telemetry_thread_main, tm) != 0) {
+        perror("telemetry thread create failed");
+        atomic_store(&tm->running, false);
+        fclose(tm->fp);
+        tm->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+ /**@brief 행 하나 추가 (한 thread에서만 호출, 압축/쓰기는 하지 않으므로 I/O thread에서 불러도 됨)
+  * @return ring이 차 있으면 FALSE (dropped 증가)*/
+bool FAS_TelemetryAppend(FAS_TELEMETRY *tm, int iBdID, uint64_t t_us, const FAS_ALL_STATUS *status){
+    if (iBdID < 0 || iBdID >= FAS_MAX_BOARD)
+        return false;
+    uint64_t head = atomic_load_explicit(&tm->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&tm->tail, memory_order_acquire);
+    if (head - tail >= FAS_TELEMETRY_RING) {
+        atomic_fetch_add_explicit(&tm->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+    FAS_TELEMETRY_SAMPLE *s = &tm->ring[head & (FAS_TELEMETRY_RING - 1)];
+    s->t_us = t_us;
+    s->iBdID = iBdID;
+    s->status = *status;
+    atomic_store_explicit(&tm->head, head + 1, memory_order_release);
+    return true;
+}
+
+ /**@brief 남은 행을 모두 쓰고 파일 닫기*/
+void FAS_TelemetryClose(FAS_TELEMETRY *tm){
+    if (tm->fp == NULL)
+        return;
+    atomic_store(&tm->running, false);
+    pthread_join(tm->thread, NULL);
+    for (int bd = 0; bd < FAS_MAX_BOARD; bd++) {
+        if (tm->block[bd] != NULL) {
+            write_block(tm, bd, tm->block[bd]);
+            free(tm->block[bd]);
+            tm->block[bd] = NULL;
+        }
+    }
+    fclose(tm->fp);
+    tm->fp = NULL;
+}
+
+/************************************************************************************************************************************
+ ************************************************************ reader ***************************************************************
+ ************************************************************************************************************************************/
+
+ /**@brief .fct 파일 열기 (magic/version 확인)*/
+bool FAS_TelemetryReaderOpen(FAS_TELEMETRY_READER *reader, const char *path){
+    memset(reader, 0, sizeof(*reader));
+    reader->fp = fopen(path, "rb");
+    if (reader->fp == NULL) {
+        perror("telemetry open failed");
+        return false;
+    }
+    uint8_t header[8];
+    if (fread(header, 1, sizeof(header), reader->fp) != sizeof(header) ||
+        fas_get_le32(header) != FAS_TELEMETRY_MAGIC || fas_get_le32(header + 4) != FAS_TELEMETRY_VERSION) {
+        fprintf(stderr, "%s: not a telemetry file\n", path);
+        fclose(reader->fp);
+        reader->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+static bool read_block(FAS_TELEMETRY_READER *reader){
+    uint8_t header[FAS_TELEMETRY_BLOCK_HEADER];
+    if (fread(header, 1, sizeof(header), reader->fp) != sizeof(header))
+        return false;
+    int rows = header[1] | (header[2] << 8);
+    uint32_t len = fas_get_le32(header + 3);
+    if (rows == 0 || rows > FAS_TELEMETRY_BLOCK_ROWS || len > sizeof(reader->payload) ||
+        fread(reader->payload, 1, len, reader->fp) != len) {
+        reader->corrupt = true;
+        return false;
+    }
+
+    const uint8_t *p = reader->payload, *end = reader->payload + len;
+    for (int col = 0; col < FAS_TELEMETRY_INT_COLUMNS && p != NULL; col++)
+        p = decode_int_column(p, end, reader->value[col], rows);
+    for (int col = 0; col < FAS_TELEMETRY_FLAG_COLUMNS && p != NULL; col++)
+        p = decode_flag_column(p, end, reader->flags[col], rows);
+    if (p == NULL) {
+        reader->corrupt = true;
+        return false;
+    }
+    reader->iBdID = header[0];
+    reader->rows = rows;
+    reader->row = 0;
+    return true;
+}
+
+ /**@brief 다음 행 (파일 순서, 같은 block 안에서는 한 보드의 시간 순)
+  * @return 파일 끝이나 망가진 block이면 FALSE*/
+bool FAS_TelemetryRead(FAS_TELEMETRY_READER *reader, FAS_TELEMETRY_SAMPLE *sample){
+    if (reader->row >= reader->rows && !read_block(reader))
+        return false;
+    int r = reader->row++;
+    memset(&sample->status, 0, sizeof(sample->status));	// 파일에 없는 칸과 padding은 0 (memcmp로 비교 가능)
+    sample->iBdID = reader->iBdID;
+    sample->t_us = (uint64_t)reader->value[0][r];
+    sample->status.command_pos = (int32_t)reader->value[1][r];
+    sample->status.actual_pos = (int32_t)reader->value[2][r];
+    sample->status.pos_error = (int32_t)reader->value[3][r];
+    sample->status.actual_vel = (int32_t)reader->value[4][r];
+    sample->status.pt_item = (uint16_t)reader->value[5][r];
+    sample->status.axis_status = reader->flags[0][r];
+    sample->status.input = reader->flags[1][r];
+    sample->status.output = reader->flags[2][r];
+    return true;
+}
+
+ /**@brief 파일 닫기*/
+void FAS_TelemetryReaderClose(FAS_TELEMETRY_READER *reader){
+    if (reader->fp != NULL)
+        fclose(reader->fp);
+    reader->fp = NULL;
+}
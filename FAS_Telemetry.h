@@ -0,0 +1,96 @@
+
+#pragma once
+
+#ifndef FAS_TELEMETRY_DEFINE
+#define FAS_TELEMETRY_DEFINE
+
+/**
+ * @file FAS_Telemetry.h
+ * @brief 장시간 polling 결과를 보드별 column으로 압축해서 저장하는 파일 형식 (.fct)
+ * @details polling thread(I/O thread)는 FAS_TelemetryAppend로 sample을 SPSC ring에 넣기만 하고,
+ * 압축과 파일 쓰기는 writer thread가 한다. writer는 보드마다 FAS_TELEMETRY_BLOCK_ROWS행을 모았다가
+ * block 하나로 압축해서 쓰므로 메모리는 (ring + 보드 수 x block 하나)로 정해져 있다.
+ *
+ * 파일: [magic u32][version u32] 다음에 block이 이어짐 (모두 little endian)
+ * block: [board u8][rows u16][payload 길이 u32][payload]
+ * payload는 column 순서대로, block마다 처음부터 다시 시작하므로 block 하나만 읽어도 풀 수 있다.
+ * - 시각, 위치, 속도, PT item : delta-of-delta를 zigzag varint로 (첫 값은 그대로, 둘째 값은 delta)
+ * - AxisStatus, Input, Output : 앞 행과 다른 행 bitmap(행당 1bit) + 다른 행의 XOR 값 varint
+ * 변환: FAS_TelemetryCsv file.fct > file.csv
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "FAS_Metrics.h"
+#include "FAS_Status.h"
+
+#define FAS_TELEMETRY_MAGIC 0x4D4C5446		// "FTLM"
+#define FAS_TELEMETRY_VERSION 1
+#define FAS_TELEMETRY_RING 16384			// I/O thread -> writer thread (2^n)
+#define FAS_TELEMETRY_BLOCK_ROWS 1024		// block 하나의 최대 행 수
+#define FAS_TELEMETRY_INT_COLUMNS 6			// 시각, CmdPos, ActPos, PosErr, ActVel, PT item
+#define FAS_TELEMETRY_FLAG_COLUMNS 3		// AxisStatus, Input, Output
+#define FAS_TELEMETRY_BLOCK_HEADER 7
+#define FAS_TELEMETRY_PAYLOAD_MAX (FAS_TELEMETRY_BLOCK_ROWS * (FAS_TELEMETRY_INT_COLUMNS * 10 + FAS_TELEMETRY_FLAG_COLUMNS * 5) \
+                                   + FAS_TELEMETRY_FLAG_COLUMNS * (FAS_TELEMETRY_BLOCK_ROWS / 8))
+
+/**@brief 행 하나 (보드 번호, 시각, 상태)*/
+typedef struct _FAS_TELEMETRY_SAMPLE
+{
+	uint64_t t_us;
+	int iBdID;
+	FAS_ALL_STATUS status;
+} FAS_TELEMETRY_SAMPLE;
+
+/**@brief 보드 하나의 아직 안 쓴 행 (writer thread 전용)*/
+typedef struct _FAS_TELEMETRY_BLOCK
+{
+	int rows;
+	int64_t value[FAS_TELEMETRY_INT_COLUMNS][FAS_TELEMETRY_BLOCK_ROWS];
+	uint32_t flags[FAS_TELEMETRY_FLAG_COLUMNS][FAS_TELEMETRY_BLOCK_ROWS];
+} FAS_TELEMETRY_BLOCK;
+
+typedef struct _FAS_TELEMETRY
+{
+	FILE *fp;
+	pthread_t thread;
+	_Atomic bool running;
+
+	FAS_TELEMETRY_SAMPLE ring[FAS_TELEMETRY_RING];
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t head;	// FAS_TelemetryAppend를 부르는 thread만 씀
+	_Alignas(FAS_CACHELINE) _Atomic uint64_t tail;	// writer thread만 씀
+
+	FAS_TELEMETRY_BLOCK *block[FAS_MAX_BOARD];		// 처음 sample이 올 때 만듦
+	uint8_t payload[FAS_TELEMETRY_BLOCK_HEADER + FAS_TELEMETRY_PAYLOAD_MAX];
+
+	_Atomic uint64_t samples;		// 파일에 들어간 행 수
+	_Atomic uint64_t dropped;		// ring이 차거나 파일 쓰기가 실패해서 버린 행 수
+	_Atomic uint64_t bytes;			// 파일 크기
+	_Atomic uint64_t blocks;
+} FAS_TELEMETRY;
+
+bool FAS_TelemetryOpen(FAS_TELEMETRY *tm, const char *path);
+bool FAS_TelemetryAppend(FAS_TELEMETRY *tm, int iBdID, uint64_t t_us, const FAS_ALL_STATUS *status);
+void FAS_TelemetryClose(FAS_TELEMETRY *tm);
+
+/**@brief .fct 파일 읽기, block 하나씩 풀어서 한 행씩 돌려줌*/
+typedef struct _FAS_TELEMETRY_READER
+{
+	FILE *fp;
+	int iBdID;
+	int rows;
+	int row;
+	int64_t value[FAS_TELEMETRY_INT_COLUMNS][FAS_TELEMETRY_BLOCK_ROWS];
+	uint32_t flags[FAS_TELEMETRY_FLAG_COLUMNS][FAS_TELEMETRY_BLOCK_ROWS];
+	uint8_t payload[FAS_TELEMETRY_PAYLOAD_MAX];
+	bool corrupt;					// 망가진 block을 만나서 멈춤
+} FAS_TELEMETRY_READER;
+
+bool FAS_TelemetryReaderOpen(FAS_TELEMETRY_READER *reader, const char *path);
+bool FAS_TelemetryRead(FAS_TELEMETRY_READER *reader, FAS_TELEMETRY_SAMPLE *sample);
+void FAS_TelemetryReaderClose(FAS_TELEMETRY_READER *reader);
+
+#endif	//FAS_TELEMETRY_DEFINE
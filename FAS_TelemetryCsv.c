@@ -0,0 +1,38 @@
+/**
+ * @file FAS_TelemetryCsv.c
+ * @brief .fct telemetry 파일을 CSV로 변환
+ * @details 사용법: FAS_TelemetryCsv file.fct > file.csv
+ * 행 순서는 파일 순서(block 단위로 보드가 바뀜)이고, 시각 순 정렬이 필요하면 board,t_us로 정렬한다.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "FAS_Telemetry.h"
+
+int main(int argc, char *argv[]){
+    static FAS_TELEMETRY_READER reader;
+    static char out_buffer[1 << 16];
+    FAS_TELEMETRY_SAMPLE s;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s file.fct > file.csv\n", argv[0]);
+        return 1;
+    }
+    if (!FAS_TelemetryReaderOpen(&reader, argv[1]))
+        return 1;
+
+    setvbuf(stdout, out_buffer, _IOFBF, sizeof(out_buffer));
+    printf("board,t_us,cmd_pos,act_pos,pos_err,act_vel,pt_item,axis_status,input,output\n");
+    uint64_t rows = 0;
+    while (FAS_TelemetryRead(&reader, &s)) {
+        printf("%d,%" PRIu64 ",%d,%d,%d,%d,%u,0x%08X,0x%08X,0x%08X\n", s.iBdID, s.t_us,
+               s.status.command_pos, s.status.actual_pos, s.status.pos_error, s.status.actual_vel,
+               s.status.pt_item, s.status.axis_status, s.status.input, s.status.output);
+        rows++;
+    }
+    fflush(stdout);
+    if (reader.corrupt)
+        fprintf(stderr, "%s: corrupt block after %" PRIu64 " rows\n", argv[1], rows);
+    FAS_TelemetryReaderClose(&reader);
+    return reader.corrupt ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file FAS_Trace.c
+ * @brief trace ring 등록과 Chrome trace-event JSON dump
+ * @details ring은 thread가 처음 trace point를 지날 때 만들어서 전역 list에 붙이고, thread가 끝나도 지우지 않는다
+ * (죽은 thread의 마지막 기록도 dump에 나오도록).
+ * dump는 쓰는 쪽을 멈추지 않는다. 복사하는 동안 덮어써진 구간은 head를 다시 읽어서 버린다.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "FAS_Trace.h"
+
+__thread FAS_TRACE_RING *fas_trace_ring = NULL;
+
+static FAS_TRACE_RING *_Atomic trace_rings = NULL;
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+static uint64_t trace_base_ticks, trace_base_ns;
+
+static const char *trace_event_name[FAS_TRACE_EVENT_COUNT] = {
+    [FAS_TRACE_BUILD] = "build",
+    [FAS_TRACE_SEND] = "send",
+    [FAS_TRACE_RECV] = "receive",
+    [FAS_TRACE_MATCH] = "match",
+    [FAS_TRACE_TIMEOUT] = "timeout",
+    [FAS_TRACE_UI_POST] = "ui-post",
+};
+
+static uint64_t monotonic_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void trace_calibrate_base(void){
+    trace_base_ns = monotonic_ns();
+    trace_base_ticks = fas_trace_ticks();
+}
+
+ /**@brief 현재 thread의 ring 생성 후 전역 list에 등록 (thread당 한 번)*/
+FAS_TRACE_RING *fas_trace_attach(void){
+    pthread_once(&trace_once, trace_calibrate_base);
+
+    FAS_TRACE_RING *ring = calloc(1, sizeof(FAS_TRACE_RING));
+    if (ring == NULL) {
+        // 메모리가 없으면 버려지는 ring 하나를 같이 씀 (기록은 섞이지만 죽지는 않게)
+        static FAS_TRACE_RING spare;
+        fas_trace_ring = &spare;
+        return &spare;
+    }
+    ring->tid = (uint32_t)syscall(SYS_gettid);
+    ring->next = atomic_load_explicit(&trace_rings, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&trace_rings, &ring->next, ring,
+                                                  memory_order_release, memory_order_relaxed))
+        ;
+    fas_trace_ring = ring;
+    return ring;
+}
+
+ /**@brief 지금까지 쌓인 기록을 Chrome trace-event JSON으로 출력 (chrome://tracing, Perfetto에서 열기)
+  * @param FILE *fp 출력 대상
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_TraceDump(FILE *fp){
+    static FAS_TRACE_RECORD copy[FAS_TRACE_RING_SIZE];
+    static pthread_mutex_t dump_lock = PTHREAD_MUTEX_INITIALIZER;	// dump끼리만 직렬화, 쓰는 쪽과는 무관
+
+    pthread_once(&trace_once, trace_calibrate_base);
+    pthread_mutex_lock(&dump_lock);
+
+    // counter -> ns 환산 비율은 init부터 지금까지의 구간으로 잡음
+    uint64_t now_ticks = fas_trace_ticks(), now_ns = monotonic_ns();
+    if (now_ns - trace_base_ns < 10000000u) {
+        usleep(10000);
+        now_ticks = fas_trace_ticks();
+        now_ns = monotonic_ns();
+    }
+    double ns_per_tick = (double)(now_ns - trace_base_ns) / (double)(now_ticks - trace_base_ticks);
+    int pid = getpid();
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", fp);
+    bool first = true;
+    for (FAS_TRACE_RING *ring = atomic_load_explicit(&trace_rings, memory_order_acquire); ring != NULL; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t start = head > FAS_TRACE_RING_SIZE ? head - FAS_TRACE_RING_SIZE : 0;
+        for (uint64_t i = start; i < head; i++)
+            copy[i - start] = ring->rec[i & (FAS_TRACE_RING_SIZE - 1)];
+
+        // 복사하는 동안 쓰는 쪽이 한 바퀴 돌아 덮어쓴 기록은 버림
+        uint64_t head_after = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t valid = head_after >= FAS_TRACE_RING_SIZE ? head_after - FAS_TRACE_RING_SIZE + 1 : 0;
+        if (valid < start)
+            valid = start;
+
+        fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"tid %u\"}}",
+                first ? "" : ",\n", pid, ring->tid, ring->tid);
+        first = false;
+        for (uint64_t i = valid; i < head; i++) {
+            const FAS_TRACE_RECORD *rec = &copy[i - start];
+            if (rec->event >= FAS_TRACE_EVENT_COUNT)
+                continue;
+            double ts_us = ((double)trace_base_ns + (double)(int64_t)(rec->ticks - trace_base_ticks) * ns_per_tick) / 1000.0;
+            fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"fastech\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,"
+                        "\"args\":{\"board\":%u,\"sync\":%u,\"arg\":%" PRIu32 "}}",
+                    trace_event_name[rec->event], ts_us, pid, ring->tid, rec->board, rec->sync, rec->arg);
+        }
+    }
+    fputs("\n]}\n", fp);
+
+    pthread_mutex_unlock(&dump_lock);
+    return !ferror(fp);
+}
+
+ /**@brief trace를 파일로 dump
+  * @param const char *path 파일 경로
+  * @return boolean 성공시 TRUE 실패시 FALSE*/
+bool FAS_TraceDumpFile(const char *path){
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        perror("Trace file open failed");
+        return false;
+    }
+    bool ok = FAS_TraceDump(fp);
+    return fclose(fp) == 0 && ok;
+}
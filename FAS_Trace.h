@@ -0,0 +1,102 @@
+
+#pragma once
+
+#ifndef FAS_TRACE_DEFINE
+#define FAS_TRACE_DEFINE
+
+/**
+ * @file FAS_Trace.h
+ * @brief 프로토콜 이벤트 trace (thread별 lock-free ring)
+ * @details FAS_TRACE_ENABLE을 정의하고 빌드했을 때만 trace point가 코드로 남는다 (-DFAS_TRACE_ENABLE).
+ * 정의하지 않으면 FAS_TRACE()는 ((void)0)이라 비용이 없다.
+ * 켜져 있으면 TSC(x86)/가상 counter(ARM64)/CLOCK_MONOTONIC 중 하나로 시각을 찍고
+ * 16 byte 기록을 자기 thread의 ring에 쓰는 것이 전부라 이벤트당 수 ns 수준이다.
+ * ring이 차면 오래된 기록부터 덮어쓴다.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define FAS_TRACE_RING_SIZE 8192	// thread당 기록 수, 2의 거듭제곱
+
+/**@brief trace point 종류*/
+typedef enum _FAS_TRACE_EVENT
+{
+	FAS_TRACE_BUILD = 0,	// 프레임 생성
+	FAS_TRACE_SEND,			// 송신 (arg: byte 수)
+	FAS_TRACE_RECV,			// 수신 (arg: byte 수)
+	FAS_TRACE_MATCH,		// 응답과 요청의 sync 일치 (arg: RTT us)
+	FAS_TRACE_TIMEOUT,		// 응답 시간 초과
+	FAS_TRACE_UI_POST,		// 결과를 GUI에 반영
+
+	FAS_TRACE_EVENT_COUNT,
+} FAS_TRACE_EVENT;
+
+/**@brief ring에 쌓이는 기록 한 개 (16 byte)*/
+typedef struct _FAS_TRACE_RECORD
+{
+	uint64_t ticks;
+	uint32_t arg;
+	uint16_t board;
+	uint8_t event;
+	uint8_t sync;
+} FAS_TRACE_RECORD;
+
+/**@brief thread 하나의 ring, 쓰는 쪽은 그 thread 하나뿐*/
+typedef struct _FAS_TRACE_RING
+{
+	_Atomic uint64_t head;
+	uint32_t tid;
+	struct _FAS_TRACE_RING *next;
+	FAS_TRACE_RECORD rec[FAS_TRACE_RING_SIZE];
+} FAS_TRACE_RING;
+
+extern __thread FAS_TRACE_RING *fas_trace_ring;
+FAS_TRACE_RING *fas_trace_attach(void);
+
+bool FAS_TraceDump(FILE *fp);
+bool FAS_TraceDumpFile(const char *path);
+
+/**@brief trace 시각 (단위는 플랫폼 counter, dump 때 ns로 환산)*/
+static inline uint64_t fas_trace_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline void fas_trace_emit(FAS_TRACE_EVENT event, int iBdID, uint8_t sync, uint32_t arg) {
+    FAS_TRACE_RING *ring = fas_trace_ring;
+    if (__builtin_expect(ring == NULL, 0))
+        ring = fas_trace_attach();
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    FAS_TRACE_RECORD *rec = &ring->rec[head & (FAS_TRACE_RING_SIZE - 1)];
+    rec->ticks = fas_trace_ticks();
+    rec->arg = arg;
+    rec->board = (uint16_t)iBdID;
+    rec->event = (uint8_t)event;
+    rec->sync = sync;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+#ifdef FAS_TRACE_ENABLE
+#define FAS_TRACE(event, iBdID, sync, arg) fas_trace_emit((event), (iBdID), (uint8_t)(sync), (uint32_t)(arg))
+#else
+#define FAS_TRACE(event, iBdID, sync, arg) ((void)0)
+#endif
+
+#endif	//FAS_TRACE_DEFINE
@@ -0,0 +1,342 @@
+/**
+ * @file FAS_Uring.c
+ * @brief io_uring 래퍼 구현 (ring mmap, fixed file, provided buffer ring, multishot recvmsg/poll)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "FAS_Uring.h"
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define FAS_URING_ENABLE
+#endif
+
+#ifdef FAS_URING_ENABLE
+
+#define BUF_SIZE 320			// recvmsg_out(16) + 주소(16) + 프레임(BUFFER_SIZE) 보다 크게, 64 byte 단위
+
+_Static_assert(sizeof(FAS_URING_CQE) == sizeof(struct io_uring_cqe), "FAS_URING_CQE layout");
+_Static_assert(FAS_URING_MORE == IORING_CQE_F_MORE, "FAS_URING_MORE");
+_Static_assert(BUF_SIZE >= sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_in) + BUFFER_SIZE, "BUF_SIZE");
+
+static int uring_setup(unsigned entries, struct io_uring_params *p){
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uring_enter(int fd, unsigned submit, unsigned wait, unsigned flags, void *arg, size_t argsz){
+    return (int)syscall(__NR_io_uring_enter, fd, submit, wait, flags, arg, argsz);
+}
+
+static int uring_register(int fd, unsigned opcode, void *arg, unsigned count){
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, count);
+}
+
+static struct io_uring_sqe *uring_sqe(FAS_URING *ring){
+    // SQ가 차면 채운 것부터 커널에 넘김 (CQE는 건드리지 않음)
+    unsigned tail = *ring->sq_tail;
+    if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+        FAS_UringSubmit(ring, false, 0);
+        if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries)
+            return NULL;
+    }
+    struct io_uring_sqe *sqe = (struct io_uring_sqe *)ring->sqes + (tail & *ring->sq_mask);
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static void uring_push(FAS_URING *ring){
+    unsigned tail = *ring->sq_tail;
+    ring->sq_array[tail & *ring->sq_mask] = tail & *ring->sq_mask;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->sq_pending++;
+}
+
+ /**@brief ring 준비, 소켓을 fixed file로, 수신 buffer를 provided buffer ring으로 등록
+  * @details 이 ring을 쓸 thread에서 불러야 한다 (SINGLE_ISSUER).
+  * @param unsigned entries SQ 크기 (CQ는 4배)
+  * @param int socket_fd fixed file 0번으로 등록할 UDP 소켓
+  * @param unsigned buffers 수신 buffer 수 (2^n)
+  * @return boolean 커널이 지원하지 않으면 FALSE (ring은 정리된 상태)*/
+bool FAS_UringInit(FAS_URING *ring, unsigned entries, int socket_fd, unsigned buffers){
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    p.cq_entries = entries * 4;
+    ring->fd = uring_setup(entries, &p);
+    if (ring->fd < 0 && errno == EINVAL) {
+        // 6.1 이전 커널: task work 지연 없이
+        memset(&p, 0, sizeof(p));
+        p.flags = IORING_SETUP_CQSIZE;
+        p.cq_entries = entries * 4;
+        ring->fd = uring_setup(entries, &p);
+    }
+    if (ring->fd < 0 || !(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP))
+        goto fail;
+
+    ring->sq_map_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_map_size > ring->sq_map_size)
+            ring->sq_map_size = ring->cq_map_size;
+        ring->cq_map_size = 0;
+    }
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_map == MAP_FAILED) {
+        ring->sq_map = NULL;
+        goto fail;
+    }
+    ring->cq_map = ring->sq_map;
+    if (ring->cq_map_size != 0) {
+        ring->cq_map = mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_map == MAP_FAILED) {
+            ring->cq_map = NULL;
+            goto fail;
+        }
+    }
+    ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        goto fail;
+    }
+
+    BYTE *sq = ring->sq_map, *cq = ring->cq_map;
+    ring->sq_head = (unsigned *)(sq + p.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + p.sq_off.array);
+    ring->sq_entries = p.sq_entries;
+    ring->cq_head = (unsigned *)(cq + p.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+    ring->cqes = (FAS_URING_CQE *)(cq + p.cq_off.cqes);
+
+    // 소켓을 fixed file로 등록 (SQE마다 fd 참조 횟수를 올리고 내리는 비용이 없어짐)
+    if (uring_register(ring->fd, IORING_REGISTER_FILES, &socket_fd, 1) < 0)
+        goto fail;
+
+    // 수신 buffer ring: 커널이 datagram마다 빈 buffer를 직접 골라 씀
+    ring->buf_count = buffers;
+    ring->buf_size = BUF_SIZE;
+    ring->buf_ring_size = buffers * sizeof(struct io_uring_buf);
+    ring->buf_ring = mmap(NULL, ring->buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ring->buf_data = malloc((size_t)buffers * BUF_SIZE);
+    if (ring->buf_ring == MAP_FAILED || ring->buf_data == NULL) {
+        if (ring->buf_ring == MAP_FAILED)
+            ring->buf_ring = NULL;
+        goto fail;
+    }
+    struct io_uring_buf_reg reg = { .ring_addr = (uint64_t)(uintptr_t)ring->buf_ring, .ring_entries = buffers, .bgid = 0 };
+    if (uring_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        goto fail;
+    struct io_uring_buf_ring *br = ring->buf_ring;
+    for (unsigned i = 0; i < buffers; i++) {
+        br->bufs[i].addr = (uint64_t)(uintptr_t)(ring->buf_data + (size_t)i * BUF_SIZE);
+        br->bufs[i].len = BUF_SIZE;
+        br->bufs[i].bid = (uint16_t)i;
+    }
+    ring->buf_tail = (uint16_t)buffers;
+    __atomic_store_n(&br->tail, ring->buf_tail, __ATOMIC_RELEASE);
+
+    ring->recv_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    return true;
+
+fail:
+    FAS_UringFree(ring);
+    return false;
+}
+
+ /**@brief ring 정리 (등록한 file/buffer는 ring fd를 닫을 때 같이 풀림)*/
+void FAS_UringFree(FAS_URING *ring){
+    if (ring->fd >= 0)
+        close(ring->fd);
+    if (ring->sqes != NULL)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_map != NULL && ring->cq_map != ring->sq_map)
+        munmap(ring->cq_map, ring->cq_map_size);
+    if (ring->sq_map != NULL)
+        munmap(ring->sq_map, ring->sq_map_size);
+    if (ring->buf_ring != NULL)
+        munmap(ring->buf_ring, ring->buf_ring_size);
+    free(ring->buf_data);
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+}
+
+ /**@brief 송신 SQE 추가 (msg와 가리키는 frame은 CQE가 나올 때까지 유지)*/
+bool FAS_UringSendmsg(FAS_URING *ring, const struct msghdr *msg, uint64_t user_data){
+    struct io_uring_sqe *sqe = uring_sqe(ring);
+    if (sqe == NULL)
+        return false;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = 0;
+    sqe->addr = (uint64_t)(uintptr_t)msg;
+    sqe->len = 1;
+    sqe->user_data = user_data;
+    uring_push(ring);
+    return true;
+}
+
+ /**@brief 등록한 소켓에 multishot recvmsg를 검 (CQE에 FAS_URING_MORE가 없어지면 다시 걸어야 함)*/
+bool FAS_UringRecvMultishot(FAS_URING *ring, uint64_t user_data){
+    struct io_uring_sqe *sqe = uring_sqe(ring);
+    if (sqe == NULL)
+        return false;
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->fd = 0;
+    sqe->addr = (uint64_t)(uintptr_t)&ring->recv_hdr;
+    sqe->len = 1;
+    sqe->buf_group = 0;
+    sqe->user_data = user_data;
+    uring_push(ring);
+    return true;
+}
+
+ /**@brief 일반 fd(eventfd 등)에 multishot poll을 검, 읽을 수 있게 될 때마다 CQE 하나*/
+bool FAS_UringPollMultishot(FAS_URING *ring, int fd, uint64_t user_data){
+    struct io_uring_sqe *sqe = uring_sqe(ring);
+    if (sqe == NULL)
+        return false;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = user_data;
+    uring_push(ring);
+    return true;
+}
+
+ /**@brief 채운 SQE를 넘기고 완료를 모음 (syscall 한 번)
+  * @param bool wait CQ가 비어 있으면 CQE 하나가 올 때까지 기다림
+  * @param int64_t timeout_us 기다리는 최대 시간, 음수면 무한
+  * @return 넘긴 SQE 수, 실패시 -1*/
+int FAS_UringSubmit(FAS_URING *ring, bool wait, int64_t timeout_us){
+    if (wait && (timeout_us == 0 || *ring->cq_head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)))
+        wait = false;
+
+    unsigned flags = IORING_ENTER_GETEVENTS;
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    void *argp = NULL;
+    size_t argsz = 0;
+    if (wait && timeout_us > 0) {
+        ts.tv_sec = timeout_us / 1000000;
+        ts.tv_nsec = (timeout_us % 1000000) * 1000;
+        memset(&arg, 0, sizeof(arg));
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+        flags |= IORING_ENTER_EXT_ARG;
+        argp = &arg;
+        argsz = sizeof(arg);
+    }
+
+    int ret = uring_enter(ring->fd, ring->sq_pending, wait ? 1 : 0, flags, argp, argsz);
+    ring->enters++;
+    if (ret < 0) {
+        if (errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            return 0;
+        perror("io_uring_enter failed");
+        return -1;
+    }
+    ring->sq_pending -= (unsigned)ret;
+    return ret;
+}
+
+ /**@brief CQE 하나를 꺼냄
+  * @return CQ가 비어 있으면 FALSE*/
+bool FAS_UringNext(FAS_URING *ring, FAS_URING_CQE *cqe){
+    unsigned head = *ring->cq_head;
+    if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+        return false;
+    *cqe = ring->cqes[head & *ring->cq_mask];
+    __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+ /**@brief multishot recvmsg CQE에서 보낸 주소와 datagram을 꺼냄 (data는 FAS_UringRecycle 전까지 유효)
+  * @return datagram 길이, buffer가 없는 CQE(오류)면 -1*/
+int FAS_UringRecvData(FAS_URING *ring, const FAS_URING_CQE *cqe, struct sockaddr_in *from, const BYTE **data){
+    if (cqe->res < 0 || !(cqe->flags & IORING_CQE_F_BUFFER))
+        return -1;
+    BYTE *buf = ring->buf_data + (size_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT) * ring->buf_size;
+    struct io_uring_recvmsg_out *out = (struct io_uring_recvmsg_out *)buf;
+    BYTE *name = buf + sizeof(*out);
+    memset(from, 0, sizeof(*from));
+    memcpy(from, name, out->namelen < sizeof(*from) ? out->namelen : sizeof(*from));
+    *data = name + ring->recv_hdr.msg_namelen + ring->recv_hdr.msg_controllen;
+    int len = (int)out->payloadlen;
+    int room = (int)(ring->buf_size - (*data - buf));
+    return len < room ? len : room;
+}
+
+ /**@brief recvmsg CQE가 쓴 buffer를 buffer ring에 돌려줌*/
+void FAS_UringRecycle(FAS_URING *ring, const FAS_URING_CQE *cqe){
+    if (!(cqe->flags & IORING_CQE_F_BUFFER))
+        return;
+    struct io_uring_buf_ring *br = ring->buf_ring;
+    uint16_t bid = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+    struct io_uring_buf *b = &br->bufs[ring->buf_tail & (ring->buf_count - 1)];
+    b->addr = (uint64_t)(uintptr_t)(ring->buf_data + (size_t)bid * ring->buf_size);
+    b->len = ring->buf_size;
+    b->bid = bid;
+    ring->buf_tail++;
+    __atomic_store_n(&br->tail, ring->buf_tail, __ATOMIC_RELEASE);
+}
+
+#else	// 헤더가 오래된 환경: 항상 epoll 경로
+
+bool FAS_UringInit(FAS_URING *ring, unsigned entries, int socket_fd, unsigned buffers){
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+    return false;
+}
+
+void FAS_UringFree(FAS_URING *ring){
+}
+
+bool FAS_UringSendmsg(FAS_URING *ring, const struct msghdr *msg, uint64_t user_data){
+    return false;
+}
+
+bool FAS_UringRecvMultishot(FAS_URING *ring, uint64_t user_data){
+    return false;
+}
+
+bool FAS_UringPollMultishot(FAS_URING *ring, int fd, uint64_t user_data){
+    return false;
+}
+
+int FAS_UringSubmit(FAS_URING *ring, bool wait, int64_t timeout_us){
+    return -1;
+}
+
+bool FAS_UringNext(FAS_URING *ring, FAS_URING_CQE *cqe){
+    return false;
+}
+
+int FAS_UringRecvData(FAS_URING *ring, const FAS_URING_CQE *cqe, struct sockaddr_in *from, const BYTE **data){
+    return -1;
+}
+
+void FAS_UringRecycle(FAS_URING *ring, const FAS_URING_CQE *cqe){
+}
+
+#endif	//FAS_URING_ENABLE
@@ -0,0 +1,69 @@
+
+#pragma once
+
+#ifndef FAS_URING_DEFINE
+#define FAS_URING_DEFINE
+
+/**
+ * @file FAS_Uring.h
+ * @brief shard transport가 쓰는 최소한의 io_uring 래퍼 (liburing 없이 syscall 직접 호출)
+ * @details 소켓은 fixed file(0번)으로 등록하고, 수신 buffer는 커널에 등록한 provided buffer ring에서
+ * 커널이 직접 골라 쓴다. 수신은 multishot recvmsg 하나를 걸어 두면 datagram마다 CQE가 계속 나오므로
+ * 다시 걸 필요가 없고, 송신 SQE와 CQE 수거는 io_uring_enter 한 번으로 같이 한다.
+ * 커널이 io_uring/multishot recvmsg/buffer ring을 지원하지 않거나 헤더가 오래돼서 빌드에서 빠지면
+ * FAS_UringInit이 FALSE를 돌려주고, 호출 쪽은 epoll 경로로 돌아간다.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "Protocol_Define.h"
+
+#define FAS_URING_MORE (1U << 1)			// IORING_CQE_F_MORE: multishot 요청이 아직 살아 있음
+
+/**@brief CQE 사본 (struct io_uring_cqe의 앞 16 byte와 같은 배치)*/
+typedef struct _FAS_URING_CQE
+{
+	uint64_t user_data;
+	int32_t res;					// 결과, 음수면 -errno
+	uint32_t flags;
+} FAS_URING_CQE;
+
+typedef struct _FAS_URING
+{
+	int fd;
+	unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+	void *sqes;
+	unsigned sq_entries;
+	unsigned sq_pending;			// 채웠지만 아직 커널에 안 넘긴 SQE 수
+	unsigned *cq_head, *cq_tail, *cq_mask;
+	FAS_URING_CQE *cqes;
+	void *sq_map, *cq_map;
+	size_t sq_map_size, cq_map_size, sqes_size;
+
+	// provided buffer ring (group 0), 수신 datagram이 여기로 들어옴
+	void *buf_ring;
+	size_t buf_ring_size;
+	unsigned buf_count;				// 2^n
+	unsigned buf_size;
+	uint16_t buf_tail;
+	BYTE *buf_data;
+
+	struct msghdr recv_hdr;			// multishot recvmsg 틀 (주소 길이만 씀)
+	uint64_t enters;				// io_uring_enter 호출 수
+} FAS_URING;
+
+bool FAS_UringInit(FAS_URING *ring, unsigned entries, int socket_fd, unsigned buffers);
+void FAS_UringFree(FAS_URING *ring);
+
+bool FAS_UringSendmsg(FAS_URING *ring, const struct msghdr *msg, uint64_t user_data);
+bool FAS_UringRecvMultishot(FAS_URING *ring, uint64_t user_data);
+bool FAS_UringPollMultishot(FAS_URING *ring, int fd, uint64_t user_data);
+
+int FAS_UringSubmit(FAS_URING *ring, bool wait, int64_t timeout_us);
+bool FAS_UringNext(FAS_URING *ring, FAS_URING_CQE *cqe);
+int FAS_UringRecvData(FAS_URING *ring, const FAS_URING_CQE *cqe, struct sockaddr_in *from, const BYTE **data);
+void FAS_UringRecycle(FAS_URING *ring, const FAS_URING_CQE *cqe);
+
+#endif	//FAS_URING_DEFINE
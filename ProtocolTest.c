@@ -6,11 +6,14 @@
  * @brief Fastech 프로그램의 Protocol Test 구현을 위한 프로그램
  * @details C언어와 GTK3(라즈비안(데비안11) 호환을 위해서), GLADE(UI XML->.glade파일) 사용
  * Ethernet 부분(Ezi Servo Plus-E 모델용)만 구현, 
- * 라이브러리로 분리할 만한 기본 함수, GUI프로그램 구현 함수가 섞인 상태
+ * FAS_* 통신 함수는 libfastech(FAS_Library.h)로 분리, 이 파일은 GUI만 담당
+ * 빌드: make ProtocolTest (libfastech.a 링크, UI(.glade/.ui)는 GResource로 실행 파일에 들어감)
+ * (trace point를 켜려면 -DFAS_TRACE_ENABLE 추가, 실행 중 kill -USR1 <pid> 하면 /tmp/fastech_trace_<pid>.json 생성)
  * @warning 동작 시 예외처리가 제대로 안되어있으니 정확한 절차로만 작동시킬것
  */
 
 #include <gtk/gtk.h>
+#include <glib-unix.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/select.h>
@@ -21,52 +24,56 @@
 #include <unistd.h>
 #include <time.h>
 #include <inttypes.h>
-#include <arpa/inet.h>
 #include "ReturnCodes_Define.h"
+#include "Protocol_Define.h"
+#include "FAS_Library.h"
+#include "FAS_Metrics.h"
+#include "FAS_Trace.h"
+#include "FAS_FrameEdit.h"
+#include "FAS_Scope.h"
+#include "FAS_Status.h"
+#include "FAS_List.h"
+#include "FAS_EStop.h"
+#include <arpa/inet.h>
 
 
 /************************************************************************************************************************************
- ********************************나중에 라이브러리로 뺄 FASTECH 라이브러리와 같은 기능의 함수*************************************************
+ ******************************** GUI가 편집 중인 프레임 상태 (통신 상태는 board 0의 FAS_CONTEXT에 있음) ************************************
  ************************************************************************************************************************************/
- 
-typedef uint8_t BYTE;
-typedef uint32_t DWORD;
-typedef char* LPSTR;
-
-#define BUFFER_SIZE 258
-#define DATA_SIZE 253
-#define PORT_UDP 3001 //UDP GUI
-#define PORT_TCP 2001 //TCP GUI
-#define TIMEOUT_SECONDS 2
-
-int client_socket;
-struct sockaddr_in server_addr;
 
-static BYTE header, sync_no, frame_type;
+static FAS_CONTEXT *board;				// FAS_BoardContext(0), Header/Sync No./소켓/응답
+static BYTE frame_type;
 static BYTE data[DATA_SIZE];
-static BYTE buffer[BUFFER_SIZE];
+static BYTE buffer[BUFFER_SIZE];		// 화면에 보이는 송신 프레임
+static int buffer_len;					// buffer에 든 프레임 길이 (codec encode가 돌려준 값, 없으면 0)
+static FAS_FRAME_EDIT frame_edit;		// Frame칸 내용과 그 byte 배열
+static FAS_SCOPE *scope;				// Status Monitor, 처음 열 때 만듦 (history가 커서 heap)
+static FAS_CODEC user_port_codec;		// User Port No.를 켰을 때 쓰는 codec (Header codec에 port만 바꿈)
+static FAS_ESTOP *estop;				// 비상정지 전용 경로, 연결/해제 때마다 프레임을 미리 만들어 둠
+static FAS_LIST *command_list;			// Use List 명령 목록, 처음 켤 때 만듦 (요청 buffer가 커서 heap)
+static bool frame_preview_shown;		// 송신 buffer 미리보기가 frame_edit 내용인지 (다른 곳에서 덮어쓰면 FALSE)
 
 char *protocol;
 bool show = TRUE;
 
-bool FAS_Connect(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID);
-bool FAS_ConnectTCP(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID);
-
-void FAS_Close(int iBdID);
-
-int FAS_ServoEnable(int iBdID, bool bOnOff);
-int FAS_MoveOriginSingleAxis(int iBdID);
-int FAS_MoveStop(int iBdID);
-int FAS_MoveVelocity(int iBdID, DWORD IVelocity, int iVelDir);
-int FAS_GetboardInfo(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize);
-int FAS_GetMotorInfo(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize);
-int FAS_GetEncoder(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize);
-int FAS_GetFirmwareInfo(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize);
-int FAS_GetSlaveInfoEx(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize);
-int FAS_SaveAllParameters(int iBdID);
-int FAS_ServoAlarmReset(int iBdID);
-int FAS_EmergencyStop(int iBdID);
-int FAS_GetAlarmType(int iBdID);
+#define SCOPE_PERIOD_US 10000			// 100Hz polling
+#define SCOPE_HISTORY (100 * 60 * 10)	// 10분
+#define SCOPE_MAX_COLUMNS 4096
+
+/**@brief scope 창 상태*/
+typedef struct _SCOPE_VIEW
+{
+	GtkWidget *window;
+	GtkWidget *area;
+	GtkLabel *label;
+	GtkToggleButton *pause;
+	GtkToggleButton *record;
+	FAS_TELEMETRY *telemetry;		// Record 중인 파일
+	uint64_t span;					// 화면에 보이는 sample 수 (휠로 확대/축소)
+	uint64_t paused_end;			// 멈췄을 때 오른쪽 끝 sample
+} SCOPE_VIEW;
+
+static SCOPE_VIEW scope_view;
 
 /************************************************************************************************************************************
  ***************************GUI 프로그램의 버튼 등 구성요소들에서 사용하는 callback등 여러 함수***********************************************
@@ -92,164 +99,267 @@ static void on_combo_direction_changed(GtkComboBox *combo_id, gpointer user_data
 static void on_check_autosync_toggled(GtkToggleButton *togglebutton, gpointer user_data);
 static void on_check_fastech_toggled(GtkToggleButton *togglebutton, gpointer user_data);
 static void on_check_showsend_toggled(GtkToggleButton *togglebutton, gpointer user_data);
+static void on_check_uselist_toggled(GtkToggleButton *togglebutton, gpointer user_data);
+static void on_list_add_clicked(GtkButton *button, gpointer user_data);
+static void on_list_run_clicked(GtkButton *button, gpointer user_data);
 
-gboolean on_text_frame_key_release_event(GtkWidget *widget, GdkEventKey *event, gpointer user_data);
+static void on_button_metrics_clicked(GtkButton *button, gpointer user_data);
+static gboolean metrics_panel_refresh(gpointer user_data);
+
+static void on_button_statusmonitor_clicked(GtkButton *button, gpointer user_data);
+static void on_button_estop_clicked(GtkButton *button, gpointer user_data);
+static void on_button_analyzeflag_clicked(GtkButton *button, gpointer user_data);
+static gboolean scope_refresh(gpointer user_data);
+
+static void on_frame_insert_text(GtkTextBuffer *text_buffer, GtkTextIter *location, gchar *text, gint len, gpointer user_data);
+static void on_frame_delete_range(GtkTextBuffer *text_buffer, GtkTextIter *start, GtkTextIter *end, gpointer user_data);
 /************************************************************************************************************************************
  ******************************************************* 편의상 만든 함수 **************************************************************
  ************************************************************************************************************************************/
  
-GtkWidget *text_sendbuffer;
-GtkWidget *text_monitor1;
-GtkWidget *text_monitor2;
-GtkWidget *text_autosync;
-GtkWidget *text_frame;
-GtkWidget *record_command1;
-GtkWidget *record_command2;
-GtkWidget *record_command3;
-GtkWidget *record_command4;
-
-GtkTextBuffer *sendbuffer_buffer;
-GtkTextBuffer *monitor1_buffer;
-GtkTextBuffer *monitor2_buffer;
-GtkTextBuffer *autosync_buffer;
-GtkTextBuffer *frame_buffer;
-GtkTextBuffer *record1_buffer;
-GtkTextBuffer *record2_buffer;
-GtkTextBuffer *record3_buffer;
-GtkTextBuffer *record4_buffer;
-
-GtkLabel *label_status;
-GtkLabel *label_time; 
+/**@brief 시작할 때 한 번만 찾아 두는 위젯 (callback에서 이름으로 찾지 않음)
+ * Record/명령 page의 위젯은 그 page가 처음 보일 때 채워짐*/
+typedef struct _PROTOCOLTEST_UI
+{
+	GtkBuilder *builder;
+	GtkWidget *window;
+	GtkStack *stk1;
+	GtkStack *stk2;
+	GtkWidget *button_send;
+	GtkEntry *entry_ip;
+	GtkEntry *entry_speed;				// 0x37 page
+	GtkToggleButton *check_fastech;
+	GtkToggleButton *check_userport;
+	GtkToggleButton *check_uselist;
+
+	GtkTextBuffer *sendbuffer_buffer;
+	GtkTextBuffer *monitor1_buffer;
+	GtkTextBuffer *monitor2_buffer;
+	GtkTextBuffer *autosync_buffer;
+	GtkTextBuffer *userport_buffer;
+	GtkTextBuffer *frame_buffer;
+	GtkTextBuffer *record1_buffer;		// Record page
+	GtkTextBuffer *record2_buffer;
+	GtkTextBuffer *record3_buffer;
+	GtkTextBuffer *record4_buffer;
+
+	GtkLabel *label_status;
+	GtkLabel *label_time;
+
+	GtkWidget *metrics_window;
+	GtkLabel *metrics_label;
+
+	GtkWidget *list_window;				// Use List 창
+	GtkTextBuffer *list_buffer;			// 명령 목록 글
+	GtkLabel *list_label;				// 마지막 실행 결과
+} PROTOCOLTEST_UI;
+
+/**@brief 처음 보일 때 resource에서 만드는 stack page*/
+typedef struct _LAZY_PAGE
+{
+	const char *placeholder;			// ProtocolTest.glade 안의 빈 page id
+	const char *resource;				// page 내용 .ui
+	const char *root;					// .ui 안의 최상위 위젯 id
+	void (*setup)(void);				// 위젯 찾기, signal 연결
+	GtkWidget *slot;					// placeholder 위젯
+	bool built;
+} LAZY_PAGE;
+
+#define UI_RESOURCE "/kr/ac/skku/fastech/ProtocolTest/"
+
+static PROTOCOLTEST_UI ui;
+static uint64_t startup_us;				// main 진입 시각
+
+static void setup_record_page(void);
+static void setup_servo_page(void);
+static void setup_velocity_page(void);
+
+static LAZY_PAGE lazy_pages[] = {
+    { "Record",     UI_RESOURCE "ProtocolTest_Record.ui", "record_page", setup_record_page },
+    { "Fixed_0x2A", UI_RESOURCE "ProtocolTest_0x2A.ui",   "page_0x2A",   setup_servo_page },
+    { "Fixed_0x37", UI_RESOURCE "ProtocolTest_0x37.ui",   "page_0x37",   setup_velocity_page },
+};
+
+static void on_stack_visible_child(GObject *stack, GParamSpec *pspec, gpointer user_data);
+static gboolean report_startup(gpointer user_data);
  
 void syno_no_update();
-char* get_time();
-void handle_alarm(int signum);
-void send_packet(BYTE *byte_array);
-void send_packetTCP(BYTE *byte_array);
+void get_time(char *time_string);
+gboolean handle_trace_dump(gpointer user_data);
+void send_packet(BYTE *byte_array, int frame_len);
 void library_interface();
-char *command_interface();
-char *FMM_interface(FMM_ERROR error);
+const char *command_interface();
 void print_buffer(uint8_t *array, size_t size);
-char* array_to_string(const unsigned char *array, int size);
+const char *array_to_string(const uint8_t *array, int size);
+int text_buffer_copy(GtkTextBuffer *text_buffer, char *out, int out_size);
+void codec_select();
 
 
  /**@brief Main 함수*/
 int main(int argc, char *argv[]) {
-    GtkBuilder *builder;
-    GtkWidget *window;
-    GObject *button;
-    GtkComboBoxText *combo_text;
-    GtkComboBox* combo_id;
-    GObject *checkbox;
     GError *error = NULL;
     
+    startup_us = FAS_MonotonicUs();
     srand(time(NULL));
-    signal(SIGALRM, handle_alarm);
+    g_unix_signal_add(SIGUSR1, handle_trace_dump, NULL);
+
+    board = FAS_BoardContext(0);
+    FAS_ContextSetCodec(board, &FAS_CodecFastech);
+    board->link.sync_no = (BYTE)(rand() % 256);
 
-    header = 0xAA;
-    sync_no = (BYTE)(rand() % 256);
+    // 통계 테이블은 공유메모리에 올리고, 안되면 프로세스 내부 메모리 사용
+    if (!FAS_MetricsInit(FAS_METRICS_SHM))
+        FAS_MetricsInit(NULL);
+    FAS_MetricsServe(FAS_METRICS_SOCK);
+
+    estop = malloc(sizeof(FAS_ESTOP));
+    if (estop != NULL && !FAS_EStopInit(estop)) {
+        free(estop);
+        estop = NULL;
+    }
     
     // GTK 초기화
     gtk_init(&argc, &argv);
 
-    // GtkBuilder 생성
-    builder = gtk_builder_new();
-
-    // XML file에서 UI불러오기
-    if (!gtk_builder_add_from_file(builder, "ProtocolTest.glade", &error)) {
-        g_printerr("Error loading UI file: %s\n", error->message);
+    // 실행 파일에 들어 있는 resource에서 UI불러오기 (현재 디렉토리와 무관)
+    // Record page와 명령별 page는 처음 보일 때 on_stack_visible_child에서 만듦
+    ui.builder = gtk_builder_new();
+    if (!gtk_builder_add_from_resource(ui.builder, UI_RESOURCE "ProtocolTest.glade", &error)) {
+        g_printerr("Error loading UI resource: %s\n", error->message);
         g_clear_error(&error);
         return 1;
     }
-
-    // Window 생성
-    window = GTK_WIDGET(gtk_builder_get_object(builder, "window"));
-    gtk_widget_show_all(window);
-    
-    GtkStack *stk2 = GTK_STACK(gtk_builder_get_object(builder, "stk2"));
-    
-    text_monitor1 = GTK_WIDGET(gtk_builder_get_object(builder, "text_monitor1"));
-    monitor1_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_monitor1));
-    text_monitor2 = GTK_WIDGET(gtk_builder_get_object(builder, "text_monitor2"));
-    monitor2_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_monitor2));
-    text_sendbuffer = GTK_WIDGET(gtk_builder_get_object(builder, "text_sendbuffer"));
-    sendbuffer_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_sendbuffer));
-    text_autosync = GTK_WIDGET(gtk_builder_get_object(builder, "text_autosync"));
-    autosync_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_autosync));
-    
-    record_command1 = GTK_WIDGET(gtk_builder_get_object(builder, "record_command1"));
-    record1_buffer= gtk_text_view_get_buffer(GTK_TEXT_VIEW(record_command1));
-    record_command2 = GTK_WIDGET(gtk_builder_get_object(builder, "record_command2"));
-    record2_buffer= gtk_text_view_get_buffer(GTK_TEXT_VIEW(record_command2));
-    record_command3 = GTK_WIDGET(gtk_builder_get_object(builder, "record_command3"));
-    record3_buffer= gtk_text_view_get_buffer(GTK_TEXT_VIEW(record_command3));
-    record_command4 = GTK_WIDGET(gtk_builder_get_object(builder, "record_command4"));
-    record4_buffer= gtk_text_view_get_buffer(GTK_TEXT_VIEW(record_command4));
-    
-    text_frame = GTK_WIDGET(gtk_builder_get_object(builder, "text_frame"));
-    frame_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_frame));
-    g_signal_connect(text_frame, "key-release-event", G_CALLBACK(on_text_frame_key_release_event), NULL);
-    
-    label_status = GTK_LABEL(gtk_builder_get_object(builder, "label_status"));
-    label_time = GTK_LABEL(gtk_builder_get_object(builder, "label_time"));
-    
-    // callback 함수 연결, user_data를 빌더로 사용함
-    button = gtk_builder_get_object(builder, "button_connect");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_connect_clicked), builder);
-    button = gtk_builder_get_object(builder, "button_send");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_send_clicked), builder);
-    
-    button = gtk_builder_get_object(builder, "button_record1");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_record1_clicked), builder);
-    button = gtk_builder_get_object(builder, "button_record2");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_record2_clicked), builder);
-    button = gtk_builder_get_object(builder, "button_record3");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_record3_clicked), builder);
-    button = gtk_builder_get_object(builder, "button_record4");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_record4_clicked), builder);
-    
-    button = gtk_builder_get_object(builder, "button_transfer1");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_transfer1_clicked), NULL);
-    button = gtk_builder_get_object(builder, "button_transfer2");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_transfer2_clicked), NULL);
-    button = gtk_builder_get_object(builder, "button_transfer3");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_transfer3_clicked), NULL);
-    button = gtk_builder_get_object(builder, "button_transfer4");
-    g_signal_connect(button, "clicked", G_CALLBACK(on_button_transfer4_clicked), NULL);
+    GtkBuilder *builder = ui.builder;
+
+    // 위젯은 여기서 한 번만 찾아 둠
+    ui.window = GTK_WIDGET(gtk_builder_get_object(builder, "window"));
+    ui.stk1 = GTK_STACK(gtk_builder_get_object(builder, "stk1"));
+    ui.stk2 = GTK_STACK(gtk_builder_get_object(builder, "stk2"));
+    ui.button_send = GTK_WIDGET(gtk_builder_get_object(builder, "button_send"));
+    ui.entry_ip = GTK_ENTRY(gtk_builder_get_object(builder, "entry_ip"));
+    ui.monitor1_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "text_monitor1")));
+    ui.monitor2_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "text_monitor2")));
+    ui.sendbuffer_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "text_sendbuffer")));
+    ui.autosync_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "text_autosync")));
+    ui.userport_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "text_userport")));
+    ui.check_fastech = GTK_TOGGLE_BUTTON(gtk_builder_get_object(builder, "check_fastech"));
+    ui.check_userport = GTK_TOGGLE_BUTTON(gtk_builder_get_object(builder, "check_userport"));
+    ui.check_uselist = GTK_TOGGLE_BUTTON(gtk_builder_get_object(builder, "check_uselist"));
+    ui.label_status = GTK_LABEL(gtk_builder_get_object(builder, "label_status"));
+    ui.label_time = GTK_LABEL(gtk_builder_get_object(builder, "label_time"));
+    for (size_t i = 0; i < G_N_ELEMENTS(lazy_pages); i++)
+        lazy_pages[i].slot = GTK_WIDGET(gtk_builder_get_object(builder, lazy_pages[i].placeholder));
     
-    combo_text = GTK_COMBO_BOX_TEXT(gtk_builder_get_object(builder, "combo_protocol"));
-    g_signal_connect(combo_text, "changed", G_CALLBACK(on_combo_protocol_changed), NULL);
+    // Frame칸은 글자가 바뀌기 직전에 편집 model(frame_edit)에 같은 편집을 적용
+    ui.frame_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "text_frame")));
+    FAS_FrameEditInit(&frame_edit);
+    g_signal_connect(ui.frame_buffer, "insert-text", G_CALLBACK(on_frame_insert_text), NULL);
+    g_signal_connect(ui.frame_buffer, "delete-range", G_CALLBACK(on_frame_delete_range), NULL);
     
-    combo_id = GTK_COMBO_BOX(gtk_builder_get_object(builder, "combo_command"));
-    g_signal_connect(combo_id, "changed", G_CALLBACK(on_combo_command_changed), stk2);
-    combo_id = GTK_COMBO_BOX(gtk_builder_get_object(builder, "combo_data1"));
-    g_signal_connect(combo_id, "changed", G_CALLBACK(on_combo_data1_changed), NULL);
-    combo_id = GTK_COMBO_BOX(gtk_builder_get_object(builder, "combo_direction"));
-    g_signal_connect(combo_id, "changed", G_CALLBACK(on_combo_direction_changed), builder);
-
-
-    checkbox = gtk_builder_get_object(builder, "check_autosync");
-    g_signal_connect(checkbox, "toggled", G_CALLBACK(on_check_autosync_toggled), NULL);
-    checkbox = gtk_builder_get_object(builder, "check_fastech");
-    g_signal_connect(checkbox, "toggled", G_CALLBACK(on_check_fastech_toggled), NULL);
-    checkbox = gtk_builder_get_object(builder, "check_showsend");
-    g_signal_connect(checkbox, "toggled", G_CALLBACK(on_check_showsend_toggled), NULL);
+    // callback 함수 연결
+    g_signal_connect(gtk_builder_get_object(builder, "button_connect"), "clicked", G_CALLBACK(on_button_connect_clicked), NULL);
+    g_signal_connect(ui.button_send, "clicked", G_CALLBACK(on_button_send_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "combo_protocol"), "changed", G_CALLBACK(on_combo_protocol_changed), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "combo_command"), "changed", G_CALLBACK(on_combo_command_changed), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "check_autosync"), "toggled", G_CALLBACK(on_check_autosync_toggled), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "check_fastech"), "toggled", G_CALLBACK(on_check_fastech_toggled), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "check_showsend"), "toggled", G_CALLBACK(on_check_showsend_toggled), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "check_uselist"), "toggled", G_CALLBACK(on_check_uselist_toggled), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_metrics"), "clicked", G_CALLBACK(on_button_metrics_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_statusmonitor"), "clicked", G_CALLBACK(on_button_statusmonitor_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_estop"), "clicked", G_CALLBACK(on_button_estop_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_analyzeflag"), "clicked", G_CALLBACK(on_button_analyzeflag_clicked), NULL);
+    g_signal_connect(ui.stk1, "notify::visible-child", G_CALLBACK(on_stack_visible_child), NULL);
+    g_signal_connect(ui.stk2, "notify::visible-child", G_CALLBACK(on_stack_visible_child), NULL);
     
     char sync_str[4];
-    sprintf(sync_str, "%u", sync_no);
-    
-    gtk_text_buffer_set_text(autosync_buffer, sync_str, -1);
-    
-    GObject *button_send = gtk_builder_get_object(builder, "button_send");
-    gtk_widget_set_sensitive(GTK_WIDGET(button_send), FALSE);
+    sprintf(sync_str, "%u", board->link.sync_no);
+    gtk_text_buffer_set_text(ui.autosync_buffer, sync_str, -1);
+    gtk_widget_set_sensitive(ui.button_send, FALSE);
+
+    // Window 표시, 첫 화면이 그려진 뒤 기동 시간 출력
+    gtk_widget_show_all(ui.window);
+    g_idle_add(report_startup, NULL);
 
     // 메인 루프 실행
     // Start the GTK main loop
     gtk_main();
 
+    if (scope != NULL) {
+        FAS_ScopeFree(scope);
+        if (scope_view.telemetry != NULL)
+            FAS_TelemetryClose(scope_view.telemetry);
+    }
+    g_free(command_list);
+    FAS_Close(0);
+    FAS_MetricsShutdown();
+    g_object_unref(ui.builder);
     return 0;
 }
 
+ /**@brief 첫 화면까지 걸린 시간을 한 번 출력 (main 진입 기준)*/
+static gboolean report_startup(gpointer user_data) {
+    g_print("Startup: %.1f ms\n", (FAS_MonotonicUs() - startup_us) / 1000.0);
+    return G_SOURCE_REMOVE;
+}
+
+/************************************************************************************************************************************
+ ******************************************** 처음 보일 때 만드는 stack page (Record, 명령별 입력칸) ********************************************
+ ************************************************************************************************************************************/
+
+ /**@brief stk1/stk2의 보이는 page가 바뀔 때의 callback, 아직 안 만든 page면 resource에서 만들어 붙임*/
+static void on_stack_visible_child(GObject *stack, GParamSpec *pspec, gpointer user_data) {
+    GtkWidget *child = gtk_stack_get_visible_child(GTK_STACK(stack));
+    GError *error = NULL;
+
+    for (size_t i = 0; i < G_N_ELEMENTS(lazy_pages); i++) {
+        LAZY_PAGE *page = &lazy_pages[i];
+        if (page->built || page->slot != child)
+            continue;
+        if (!gtk_builder_add_from_resource(ui.builder, page->resource, &error)) {
+            g_printerr("Error loading UI resource: %s\n", error->message);
+            g_clear_error(&error);
+            return;
+        }
+        GtkWidget *root = GTK_WIDGET(gtk_builder_get_object(ui.builder, page->root));
+        gtk_container_add(GTK_CONTAINER(page->slot), root);
+        page->setup();
+        gtk_widget_show_all(root);
+        page->built = TRUE;
+        return;
+    }
+}
+
+ /**@brief Record page: 기록칸 buffer, Record/Transfer버튼 연결*/
+static void setup_record_page(void) {
+    GtkBuilder *builder = ui.builder;
+    ui.record1_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "record_command1")));
+    ui.record2_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "record_command2")));
+    ui.record3_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "record_command3")));
+    ui.record4_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(gtk_builder_get_object(builder, "record_command4")));
+    
+    g_signal_connect(gtk_builder_get_object(builder, "button_record1"), "clicked", G_CALLBACK(on_button_record1_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_record2"), "clicked", G_CALLBACK(on_button_record2_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_record3"), "clicked", G_CALLBACK(on_button_record3_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_record4"), "clicked", G_CALLBACK(on_button_record4_clicked), NULL);
+    
+    g_signal_connect(gtk_builder_get_object(builder, "button_transfer1"), "clicked", G_CALLBACK(on_button_transfer1_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_transfer2"), "clicked", G_CALLBACK(on_button_transfer2_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_transfer3"), "clicked", G_CALLBACK(on_button_transfer3_clicked), NULL);
+    g_signal_connect(gtk_builder_get_object(builder, "button_transfer4"), "clicked", G_CALLBACK(on_button_transfer4_clicked), NULL);
+}
+
+ /**@brief 0x2A(ServoEnable) page: Enable 선택 콤보박스 연결*/
+static void setup_servo_page(void) {
+    g_signal_connect(gtk_builder_get_object(ui.builder, "combo_data1"), "changed", G_CALLBACK(on_combo_data1_changed), NULL);
+}
+
+ /**@brief 0x37(MoveVelocity) page: 속도 입력칸, 방향 콤보박스 연결*/
+static void setup_velocity_page(void) {
+    ui.entry_speed = GTK_ENTRY(gtk_builder_get_object(ui.builder, "entry_speed"));
+    g_signal_connect(gtk_builder_get_object(ui.builder, "combo_direction"), "changed", G_CALLBACK(on_combo_direction_changed), NULL);
+}
+
 /************************************************************************************************************************************
  ********************************GUI 프로그램의 버튼 등 구성요소들에서 사용하는 callback함수*************************************************
  ************************************************************************************************************************************/
@@ -257,19 +367,12 @@ int main(int argc, char *argv[]) {
  /**@brief Connect버튼의 callback*/
 static void on_button_connect_clicked(GtkButton *button, gpointer user_data) {
     BYTE sb1, sb2, sb3, sb4;
-    
-    // Get the GtkBuilder object passed as user data
-    GtkBuilder *builder = GTK_BUILDER(user_data);
 
     // Get the label of the button
     const char *label_text = gtk_button_get_label(button);
-    GObject *button_send = gtk_builder_get_object(builder, "button_send");
-
-    // Get the entry widget by its ID
-    GtkEntry *entry_ip = GTK_ENTRY(gtk_builder_get_object(builder, "entry_ip"));
 
     // Get the entered text from the entry
-    const char *ip_text = gtk_entry_get_text(entry_ip);
+    const char *ip_text = gtk_entry_get_text(ui.entry_ip);
 
     // Check if the IP is valid (For a simple example, let's assume it's valid if it's not empty)
     if (g_strcmp0(ip_text, "") != 0) {
@@ -313,17 +416,18 @@ static void on_button_connect_clicked(GtkButton *button, gpointer user_data) {
     if (strcmp(label_text, "Connect") == 0)
     {
         g_print("Selected Protocol: %s\n", protocol);
+        codec_select();
         
         if(strcmp(protocol, "TCP") == 0){
             if(FAS_ConnectTCP(sb1, sb2, sb3, sb4, 0)){
                 gtk_button_set_label(button, "Disconn");
-                gtk_widget_set_sensitive(GTK_WIDGET(button_send), TRUE);
+                gtk_widget_set_sensitive(ui.button_send, TRUE);
             }
         }
         else if(strcmp(protocol, "UDP") == 0){
             if(FAS_Connect(sb1, sb2, sb3, sb4, 0)){
                 gtk_button_set_label(button, "Disconn");
-                gtk_widget_set_sensitive(GTK_WIDGET(button_send), TRUE);
+                gtk_widget_set_sensitive(ui.button_send, TRUE);
             }
         }
         else if(protocol != NULL){
@@ -334,27 +438,23 @@ static void on_button_connect_clicked(GtkButton *button, gpointer user_data) {
     {
         FAS_Close(0);
         gtk_button_set_label(button, "Connect");
-        gtk_widget_set_sensitive(GTK_WIDGET(button_send), FALSE);
+        gtk_widget_set_sensitive(ui.button_send, FALSE);
     }
+    if (estop != NULL)
+        FAS_EStopArm(estop);
 }
 
- /**@brief Send버튼의 callback*/
+ /**@brief Send버튼의 callback (Use List를 켜면 명령 목록 실행)*/
 static void on_button_send_clicked(GtkButton *button, gpointer user_data){
-    
-    if(strcmp(protocol, "TCP") == 0){
-        send_packetTCP(buffer);
-    }
-    else if(strcmp(protocol, "UDP") == 0){
-        send_packet(buffer);
-    }
-    else if(protocol != NULL){
-        g_print("Select Protocol\n");
-    }
-
+    if (gtk_toggle_button_get_active(ui.check_uselist))
+        on_list_run_clicked(button, user_data);
+    else
+        send_packet(buffer, buffer_len);
 }
 
  /**@brief TCP/UDP 프로토콜 선택 콤보박스의 callback*/
 static void on_combo_protocol_changed(GtkComboBoxText *combo_text, gpointer user_data) {
+    g_free(protocol);
     protocol = gtk_combo_box_text_get_active_text(combo_text);
     if (protocol != NULL) {
         g_print("Selected Protocol: %s\n", protocol);
@@ -365,9 +465,9 @@ static void on_combo_protocol_changed(GtkComboBoxText *combo_text, gpointer user
 static void on_combo_command_changed(GtkComboBox *combo_id, gpointer user_data) {
     const gchar *selected_id = gtk_combo_box_get_active_id(combo_id);
     
-    gtk_label_set_text(label_status, "Ready");
+    gtk_label_set_text(ui.label_status, "Ready");
     if (selected_id != NULL) {
-        GtkStack *stk2 = GTK_STACK(user_data);
+        GtkStack *stk2 = ui.stk2;
 
         // 선택한 옵션에 따라 보여지는 페이지를 변경
         if (g_strcmp0(selected_id, "0x2A") == 0) {
@@ -421,11 +521,11 @@ static void on_combo_data1_changed(GtkComboBox *combo_id, gpointer user_data) {
 static void on_check_autosync_toggled(GtkToggleButton *togglebutton, gpointer user_data) {
     gboolean is_checked = gtk_toggle_button_get_active(togglebutton);
     if (is_checked) {
-        sync_no = (BYTE)(rand() % 256);
-        g_print("Auto Sync Enabled Sync No: %X \n",sync_no);
+        board->link.sync_no = (BYTE)(rand() % 256);
+        g_print("Auto Sync Enabled Sync No: %X \n", board->link.sync_no);
     } else {
-        sync_no = 0x00;
-        g_print("Auto Sync Disabled Sync No: %X \n",sync_no);
+        board->link.sync_no = 0x00;
+        g_print("Auto Sync Disabled Sync No: %X \n", board->link.sync_no);
     }
 }
 
@@ -439,513 +539,627 @@ static void on_check_showsend_toggled(GtkToggleButton *togglebutton, gpointer us
     }
 }
 
- /**@brief FASTECH 프로토콜 체크박스의 callback*/
-static void on_check_fastech_toggled(GtkToggleButton *togglebutton, gpointer user_data) {
-    gboolean is_checked = gtk_toggle_button_get_active(togglebutton);
-    if (is_checked) {
-        header = 0xAA;
-        g_print("FASTECH Protocol header: %X \n",header);
-    } else {
-        header = 0x00;
-        g_print("USER Protocol header: %X \n",header);
+  /**@brief Metrics버튼의 callback, 통계 패널을 띄움*/
+static void on_button_metrics_clicked(GtkButton *button, gpointer user_data) {
+    if (ui.metrics_window == NULL) {
+        ui.metrics_window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+        gtk_window_set_title(GTK_WINDOW(ui.metrics_window), "Metrics");
+        gtk_window_set_default_size(GTK_WINDOW(ui.metrics_window), 360, 300);
+        gtk_window_set_transient_for(GTK_WINDOW(ui.metrics_window), GTK_WINDOW(gtk_widget_get_toplevel(GTK_WIDGET(button))));
+        g_signal_connect(ui.metrics_window, "delete-event", G_CALLBACK(gtk_widget_hide_on_delete), NULL);
+
+        ui.metrics_label = GTK_LABEL(gtk_label_new(""));
+        gtk_label_set_xalign(ui.metrics_label, 0);
+        gtk_label_set_yalign(ui.metrics_label, 0);
+        gtk_label_set_selectable(ui.metrics_label, TRUE);
+        GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+        gtk_container_add(GTK_CONTAINER(scroll), GTK_WIDGET(ui.metrics_label));
+        gtk_container_add(GTK_CONTAINER(ui.metrics_window), scroll);
+
+        // 창이 떠 있는 동안만 0.5초마다 갱신
+        g_timeout_add(500, metrics_panel_refresh, NULL);
     }
+    metrics_panel_refresh(NULL);
+    gtk_widget_show_all(ui.metrics_window);
+    gtk_window_present(GTK_WINDOW(ui.metrics_window));
 }
 
- /**@brief MoveVelocity에서 방향 선택 콤보박스의 callback*/
-static void on_combo_direction_changed(GtkComboBox *combo_id, gpointer user_data) {
-    memset(&data, 0, sizeof(data));
-    // Get the GtkBuilder object passed as user data
-    GtkBuilder *builder = GTK_BUILDER(user_data);
+ /**@brief E-STOP 버튼의 callback, 연결된 보드 전부에 비상정지를 보내고 결과를 상태줄에 표시
+  * 보드 context를 쓰지 않으므로 Status Monitor polling이나 진행 중인 송신을 기다리지 않음*/
+static void on_button_estop_clicked(GtkButton *button, gpointer user_data) {
+    FAS_ESTOP_RESULT result;
+    char msg[128];
 
-    // Get the entry widget by its ID
-    GtkEntry *entry_speed = GTK_ENTRY(gtk_builder_get_object(builder, "entry_speed"));
-    
-    const gchar *selected_id = gtk_combo_box_get_active_id(combo_id);
-    const gchar *text = gtk_entry_get_text(GTK_ENTRY(entry_speed));
-    
-    int value = atoi(text);
-    
-    for (int i = 0; i < 4; i++) {
-        data[i] = (value >> (8 * i)) & 0xFF;
+    if (estop == NULL || estop->count == 0) {
+        gtk_label_set_text(ui.label_status, "E-STOP: no board");
+        return;
     }
+    if (FAS_EStopTrigger(estop, FAS_ESTOP_DEFAULT_DEADLINE_MS, &result) < 0)
+        return;
+    for (int i = 0; i < estop->count; i++)
+        if (estop->board[i].status != FMM_OK)
+            g_print("E-STOP board %d: %s\n", estop->board[i].iBdID, FAS_ErrorName(estop->board[i].status));
+    snprintf(msg, sizeof(msg), "E-STOP %d/%d acked, wire %u us, last %u us",
+             result.acked, result.boards, result.wire_us, result.worst_ack_us);
+    g_print("%s (max wire %u us)\n", msg, estop->max_wire_us);
+    gtk_label_set_text(ui.label_status, msg);
+}
 
-    if (selected_id != NULL) {
-        g_print("Selected Data: %s\n", selected_id);
-        char* endptr;
-        unsigned long int value = strtoul(selected_id, &endptr, 16);
-        if (*endptr == '\0' && value <= UINT8_MAX) {
-            data[4] = (uint8_t)value;
-        } else {
-            g_print("Invalid input: %s\n", selected_id);
+ /**@brief Analyze Flag 버튼의 callback, 마지막 응답(0x40/0x41/0x43)의 AxisStatus를 flag 이름으로 monitor1에 붙임*/
+static void on_button_analyzeflag_clicked(GtkButton *button, gpointer user_data) {
+    char text[512];
+    uint32_t status;
+
+    if (board->rx_len <= FRAME_HEADER_SIZE + 1
+        || !FAS_AxisStatusFromResponse(board->rx[4], &board->rx[FRAME_HEADER_SIZE + 1], board->rx_len - (FRAME_HEADER_SIZE + 1), &status)) {
+        gtk_label_set_text(ui.label_status, "No axis status");
+        return;
+    }
+    int len = snprintf(text, sizeof(text), "\n\n[AXIS STATUS] 0x%08X\n", status);
+    FAS_AxisStatusFormat(text + len, sizeof(text) - len, status);
+
+    GtkTextIter iter;
+    gtk_text_buffer_get_end_iter(ui.monitor1_buffer, &iter);
+    gtk_text_buffer_insert(ui.monitor1_buffer, &iter, text, -1);
+    gtk_label_set_text(ui.label_status, (status & FAS_AXIS_ERROR_MASK) ? "Alarm" : "OK");
+}
+
+ /**@brief 통계 패널 내용 갱신, 카운터를 읽기만 하므로 송수신과 경합하지 않음*/
+static gboolean metrics_panel_refresh(gpointer user_data) {
+    static FAS_METRICS_SNAPSHOT snap;
+    static char text[4096];
+    size_t len = 0;
+
+    if (ui.metrics_window == NULL || !gtk_widget_get_visible(ui.metrics_window))
+        return G_SOURCE_CONTINUE;
+
+    text[0] = '\0';
+    for (int bd = 0; bd < FAS_MAX_BOARD && len < sizeof(text); bd++) {
+        if (!FAS_MetricsSnapshot(bd, &snap))
+            continue;
+        uint64_t mean = snap.frames_recv ? snap.rtt_sum_us / snap.frames_recv : 0;
+        len += snprintf(text + len, sizeof(text) - len,
+                        "[Board %d]\n"
+                        "Sent      : %" PRIu64 " frames / %" PRIu64 " bytes\n"
+                        "Received  : %" PRIu64 " frames / %" PRIu64 " bytes\n"
+                        "Timeout   : %" PRIu64 "\n"
+                        "CRC fail  : %" PRIu64 "\n"
+                        "RTT       : mean %" PRIu64 " us, p50 < %" PRIu64 " us, p99 < %" PRIu64 " us\n"
+                        "Drive+wire: p50 < %" PRIu64 " us, p99 < %" PRIu64 " us (kernel timestamp)\n"
+                        "Host stack: p50 < %" PRIu64 " us, p99 < %" PRIu64 " us\n",
+                        bd, snap.frames_sent, snap.bytes_sent, snap.frames_recv, snap.bytes_recv,
+                        snap.timeouts, snap.crc_fail, mean,
+                        FAS_MetricsRttPercentile(&snap, 50), FAS_MetricsRttPercentile(&snap, 99),
+                        FAS_MetricsHistPercentile(snap.wire_hist, 50), FAS_MetricsHistPercentile(snap.wire_hist, 99),
+                        FAS_MetricsHistPercentile(snap.stack_hist, 50), FAS_MetricsHistPercentile(snap.stack_hist, 99));
+        for (int code = 0; code < FAS_ERROR_CODES && len < sizeof(text); code++) {
+            if (snap.error_hist[code] != 0)
+                len += snprintf(text + len, sizeof(text) - len, "  %-22s %" PRIu64 "\n",
+                                FAS_ErrorName((FMM_ERROR)code), snap.error_hist[code]);
         }
-    } else {
-        g_print("No item selected.\n");
+        if (len < sizeof(text))
+            len += snprintf(text + len, sizeof(text) - len, "\n");
     }
-    print_buffer(data, 5);
-    library_interface();
+    gtk_label_set_text(ui.metrics_label, len ? text : "No traffic yet");
+    return G_SOURCE_CONTINUE;
 }
 
- /**@brief Frame칸에 명령어를 입력할 때 생기는 callback*/
-gboolean on_text_frame_key_release_event(GtkWidget *widget, GdkEventKey *event, gpointer user_data) {
-    GtkTextBuffer *frame_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(widget));
+/************************************************************************************************************************************
+ ******************************** Use List: 명령 목록을 pipeline 묶음으로 실행 (형식은 FAS_List.h) ***********************************
+ ************************************************************************************************************************************/
+
+#define LIST_TEXT_SIZE 16384
+#define LIST_RESULT_SIZE 32768
 
-    GtkTextIter start, end;
-    gtk_text_buffer_get_bounds(frame_buffer, &start, &end);
-    char *input = gtk_text_buffer_get_text(frame_buffer, &start, &end, FALSE);
-
-    g_print("Current Text: %s\n", input);
-
-    int inputLength = strlen(input);
-    int outputSize = 0;
-    uint8_t *output = NULL;
-
-    // "[2A 01 12]"처럼 HEX 형식인지 확인
-    if (inputLength >= 3 && input[0] == '[' && input[inputLength - 1] == ']') {
-        // "2A 01 12" 부분 추출
-        char hexPart[100];
-        strncpy(hexPart, input + 1, inputLength - 2);
-        hexPart[inputLength - 2] = '\0';
-
-        // 16진수 문자열을 숫자로 변환하여 동적 메모리 할당 후 저장
-        char *token;
-        int index = 0;
-        token = strtok(hexPart, " ");
-        while (token != NULL) {
-            output = (uint8_t *)realloc(output, (index + 1) * sizeof(uint8_t));
-            output[index++] = (uint8_t)strtol(token, NULL, 16);
-            token = strtok(NULL, " ");
-        }
+static const char *list_example =
+    "# board type(hex) data(hex)...   '>' = after previous line, '@N' = after line N\n"
+    "# 0 2A 01\n"
+    "# > 0 37 00 00 10 27 00 00 01\n";
 
-        outputSize = index;
-    }
-    // "112 123 123" 처럼 10진수 형식인 경우
-    else if (input[0] != '[') {
-        // 10진수 문자열을 숫자로 변환하여 동적 메모리 할당 후 저장
-        char *token;
-        int index = 0;
-        token = strtok(input, " ");
-        while (token != NULL) {
-            output = (uint8_t *)realloc(output, (index + 1) * sizeof(uint8_t));
-            output[index++] = (uint8_t)atoi(token);
-            token = strtok(NULL, " ");
-        }
-        outputSize = index;
+ /**@brief Use List 체크박스의 callback, 켜면 목록 창을 띄우고 Send가 목록 전체를 실행함*/
+static void on_check_uselist_toggled(GtkToggleButton *togglebutton, gpointer user_data) {
+    if (!gtk_toggle_button_get_active(togglebutton)) {
+        if (ui.list_window != NULL)
+            gtk_widget_hide(ui.list_window);
+        return;
     }
-    else{
-        g_free(output);
+    if (command_list == NULL)
+        command_list = g_new0(FAS_LIST, 1);
+    if (ui.list_window == NULL) {
+        ui.list_window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+        gtk_window_set_title(GTK_WINDOW(ui.list_window), "Command List");
+        gtk_window_set_default_size(GTK_WINDOW(ui.list_window), 720, 480);
+        gtk_window_set_transient_for(GTK_WINDOW(ui.list_window), GTK_WINDOW(ui.window));
+        g_signal_connect(ui.list_window, "delete-event", G_CALLBACK(gtk_widget_hide_on_delete), NULL);
+
+        GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
+        GtkWidget *hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+        GtkWidget *add = gtk_button_new_with_label("Add Frame");
+        GtkWidget *run = gtk_button_new_with_label("Run");
+        g_signal_connect(add, "clicked", G_CALLBACK(on_list_add_clicked), NULL);
+        g_signal_connect(run, "clicked", G_CALLBACK(on_list_run_clicked), NULL);
+        gtk_box_pack_start(GTK_BOX(hbox), add, FALSE, FALSE, 0);
+        gtk_box_pack_start(GTK_BOX(hbox), run, FALSE, FALSE, 0);
+
+        GtkWidget *text = gtk_text_view_new();
+        ui.list_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text));
+        gtk_text_buffer_set_text(ui.list_buffer, list_example, -1);
+        GtkWidget *text_scroll = gtk_scrolled_window_new(NULL, NULL);
+        gtk_container_add(GTK_CONTAINER(text_scroll), text);
+
+        ui.list_label = GTK_LABEL(gtk_label_new(""));
+        gtk_label_set_xalign(ui.list_label, 0);
+        gtk_label_set_yalign(ui.list_label, 0);
+        gtk_label_set_selectable(ui.list_label, TRUE);
+        GtkWidget *result_scroll = gtk_scrolled_window_new(NULL, NULL);
+        gtk_container_add(GTK_CONTAINER(result_scroll), GTK_WIDGET(ui.list_label));
+
+        gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, FALSE, 0);
+        gtk_box_pack_start(GTK_BOX(vbox), text_scroll, TRUE, TRUE, 0);
+        gtk_box_pack_start(GTK_BOX(vbox), result_scroll, TRUE, TRUE, 0);
+        gtk_container_add(GTK_CONTAINER(ui.list_window), vbox);
     }
+    gtk_widget_show_all(ui.list_window);
+    gtk_window_present(GTK_WINDOW(ui.list_window));
+}
 
-    printf("Parsed Hex: ");
-    for (int i = 0; i < outputSize; i++) {
-        printf("%02X ", output[i]);
+ /**@brief Add Frame 버튼의 callback, 지금 송신 buffer의 명령을 목록 끝에 한 줄로 붙임 (보드 0, 기다림 없음)*/
+static void on_list_add_clicked(GtkButton *button, gpointer user_data) {
+    char line[BUFFER_SIZE * 3 + 16];
+    int frame_len = buffer_len;
+    if (frame_len < FRAME_HEADER_SIZE)
+        return;
+    int len = snprintf(line, sizeof(line), "0 %02X", buffer[4]);
+    for (int i = FRAME_HEADER_SIZE; i < frame_len && len < (int)sizeof(line); i++)
+        len += snprintf(line + len, sizeof(line) - len, " %02X", buffer[i]);
+    if (len < (int)sizeof(line))
+        snprintf(line + len, sizeof(line) - len, "   # %s\n", FAS_FrameName(buffer[4]));
+
+    GtkTextIter iter;
+    gtk_text_buffer_get_end_iter(ui.list_buffer, &iter);
+    gtk_text_buffer_insert(ui.list_buffer, &iter, line, -1);
+}
+
+ /**@brief Run 버튼의 callback, 목록 전체를 보드 0 연결로 실행하고 명령마다 결과/시간을 창에 표시
+  * send_packet을 한 줄씩 부르지 않고 FAS_ListExecute 한 번 (서로 기다리지 않는 명령은 pipeline)*/
+static void on_list_run_clicked(GtkButton *button, gpointer user_data) {
+    static char text[LIST_TEXT_SIZE];
+    static char result[LIST_RESULT_SIZE];
+    char msg[64];
+    int error_line = 0;
+
+    if (command_list == NULL || ui.list_buffer == NULL)
+        return;
+    if (!board->open) {
+        g_print("Not connected\n");
+        return;
     }
-    printf("\n");
-    
-    g_free(input);
-
-    if (output != NULL) {
-        buffer[0] = header;
-        buffer[1] = outputSize + 2;
-        buffer[2] = sync_no;
-        memcpy(&buffer[4], output, outputSize); // outputSize만큼 복사
-        free(output);
-
-        char *text = array_to_string(buffer, buffer[1] + 2);
-        gtk_text_buffer_set_text(sendbuffer_buffer, text, -1);
-        g_free(text);
-    } else {
-        gtk_text_buffer_set_text(sendbuffer_buffer, "", -1);
-        memset(buffer, 0, sizeof(buffer));
+    text_buffer_copy(ui.list_buffer, text, sizeof(text));
+    if (!FAS_ListParse(command_list, text, &error_line)) {
+        snprintf(msg, sizeof(msg), "List error: line %d", error_line);
+        gtk_label_set_text(ui.label_status, msg);
+        gtk_label_set_text(ui.list_label, msg);
+        return;
+    }
+    if (command_list->count == 0) {
+        gtk_label_set_text(ui.label_status, "List empty");
+        return;
     }
 
-    return FALSE;
-}
+    char currentTimeString[9];
+    get_time(currentTimeString);
+    gtk_label_set_text(ui.label_time, currentTimeString);
 
-static void on_button_record1_clicked(GtkButton *button, gpointer user_data) {
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(sendbuffer_buffer, &start);
-    gtk_text_buffer_get_end_iter(sendbuffer_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(sendbuffer_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(record1_buffer, text, -1);
-}
+    // board 0 context의 소켓과 Sync No.를 그대로 씀 (GUI thread 안에서만 부르므로 send_packet과 겹치지 않음)
+    FAS_BATCH_OPTION option = { .window = FAS_DEFAULT_WINDOW, .timeout_ms = board->timeout_ms };
+    int failed = FAS_ListExecute(&board->link, 1, command_list, &option);
+    FAS_ListFormatResult(command_list, result, sizeof(result));
+    gtk_label_set_text(ui.list_label, result);
+    g_print("%s", result);
 
-static void on_button_record2_clicked(GtkButton *button, gpointer user_data) {
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(sendbuffer_buffer, &start);
-    gtk_text_buffer_get_end_iter(sendbuffer_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(sendbuffer_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(record2_buffer, text, -1);
+    char sync_str[4];
+    sprintf(sync_str, "%u", board->link.sync_no);
+    gtk_text_buffer_set_text(ui.autosync_buffer, sync_str, -1);
+    snprintf(msg, sizeof(msg), "List %d/%d OK, %u us", command_list->count - (failed > 0 ? failed : 0),
+             command_list->count, command_list->total_us);
+    gtk_label_set_text(ui.label_status, failed < 0 ? "NG" : msg);
 }
 
-static void on_button_record3_clicked(GtkButton *button, gpointer user_data) {
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(sendbuffer_buffer, &start);
-    gtk_text_buffer_get_end_iter(sendbuffer_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(sendbuffer_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(record3_buffer, text, -1);
-}
+/************************************************************************************************************************************
+ ******************************** Status Monitor: 위치/속도/위치 오차 scope (0x43 주기 polling) *************************************
+ ************************************************************************************************************************************/
 
-static void on_button_record4_clicked(GtkButton *button, gpointer user_data) {
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(sendbuffer_buffer, &start);
-    gtk_text_buffer_get_end_iter(sendbuffer_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(sendbuffer_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(record4_buffer, text, -1);
+
+static const char *scope_channel_name[FAS_SCOPE_CHANNELS] = { "Actual Pos [pulse]", "Actual Vel [pps]", "Pos Error [pulse]" };
+
+ /**@brief 지금 화면 오른쪽 끝 sample (멈췄으면 멈춘 위치)*/
+static uint64_t scope_view_end(void) {
+    return gtk_toggle_button_get_active(scope_view.pause) ? scope_view.paused_end : scope->count;
 }
 
+ /**@brief scope 그리기, 채널마다 열 하나에 최소~최대 세로선 하나 (sample 수와 무관하게 폭만큼만 그림)*/
+static gboolean on_scope_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data) {
+    static int32_t col_min[SCOPE_MAX_COLUMNS], col_max[SCOPE_MAX_COLUMNS];
+    int width = gtk_widget_get_allocated_width(widget);
+    int height = gtk_widget_get_allocated_height(widget);
+    int columns = width < SCOPE_MAX_COLUMNS ? width : SCOPE_MAX_COLUMNS;
+    double pane = height / (double)FAS_SCOPE_CHANNELS;
+
+    cairo_set_source_rgb(cr, 0.08, 0.08, 0.08);
+    cairo_paint(cr);
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_font_size(cr, 11);
+
+    for (int ch = 0; ch < FAS_SCOPE_CHANNELS; ch++) {
+        double top = ch * pane;
+        int filled = FAS_ScopeQuery(scope, (FAS_SCOPE_CHANNEL)ch, scope_view_end(), scope_view.span,
+                                    columns, col_min, col_max);
+        int32_t lo = INT32_MAX, hi = INT32_MIN;
+        for (int c = 0; c < columns; c++) {
+            if (col_min[c] > col_max[c])
+                continue;
+            if (col_min[c] < lo)
+                lo = col_min[c];
+            if (col_max[c] > hi)
+                hi = col_max[c];
+        }
 
-// 전송 버튼을 누를 때 호출되는 콜백 함수
-static void on_button_transfer1_clicked(GtkButton *button, gpointer user_data) {
-    gtk_label_set_text(label_status, "Sending");
-    
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(record1_buffer, &start);
-    gtk_text_buffer_get_end_iter(record1_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(record1_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(sendbuffer_buffer, text, -1);
-    // 텍스트를 띄어쓰기를 기준으로 16진수로 변환하여 uint8_t 배열에 저장합니다.
-    BYTE byte_array[258];
-    int byte_count = 0;
-    gchar **tokens = g_strsplit(text, " ", -1); // 띄어쓰기로 문자열 분할
-    for (int i = 0; tokens[i] != NULL; i++) {
-        byte_array[byte_count] = (BYTE)g_ascii_strtoull(tokens[i], NULL, 16);
-        byte_count++;
-    }
-    g_strfreev(tokens);
+        char text[64];
+        cairo_set_source_rgb(cr, 0.6, 0.6, 0.6);
+        cairo_move_to(cr, 4, top + 12);
+        cairo_show_text(cr, scope_channel_name[ch]);
+        if (filled == 0)
+            continue;
+        snprintf(text, sizeof(text), "%d ~ %d", lo, hi);
+        cairo_move_to(cr, 4, top + 24);
+        cairo_show_text(cr, text);
+
+        double range = hi > lo ? (double)hi - lo : 1.0;
+        double scale = (pane - 30) / range, base = top + pane - 4;
+        static const double color[FAS_SCOPE_CHANNELS][3] = { { 0.3, 0.9, 0.3 }, { 0.3, 0.7, 1.0 }, { 1.0, 0.6, 0.2 } };
+        cairo_set_source_rgb(cr, color[ch][0], color[ch][1], color[ch][2]);
+        for (int c = 0; c < columns; c++) {
+            if (col_min[c] > col_max[c])
+                continue;
+            cairo_move_to(cr, c + 0.5, base - (col_max[c] - (double)lo) * scale);
+            cairo_line_to(cr, c + 0.5, base - (col_min[c] - (double)lo) * scale + 1);
+        }
+        cairo_stroke(cr);
 
-    // 변환된 16진수 값을 10진수로 출력해봅니다.
-    for (int i = 0; i < byte_count; i++) {
-        printf("%02X ", byte_array[i]);
-    }
-    printf("\n");
-    
-    if(strcmp(protocol, "TCP") == 0){
-        send_packetTCP(byte_array);
-    }
-    else if(strcmp(protocol, "UDP") == 0){
-        send_packet(byte_array);
-    }
-    else if(protocol != NULL){
-        g_print("Select Protocol\n");
+        cairo_set_source_rgb(cr, 0.3, 0.3, 0.3);
+        cairo_move_to(cr, 0, top + pane - 0.5);
+        cairo_line_to(cr, width, top + pane - 0.5);
+        cairo_stroke(cr);
     }
+    return FALSE;
 }
 
-// 전송 버튼을 누를 때 호출되는 콜백 함수
-static void on_button_transfer2_clicked(GtkButton *button, gpointer user_data) {
-    gtk_label_set_text(label_status, "Sending");
-    
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(record2_buffer, &start);
-    gtk_text_buffer_get_end_iter(record2_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(record2_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(sendbuffer_buffer, text, -1);
-    // 텍스트를 띄어쓰기를 기준으로 16진수로 변환하여 uint8_t 배열에 저장합니다.
-    BYTE byte_array[258];
-    int byte_count = 0;
-    gchar **tokens = g_strsplit(text, " ", -1); // 띄어쓰기로 문자열 분할
-    for (int i = 0; tokens[i] != NULL; i++) {
-        byte_array[byte_count] = (BYTE)g_ascii_strtoull(tokens[i], NULL, 16);
-        byte_count++;
-    }
-    g_strfreev(tokens);
+ /**@brief 휠로 보이는 구간 확대/축소 (2배씩, history 전체까지)*/
+static gboolean on_scope_scroll(GtkWidget *widget, GdkEventScroll *event, gpointer user_data) {
+    if (event->direction == GDK_SCROLL_UP && scope_view.span > 64)
+        scope_view.span /= 2;
+    else if (event->direction == GDK_SCROLL_DOWN && scope_view.span < scope->history)
+        scope_view.span *= 2;
+    gtk_widget_queue_draw(scope_view.area);
+    return TRUE;
+}
 
-    // 변환된 16진수 값을 10진수로 출력해봅니다.
-    for (int i = 0; i < byte_count; i++) {
-        printf("%02X ", byte_array[i]);
-    }
-    printf("\n");
-    
-    if(strcmp(protocol, "TCP") == 0){
-        send_packetTCP(byte_array);
+ /**@brief Pause버튼의 callback, 멈춘 위치를 기억 (polling과 history 저장은 계속)*/
+static void on_scope_pause_toggled(GtkToggleButton *togglebutton, gpointer user_data) {
+    scope_view.paused_end = scope->count;
+    gtk_widget_queue_draw(scope_view.area);
+}
+
+ /**@brief Record버튼의 callback, polling 결과를 .fct 파일(FAS_Telemetry)로 기록 시작/종료
+  * poll thread가 쓰는 telemetry 포인터를 바꾸므로 polling을 잠깐 멈췄다가 다시 시작함*/
+static void on_scope_record_toggled(GtkToggleButton *togglebutton, gpointer user_data) {
+    bool polling = atomic_load(&scope->running);
+    FAS_ScopeStop(scope);
+
+    if (gtk_toggle_button_get_active(togglebutton) && scope_view.telemetry == NULL) {
+        char path[64];
+        time_t now = time(NULL);
+        struct tm tm_now;
+        localtime_r(&now, &tm_now);
+        strftime(path, sizeof(path), "fastech_%Y%m%d_%H%M%S.fct", &tm_now);
+        scope_view.telemetry = g_new0(FAS_TELEMETRY, 1);
+        if (FAS_TelemetryOpen(scope_view.telemetry, path)) {
+            g_print("Recording: %s\n", path);
+        }
+        else {
+            g_free(scope_view.telemetry);
+            scope_view.telemetry = NULL;
+            gtk_toggle_button_set_active(togglebutton, FALSE);
+        }
     }
-    else if(strcmp(protocol, "UDP") == 0){
-        send_packet(byte_array);
+    else if (!gtk_toggle_button_get_active(togglebutton) && scope_view.telemetry != NULL) {
+        FAS_TelemetryClose(scope_view.telemetry);
+        g_print("Recorded %" PRIu64 " rows, %" PRIu64 " bytes, dropped %" PRIu64 "\n",
+                atomic_load(&scope_view.telemetry->samples), atomic_load(&scope_view.telemetry->bytes),
+                atomic_load(&scope_view.telemetry->dropped));
+        g_free(scope_view.telemetry);
+        scope_view.telemetry = NULL;
     }
-    else if(protocol != NULL){
-        g_print("Select Protocol\n");
+    scope->telemetry = scope_view.telemetry;
+
+    if (polling) {
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &board->link.addr.sin_addr, ip, sizeof(ip));
+        FAS_ScopeStart(scope, ip, board->link.tcp, SCOPE_PERIOD_US);
     }
 }
 
-// 전송 버튼을 누를 때 호출되는 콜백 함수
-static void on_button_transfer3_clicked(GtkButton *button, gpointer user_data) {
-    gtk_label_set_text(label_status, "Sending");
-    
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(record3_buffer, &start);
-    gtk_text_buffer_get_end_iter(record3_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(record3_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(sendbuffer_buffer, text, -1);
-    // 텍스트를 띄어쓰기를 기준으로 16진수로 변환하여 uint8_t 배열에 저장합니다.
-    BYTE byte_array[258];
-    int byte_count = 0;
-    gchar **tokens = g_strsplit(text, " ", -1); // 띄어쓰기로 문자열 분할
-    for (int i = 0; tokens[i] != NULL; i++) {
-        byte_array[byte_count] = (BYTE)g_ascii_strtoull(tokens[i], NULL, 16);
-        byte_count++;
-    }
-    g_strfreev(tokens);
+ /**@brief scope 창을 닫으면 기록과 polling도 멈춤*/
+static gboolean on_scope_delete(GtkWidget *widget, GdkEvent *event, gpointer user_data) {
+    gtk_toggle_button_set_active(scope_view.record, FALSE);
+    FAS_ScopeStop(scope);
+    gtk_widget_hide(widget);
+    return TRUE;
+}
 
-    // 변환된 16진수 값을 10진수로 출력해봅니다.
-    for (int i = 0; i < byte_count; i++) {
-        printf("%02X ", byte_array[i]);
-    }
-    printf("\n");
-    
-    if(strcmp(protocol, "TCP") == 0){
-        send_packetTCP(byte_array);
+ /**@brief Status Monitor버튼의 callback, 별도 연결로 0x43을 주기 polling하는 scope 창을 띄움*/
+static void on_button_statusmonitor_clicked(GtkButton *button, gpointer user_data) {
+    if (!board->open) {
+        g_print("Not connected\n");
+        return;
     }
-    else if(strcmp(protocol, "UDP") == 0){
-        send_packet(byte_array);
+    if (scope == NULL) {
+        scope = g_new0(FAS_SCOPE, 1);
+        if (!FAS_ScopeInit(scope, 0, SCOPE_HISTORY)) {
+            g_free(scope);
+            scope = NULL;
+            return;
+        }
     }
-    else if(protocol != NULL){
-        g_print("Select Protocol\n");
+    if (scope_view.window == NULL) {
+        scope_view.window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+        gtk_window_set_title(GTK_WINDOW(scope_view.window), "Status Monitor");
+        gtk_window_set_default_size(GTK_WINDOW(scope_view.window), 640, 420);
+        gtk_window_set_transient_for(GTK_WINDOW(scope_view.window), GTK_WINDOW(ui.window));
+        g_signal_connect(scope_view.window, "delete-event", G_CALLBACK(on_scope_delete), NULL);
+
+        GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
+        GtkWidget *hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+        scope_view.pause = GTK_TOGGLE_BUTTON(gtk_toggle_button_new_with_label("Pause"));
+        g_signal_connect(scope_view.pause, "toggled", G_CALLBACK(on_scope_pause_toggled), NULL);
+        scope_view.record = GTK_TOGGLE_BUTTON(gtk_toggle_button_new_with_label("Record"));
+        g_signal_connect(scope_view.record, "toggled", G_CALLBACK(on_scope_record_toggled), NULL);
+        scope_view.label = GTK_LABEL(gtk_label_new(""));
+        gtk_box_pack_start(GTK_BOX(hbox), GTK_WIDGET(scope_view.pause), FALSE, FALSE, 0);
+        gtk_box_pack_start(GTK_BOX(hbox), GTK_WIDGET(scope_view.record), FALSE, FALSE, 0);
+        gtk_box_pack_start(GTK_BOX(hbox), GTK_WIDGET(scope_view.label), FALSE, FALSE, 0);
+
+        scope_view.area = gtk_drawing_area_new();
+        gtk_widget_add_events(scope_view.area, GDK_SCROLL_MASK);
+        g_signal_connect(scope_view.area, "draw", G_CALLBACK(on_scope_draw), NULL);
+        g_signal_connect(scope_view.area, "scroll-event", G_CALLBACK(on_scope_scroll), NULL);
+        gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, FALSE, 0);
+        gtk_box_pack_start(GTK_BOX(vbox), scope_view.area, TRUE, TRUE, 0);
+        gtk_container_add(GTK_CONTAINER(scope_view.window), vbox);
+
+        scope_view.span = 100 * 30;		// 처음에는 최근 30초
+        g_timeout_add(33, scope_refresh, NULL);
     }
+
+    // GUI와 같은 드라이브에 소켓을 따로 열어서 polling (board 0 context는 GUI thread 전용)
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &board->link.addr.sin_addr, ip, sizeof(ip));
+    if (!FAS_ScopeStart(scope, ip, board->link.tcp, SCOPE_PERIOD_US))
+        g_print("Status Monitor already polling or connect failed: %s\n", ip);
+
+    gtk_widget_show_all(scope_view.window);
+    gtk_window_present(GTK_WINDOW(scope_view.window));
 }
 
-// 전송 버튼을 누를 때 호출되는 콜백 함수
-static void on_button_transfer4_clicked(GtkButton *button, gpointer user_data) {
-    gtk_label_set_text(label_status, "Sending");
-    
-    GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(record4_buffer, &start);
-    gtk_text_buffer_get_end_iter(record4_buffer, &end);
-    gchar *text = gtk_text_buffer_get_text(record4_buffer, &start, &end, FALSE);
-    
-    gtk_text_buffer_set_text(sendbuffer_buffer, text, -1);
-    // 텍스트를 띄어쓰기를 기준으로 16진수로 변환하여 uint8_t 배열에 저장합니다.
-    BYTE byte_array[258];
-    int byte_count = 0;
-    gchar **tokens = g_strsplit(text, " ", -1); // 띄어쓰기로 문자열 분할
-    for (int i = 0; tokens[i] != NULL; i++) {
-        byte_array[byte_count] = (BYTE)g_ascii_strtoull(tokens[i], NULL, 16);
-        byte_count++;
-    }
-    g_strfreev(tokens);
+ /**@brief 30Hz로 ring을 비우고 다시 그림 (멈춘 동안은 저장만 함)*/
+static gboolean scope_refresh(gpointer user_data) {
+    if (scope_view.window == NULL || !gtk_widget_get_visible(scope_view.window))
+        return G_SOURCE_CONTINUE;
+
+    int drained = FAS_ScopeDrain(scope);
+    char text[160];
+    snprintf(text, sizeof(text), "%.1f s | samples %" PRIu64 " | polls %" PRIu64 ", failed %" PRIu64 ", overrun %" PRIu64,
+             scope_view.span * (SCOPE_PERIOD_US / 1e6), scope->count,
+             atomic_load(&scope->polls), atomic_load(&scope->failures), atomic_load(&scope->overruns));
+    gtk_label_set_text(scope_view.label, text);
+    if (drained > 0 && !gtk_toggle_button_get_active(scope_view.pause))
+        gtk_widget_queue_draw(scope_view.area);
+    return G_SOURCE_CONTINUE;
+}
 
-    // 변환된 16진수 값을 10진수로 출력해봅니다.
-    for (int i = 0; i < byte_count; i++) {
-        printf("%02X ", byte_array[i]);
-    }
-    printf("\n");
-    
-    if(strcmp(protocol, "TCP") == 0){
-        send_packetTCP(byte_array);
-    }
-    else if(strcmp(protocol, "UDP") == 0){
-        send_packet(byte_array);
-    }
-    else if(protocol != NULL){
-        g_print("Select Protocol\n");
+ /**@brief FASTECH 프로토콜 체크박스의 callback*/
+static void on_check_fastech_toggled(GtkToggleButton *togglebutton, gpointer user_data) {
+    codec_select();
+    if (gtk_toggle_button_get_active(togglebutton)) {
+        g_print("FASTECH Protocol header: %X \n", board->codec->header);
+    } else {
+        g_print("USER Protocol header: %X \n", board->codec->header);
     }
+    if (estop != NULL)
+        FAS_EStopArm(estop);
 }
-/************************************************************************************************************************************
- ********************************나중에 라이브러리로 뺄 FASTECH 라이브러리와 같은 기능의 함수*************************************************
- ************************************************************************************************************************************/
- 
- /**@brief UDP 연결 시 사용
-  * @param BYTE sb1,sb2,sb3,sb4 IPv4주소 입력 시 각 자리
-  * @param int iBdID 드라이브 ID
-  * @return boolean 성공시 TRUE 실패시 FALSE*/
-bool FAS_Connect(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID){
-    char SERVER_IP[16]; //최대 길이 가정 "xxx.xxx.xxx.xxx\0" 
-    snprintf(SERVER_IP, sizeof(SERVER_IP), "%u.%u.%u.%u", sb1, sb2, sb3, sb4);
-    
-    // Create socket
-    if ((client_socket = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
-        perror("Socket creation failed\n");
-        close(client_socket);
-        return FALSE;
-    }
-    else{
-        g_print("Socket created\n");
-    }
 
-    memset(&server_addr, 0, sizeof(server_addr));
+ /**@brief MoveVelocity에서 방향 선택 콤보박스의 callback*/
+static void on_combo_direction_changed(GtkComboBox *combo_id, gpointer user_data) {
+    memset(&data, 0, sizeof(data));
     
-    // Configure server address
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(PORT_UDP);
-    if (inet_pton(AF_INET, SERVER_IP, &server_addr.sin_addr) <= 0) {
-        perror("Invalid address/ Address not supported\n");
-        close(client_socket);
-        return FALSE;
-    }
-    else{
-        g_print("Valid address\n");
+    const gchar *selected_id = gtk_combo_box_get_active_id(combo_id);
+    const gchar *text = gtk_entry_get_text(ui.entry_speed);
+    
+    int value = atoi(text);
+    
+    for (int i = 0; i < 4; i++) {
+        data[i] = (value >> (8 * i)) & 0xFF;
     }
-    return TRUE;
-}
 
- /**@brief TCP 연결 시 사용
-  * @param BYTE sb1,sb2,sb3,sb4 IPv4주소 입력 시 각 자리
-  * @param int iBdID 드라이브 ID
-  * @return boolean 성공시 TRUE 실패시 FALSE*/
-bool FAS_ConnectTCP(BYTE sb1, BYTE sb2, BYTE sb3, BYTE sb4, int iBdID){
-    
-     char SERVER_IP[16]; // 최대 길이 가정 "xxx.xxx.xxx.xxx\0"
-    snprintf(SERVER_IP, sizeof(SERVER_IP), "%u.%u.%u.%u", sb1, sb2, sb3, sb4);
-
-    // Create socket
-    if ((client_socket = socket(AF_INET, SOCK_STREAM, 0)) == -1) {
-        perror("Socket creation failed");
-        close(client_socket);
-        return false;
+    if (selected_id != NULL) {
+        g_print("Selected Data: %s\n", selected_id);
+        char* endptr;
+        unsigned long int value = strtoul(selected_id, &endptr, 16);
+        if (*endptr == '\0' && value <= UINT8_MAX) {
+            data[4] = (uint8_t)value;
+        } else {
+            g_print("Invalid input: %s\n", selected_id);
+        }
     } else {
-        g_print("Socket created\n");
+        g_print("No item selected.\n");
     }
+    print_buffer(data, 5);
+    library_interface();
+}
 
-    // Prepare the sockaddr_in structure
-    struct sockaddr_in server_addr;
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = inet_addr(SERVER_IP);
-    server_addr.sin_port = htons(PORT_TCP);
+ /**@brief 송신 buffer 미리보기에서 frame[at, at + removed) 자리를 bytes[0, inserted)로 바꿈 (" XX" 한 칸이 byte 하나)*/
+static void preview_splice(int at, int removed, const BYTE *bytes, int inserted) {
+    GtkTextIter start, end;
+    char text[BUFFER_SIZE * 3 + 1];
+    int n = 0;
+    for (int i = 0; i < inserted; i++)
+        n += snprintf(text + n, sizeof(text) - n, at + i == 0 ? "%02X" : " %02X", bytes[i]);
+
+    int from = at == 0 ? 0 : 3 * at - 1;
+    gtk_text_buffer_get_iter_at_offset(ui.sendbuffer_buffer, &start, from);
+    gtk_text_buffer_get_iter_at_offset(ui.sendbuffer_buffer, &end, at == 0 ? 3 * removed - 1 : 3 * (at + removed) - 1);
+    gtk_text_buffer_delete(ui.sendbuffer_buffer, &start, &end);
+    gtk_text_buffer_insert(ui.sendbuffer_buffer, &start, text, n);
+}
 
-    // Set the timer for TIMEOUT_SECONDS seconds
-    alarm(TIMEOUT_SECONDS);
+ /**@brief Frame칸 편집 후 송신 buffer와 미리보기 갱신, 바뀐 byte만 고침*/
+static void frame_edit_update(void) {
+    FAS_FRAME_EDIT *edit = &frame_edit;
 
-    // Connect to the server (blocking call, but limited by the timer)
-    int result = connect(client_socket, (struct sockaddr *)&server_addr, sizeof(server_addr));
+    if (!FAS_FrameEditComplete(edit)) {
+        int bad = FAS_FrameEditFirstInvalid(edit);
+        if (bad >= 0) {
+            char msg[32];
+            snprintf(msg, sizeof(msg), "Invalid byte %d", bad + 1);
+            gtk_label_set_text(ui.label_status, msg);
+        }
+        else if (edit->tokens > DATA_SIZE) {
+            gtk_label_set_text(ui.label_status, "Too long");
+        }
+        if (frame_preview_shown) {
+            gtk_text_buffer_set_text(ui.sendbuffer_buffer, "", -1);
+            memset(buffer, 0, sizeof(buffer));
+            buffer_len = 0;
+            frame_preview_shown = FALSE;
+        }
+        return;
+    }
 
-    // Cancel the timer
-    alarm(0);
+    BYTE head[4] = { board->codec->header, (BYTE)(edit->tokens + 2), board->link.sync_no, 0 };
+    memcpy(buffer, head, sizeof(head));
+    memcpy(&buffer[4], edit->bytes, edit->tokens);
+    buffer_len = (int)sizeof(head) + edit->tokens;
 
-    if (result == -1) {
-        perror("Connection failed");
-        close(client_socket);
-        return false;
-    } else {
-        g_print("Connection Success\n");
+    if (!frame_preview_shown || edit->reparsed) {
+        gtk_text_buffer_set_text(ui.sendbuffer_buffer, array_to_string(buffer, buffer_len), -1);
+        frame_preview_shown = TRUE;
     }
-
-    return true;
+    else {
+        preview_splice(0, 4, head, 4);
+        preview_splice(4 + edit->changed_at, edit->removed, &edit->bytes[edit->changed_at], edit->inserted);
+    }
+    gtk_label_set_text(ui.label_status, "Ready");
 }
 
- /**@brief 연결 해제 시 사용
-  * @param int iBdID 드라이브 ID */
-void FAS_Close(int iBdID){
-    close(client_socket);
-}
+ /**@brief Frame칸에 글자가 들어가기 직전의 callback, 들어갈 부분만 다시 읽음*/
+static void on_frame_insert_text(GtkTextBuffer *text_buffer, GtkTextIter *location, gchar *text, gint len, gpointer user_data) {
+    char ascii[FAS_EDIT_TEXT_MAX];
+    int n = 0;
 
- /**@brief 해당보드의 정보
-  * @param int iBdID 드라이브 ID
-  * @param BYTE pType 모터의 Type
-  * @param LPSTR LpBuff Motor정보를 받을 문자열
-  * @param int nBuffSize 버퍼의 사이즈 */
-int FAS_GetboardInfo(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+    // 입력칸 위치는 글자 단위이므로 UTF-8 글자 하나를 한 칸으로 (프레임은 ASCII만 씀)
+    const gchar *p = text;
+    while (p < text + len && n < (int)sizeof(ascii)) {
+        ascii[n++] = (unsigned char)*p < 0x80 ? *p : '?';
+        p = g_utf8_next_char(p);
+    }
+    // 너무 길면 입력칸에도 넣지 않아서 model과 입력칸이 어긋나지 않게 함
+    if (p < text + len || !FAS_FrameEditReplace(&frame_edit, gtk_text_iter_get_offset(location), 0, ascii, n)) {
+        g_signal_stop_emission_by_name(text_buffer, "insert-text");
+        gtk_label_set_text(ui.label_status, "Too long");
+        return;
+    }
+    frame_edit_update();
 }
 
- /**@brief 해당모터의 정보
-  * @param int iBdID 드라이브 ID
-  * @param BYTE pType 모터의 Type
-  * @param LPSTR LpBuff Motor정보를 받을 문자열
-  * @param int nBuffSize 버퍼의 사이즈 */
-int FAS_GetMotorInfo(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+ /**@brief Frame칸에서 글자가 지워지기 직전의 callback*/
+static void on_frame_delete_range(GtkTextBuffer *text_buffer, GtkTextIter *start, GtkTextIter *end, gpointer user_data) {
+    int from = gtk_text_iter_get_offset(start);
+    int to = gtk_text_iter_get_offset(end);
+    if (from > to) {
+        int t = from;
+        from = to;
+        to = t;
+    }
+    FAS_FrameEditReplace(&frame_edit, from, to - from, "", 0);
+    frame_edit_update();
 }
 
- /**@brief 해당엔코더의 정보
-  * @param int iBdID 드라이브 ID
-  * @param BYTE pType 모터의 Type
-  * @param LPSTR LpBuff Motor정보를 받을 문자열
-  * @param int nBuffSize 버퍼의 사이즈 */
-int FAS_GetEncoder(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+ /**@brief 송신 buffer 내용을 Record칸에 복사 (Record버튼 공통)*/
+static void record_frame(GtkTextBuffer *record_buffer) {
+    char text[BUFFER_SIZE * 3];
+    text_buffer_copy(ui.sendbuffer_buffer, text, sizeof(text));
+    gtk_text_buffer_set_text(record_buffer, text, -1);
 }
 
- /**@brief 펌웨어의 정보
-  * @param int iBdID 드라이브 ID
-  * @param BYTE pType 모터의 Type
-  * @param LPSTR LpBuff Motor정보를 받을 문자열
-  * @param int nBuffSize 버퍼의 사이즈 */
-int FAS_GetFirmwareInfo(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+static void on_button_record1_clicked(GtkButton *button, gpointer user_data) {
+    record_frame(ui.record1_buffer);
 }
 
- /**@brief 해당보드의 정보
-  * @param int iBdID 드라이브 ID
-  * @param BYTE pType 모터의 Type
-  * @param LPSTR LpBuff Motor정보를 받을 문자열
-  * @param int nBuffSize 버퍼의 사이즈 */
-int FAS_GetSlaveInfoEx(int iBdID, BYTE pType, LPSTR LpBuff, int nBuffSize){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+static void on_button_record2_clicked(GtkButton *button, gpointer user_data) {
+    record_frame(ui.record2_buffer);
 }
 
- /**@brief 현재까지 수정된 파라미터 값고 입출력 신호를 ROM영역에 저장
-  * @param int iBdID 드라이브 ID*/
-int FAS_SaveAllParameters(int iBdID){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+static void on_button_record3_clicked(GtkButton *button, gpointer user_data) {
+    record_frame(ui.record3_buffer);
 }
 
- /**@brief 비상정지
-  * @param int iBdID 드라이브 ID
-  * @return 명령이 수행된 정보*/
-int FAS_EmergencyStop(int iBdID){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+static void on_button_record4_clicked(GtkButton *button, gpointer user_data) {
+    record_frame(ui.record4_buffer);
 }
 
- /**@brief Servo의 상태를 ON/OFF
-  * @param int iBdID 드라이브 ID 
-  * @param bool bOnOff Enable/Disable
-  * @return 명령이 수행된 정보*/
-int FAS_ServoEnable(int iBdID, bool bOnOff){
-    buffer[0] = header; buffer[1] = 0x04; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type; buffer[5] = data[0];
-    return 0;
-}
 
- /**@brief Alarm Reset명령 보냄
-  * @param int iBdID 드라이브 ID*/
-int FAS_ServoAlarmReset(int iBdID){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+ /**@brief Record칸의 프레임을 보냄 (Transfer버튼 공통)*/
+static void transfer_record(GtkTextBuffer *record_buffer) {
+    gtk_label_set_text(ui.label_status, "Sending");
+    
+    char text[BUFFER_SIZE * 3];
+    text_buffer_copy(record_buffer, text, sizeof(text));
+    gtk_text_buffer_set_text(ui.sendbuffer_buffer, text, -1);
+    frame_preview_shown = FALSE;
+    
+    // 텍스트를 띄어쓰기를 기준으로 16진수로 변환하여 byte 배열에 저장 (heap 사용 안 함)
+    BYTE byte_array[BUFFER_SIZE];
+    int byte_count = FAS_ParseBytes(text, 16, byte_array, sizeof(byte_array));
+    print_buffer(byte_array, byte_count);
+    
+    if (byte_count < FRAME_HEADER_SIZE) {
+        g_print("Frame too short\n");
+        gtk_label_set_text(ui.label_status, "NG");
+        return;
+    }
+    // 적힌 byte를 그대로 보냄 (길이 규칙은 codec마다 다르므로 Length byte로 세지 않음)
+    send_packet(byte_array, byte_count);
 }
 
- /**@brief Alarm 정보 요청
-  * @param int iBdID 드라이브 ID*/
-int FAS_GetAlarmType(int iBdID){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+// 전송 버튼을 누를 때 호출되는 콜백 함수
+static void on_button_transfer1_clicked(GtkButton *button, gpointer user_data) {
+    transfer_record(ui.record1_buffer);
 }
 
- /**@brief Servo를 천천히 멈추는 기능
-  * @param int iBdID 드라이브 ID
-  * @return 명령이 수행된 정보*/
-int FAS_MoveStop(int iBdID){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+// 전송 버튼을 누를 때 호출되는 콜백 함수
+static void on_button_transfer2_clicked(GtkButton *button, gpointer user_data) {
+    transfer_record(ui.record2_buffer);
 }
 
- /**@brief 시스템의 원점을 찾는 기능?
-  * @param int iBdID 드라이브 ID
-  * @return 명령이 수행된 정보*/
-int FAS_MoveOriginSingleAxis(int iBdID){
-    buffer[0] = header; buffer[1] = 0x03; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    return 0;
+// 전송 버튼을 누를 때 호출되는 콜백 함수
+static void on_button_transfer3_clicked(GtkButton *button, gpointer user_data) {
+    transfer_record(ui.record3_buffer);
 }
 
-/**@brief Jog 운전 시작을 요청
-  * @param int iBdID 드라이브 ID
-  * @param DWORD lVelocity 이동 시 속도 값 (pps)
-  * @param int iVelDir 이동할 방향 (0:-Jog, 1:+Jog)
-  * @return 명령이 수행된 정보*/
-int FAS_MoveVelocity(int iBdID, DWORD lVelocity, int iVelDir) {
-    buffer[0] = header; buffer[1] = 0x08; buffer[2] = sync_no; buffer[3] = 0x00; buffer[4] = frame_type;
-    memcpy(&buffer[5], data, sizeof(data));
-    return 0;
+// 전송 버튼을 누를 때 호출되는 콜백 함수
+static void on_button_transfer4_clicked(GtkButton *button, gpointer user_data) {
+    transfer_record(ui.record4_buffer);
 }
 /************************************************************************************************************************************
  ******************************************************* 편의상 만든 함수 **************************************************************
@@ -959,335 +1173,175 @@ int FAS_MoveVelocity(int iBdID, DWORD lVelocity, int iVelDir) {
     printf("\n");
 }
 
-/**@brief  배열을 문자열로 변환하는 함수*/
-char* array_to_string(const uint8_t *array, int size) {
-    char *str = g_strdup_printf("%02X", array[0]); // 첫 번째 요소는 따로 처리
+/**@brief  배열을 문자열로 변환하는 함수
+ * @return GUI thread 전용 고정 buffer (다음 호출 때 덮어씀, free하지 않음)*/
+const char *array_to_string(const uint8_t *array, int size) {
+    static char text[BUFFER_SIZE * 3];
+    FAS_FormatFrame(text, sizeof(text), array, size);
+    return text;
+}
 
-    char *temp;
-    for (int i = 1; i < size; i++) { // 첫 번째 요소 이후의 요소들 처리
-        temp = g_strdup_printf("%s %02X", str, array[i]);
-        g_free(str);
-        str = temp;
+ /**@brief GtkTextBuffer 내용을 heap 할당 없이 out에 복사 (gtk_text_buffer_get_text 대신)
+  * @return 복사한 byte 수 (out_size - 1까지)*/
+int text_buffer_copy(GtkTextBuffer *text_buffer, char *out, int out_size) {
+    GtkTextIter iter;
+    int len = 0;
+    gtk_text_buffer_get_start_iter(text_buffer, &iter);
+    while (!gtk_text_iter_is_end(&iter) && len < out_size - 1) {
+        gunichar c = gtk_text_iter_get_char(&iter);
+        out[len++] = c < 0x80 ? (char)c : ' ';	// 프레임은 ASCII만 씀
+        gtk_text_iter_forward_char(&iter);
     }
-
-    return str;
+    out[len] = '\0';
+    return len;
 }
 
- /**@brief 함수들을 찾아가게하는 인터페이스 용도 함수*/
+ /**@brief 함수들을 찾아가게하는 인터페이스 용도 함수 (선택한 명령의 프레임을 송신 buffer에 조립)*/
 void library_interface(){
-    switch(frame_type)
-    {
-        case 0x01:
-            FAS_GetboardInfo(0, 0, NULL, 0);
-            break;
-        case 0x05:
-            FAS_GetMotorInfo(0, 0, NULL, 0);
-            break;
-        case 0x06:
-            FAS_GetEncoder(0, 0, NULL, 0);
-            break;
-        case 0x07:
-            FAS_GetFirmwareInfo(0, 0, NULL, 0);
-            break;
-        case 0x09:
-            FAS_ServoEnable(0, 0);
-            break;
-        case 0x10:
-            FAS_SaveAllParameters(0);
-            break;
-        case 0x2A:
-            FAS_ServoEnable(0, 0);
-            break;
-        case 0x2B:
-            FAS_ServoAlarmReset(0);
-            break;
-        case 0x2E:
-            FAS_GetAlarmType(0);
-            break;
-        case 0x31:
-            FAS_MoveStop(0);
-            break;
-        case 0x32:
-            FAS_EmergencyStop(0);
-            break;
-        case 0x33:
-            FAS_MoveOriginSingleAxis(0);
-            break;
-         case 0x37:
-            FAS_MoveVelocity(0, 1000, 0); // 예시로 lVelocity를 1000, iVelDir를 0으로 설정
-            break;
-    }
-    size_t data_size = buffer[1] + 2;
-    print_buffer(buffer, data_size);
+    int data_len = FAS_FrameDataLength(frame_type);
+    // 길이 규칙은 codec마다 다르므로 (serial은 Length byte가 없음) encode가 돌려준 길이를 씀
+    // 가변 길이 명령은 Frame 입력칸이 이미 buffer에 만들어 둔 프레임을 씀
+    int frame_len = data_len != FAS_FRAME_DATA_VARIABLE
+        ? board->codec->encode(buffer, board->link.sync_no, frame_type, data, data_len)
+        : buffer_len;
+    if (frame_len < 0)
+        return;
+    buffer_len = frame_len;
+    FAS_TRACE(FAS_TRACE_BUILD, 0, board->link.sync_no, frame_type);
+    print_buffer(buffer, frame_len);
     
-    char *text = array_to_string(buffer, buffer[1] + 2);
-    gtk_text_buffer_set_text(sendbuffer_buffer, text, -1);
+    gtk_text_buffer_set_text(ui.sendbuffer_buffer, array_to_string(buffer, frame_len), -1);
+    frame_preview_shown = FALSE;
 }
 
- /**@brief 각 명령어의 함수 이름을 찾아가는 인터페이스 용도 함수*/
-char *command_interface(){
-    switch(frame_type)
-    {
-        case 0x01:
-            return"FAS_GetboardInfo";
-        case 0x05:
-            return "FAS_GetMotorInfo";
-        case 0x06:
-            return "FAS_GetEncoder";
-        case 0x07:
-            return "FAS_GetFirmwareInfo";
-        case 0x09:
-            return "FAS_ServoEnable";
-        case 0x10:
-            return "FAS_SaveAllParameters";
-        case 0x2A:
-            return "FAS_ServoEnable";
-        case 0x2B:
-            return "FAS_ServoAlarmReset";
-        case 0x2E:
-            return "FAS_GetAlarmType";
-        case 0x31:
-            return "FAS_MoveStop";
-        case 0x32:
-            return "FAS_EmergencyStop";
-        case 0x33:
-            return "FAS_MoveOriginSingleAxis";
-         case 0x37:
-            return "FAS_MoveVelocity";
-        default:
-            return "Transfer Fail";
+ /**@brief check_fastech/check_userport에 맞는 codec을 board에 설정 (port는 다음 연결부터)*/
+void codec_select(){
+    const FAS_CODEC *codec = gtk_toggle_button_get_active(ui.check_fastech) ? &FAS_CodecFastech : &FAS_CodecUser;
+    if (gtk_toggle_button_get_active(ui.check_userport)) {
+        char text[16];
+        text_buffer_copy(ui.userport_buffer, text, sizeof(text));
+        int port = atoi(text);
+        if (port > 0 && port < 65536) {
+            FAS_CodecWithPort(&user_port_codec, codec, (uint16_t)port);
+            codec = &user_port_codec;
+        }
+        else {
+            g_print("Invalid user port: %s\n", text);
+        }
     }
+    FAS_ContextSetCodec(board, codec);
 }
 
- /**@brief 통신상태에서 출력할 내용을 찾아가는 인터페이스 용도 함수*/
-char* FMM_interface(FMM_ERROR error) {
-    switch (error) {
-        case FMM_OK:
-            return "FMM_OK";
-        case FMM_NOT_OPEN:
-            return "FMM_NOT_OPEN";
-        case FMM_INVALID_PORT_NUM:
-            return "FMM_INVALID_PORT_NUM";
-        case FMM_INVALID_SLAVE_NUM:
-            return "FMM_INVALID_SLAVE_NUM";
-        case FMC_DISCONNECTED:
-            return "FMC_DISCONNECTED";
-        case FMC_TIMEOUT_ERROR:
-            return "FMC_TIMEOUT_ERROR";
-        case FMC_CRCFAILED_ERROR:
-            return "FMC_CRCFAILED_ERROR";
-        case FMC_RECVPACKET_ERROR:
-            return "FMC_RECVPACKET_ERROR";
-        case FMM_POSTABLE_ERROR:
-            return "FMM_POSTABLE_ERROR";
-        case FMP_FRAMETYPEERROR:
-            return "FMP_FRAMETYPEERROR";
-        case FMP_DATAERROR:
-            return "FMP_DATAERROR";
-        case FMP_PACKETERROR:
-            return "FMP_PACKETERROR";
-        case FMP_RUNFAIL:
-            return "FMP_RUNFAIL";
-        case FMP_RESETFAIL:
-            return "FMP_RESETFAIL";
-        case FMP_SERVOONFAIL1:
-            return "FMP_SERVOONFAIL1";
-        case FMP_SERVOONFAIL2:
-            return "FMP_SERVOONFAIL2";
-        case FMP_SERVOONFAIL3:
-            return "FMP_SERVOONFAIL3";
-        case FMP_SERVOOFF_FAIL:
-            return "FMP_SERVOOFF_FAIL";
-        case FMP_ROMACCESS:
-            return "FMP_ROMACCESS";
-        case FMP_PACKETCRCERROR:
-            return "FMP_PACKETCRCERROR";
-        case FMM_UNKNOWN_ERROR:
-            return "FMM_UNKNOWN_ERROR";
-        default:
-            return "Unknown error";
-    }
+ /**@brief 각 명령어의 함수 이름을 찾아가는 인터페이스 용도 함수*/
+const char *command_interface(){
+    return FAS_FrameName(frame_type);
 }
 
 void syno_no_update(){
-    sync_no++;
+    board->link.sync_no++;
     char sync_str[4];
-    sprintf(sync_str, "%u", sync_no);
-    gtk_text_buffer_set_text(autosync_buffer, sync_str, -1);
+    sprintf(sync_str, "%u", board->link.sync_no);
+    gtk_text_buffer_set_text(ui.autosync_buffer, sync_str, -1);
 }
 
-char* get_time() {
+void get_time(char *time_string) {
     time_t currentTime;
-    struct tm* timeInfo;
-    char* timeString = (char*)malloc(9); // "hh:mm:ss" + null terminator
-
-    if (timeString == NULL) {
-        printf("메모리 할당 오류\n");
-        return NULL;
-    }
+    struct tm timeInfo;
 
     // 시스템의 현재 시간 가져오기
     currentTime = time(NULL);
 
-    // 현재 시간을 localtime 함수를 이용하여 시간 구조체에 저장
-    timeInfo = localtime(&currentTime);
+    // 현재 시간을 localtime_r 함수를 이용하여 시간 구조체에 저장
+    localtime_r(&currentTime, &timeInfo);
 
-    // 시간:분:초 형식으로 문자열로 변환
-    strftime(timeString, 9, "%H:%M:%S", timeInfo);
-    return timeString;
+    // 시간:분:초 형식으로 문자열로 변환 ("hh:mm:ss" + null, 호출자 buffer 9 byte 이상)
+    strftime(time_string, 9, "%H:%M:%S", &timeInfo);
 }
 
-void handle_alarm(int signum) {
-    // 타이머 시간이 초과되면 SIGALRM 신호가 발생합니다.
-    // 이때 소켓을 닫고 연결 실패로 간주합니다.
-    perror("Connection timed out");
-    close(client_socket);
-    
-    gtk_label_set_text(label_status, "NG");
+ /**@brief SIGUSR1을 받으면 trace ring을 JSON으로 저장 (GTK main loop에서 실행되므로 stdio 사용 가능)*/
+gboolean handle_trace_dump(gpointer user_data) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/fastech_trace_%d.json", (int)getpid());
+    if (FAS_TraceDumpFile(path))
+        g_print("Trace dumped: %s\n", path);
+    return G_SOURCE_CONTINUE;
 }
 
-void send_packet(BYTE *byte_array){
+void send_packet(BYTE *byte_array, int frame_len){
+    if (!board->open) {
+        g_print("Not connected\n");
+        return;
+    }
+    if (frame_len <= 0) {
+        g_print("No frame\n");
+        return;
+    }
     
     syno_no_update();
-    char* currentTimeString = get_time();
-    if (currentTimeString != NULL) {
-        gtk_label_set_text(label_time, currentTimeString);
-        free(currentTimeString); // 메모리 해제
-    }
-    gtk_label_set_text(label_status, "Sending");
+    char currentTimeString[9];
+    get_time(currentTimeString);
+    gtk_label_set_text(ui.label_time, currentTimeString);
+    gtk_label_set_text(ui.label_status, "Sending");
     
     if(show){
-        char *text = array_to_string(byte_array, byte_array[1] + 2);
-        gtk_text_buffer_set_text(monitor1_buffer, text, -1);
+        gtk_text_buffer_set_text(ui.monitor1_buffer, array_to_string(byte_array, frame_len), -1);
         
         frame_type = byte_array[4];
-        char *command = command_interface();
-        gtk_text_buffer_set_text(monitor2_buffer, "[SEND]", -1);
+        const char *command = command_interface();
+        gtk_text_buffer_set_text(ui.monitor2_buffer, "[SEND]", -1);
         
         GtkTextIter iter;
-        gtk_text_buffer_get_end_iter(monitor2_buffer, &iter);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, command, -1);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
+        gtk_text_buffer_get_end_iter(ui.monitor2_buffer, &iter);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, "\n", -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, command, -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, "\n", -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, "\n", -1);
     }
-    int send_result = sendto(client_socket, byte_array, byte_array[1] + 2, 0, (const struct sockaddr *)&server_addr, sizeof(server_addr));
-    if (send_result < 0) {
-        perror("sendto failed");
+    
+    // 송신, Sync No.가 같은 응답 대기, 통계/trace 기록은 라이브러리가 함 (UDP/TCP 모두)
+    FMM_ERROR status = FAS_ContextTransact(board, byte_array, frame_len);
+    if (board->rx_len == 0) {
+        g_print("No response: %s\n", FAS_ErrorName(status));
+        gtk_label_set_text(ui.label_status, "NG");
         return;
     }
-    alarm(TIMEOUT_SECONDS);
-    while(1){
-        ssize_t received_bytes = recvfrom(client_socket, buffer, sizeof(buffer), 0, NULL, NULL);
-        
-        if (received_bytes < 0) {
-            perror("recvfrom failed");
-            break;
-        }
+    BYTE *response = board->rx;
+    int received_bytes = board->rx_len;
 
-        // Print the received data in hexadecimal format
-        printf("Server: ");
-        for (ssize_t i = 0; i < received_bytes; i++) {
-            printf("%02x ", (BYTE)buffer[i]);
-        }
-        printf("\n");
-        
-        gtk_label_set_text(label_status, "OK");
-        alarm(0);
-        if(show){
-            FMM_ERROR errorCode = buffer[5];
-            char *errorMsg = FMM_interface(errorCode);
-            
-            char *response_text = array_to_string(buffer, received_bytes);
-            GtkTextIter iter;
-            gtk_text_buffer_get_end_iter(monitor1_buffer, &iter);
-            gtk_text_buffer_insert(monitor1_buffer, &iter, "\n", -1); // Add a newline
-            gtk_text_buffer_insert(monitor1_buffer, &iter, "\n", -1); // Add a newline
-            gtk_text_buffer_insert(monitor1_buffer, &iter, response_text, -1);
-            
-            frame_type = buffer[4];
-            char *command = command_interface();
-            gtk_text_buffer_get_end_iter(monitor2_buffer, &iter);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "[RECEIVE]", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, command, -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "RESPONSE : ", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, errorMsg, -1);
-        }
-        else{
-            break;
-        }
-        break;
+    // Print the received data in hexadecimal format
+    printf("Server: ");
+    for (int i = 0; i < received_bytes; i++) {
+        printf("%02x ", response[i]);
     }
-    memset(&buffer, 0, sizeof(buffer));
-}
-
-void send_packetTCP(BYTE *byte_array){
+    printf("\n");
     
-    syno_no_update();
-    char* currentTimeString = get_time();
-    if (currentTimeString != NULL) {
-        gtk_label_set_text(label_time, currentTimeString);
-        free(currentTimeString); // 메모리 해제
-    }
-    gtk_label_set_text(label_status, "Sending");
+    gtk_label_set_text(ui.label_status, "OK");
     if(show){
-        char *text = array_to_string(byte_array, byte_array[1] + 2);
-        gtk_text_buffer_set_text(monitor1_buffer, text, -1);
-        frame_type = byte_array[4];
-        char *command = command_interface();
-        gtk_text_buffer_set_text(monitor2_buffer, "[SEND]", -1);
+        const char *errorMsg = FAS_ErrorName(status);
+        
+        const char *response_text = array_to_string(response, received_bytes);
         GtkTextIter iter;
-        gtk_text_buffer_get_end_iter(monitor2_buffer, &iter);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, command, -1);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-        gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-    }
-    ssize_t sent_bytes = send(client_socket, byte_array, byte_array[1] + 2, 0);
-    if (sent_bytes < 0) {
-        perror("sendto failed");
-    }
-    
-    memset(&buffer, 0, sizeof(buffer));
-    
-    while (1) {
-        // Receive message from server
-        int received_bytes = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-        buffer[received_bytes] = '\0';
+        gtk_text_buffer_get_end_iter(ui.monitor1_buffer, &iter);
+        gtk_text_buffer_insert(ui.monitor1_buffer, &iter, "\n", -1); // Add a newline
+        gtk_text_buffer_insert(ui.monitor1_buffer, &iter, "\n", -1); // Add a newline
+        gtk_text_buffer_insert(ui.monitor1_buffer, &iter, response_text, -1);
         
-        printf("Server: ");
-        for (ssize_t i = 0; i < received_bytes; i++) {
-            printf("%02x ", (BYTE)buffer[i]);
-        }
-        printf("\n");
-        gtk_label_set_text(label_status, "OK");
-        if(show){
-            FMM_ERROR errorCode = buffer[5];
-            char *errorMsg = FMM_interface(errorCode);
-            
-            char *response_text = array_to_string(buffer, received_bytes);
-            GtkTextIter iter;
-            gtk_text_buffer_get_end_iter(monitor1_buffer, &iter);
-            gtk_text_buffer_insert(monitor1_buffer, &iter, "\n", -1); // Add a newline
-            gtk_text_buffer_insert(monitor1_buffer, &iter, "\n", -1); // Add a newline
-            gtk_text_buffer_insert(monitor1_buffer, &iter, response_text, -1);
-            
-            frame_type = buffer[4];
-            char *command = command_interface();
-            gtk_text_buffer_get_end_iter(monitor2_buffer, &iter);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "[RECEIVE]", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, command, -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "\n", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, "RESPONSE : ", -1);
-            gtk_text_buffer_insert(monitor2_buffer, &iter, errorMsg, -1);
-        }
-        else{
-            break;
-        }
-        break;
+        frame_type = response[4];
+        const char *command = command_interface();
+        gtk_text_buffer_get_end_iter(ui.monitor2_buffer, &iter);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, "[RECEIVE]", -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, "\n", -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, command, -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, "\n", -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, "RESPONSE : ", -1);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, errorMsg, -1);
+
+        // RTT를 kernel timestamp로 나눔: 드라이브 + 회선 / 우리 쪽 (stack, GTK main loop 대기)
+        static const char *ts_name[] = { "monotonic", "kernel sw", "kernel hw" };
+        char rtt_text[128];
+        snprintf(rtt_text, sizeof(rtt_text), "\nRTT %u us (drive+wire %u us, host %u us, %s)",
+                 board->rtt_us, board->wire_us, board->rtt_us - board->wire_us, ts_name[board->ts_source]);
+        gtk_text_buffer_insert(ui.monitor2_buffer, &iter, rtt_text, -1);
+        FAS_TRACE(FAS_TRACE_UI_POST, 0, response[2], received_bytes);
     }
-    memset(&buffer, 0, sizeof(buffer));
 }
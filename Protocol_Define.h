@@ -0,0 +1,87 @@
+
+#pragma once
+
+#ifndef FAS_PROTOCOL_DEFINE
+#define FAS_PROTOCOL_DEFINE
+
+#include <stdint.h>
+
+//------------------------------------------------------------------
+//                 Ezi-SERVO Plus-E Ethernet Frame Defines.
+//------------------------------------------------------------------
+// [Header][Length][Sync No.][Reserved][Frame Type][Data ...]
+// Length는 Sync No.부터 끝까지의 byte 수, 응답은 Data 첫 byte가 통신 상태(FMM_ERROR)
+
+typedef uint8_t BYTE;
+typedef uint32_t DWORD;
+typedef char* LPSTR;
+
+#define BUFFER_SIZE 258
+#define DATA_SIZE 253
+#define PORT_UDP 3001 //UDP GUI
+#define PORT_TCP 2001 //TCP GUI
+#define TIMEOUT_SECONDS 2
+
+#define FRAME_HEADER 0xAA
+#define FRAME_HEADER_SIZE 5		// Header, Length, Sync No., Reserved, Frame Type
+
+typedef enum _FAS_FRAME_TYPE
+{
+	FRAME_GETSLAVEINFO = 0x01,
+	FRAME_GETMOTORINFO = 0x05,
+	FRAME_GETENCODER = 0x06,
+	FRAME_GETFIRMWAREINFO = 0x07,
+	FRAME_GETSLAVEINFOEX = 0x09,
+
+	FRAME_SAVEALLPARAMETERS = 0x10,
+	FRAME_GETROMPARAMETER,
+	FRAME_SETPARAMETER,
+	FRAME_GETPARAMETER,
+
+	FRAME_SERVOENABLE = 0x2A,
+	FRAME_SERVOALARMRESET,
+	FRAME_GETALARMTYPE = 0x2E,
+
+	FRAME_MOVESTOP = 0x31,
+	FRAME_EMERGENCYSTOP,
+	FRAME_MOVEORIGINSINGLEAXIS,
+	FRAME_MOVESINGLEAXISABSPOS,
+	FRAME_MOVESINGLEAXISINCPOS,
+	FRAME_MOVETOLIMIT,
+	FRAME_MOVEVELOCITY,
+	FRAME_POSITIONABSOVERRIDE,
+	FRAME_POSITIONINCOVERRIDE,
+	FRAME_VELOCITYOVERRIDE,
+
+	FRAME_GETAXISSTATUS = 0x40,
+	FRAME_GETIOAXISSTATUS,
+	FRAME_GETMOTIONSTATUS,
+	FRAME_GETALLSTATUS,
+
+	FRAME_SETCOMMANDPOS = 0x50,
+	FRAME_GETCOMMANDPOS,
+	FRAME_SETACTUALPOS,
+	FRAME_GETACTUALPOS,
+	FRAME_GETPOSERROR,
+	FRAME_GETACTUALVEL,
+	FRAME_CLEARPOSITION = 0x56,
+
+	FRAME_POSTABLEREADITEM = 0x60,
+	FRAME_POSTABLEWRITEITEM,
+	FRAME_POSTABLEREADROM,
+	FRAME_POSTABLEWRITEROM,
+	FRAME_POSTABLERUNITEM,
+
+} FAS_FRAME_TYPE;
+
+/**@brief little endian 4 byte 쓰기*/
+static inline void fas_put_le32(BYTE *p, uint32_t v) {
+    p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = (v >> 24) & 0xFF;
+}
+
+/**@brief little endian 4 byte 읽기*/
+static inline uint32_t fas_get_le32(const BYTE *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#endif	//FAS_PROTOCOL_DEFINE